@@ -0,0 +1,99 @@
+/*
+ * BenchmarkHelpers.hpp
+ *
+ *  Knot and query time generation shared by the curves benchmarks.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include "curves/Curve.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace curves {
+namespace bench {
+
+//! Order in which a benchmark queries the curve.
+enum QueryPattern {
+  Random = 0,      // uniformly distributed, unsorted
+  Monotonic = 1,   // uniformly distributed, sorted
+  UniformGrid = 2  // evenly spaced, sorted
+};
+
+//! Number of queries per benchmark iteration.
+static const size_t kQueryCount = 1024;
+
+static const long kMinKnotCount = 10;
+static const long kMaxKnotCount = 1000000;
+
+inline std::string getQueryPatternName(long pattern) {
+  switch (pattern) {
+    case Random: return "random";
+    case Monotonic: return "monotonic";
+    case UniformGrid: return "grid";
+    default: return "unknown";
+  }
+}
+
+//! Knot times with an average spacing of 0.1s and some jitter, so they are not perfectly even.
+inline std::vector<Time> getKnotTimes(size_t knotCount, unsigned int seed = 1) {
+  std::default_random_engine engine(seed);
+  std::uniform_real_distribution<double> jitter(-0.03, 0.03);
+  std::vector<Time> times;
+  times.reserve(knotCount);
+  for (size_t i = 0; i < knotCount; ++i) {
+    times.push_back(0.1 * i + (i == 0 ? 0.0 : jitter(engine)));
+  }
+  return times;
+}
+
+inline std::vector<Time> getQueryTimes(long pattern, Time minTime, Time maxTime,
+                                       size_t queryCount = kQueryCount, unsigned int seed = 2) {
+  std::vector<Time> times;
+  times.reserve(queryCount);
+  if (pattern == UniformGrid) {
+    const Time step = (maxTime - minTime) / (queryCount - 1);
+    for (size_t i = 0; i < queryCount; ++i) {
+      times.push_back(std::min(minTime + step * i, maxTime));
+    }
+    return times;
+  }
+  std::default_random_engine engine(seed);
+  std::uniform_real_distribution<double> distribution(minTime, maxTime);
+  for (size_t i = 0; i < queryCount; ++i) {
+    times.push_back(distribution(engine));
+  }
+  if (pattern == Monotonic) {
+    std::sort(times.begin(), times.end());
+  }
+  return times;
+}
+
+//! Register the knot counts kMinKnotCount, 10*kMinKnotCount, ..., maxKnotCount.
+inline void addKnotCounts(::benchmark::internal::Benchmark* benchmark, long maxKnotCount = kMaxKnotCount) {
+  for (long knotCount = kMinKnotCount; knotCount <= maxKnotCount; knotCount *= 10) {
+    benchmark->Arg(knotCount);
+  }
+}
+
+//! Register all pairs (knot count, query pattern).
+inline void addKnotCountsAndQueryPatterns(::benchmark::internal::Benchmark* benchmark,
+                                          long maxKnotCount) {
+  for (long knotCount = kMinKnotCount; knotCount <= maxKnotCount; knotCount *= 10) {
+    for (long pattern = Random; pattern <= UniformGrid; ++pattern) {
+      benchmark->Args({knotCount, pattern});
+    }
+  }
+}
+
+inline void addKnotCountsAndQueryPatterns(::benchmark::internal::Benchmark* benchmark) {
+  addKnotCountsAndQueryPatterns(benchmark, kMaxKnotCount);
+}
+
+} // namespace bench
+} // namespace curves
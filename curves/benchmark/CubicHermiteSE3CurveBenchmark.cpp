@@ -0,0 +1,91 @@
+/*
+ * CubicHermiteSE3CurveBenchmark.cpp
+ *
+ *  Evaluation latency of CubicHermiteSE3Curve.
+ */
+
+#include "BenchmarkHelpers.hpp"
+
+#include "curves/CubicHermiteSE3Curve.hpp"
+
+using namespace curves;
+
+namespace {
+
+typedef CubicHermiteSE3Curve::ValueType ValueType;
+typedef CubicHermiteSE3Curve::DerivativeType DerivativeType;
+
+void fitRandomCurve(size_t knotCount, CubicHermiteSE3Curve* curve) {
+  const std::vector<Time> times = bench::getKnotTimes(knotCount);
+  std::default_random_engine engine(3);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  std::vector<ValueType> values;
+  values.reserve(knotCount);
+  for (size_t i = 0; i < knotCount; ++i) {
+    values.push_back(ValueType(ValueType::Position(distribution(engine), distribution(engine), distribution(engine)),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(distribution(engine), distribution(engine),
+                                                                          distribution(engine)))));
+  }
+  curve->fitCurve(times, values);
+}
+
+void CubicHermiteSE3CurveEvaluate(benchmark::State& state) {
+  CubicHermiteSE3Curve curve;
+  fitRandomCurve(state.range(0), &curve);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), curve.getMinTime(), curve.getMaxTime());
+  ValueType value;
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      curve.evaluate(value, queries[i]);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(CubicHermiteSE3CurveEvaluate)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+void CubicHermiteSE3CurveEvaluateWithCursor(benchmark::State& state) {
+  CubicHermiteSE3Curve curve;
+  fitRandomCurve(state.range(0), &curve);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), curve.getMinTime(), curve.getMaxTime());
+  ValueType value;
+  for (auto _ : state) {
+    CubicHermiteSE3Curve::CoefficientCursor cursor;
+    for (size_t i = 0; i < queries.size(); ++i) {
+      curve.evaluate(value, queries[i], &cursor);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(CubicHermiteSE3CurveEvaluateWithCursor)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+void CubicHermiteSE3CurveEvaluateDerivative(benchmark::State& state) {
+  CubicHermiteSE3Curve curve;
+  fitRandomCurve(state.range(0), &curve);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), curve.getMinTime(), curve.getMaxTime());
+  DerivativeType derivative;
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      curve.evaluateDerivative(derivative, queries[i], 1);
+      benchmark::DoNotOptimize(derivative);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(CubicHermiteSE3CurveEvaluateDerivative)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+void CubicHermiteSE3CurveFit(benchmark::State& state) {
+  for (auto _ : state) {
+    CubicHermiteSE3Curve curve;
+    fitRandomCurve(state.range(0), &curve);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(CubicHermiteSE3CurveFit)->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b); });
+
+} // namespace
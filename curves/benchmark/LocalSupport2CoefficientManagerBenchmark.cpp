@@ -0,0 +1,76 @@
+/*
+ * LocalSupport2CoefficientManagerBenchmark.cpp
+ *
+ *  Lookup and insertion cost of LocalSupport2CoefficientManager for both storages.
+ */
+
+#include "BenchmarkHelpers.hpp"
+
+#include "curves/LocalSupport2CoefficientManager.hpp"
+#include "curves/SortedArrayCoefficientStorage.hpp"
+
+#include <Eigen/Core>
+
+using namespace curves;
+
+namespace {
+
+typedef Eigen::Vector3d Coefficient;
+typedef LocalSupport2CoefficientManager<Coefficient> MapManager;
+typedef LocalSupport2CoefficientManager<Coefficient, SortedArrayCoefficientStorage<Coefficient> > ArrayManager;
+
+template <class Manager>
+void ManagerGetCoefficientsAt(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  const std::vector<Coefficient> coefficients(times.size(), Coefficient::Ones());
+  Manager manager;
+  manager.insertCoefficients(times, coefficients);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), manager.getMinTime(), manager.getMaxTime());
+  typename Manager::CoefficientIter coefficient0, coefficient1;
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      benchmark::DoNotOptimize(manager.getCoefficientsAt(queries[i], &coefficient0, &coefficient1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK_TEMPLATE(ManagerGetCoefficientsAt, MapManager)->Apply(bench::addKnotCountsAndQueryPatterns);
+BENCHMARK_TEMPLATE(ManagerGetCoefficientsAt, ArrayManager)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+template <class Manager>
+void ManagerGetCoefficientsAtWithCursor(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  const std::vector<Coefficient> coefficients(times.size(), Coefficient::Ones());
+  Manager manager;
+  manager.insertCoefficients(times, coefficients);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), manager.getMinTime(), manager.getMaxTime());
+  typename Manager::CoefficientIter coefficient0, coefficient1;
+  for (auto _ : state) {
+    typename Manager::Cursor cursor;
+    for (size_t i = 0; i < queries.size(); ++i) {
+      benchmark::DoNotOptimize(manager.getCoefficientsAt(queries[i], &cursor, &coefficient0, &coefficient1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK_TEMPLATE(ManagerGetCoefficientsAtWithCursor, ArrayManager)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+template <class Manager>
+void ManagerInsertCoefficients(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  const std::vector<Coefficient> coefficients(times.size(), Coefficient::Ones());
+  for (auto _ : state) {
+    Manager manager;
+    manager.insertCoefficients(times, coefficients);
+    benchmark::DoNotOptimize(manager.size());
+  }
+  state.SetItemsProcessed(state.iterations() * times.size());
+}
+BENCHMARK_TEMPLATE(ManagerInsertCoefficients, MapManager)
+    ->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b); });
+BENCHMARK_TEMPLATE(ManagerInsertCoefficients, ArrayManager)
+    ->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b); });
+
+} // namespace
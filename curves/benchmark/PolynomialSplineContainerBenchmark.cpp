@@ -0,0 +1,95 @@
+/*
+ * PolynomialSplineContainerBenchmark.cpp
+ *
+ *  Fitting and evaluation cost of PolynomialSplineContainer.
+ */
+
+#include "BenchmarkHelpers.hpp"
+
+#include "curves/PolynomialSplineContainer.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+namespace {
+
+// The dense solver is cubic in the number of knots, larger fits do not finish in reasonable time.
+const long kMaxDenseKnotCount = 1000;
+
+std::vector<double> getKnotValues(const std::vector<Time>& times) {
+  std::vector<double> values;
+  values.reserve(times.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    values.push_back(std::sin(times[i]));
+  }
+  return values;
+}
+
+void PolynomialSplineContainerSetData(benchmark::State& state, PolynomialSplineContainer::SolverType solverType) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  const std::vector<double> values = getKnotValues(times);
+  for (auto _ : state) {
+    PolynomialSplineContainer container;
+    container.setSolverType(solverType);
+    container.setData(times, values, 0.0, 0.0, 0.0, 0.0);
+    benchmark::DoNotOptimize(container.getSplines().data());
+  }
+  state.SetItemsProcessed(state.iterations() * times.size());
+}
+BENCHMARK_CAPTURE(PolynomialSplineContainerSetData, DenseQR, PolynomialSplineContainer::SolverType::DenseQR)
+    ->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b, kMaxDenseKnotCount); });
+BENCHMARK_CAPTURE(PolynomialSplineContainerSetData, SparseMinimumNorm,
+                  PolynomialSplineContainer::SolverType::SparseMinimumNorm)
+    ->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b); });
+
+// Refit with unchanged knot times, reusing the cached factorization.
+void PolynomialSplineContainerRefit(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  const std::vector<double> values = getKnotValues(times);
+  PolynomialSplineContainer container;
+  container.setSolverType(PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  container.setData(times, values, 0.0, 0.0, 0.0, 0.0);
+  double initialVelocity = 0.0;
+  for (auto _ : state) {
+    initialVelocity += 1e-3;
+    container.setData(times, values, initialVelocity, 0.0, 0.0, 0.0);
+    benchmark::DoNotOptimize(container.getSplines().data());
+  }
+  state.SetItemsProcessed(state.iterations() * times.size());
+}
+BENCHMARK(PolynomialSplineContainerRefit)->Apply([](benchmark::internal::Benchmark* b) { bench::addKnotCounts(b); });
+
+void PolynomialSplineContainerGetPositionAtTime(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  PolynomialSplineContainer container;
+  container.setSolverType(PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  container.setData(times, getKnotValues(times), 0.0, 0.0, 0.0, 0.0);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), 0.0, container.getContainerDuration());
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      benchmark::DoNotOptimize(container.getPositionAtTime(queries[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(PolynomialSplineContainerGetPositionAtTime)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+void PolynomialSplineContainerEvaluateState(benchmark::State& state) {
+  const std::vector<Time> times = bench::getKnotTimes(state.range(0));
+  PolynomialSplineContainer container;
+  container.setSolverType(PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  container.setData(times, getKnotValues(times), 0.0, 0.0, 0.0, 0.0);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), 0.0, container.getContainerDuration());
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      benchmark::DoNotOptimize(container.evaluateState(queries[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(PolynomialSplineContainerEvaluateState)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+} // namespace
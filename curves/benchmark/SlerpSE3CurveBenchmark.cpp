@@ -0,0 +1,61 @@
+/*
+ * SlerpSE3CurveBenchmark.cpp
+ *
+ *  Evaluation latency of SlerpSE3Curve.
+ */
+
+#include "BenchmarkHelpers.hpp"
+
+#include "curves/SlerpSE3Curve.hpp"
+
+using namespace curves;
+
+namespace {
+
+typedef SlerpSE3Curve::ValueType ValueType;
+
+void fitRandomCurve(size_t knotCount, SlerpSE3Curve* curve) {
+  const std::vector<Time> times = bench::getKnotTimes(knotCount);
+  std::default_random_engine engine(3);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  std::vector<ValueType> values;
+  values.reserve(knotCount);
+  for (size_t i = 0; i < knotCount; ++i) {
+    values.push_back(ValueType(ValueType::Position(distribution(engine), distribution(engine), distribution(engine)),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(distribution(engine), distribution(engine),
+                                                                          distribution(engine)))));
+  }
+  curve->fitCurve(times, values);
+}
+
+void SlerpSE3CurveEvaluate(benchmark::State& state) {
+  SlerpSE3Curve curve;
+  fitRandomCurve(state.range(0), &curve);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), curve.getMinTime(), curve.getMaxTime());
+  ValueType value;
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      curve.evaluate(value, queries[i]);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(SlerpSE3CurveEvaluate)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+void SlerpSE3CurveEvaluateBatch(benchmark::State& state) {
+  SlerpSE3Curve curve;
+  fitRandomCurve(state.range(0), &curve);
+  const std::vector<Time> queries = bench::getQueryTimes(state.range(1), curve.getMinTime(), curve.getMaxTime());
+  std::vector<ValueType> values;
+  for (auto _ : state) {
+    curve.evaluate(queries, &values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetLabel(bench::getQueryPatternName(state.range(1)));
+}
+BENCHMARK(SlerpSE3CurveEvaluateBatch)->Apply(bench::addKnotCountsAndQueryPatterns);
+
+} // namespace
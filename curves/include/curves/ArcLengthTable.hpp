@@ -0,0 +1,210 @@
+/*
+ * ArcLengthTable.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// Speed of a position derivative.
+template <class Derived>
+double getLinearSpeed(const Eigen::MatrixBase<Derived>& velocity) {
+  return velocity.norm();
+}
+
+/// Linear speed of a twist, e.g. the derivative of an SE3 curve.
+template <class Twist>
+auto getLinearSpeed(const Twist& twist) -> decltype(twist.getTranslationalVelocity().vector().norm()) {
+  return twist.getTranslationalVelocity().vector().norm();
+}
+
+/// \brief Arc length parametrization of the position of a curve.
+///
+/// The segments between the knots are split into intervals whose lengths are integrated
+/// with 5 point Gauss-Legendre quadrature of the speed, accurate to the order of 10 for
+/// polynomial segments. Within an interval, the time is a cubic Hermite function of the
+/// arc length with the inverse speeds as slopes, limited to keep it monotone (Fritsch-Carlson).
+/// Lookups by arc length or time are a binary search over the intervals.
+///
+/// The table refers to the curve and has to be built again when the curve is changed.
+/// CurveType has to provide evaluate() and a first order evaluateDerivative() whose
+/// result is accepted by getLinearSpeed, like CubicHermiteE3Curve, CubicHermiteSE3Curve
+/// and PolynomialSplineQuinticVector3Curve.
+template <class CurveType>
+class ArcLengthTable {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  ArcLengthTable() : curve_(NULL) {}
+
+  /// \brief Build the table over the knot times of the curve, splitting every segment into
+  ///        intervalsPerSegment intervals. Returns false if the speed cannot be evaluated.
+  bool build(const CurveType& curve, const std::vector<Time>& knotTimes, unsigned int intervalsPerSegment = 4) {
+    CHECK_GT(intervalsPerSegment, 0u);
+    clear();
+    if (knotTimes.size() < 2) {
+      return false;
+    }
+    curve_ = &curve;
+    const size_t numIntervals = (knotTimes.size() - 1) * intervalsPerSegment;
+    times_.reserve(numIntervals + 1);
+    lengths_.reserve(numIntervals + 1);
+    speeds_.reserve(numIntervals + 1);
+    times_.push_back(knotTimes.front());
+    lengths_.push_back(0.0);
+    for (size_t k = 0; k + 1 < knotTimes.size(); ++k) {
+      CHECK_LT(knotTimes[k], knotTimes[k + 1]) << "Knot times have to be strictly increasing.";
+      const Time dt = (knotTimes[k + 1] - knotTimes[k]) / intervalsPerSegment;
+      for (unsigned int j = 1; j <= intervalsPerSegment; ++j) {
+        const Time time = j == intervalsPerSegment ? knotTimes[k + 1] : knotTimes[k] + j * dt;
+        double length;
+        if (!integrate(times_.back(), time, &length)) {
+          clear();
+          return false;
+        }
+        times_.push_back(time);
+        lengths_.push_back(lengths_.back() + length);
+      }
+    }
+    for (size_t i = 0; i < times_.size(); ++i) {
+      double speed;
+      if (!getSpeed(times_[i], &speed)) {
+        clear();
+        return false;
+      }
+      speeds_.push_back(speed);
+    }
+    return true;
+  }
+
+  /// \brief Build the table over the knot times returned by curve.getCurveTimes().
+  bool build(const CurveType& curve, unsigned int intervalsPerSegment = 4) {
+    std::vector<Time> knotTimes;
+    curve.getCurveTimes(&knotTimes);
+    return build(curve, knotTimes, intervalsPerSegment);
+  }
+
+  void clear() {
+    curve_ = NULL;
+    times_.clear();
+    lengths_.clear();
+    speeds_.clear();
+  }
+
+  bool isEmpty() const { return times_.empty(); }
+
+  double getTotalLength() const { return lengths_.empty() ? 0.0 : lengths_.back(); }
+
+  /// \brief Time at which the curve has covered arcLength, clamped to the table.
+  Time getTimeAtArcLength(double arcLength) const {
+    CHECK(!isEmpty()) << "The arc length table is empty.";
+    if (arcLength <= 0.0) {
+      return times_.front();
+    }
+    if (arcLength >= lengths_.back()) {
+      return times_.back();
+    }
+    const size_t i = std::upper_bound(lengths_.begin(), lengths_.end(), arcLength) - lengths_.begin() - 1;
+    const double ds = lengths_[i + 1] - lengths_[i];
+    const Time dt = times_[i + 1] - times_[i];
+    if (!(ds > 0.0)) {
+      return times_[i];
+    }
+    // Slopes dt/ds of the Hermite interpolation, at most 3 times the secant slope to stay monotone.
+    const double secant = dt / ds;
+    const double slope0 = speeds_[i] * 3.0 > 1.0 / secant ? 1.0 / speeds_[i] : 3.0 * secant;
+    const double slope1 = speeds_[i + 1] * 3.0 > 1.0 / secant ? 1.0 / speeds_[i + 1] : 3.0 * secant;
+    const double u = (arcLength - lengths_[i]) / ds;
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    return times_[i] + dt * (-2.0 * u3 + 3.0 * u2) + ds * (slope0 * (u3 - 2.0 * u2 + u) + slope1 * (u3 - u2));
+  }
+
+  /// \brief Arc length covered at time, clamped to the table.
+  double getArcLengthAtTime(Time time) const {
+    CHECK(!isEmpty()) << "The arc length table is empty.";
+    if (time <= times_.front()) {
+      return 0.0;
+    }
+    if (time >= times_.back()) {
+      return lengths_.back();
+    }
+    const size_t i = std::upper_bound(times_.begin(), times_.end(), time) - times_.begin() - 1;
+    double length = 0.0;
+    integrate(times_[i], time, &length);
+    return std::min(lengths_[i] + length, lengths_[i + 1]);
+  }
+
+  /// \brief Evaluate the curve where it has covered arcLength.
+  bool evaluateAtArcLength(ValueType& value, double arcLength) const {
+    return !isEmpty() && curve_->evaluate(value, getTimeAtArcLength(arcLength));
+  }
+
+  /// \brief Evaluate the curve at numSamples equally spaced arc lengths from the start to the end.
+  bool sampleAtEqualArcLengths(size_t numSamples, std::vector<ValueType>* values) const {
+    CHECK_NOTNULL(values);
+    values->resize(numSamples);
+    bool success = !isEmpty();
+    const double step = numSamples > 1 ? getTotalLength() / (numSamples - 1) : 0.0;
+    for (size_t i = 0; i < numSamples && success; ++i) {
+      success = evaluateAtArcLength((*values)[i], i * step);
+    }
+    return success;
+  }
+
+  /// Times at the boundaries of the intervals.
+  const std::vector<Time>& getTimes() const { return times_; }
+
+  /// Arc lengths at the interval boundaries.
+  const std::vector<double>& getArcLengths() const { return lengths_; }
+
+ private:
+  bool getSpeed(Time time, double* speed) const {
+    DerivativeType derivative;
+    if (!curve_->evaluateDerivative(derivative, time, 1)) {
+      return false;
+    }
+    *speed = getLinearSpeed(derivative);
+    return true;
+  }
+
+  /// Length of the curve between timeA and timeB with 5 point Gauss-Legendre quadrature.
+  bool integrate(Time timeA, Time timeB, double* length) const {
+    static const double nodes[5] = {0.0, -0.5384693101056831, 0.5384693101056831,
+                                    -0.9061798459386640, 0.9061798459386640};
+    static const double weights[5] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665,
+                                      0.2369268850561891, 0.2369268850561891};
+    const double halfDuration = 0.5 * (timeB - timeA);
+    const Time center = 0.5 * (timeA + timeB);
+    *length = 0.0;
+    for (int i = 0; i < 5; ++i) {
+      double speed;
+      if (!getSpeed(center + halfDuration * nodes[i], &speed)) {
+        return false;
+      }
+      *length += weights[i] * speed;
+    }
+    *length *= halfDuration;
+    return true;
+  }
+
+  const CurveType* curve_;
+
+  /// Interval boundaries, the arc length and the speed there.
+  std::vector<Time> times_;
+  std::vector<double> lengths_;
+  std::vector<double> speeds_;
+};
+
+} // namespace curves
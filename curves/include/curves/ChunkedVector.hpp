@@ -0,0 +1,322 @@
+/*
+ * ChunkedVector.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace curves {
+
+/// \brief Array with the interface of std::vector, stored in chunks which copies share
+///        until they are modified (copy-on-write).
+///
+/// The elements are kept in chunks of ChunkSize elements, and the array holds a shared
+/// table of pointers to its chunks. Copying the array only copies the pointer to the table,
+/// so it is O(1) and copies keep sharing all chunks. The first modification of a shared
+/// array copies the table, O(size / ChunkSize), and every chunk it writes to for the first
+/// time, O(ChunkSize). Appending or modifying the last elements, as extending a curve does,
+/// therefore leaves all other chunks shared with the copies.
+///
+/// Erasing elements at the front only drops whole chunks, so a sliding window over the
+/// elements is amortized O(1). Inserting or erasing elsewhere moves the elements after
+/// the position, O(size), like a std::vector.
+///
+/// Writes through the non-const accessors (operator[], at, front, back) copy a shared
+/// chunk first, reads through the const ones never copy. The elements are therefore only
+/// written through non-const access of the array that owns them, and references into a
+/// chunk are invalidated by the next non-const access. Copies of an array can be read and
+/// destroyed from other threads while the array is modified, but like a std::vector, an
+/// array is not modified concurrently, except writing to distinct elements after
+/// makeUnique().
+///
+/// A table or chunk is written in place once its reference count is 1. The count is read
+/// with a relaxed load, so an acquire fence follows: it synchronizes with the release of
+/// the last other reference, so all reads of a copy destroyed on another thread happen
+/// before the chunk is written.
+///
+/// Chunks are std::vector<T, Eigen::aligned_allocator<T>>, so T must not be bool. Use
+/// unsigned char for flags.
+template <class T, size_t ChunkSize = 64>
+class ChunkedVector {
+ public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef T& reference;
+  typedef const T& const_reference;
+
+  /// Random access iterator for reading the elements.
+  class const_iterator {
+   public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    const_iterator() : vector_(NULL), index_(0) {}
+
+    const_iterator(const ChunkedVector* vector, size_t index) : vector_(vector), index_(index) {}
+
+    reference operator*() const { return (*vector_)[index_]; }
+    pointer operator->() const { return &(*vector_)[index_]; }
+    reference operator[](difference_type n) const { return (*vector_)[index_ + n]; }
+
+    const_iterator& operator++() { ++index_; return *this; }
+    const_iterator& operator--() { --index_; return *this; }
+    const_iterator operator++(int) { const_iterator it(*this); ++index_; return it; }
+    const_iterator operator--(int) { const_iterator it(*this); --index_; return it; }
+    const_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+    const_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+    const_iterator operator+(difference_type n) const { return const_iterator(vector_, index_ + n); }
+    const_iterator operator-(difference_type n) const { return const_iterator(vector_, index_ - n); }
+    difference_type operator-(const const_iterator& other) const {
+      return difference_type(index_) - difference_type(other.index_);
+    }
+
+    bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+    bool operator<(const const_iterator& other) const { return index_ < other.index_; }
+    bool operator>(const const_iterator& other) const { return index_ > other.index_; }
+    bool operator<=(const const_iterator& other) const { return index_ <= other.index_; }
+    bool operator>=(const const_iterator& other) const { return index_ >= other.index_; }
+
+    /// Position of the element in the array.
+    size_t index() const { return index_; }
+
+   private:
+    const ChunkedVector* vector_;
+    size_t index_;
+  };
+
+  typedef const_iterator iterator;
+
+  ChunkedVector() : head_(0), size_(0) {}
+
+  ChunkedVector(size_t size, const T& value = T()) : head_(0), size_(0) {
+    resize(size, value);
+  }
+
+  template <class InputIterator>
+  ChunkedVector(InputIterator first, InputIterator last) : head_(0), size_(0) {
+    for (; first != last; ++first) {
+      push_back(*first);
+    }
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear() {
+    table_.reset();
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /// Only kept for the interface of std::vector, chunks are allocated as the array grows.
+  void reserve(size_t /*size*/) {}
+
+  const T& operator[](size_t i) const {
+    const size_t position = head_ + i;
+    return (*(*table_)[position / ChunkSize])[position % ChunkSize];
+  }
+
+  /// Access for writing, copies the chunk of the element if it is shared.
+  T& operator[](size_t i) {
+    const size_t position = head_ + i;
+    return getUniqueChunk(position / ChunkSize)[position % ChunkSize];
+  }
+
+  const T& at(size_t i) const {
+    checkRange(i);
+    return (*this)[i];
+  }
+
+  T& at(size_t i) {
+    checkRange(i);
+    return (*this)[i];
+  }
+
+  const T& front() const { return (*this)[0]; }
+  T& front() { return (*this)[0]; }
+  const T& back() const { return (*this)[size_ - 1]; }
+  T& back() { return (*this)[size_ - 1]; }
+
+  void push_back(const T& value) {
+    const size_t position = head_ + size_;
+    if (position % ChunkSize == 0) {
+      makeUniqueTable();
+      table_->push_back(std::make_shared<Chunk>());
+      table_->back()->reserve(ChunkSize);
+    }
+    getUniqueChunk(position / ChunkSize).push_back(value);
+    ++size_;
+  }
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    push_back(T(std::forward<Args>(args)...));
+  }
+
+  void pop_back() {
+    if (size_ == 1) {
+      clear();
+      return;
+    }
+    const size_t position = head_ + size_ - 1;
+    Chunk& chunk = getUniqueChunk(position / ChunkSize);
+    chunk.pop_back();
+    if (chunk.empty()) {
+      table_->pop_back();
+    }
+    --size_;
+  }
+
+  void resize(size_t size, const T& value = T()) {
+    while (size_ > size) {
+      pop_back();
+    }
+    while (size_ < size) {
+      push_back(value);
+    }
+  }
+
+  /// Insert count copies of value before position.
+  const_iterator insert(const_iterator position, size_t count, const T& value) {
+    const size_t index = position.index();
+    if (index == 0 && count <= head_) {
+      // The elements erased at the front of the first chunk are still allocated.
+      head_ -= count;
+      size_ += count;
+    } else {
+      const size_t oldSize = size_;
+      resize(oldSize + count, value);
+      for (size_t i = oldSize; i > index; --i) {
+        (*this)[i - 1 + count] = static_cast<const ChunkedVector&>(*this)[i - 1];
+      }
+    }
+    for (size_t i = index; i < index + count; ++i) {
+      (*this)[i] = value;
+    }
+    return const_iterator(this, index);
+  }
+
+  const_iterator insert(const_iterator position, const T& value) {
+    return insert(position, 1, value);
+  }
+
+  /// Erase the elements in [first, last).
+  const_iterator erase(const_iterator first, const_iterator last) {
+    const size_t begin = first.index();
+    const size_t count = last.index() - begin;
+    if (count == 0) {
+      return first;
+    }
+    if (count == size_) {
+      clear();
+    } else if (begin == 0) {
+      // Only drop the chunks which become empty.
+      head_ += count;
+      size_ -= count;
+      const size_t numEmptyChunks = head_ / ChunkSize;
+      if (numEmptyChunks > 0) {
+        makeUniqueTable();
+        table_->erase(table_->begin(), table_->begin() + numEmptyChunks);
+        head_ -= numEmptyChunks * ChunkSize;
+      }
+    } else {
+      for (size_t i = begin; i + count < size_; ++i) {
+        (*this)[i] = static_cast<const ChunkedVector&>(*this)[i + count];
+      }
+      resize(size_ - count);
+    }
+    return const_iterator(this, begin);
+  }
+
+  const_iterator erase(const_iterator position) {
+    return erase(position, position + 1);
+  }
+
+  /// \brief Copy all shared chunks, after which distinct elements can be written from
+  ///        different threads.
+  void makeUnique() {
+    if (!table_) {
+      return;
+    }
+    for (size_t i = 0; i < table_->size(); ++i) {
+      getUniqueChunk(i);
+    }
+  }
+
+  /// True if the chunk of element i is shared with a copy of the array.
+  bool isShared(size_t i) const {
+    return (*table_)[(head_ + i) / ChunkSize].use_count() > 1 || table_.use_count() > 1;
+  }
+
+ private:
+  typedef std::vector<T, Eigen::aligned_allocator<T> > Chunk;
+  typedef std::vector<std::shared_ptr<Chunk> > Table;
+
+  void checkRange(size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range("ChunkedVector index out of range");
+    }
+  }
+
+  /// Whether this array holds the only reference to pointer, after which it can be written.
+  /// The reference counts of shared tables and chunks only change concurrently by copies
+  /// being destroyed, so a count of 1 is never stale. use_count() is a relaxed load, the
+  /// fence orders it after the release in the destructor of the last other reference.
+  template <class Pointee>
+  static bool isUnique(const std::shared_ptr<Pointee>& pointer) {
+    if (pointer.use_count() > 1) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+  }
+
+  /// Copy the table if it is shared.
+  void makeUniqueTable() {
+    if (!table_) {
+      table_ = std::make_shared<Table>();
+    } else if (!isUnique(table_)) {
+      table_ = std::make_shared<Table>(*table_);
+    }
+  }
+
+  Chunk& getUniqueChunk(size_t chunkIndex) {
+    makeUniqueTable();
+    std::shared_ptr<Chunk>& chunk = (*table_)[chunkIndex];
+    if (!isUnique(chunk)) {
+      std::shared_ptr<Chunk> copy = std::make_shared<Chunk>();
+      copy->reserve(ChunkSize);
+      copy->insert(copy->end(), chunk->begin(), chunk->end());
+      chunk = copy;
+    }
+    return *chunk;
+  }
+
+  /// Chunks of the elements. The first element is at head_ in the first chunk.
+  std::shared_ptr<Table> table_;
+
+  /// Number of erased elements at the front of the first chunk.
+  size_t head_;
+
+  size_t size_;
+};
+
+} // namespace curves
@@ -0,0 +1,313 @@
+/*
+ * ClosestTimeIndex.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// Position of a vector space value.
+template <class Derived>
+Eigen::Vector3d getPositionVector(const Eigen::MatrixBase<Derived>& value) {
+  return value;
+}
+
+/// Position of a pose, e.g. the value of an SE3 curve.
+template <class Pose>
+auto getPositionVector(const Pose& pose) -> decltype(Eigen::Vector3d(pose.getPosition().vector())) {
+  return pose.getPosition().vector();
+}
+
+/// Velocity of a position derivative.
+template <class Derived>
+Eigen::Vector3d getLinearVelocity(const Eigen::MatrixBase<Derived>& velocity) {
+  return velocity;
+}
+
+/// Linear velocity of a twist, e.g. the derivative of an SE3 curve.
+template <class Twist>
+auto getLinearVelocity(const Twist& twist) -> decltype(Eigen::Vector3d(twist.getTranslationalVelocity().vector())) {
+  return twist.getTranslationalVelocity().vector();
+}
+
+/// \brief Bounding volume hierarchy over the position of a curve to find the time at which
+///        the curve is closest to a point.
+///
+/// The segments between the knots are split into intervals. The box of an interval holds
+/// the Bezier control points of the cubic Hermite interpolation of its end points, which
+/// bounds cubic segments exactly. For higher orders, the box is enlarged by the deviation
+/// of the curve from that cubic at the center of the interval. The boxes are the leaves of
+/// a balanced binary tree over the intervals in time order.
+///
+/// A query descends the tree nearest box first and refines the time within an interval
+/// with Gauss-Newton steps, starting from the projection onto the chord of the interval.
+/// Boxes further away than the closest point so far are skipped, so a query only refines
+/// the few intervals near the point. Warm-starting from the previous answer gives a close
+/// bound before the descent, which suits tracking a reference along the curve.
+///
+/// The index refers to the curve and has to be built again when the curve is changed.
+/// CurveType has to provide evaluate() and a first order evaluateDerivative() whose
+/// results are accepted by getPositionVector and getLinearVelocity, like CubicHermiteE3Curve,
+/// CubicHermiteSE3Curve and PolynomialSplineQuinticVector3Curve.
+template <class CurveType>
+class ClosestTimeIndex {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  ClosestTimeIndex() : curve_(NULL) {}
+
+  /// \brief Build the index over the knot times of the curve, splitting every segment into
+  ///        intervalsPerSegment intervals. Returns false if the curve cannot be evaluated.
+  bool build(const CurveType& curve, const std::vector<Time>& knotTimes, unsigned int intervalsPerSegment = 4) {
+    CHECK_GT(intervalsPerSegment, 0u);
+    clear();
+    if (knotTimes.size() < 2) {
+      return false;
+    }
+    curve_ = &curve;
+    const size_t numIntervals = (knotTimes.size() - 1) * intervalsPerSegment;
+    times_.reserve(numIntervals + 1);
+    times_.push_back(knotTimes.front());
+    for (size_t k = 0; k + 1 < knotTimes.size(); ++k) {
+      CHECK_LT(knotTimes[k], knotTimes[k + 1]) << "Knot times have to be strictly increasing.";
+      const Time dt = (knotTimes[k + 1] - knotTimes[k]) / intervalsPerSegment;
+      for (unsigned int j = 1; j <= intervalsPerSegment; ++j) {
+        times_.push_back(j == intervalsPerSegment ? knotTimes[k + 1] : knotTimes[k] + j * dt);
+      }
+    }
+    positions_.resize(times_.size());
+    std::vector<Eigen::Vector3d> velocities(times_.size());
+    for (size_t i = 0; i < times_.size(); ++i) {
+      if (!evaluate(times_[i], &positions_[i], &velocities[i])) {
+        clear();
+        return false;
+      }
+    }
+
+    std::vector<Box> boxes(numIntervals);
+    for (size_t i = 0; i < numIntervals; ++i) {
+      const double third = (times_[i + 1] - times_[i]) / 3.0;
+      Box& box = boxes[i];
+      box.extend(positions_[i]);
+      box.extend(positions_[i + 1]);
+      box.extend(Eigen::Vector3d(positions_[i] + third * velocities[i]));
+      box.extend(Eigen::Vector3d(positions_[i + 1] - third * velocities[i + 1]));
+      ValueType value;
+      if (!curve.evaluate(value, 0.5 * (times_[i] + times_[i + 1]))) {
+        clear();
+        return false;
+      }
+      const Eigen::Vector3d cubicCenter = 0.5 * (positions_[i] + positions_[i + 1])
+          + 0.375 * third * (velocities[i] - velocities[i + 1]);
+      const double margin = (getPositionVector(value) - cubicCenter).norm();
+      box.min().array() -= margin;
+      box.max().array() += margin;
+    }
+    nodes_.reserve(2 * numIntervals);
+    buildNode(boxes, 0, numIntervals);
+    return true;
+  }
+
+  /// \brief Build the index over the knot times returned by curve.getCurveTimes().
+  bool build(const CurveType& curve, unsigned int intervalsPerSegment = 4) {
+    std::vector<Time> knotTimes;
+    curve.getCurveTimes(&knotTimes);
+    return build(curve, knotTimes, intervalsPerSegment);
+  }
+
+  void clear() {
+    curve_ = NULL;
+    times_.clear();
+    positions_.clear();
+    nodes_.clear();
+  }
+
+  bool isEmpty() const { return times_.empty(); }
+
+  /// \brief Find the time at which the curve is closest to position.
+  ///        The distance is optional. Returns false if the index is empty or the
+  ///        curve cannot be evaluated.
+  bool findClosestTime(const Eigen::Vector3d& position, Time* time, double* distance = NULL) const {
+    CHECK_NOTNULL(time);
+    if (isEmpty()) {
+      return false;
+    }
+    Result result;
+    if (!search(position, &result)) {
+      return false;
+    }
+    return getResult(result, time, distance);
+  }
+
+  /// \brief Find the time at which the curve is closest to position, starting from the
+  ///        interval at hintTime, usually the previous answer.
+  bool findClosestTime(const Eigen::Vector3d& position, Time hintTime, Time* time,
+                       double* distance = NULL) const {
+    CHECK_NOTNULL(time);
+    if (isEmpty()) {
+      return false;
+    }
+    Result result;
+    if (!refine(position, getInterval(hintTime), &result) || !search(position, &result)) {
+      return false;
+    }
+    return getResult(result, time, distance);
+  }
+
+  /// Times at the boundaries of the intervals.
+  const std::vector<Time>& getTimes() const { return times_; }
+
+ private:
+  typedef Eigen::AlignedBox3d Box;
+
+  struct Node {
+    Box box;
+    /// The intervals [begin, end) below the node.
+    size_t begin;
+    size_t end;
+    /// Index of the children, 0 for leaves.
+    size_t left;
+    size_t right;
+  };
+
+  struct Result {
+    Result() : time(0.0), squaredDistance(std::numeric_limits<double>::infinity()) {}
+    Time time;
+    double squaredDistance;
+  };
+
+  /// Maximal number of Gauss-Newton steps within an interval.
+  static const unsigned int kMaxIterations = 10;
+
+  size_t buildNode(const std::vector<Box>& boxes, size_t begin, size_t end) {
+    const size_t index = nodes_.size();
+    nodes_.push_back(Node());
+    nodes_[index].begin = begin;
+    nodes_[index].end = end;
+    if (end - begin == 1) {
+      nodes_[index].box = boxes[begin];
+      nodes_[index].left = nodes_[index].right = 0;
+      return index;
+    }
+    const size_t middle = begin + (end - begin) / 2;
+    const size_t left = buildNode(boxes, begin, middle);
+    const size_t right = buildNode(boxes, middle, end);
+    nodes_[index].left = left;
+    nodes_[index].right = right;
+    nodes_[index].box = nodes_[left].box.merged(nodes_[right].box);
+    return index;
+  }
+
+  bool evaluate(Time time, Eigen::Vector3d* position, Eigen::Vector3d* velocity) const {
+    ValueType value;
+    DerivativeType derivative;
+    if (!curve_->evaluate(value, time) || !curve_->evaluateDerivative(derivative, time, 1)) {
+      return false;
+    }
+    *position = getPositionVector(value);
+    *velocity = getLinearVelocity(derivative);
+    return true;
+  }
+
+  size_t getInterval(Time time) const {
+    const size_t i = std::upper_bound(times_.begin(), times_.end(), time) - times_.begin();
+    return std::min(i == 0 ? 0 : i - 1, times_.size() - 2);
+  }
+
+  /// Descend the tree and refine the intervals which may be closer than result.
+  bool search(const Eigen::Vector3d& position, Result* result) const {
+    std::vector<size_t> stack(1, 0);
+    while (!stack.empty()) {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      if (node.box.squaredExteriorDistance(position) >= result->squaredDistance) {
+        continue;
+      }
+      if (node.left == 0) {
+        if (!refine(position, node.begin, result)) {
+          return false;
+        }
+        continue;
+      }
+      // Visit the nearer child first, so it tightens the bound for the other one.
+      const bool leftFirst = nodes_[node.left].box.squaredExteriorDistance(position)
+          <= nodes_[node.right].box.squaredExteriorDistance(position);
+      stack.push_back(leftFirst ? node.right : node.left);
+      stack.push_back(leftFirst ? node.left : node.right);
+    }
+    return true;
+  }
+
+  /// Closest point within interval i with Gauss-Newton steps, kept if closer than result.
+  bool refine(const Eigen::Vector3d& position, size_t i, Result* result) const {
+    const Time startTime = times_[i];
+    const Time endTime = times_[i + 1];
+    for (size_t j = i; j <= i + 1; ++j) {
+      update(times_[j], (positions_[j] - position).squaredNorm(), result);
+    }
+    const Eigen::Vector3d chord = positions_[i + 1] - positions_[i];
+    const double chordLength2 = chord.squaredNorm();
+    const double u = chordLength2 > 0.0 ?
+        std::max(0.0, std::min(1.0, (position - positions_[i]).dot(chord) / chordLength2)) : 0.5;
+    Time time = startTime + u * (endTime - startTime);
+    const Time tolerance = 1e-12 * (endTime - startTime);
+    Eigen::Vector3d point, velocity;
+    for (unsigned int k = 0; k < kMaxIterations; ++k) {
+      if (!evaluate(time, &point, &velocity)) {
+        return false;
+      }
+      const Eigen::Vector3d difference = point - position;
+      update(time, difference.squaredNorm(), result);
+      const double speed2 = velocity.squaredNorm();
+      if (!(speed2 > 0.0)) {
+        break;
+      }
+      const Time nextTime = std::max(startTime, std::min(endTime, time - difference.dot(velocity) / speed2));
+      if (std::abs(nextTime - time) <= tolerance) {
+        break;
+      }
+      time = nextTime;
+    }
+    return true;
+  }
+
+  static void update(Time time, double squaredDistance, Result* result) {
+    if (squaredDistance < result->squaredDistance) {
+      result->time = time;
+      result->squaredDistance = squaredDistance;
+    }
+  }
+
+  static bool getResult(const Result& result, Time* time, double* distance) {
+    *time = result.time;
+    if (distance != NULL) {
+      *distance = std::sqrt(result.squaredDistance);
+    }
+    return true;
+  }
+
+  const CurveType* curve_;
+
+  /// Interval boundaries and the position there.
+  std::vector<Time> times_;
+  std::vector<Eigen::Vector3d> positions_;
+
+  /// The tree, the root first.
+  std::vector<Node> nodes_;
+};
+
+} // namespace curves
@@ -0,0 +1,134 @@
+/*
+ * CoefficientJacobians.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <Eigen/StdVector>
+#include <glog/logging.h>
+#include <cstddef>
+#include <vector>
+
+#include "curves/Curve.hpp"
+#include "curves/DenseKeyIndex.hpp"
+
+namespace curves {
+
+/// \brief Values of a curve at many times and their Jacobians with respect to the two
+///        coefficients of local support, as a block sparse structure keyed by Key.
+///
+/// Row i holds the value at time i and the Jacobian blocks with respect to the coefficients
+/// at the start and at the end of its segment. The distinct keys are listed in the order
+/// they appear, which is the order of the coefficients for sorted times, so every key owns
+/// a block column for assembling a factor graph or a normal equation. Keys are mapped to
+/// their block column with a DenseKeyIndex.
+///
+/// The storage is kept between evaluations, so filling the structure again for the same
+/// number of times does not allocate.
+template <int ValueDimension, int CoefficientDimension>
+class CoefficientJacobians {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef Eigen::Matrix<double, ValueDimension, 1> Value;
+  typedef Eigen::Matrix<double, ValueDimension, CoefficientDimension> JacobianBlock;
+
+  CoefficientJacobians() {}
+
+  /// Set the number of times, keeping the allocated storage, and forget the keys.
+  void resize(size_t numTimes) {
+    values_.resize(numTimes);
+    blocks_.resize(2 * numTimes);
+    blockColumns_.resize(2 * numTimes);
+    keys_.clear();
+    keyColumns_.clear();
+  }
+
+  /// Number of times.
+  size_t size() const {
+    return values_.size();
+  }
+
+  Value& getValue(size_t i) {
+    return values_[i];
+  }
+
+  const Value& getValue(size_t i) const {
+    return values_[i];
+  }
+
+  /// Jacobian of value i with respect to coefficient 0 (segment start) or 1 (segment end).
+  JacobianBlock& getJacobian(size_t i, unsigned int coefficient) {
+    return blocks_[2 * i + coefficient];
+  }
+
+  const JacobianBlock& getJacobian(size_t i, unsigned int coefficient) const {
+    return blocks_[2 * i + coefficient];
+  }
+
+  /// Key of coefficient 0 (segment start) or 1 (segment end) of value i.
+  Key getKey(size_t i, unsigned int coefficient) const {
+    return keys_[blockColumns_[2 * i + coefficient]];
+  }
+
+  /// Block column of coefficient 0 or 1 of value i, the index of its key in getKeys().
+  size_t getBlockColumn(size_t i, unsigned int coefficient) const {
+    return blockColumns_[2 * i + coefficient];
+  }
+
+  /// Set the keys of value i, adding them to the keys if they are new.
+  void setKeys(size_t i, Key key0, Key key1) {
+    blockColumns_[2 * i] = addKey(key0);
+    blockColumns_[2 * i + 1] = addKey(key1);
+  }
+
+  /// The distinct keys of all values, in the order of their block columns.
+  const std::vector<Key>& getKeys() const {
+    return keys_;
+  }
+
+  /// Assemble the Jacobian of all values with respect to the coefficients of getKeys().
+  void getSparseJacobian(Eigen::SparseMatrix<double>* jacobian) const {
+    CHECK_NOTNULL(jacobian);
+    jacobian->resize(ValueDimension * size(), CoefficientDimension * keys_.size());
+    std::vector<Eigen::Triplet<double> > triplets;
+    triplets.reserve(2 * ValueDimension * CoefficientDimension * size());
+    for (size_t i = 0; i < size(); ++i) {
+      for (unsigned int c = 0; c < 2; ++c) {
+        const JacobianBlock& block = getJacobian(i, c);
+        const size_t column = CoefficientDimension * getBlockColumn(i, c);
+        for (int r = 0; r < ValueDimension; ++r) {
+          for (int k = 0; k < CoefficientDimension; ++k) {
+            triplets.push_back(Eigen::Triplet<double>(ValueDimension * i + r, column + k, block(r, k)));
+          }
+        }
+      }
+    }
+    // Blocks of both coefficients of a segment with the same key are summed.
+    jacobian->setFromTriplets(triplets.begin(), triplets.end());
+  }
+
+ private:
+  /// The block column of key, which is added if it is new.
+  size_t addKey(Key key) {
+    const size_t* column = keyColumns_.find(key);
+    if (column != NULL) {
+      return *column;
+    }
+    keys_.push_back(key);
+    keyColumns_.set(key, keys_.size() - 1);
+    return keys_.size() - 1;
+  }
+
+  std::vector<Value, Eigen::aligned_allocator<Value> > values_;
+  std::vector<JacobianBlock, Eigen::aligned_allocator<JacobianBlock> > blocks_;
+  std::vector<size_t> blockColumns_;
+  std::vector<Key> keys_;
+  DenseKeyIndex<size_t> keyColumns_;
+};
+
+} // namespace curves
@@ -0,0 +1,152 @@
+/*
+ * ConcurrentCurve.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/Curve.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace curves {
+
+/// \brief A curve which one thread modifies while others evaluate it.
+///
+/// The curve is published as an immutable snapshot (read-copy-update). Readers take a
+/// snapshot and evaluate it without waiting for the writer, a snapshot stays valid and
+/// unchanged for as long as it is held. Writers modify a private copy of the current
+/// curve and publish it when they are done, so every modification copies the curve once.
+/// Curves with copy-on-write storage (CubicHermiteSE3Curve, the polynomial spline curves)
+/// only copy the chunks a modification touches. Other curves are meant to be of bounded
+/// size, e.g. with a sliding window (setWindow), and batches of knots should be added with
+/// one extend call.
+///
+/// Writers are serialized among themselves, readers never wait on them beyond the atomic
+/// exchange of the snapshot pointer.
+template <class CurveType>
+class ConcurrentCurve {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+  typedef std::shared_ptr<const CurveType> Snapshot;
+
+  ConcurrentCurve() :
+      snapshot_(std::make_shared<CurveType>()) {
+  }
+
+  explicit ConcurrentCurve(const CurveType& curve) :
+      snapshot_(std::make_shared<CurveType>(curve)) {
+  }
+
+  /// \brief The current state of the curve. Does not block.
+  Snapshot getSnapshot() const {
+    return std::atomic_load(&snapshot_);
+  }
+
+  /// \brief Replace the curve by a copy modified by function(CurveType&).
+  ///
+  /// Readers see either the old or the new curve, never an intermediate state.
+  template <class Function>
+  void update(const Function& function) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::shared_ptr<CurveType> curve = std::make_shared<CurveType>(*std::atomic_load(&snapshot_));
+    function(*curve);
+    std::atomic_store(&snapshot_, Snapshot(std::move(curve)));
+  }
+
+  /// \brief Replace the curve. Does not copy the current one.
+  void reset(const CurveType& curve) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    std::atomic_store(&snapshot_, Snapshot(std::make_shared<CurveType>(curve)));
+  }
+
+  /// \brief Extend the curve, see Curve::extend.
+  void extend(const std::vector<Time>& times, const std::vector<ValueType>& values,
+              std::vector<Key>* outKeys = NULL) {
+    update([&](CurveType& curve) { curve.extend(times, values, outKeys); });
+  }
+
+  /// \brief Fit a new curve, see Curve::fitCurve. Settings of the curve such as its window are kept.
+  void fitCurve(const std::vector<Time>& times, const std::vector<ValueType>& values,
+                std::vector<Key>* outKeys = NULL) {
+    update([&](CurveType& curve) { curve.fitCurve(times, values, outKeys); });
+  }
+
+  /// \brief Evaluate the current snapshot. Use getSnapshot for consistent series of queries.
+  bool evaluate(ValueType& value, Time time) const {
+    return getSnapshot()->evaluate(value, time);
+  }
+
+  /// \brief Evaluate the derivative of the current snapshot.
+  bool evaluateDerivative(DerivativeType& value, Time time, unsigned int derivativeOrder) const {
+    return getSnapshot()->evaluateDerivative(value, time, derivativeOrder);
+  }
+
+  Time getMinTime() const {
+    return getSnapshot()->getMinTime();
+  }
+
+  Time getMaxTime() const {
+    return getSnapshot()->getMaxTime();
+  }
+
+  /// \brief Evaluates the curve at increasing times while other threads modify it.
+  ///
+  /// Like CurveCursor, but the remembered segment belongs to a snapshot held by the
+  /// cursor, which a concurrent writer can not change or free. Every query takes the
+  /// current snapshot; when it was replaced, the cursor drops the old one and searches
+  /// again. Every thread uses its own cursor. CurveType has to support cursors, see
+  /// CurveCursor.
+  class Cursor {
+   public:
+    explicit Cursor(const ConcurrentCurve& curve) : curve_(curve) {}
+
+    /// Evaluate the ambient space of the current snapshot.
+    bool evaluate(ValueType& value, Time time) {
+      return getCurrentSnapshot().evaluate(value, time, &cursor_);
+    }
+
+    /// Evaluate the derivatives of the current snapshot.
+    bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder) {
+      return getCurrentSnapshot().evaluateDerivative(derivative, time, derivativeOrder, &cursor_);
+    }
+
+    /// Forget the remembered segment and release the snapshot.
+    void reset() {
+      cursor_.reset();
+      snapshot_.reset();
+    }
+
+    /// The snapshot of the last query, empty before the first one.
+    const Snapshot& getSnapshot() const {
+      return snapshot_;
+    }
+
+   private:
+    const CurveType& getCurrentSnapshot() {
+      Snapshot snapshot = curve_.getSnapshot();
+      // The held snapshot is not freed, so a new one can not reuse its address.
+      if (snapshot != snapshot_) {
+        snapshot_ = std::move(snapshot);
+        cursor_.reset();
+      }
+      return *snapshot_;
+    }
+
+    const ConcurrentCurve& curve_;
+    Snapshot snapshot_;
+    typename CurveType::CoefficientCursor cursor_;
+  };
+
+ private:
+  ConcurrentCurve(const ConcurrentCurve&);
+  ConcurrentCurve& operator=(const ConcurrentCurve&);
+
+  Snapshot snapshot_;
+  std::mutex writerMutex_;
+};
+
+} // namespace curves
@@ -10,6 +10,7 @@
 
 #include <kindr/Core>
 
+#include "curves/CoefficientJacobians.hpp"
 #include "curves/LocalSupport2CoefficientManager.hpp"
 #include "curves/SE3Curve.hpp"
 
@@ -61,9 +62,12 @@ namespace curves {
 // p(t) = p0 * b0 + p1 * b1 + p2 * b2 + p3 + b3
 
 class CubicHermiteE3Curve  {
+  template <int, unsigned int>
+  friend class CurveBatch;
  public:
   typedef HermiteE3Knot Coefficient;
   typedef LocalSupport2CoefficientManager<Coefficient>::CoefficientIter CoefficientIter;
+  typedef LocalSupport2CoefficientManager<Coefficient>::Cursor CoefficientCursor;
   typedef HermiteE3Knot::Position ValueType;
   typedef HermiteE3Knot::Velocity DerivativeType;
   typedef HermiteE3Knot::Acceleration Acceleration;
@@ -87,6 +91,9 @@ class CubicHermiteE3Curve  {
   // return number of coefficients curve is composed of
   int size() const;
 
+  /// The times of the coefficients.
+  void getCurveTimes(std::vector<Time>* outTimes) const;
+
   /// \brief calculate the slope between 2 coefficients
   DerivativeType calculateSlope(const Time& timeA,
                                 const Time& timeB,
@@ -110,8 +117,8 @@ class CubicHermiteE3Curve  {
 
   virtual void fitCurveWithDerivatives(const std::vector<Time>& times,
                         const std::vector<ValueType>& values,
-                        const DerivativeType& initialDerivative = DerivativeType(),
-                        const DerivativeType& finalDerivative = DerivativeType(),
+                        const DerivativeType& initialDerivative = DerivativeType::Zero(),
+                        const DerivativeType& finalDerivative = DerivativeType::Zero(),
                         std::vector<Key>* outKeys = NULL);
 
 
@@ -122,16 +129,53 @@ class CubicHermiteE3Curve  {
   /// Evaluate the ambient space of the curve.
   virtual bool evaluate(ValueType& value, Time time) const;
 
+  /// Evaluate the curve, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const;
+
   /// Evaluate the curve derivatives.
   virtual bool evaluateDerivative(DerivativeType& derivative, Time time,
                                   unsigned int derivativeOrder) const;
 
+  /// Evaluate the curve derivatives, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder,
+                          CoefficientCursor* cursor) const;
+
   bool evaluateLinearAcceleration(Acceleration& linearAcceleration, Time time) const;
 
+  /// Evaluate the curve at multiple times.
+  /// The times of one segment are evaluated together as the matrix product of their
+  /// powers [1 alpha alpha^2 alpha^3] with the Hermite basis matrix and the knots of the
+  /// segment, which is computed once per segment. Sorted times walk the segments linearly.
+  /// Returns false if any time is out of range, its value is set to zero.
+  bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+  /// Evaluate the first or second derivative at multiple times, see evaluate above.
+  bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                          unsigned int derivativeOrder) const;
+
+  /// Jacobians of the values at multiple times with respect to the knots, stacked as
+  /// (position, velocity).
+  typedef CoefficientJacobians<3, 6> KnotJacobians;
+
+  /// Evaluate the derivative of order derivativeOrder (0 for the value) at multiple times
+  /// together with its Jacobians with respect to the two knots of its segment. The curve is
+  /// linear in the knots, so the Jacobian blocks are the Hermite weights of evaluate above
+  /// times the identity. Sorted times walk the segments linearly, and the storage of the
+  /// jacobians is reused. Returns false if the curve is empty or any time is out of
+  /// range, its value and Jacobians are then zero and its keys those of the closest knot.
+  bool evaluateWithJacobians(const std::vector<Time>& times, KnotJacobians* jacobians,
+                             unsigned int derivativeOrder = 0) const;
+
   // clear the curve
   virtual void clear();
 
  private:
+  /// Evaluate the derivative of order derivativeOrder (0 for the value) at multiple times.
+  bool evaluateAtTimes(const std::vector<Time>& times, unsigned int derivativeOrder,
+                       std::vector<Eigen::Vector3d>* values) const;
+
   LocalSupport2CoefficientManager<Coefficient> manager_;
 };
 
@@ -0,0 +1,277 @@
+/*
+ * CubicHermiteSE2Curve.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <glog/logging.h>
+
+#include "curves/EvaluationError.hpp"
+#include "curves/Instrumentation.hpp"
+#include "curves/LocalSupport2CoefficientManager.hpp"
+#include "curves/SamplingPolicy.hpp"
+#include "curves/SE2Curve.hpp"
+#include "curves/SortedArrayCoefficientStorage.hpp"
+
+namespace curves {
+
+/// Hermite coefficient of a planar pose packed into 6 doubles without padding: the position,
+/// the heading angle and the derivative (vx, vy, omega) in the reference frame.
+struct HermiteSE2Transformation {
+  typedef SE2Transformation Transform;
+  typedef Vector3d Derivative;
+  static const size_t kSize = 6;
+
+  HermiteSE2Transformation() : derivative_(Derivative::Zero()) {}
+
+  HermiteSE2Transformation(const Transform& transform, const Derivative& derivative)
+      : transformation_(transform), derivative_(derivative) {}
+
+  const Transform& getTransformation() const {
+    return transformation_;
+  }
+
+  Derivative getTransformationDerivative() const {
+    return derivative_;
+  }
+
+  void setTransformation(const Transform& transformation) {
+    transformation_ = transformation;
+  }
+
+  void setTransformationDerivative(const Derivative& derivative) {
+    derivative_ = derivative;
+  }
+
+ private:
+  Transform transformation_;
+  Eigen::Matrix<double, 3, 1, Eigen::DontAlign> derivative_;
+};
+
+static_assert(sizeof(HermiteSE2Transformation) == HermiteSE2Transformation::kSize * sizeof(double),
+              "Hermite SE2 coefficients are expected to be packed.");
+
+/// Implements a cubic Hermite curve over SE2.
+///
+/// The position and the heading angle are interpolated with the cubic Hermite polynomials,
+/// the angle along the shortest rotation between the knots. As the rotation of the plane
+/// commutes, this is exact and cheaper than the interpolation on the manifold needed by
+/// CubicHermiteSE3Curve, and the derivatives of any order follow from the basis polynomials.
+class CubicHermiteSE2Curve : public SE2Curve {
+  friend class SamplingPolicy;
+ public:
+  typedef SE2Curve::ValueType ValueType;
+  typedef SE2Curve::DerivativeType DerivativeType;
+  typedef HermiteSE2Transformation Coefficient;
+  typedef LocalSupport2CoefficientManager<Coefficient, SortedArrayCoefficientStorage<Coefficient> > CoefficientManager;
+  typedef CoefficientManager::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
+  typedef CoefficientManager::CoefficientIter CoefficientIter;
+
+  CubicHermiteSE2Curve();
+  virtual ~CubicHermiteSE2Curve();
+
+  /// Print the value of the coefficient, for debugging and unit tests
+  virtual void print(const std::string& str = "") const;
+
+  /// The first valid time for the curve.
+  virtual Time getMinTime() const;
+
+  /// The one past the last valid time for the curve.
+  virtual Time getMaxTime() const;
+
+  bool isEmpty() const;
+
+  // return number of coefficients curve is composed of
+  int size() const;
+
+  /// \brief calculate the slope between 2 coefficients
+  DerivativeType calculateSlope(const Time& timeA,
+                                const Time& timeB,
+                                const ValueType& coeffA,
+                                const ValueType& coeffB) const;
+
+  /// Extend the curve so that it can be evaluated at these times.
+  /// Try to make the curve fit to the values.
+  /// Underneath the curve should have some default policy for fitting.
+  virtual void extend(const std::vector<Time>& times,
+                      const std::vector<ValueType>& values,
+                      std::vector<Key>* outKeys = NULL);
+
+  /// \brief Fit a new curve to these data points.
+  ///
+  /// The existing curve will be cleared. The slopes of the first and last knot are zero,
+  /// the others are the Catmull-Rom slopes between their neighbours.
+  virtual void fitCurve(const std::vector<Time>& times,
+                        const std::vector<ValueType>& values,
+                        std::vector<Key>* outKeys = NULL);
+
+  /// \brief Fit a new curve to these data points and boundary derivatives, see fitCurve.
+  void fitCurveWithDerivatives(const std::vector<Time>& times,
+                               const std::vector<ValueType>& values,
+                               const DerivativeType& initialDerivative = DerivativeType::Zero(),
+                               const DerivativeType& finalDerivative = DerivativeType::Zero(),
+                               std::vector<Key>* outKeys = NULL);
+
+  /// \brief Fit a new curve to these data points with the derivatives of all knots.
+  void fitCurveWithDerivatives(const std::vector<Time>& times,
+                               const std::vector<ValueType>& values,
+                               const std::vector<DerivativeType>& derivatives,
+                               std::vector<Key>* outKeys = NULL);
+
+  /// Evaluate the ambient space of the curve.
+  virtual bool evaluate(ValueType& value, Time time) const;
+
+  /// Evaluate the ambient space of the curve. Fails if the time is out of bounds.
+  ValueType evaluate(Time time) const;
+
+  /// Evaluate the curve derivatives (vx, vy, omega) in the reference frame.
+  virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const;
+
+  /// Evaluate the ambient space of the curve at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+  /// Evaluate the curve derivatives at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                                  unsigned derivativeOrder) const;
+
+  /// Number of failed evaluations of this curve, by error.
+  const EvaluationErrorCounters& getEvaluationErrorCounters() const {
+    return evaluationErrors_;
+  }
+
+  // set minimum sampling period
+  void setMinSamplingPeriod(Time time);
+
+  /// \brief Set the sampling ratio.
+  ///   eg. 4 will add a coefficient every 4 extend
+  void setSamplingRatio(const int ratio);
+
+  virtual void clear();
+
+  /// \brief Perform a rigid transformation on the left side of the curve
+  void transformCurve(const ValueType T);
+
+  void getCurveTimes(std::vector<Time>* outTimes) const;
+
+ private:
+  /// \brief Evaluate the Hermite polynomials of the segment between a and b, the value for
+  ///        derivativeOrder 0 as (x, y, unwrapped angle).
+  Vector3d interpolate(Time time, CoefficientIter a, CoefficientIter b, unsigned derivativeOrder) const;
+
+  CoefficientManager manager_;
+  SamplingPolicy hermitePolicy_;
+
+  /// Failed evaluations, counted from const evaluation methods.
+  mutable EvaluationErrorCounters evaluationErrors_;
+};
+
+// implements the special (extend) policies for Cubic Hermite SE2 curves, like those of
+// CubicHermiteSE3Curve: measurements which do not become a knot are written into an
+// interpolated knot at the end of the curve, which is moved in place.
+template <>
+inline Key SamplingPolicy::defaultExtend<CubicHermiteSE2Curve, SE2Transformation>(const Time& time,
+                  const SE2Transformation& value,
+                  CubicHermiteSE2Curve* curve) {
+  typedef CubicHermiteSE2Curve::Coefficient Coefficient;
+  typedef CubicHermiteSE2Curve::TimeToKeyCoefficientMap::iterator CoefficientIter;
+
+  CubicHermiteSE2Curve::DerivativeType derivative;
+  const bool hasInterpolatedKnot = measurementsSinceLastExtend_ > 0 && curve->manager_.size() > 1;
+  CoefficientIter end = curve->manager_.coefficientEnd();
+  if (hasInterpolatedKnot) {
+    --end;
+  }
+  const size_t numKnots = curve->manager_.size() - (hasInterpolatedKnot ? 1 : 0);
+
+  if (numKnots == 0) {
+    derivative.setZero();
+  } else if (numKnots == 1) {
+    CoefficientIter last = curve->manager_.coefficientBegin();
+    derivative = curve->calculateSlope(last->first, time, last->second.coefficient.getTransformation(), value);
+    curve->manager_.updateCoefficientByKey(last->second.key,
+                                           Coefficient(last->second.coefficient.getTransformation(), derivative));
+  } else {
+    CoefficientIter rVal1 = end;
+    --rVal1;
+    CoefficientIter rVal0 = rVal1;
+    --rVal0;
+    // the previous knot gets the Catmull-Rom slope, the new one the slope of the last segment
+    curve->manager_.updateCoefficientByKey(rVal1->second.key, Coefficient(
+        rVal1->second.coefficient.getTransformation(),
+        curve->calculateSlope(rVal0->first, time, rVal0->second.coefficient.getTransformation(), value)));
+    derivative = curve->calculateSlope(rVal1->first, time, rVal1->second.coefficient.getTransformation(), value);
+  }
+  measurementsSinceLastExtend_ = 0;
+  lastExtend_ = time;
+  if (hasInterpolatedKnot) {
+    // the interpolated coefficient becomes the new knot
+    const Key key = end->second.key;
+    curve->manager_.modifyCoefficient(end, time, Coefficient(value, derivative));
+    return key;
+  }
+  return curve->manager_.insertCoefficient(time, Coefficient(value, derivative));
+}
+
+template <>
+inline Key SamplingPolicy::interpolationExtend<CubicHermiteSE2Curve, SE2Transformation>(const Time& time,
+                        const SE2Transformation& value,
+                        CubicHermiteSE2Curve* curve) {
+  typedef CubicHermiteSE2Curve::Coefficient Coefficient;
+  typedef CubicHermiteSE2Curve::TimeToKeyCoefficientMap::iterator CoefficientIter;
+
+  CoefficientIter last = --curve->manager_.coefficientEnd();
+  if (measurementsSinceLastExtend_ == 0) {
+    // extend curve with new interpolation coefficient, with the velocities of the last coefficient
+    ++measurementsSinceLastExtend_;
+    return curve->manager_.insertCoefficient(time, Coefficient(value, last->second.coefficient.getTransformationDerivative()));
+  }
+  // assumes the interpolation coefficient is already set (at end of curve)
+  CoefficientIter rVal0 = last;
+  --rVal0;
+  ++measurementsSinceLastExtend_;
+  const Key key = last->second.key;
+  curve->manager_.modifyCoefficient(last, time, Coefficient(value, curve->calculateSlope(
+      rVal0->first, time, rVal0->second.coefficient.getTransformation(), value)));
+  return key;
+}
+
+template<>
+inline void SamplingPolicy::extend<CubicHermiteSE2Curve, SE2Transformation>(const std::vector<Time>& times,
+                                                                      const std::vector<SE2Transformation>& values,
+                                                                      CubicHermiteSE2Curve* curve,
+                                                                      std::vector<Key>* outKeys) {
+  for (size_t i = 0; i < times.size(); ++i) {
+    // ensure time strictly increases
+    CHECK((times[i] > curve->manager_.getMaxTime() && (i == 0 || times[i] > times[i - 1]))
+          || curve->manager_.size() == 0) << "curve can only be extended into the future. Requested = "
+        << times[i] << " < curve max time = " << curve->manager_.getMaxTime();
+    const bool isEmpty = curve->manager_.size() == 0;
+    const Key lastKey = isEmpty ? Key() : (--curve->manager_.coefficientEnd())->second.key;
+    Key key;
+    if (isEmpty) {
+      key = defaultExtend(times[i], values[i], curve);
+    } else if (measurementsSinceLastExtend_ >= minimumMeasurements_ &&
+        lastExtend_ + minSamplingPeriod_ < times[i]) {
+      key = defaultExtend(times[i], values[i], curve);
+    } else if (measurementsSinceLastExtend_ == 0 || i + 1 == times.size() ||
+        (measurementsSinceLastExtend_ + 1 >= minimumMeasurements_ &&
+         lastExtend_ + minSamplingPeriod_ < times[i + 1])) {
+      key = interpolationExtend(times[i], values[i], curve);
+    } else {
+      // superseded by the next measurement of the batch
+      ++measurementsSinceLastExtend_;
+      continue;
+    }
+    // like insertCoefficients, only return the keys of new coefficients, not of the moved
+    // interpolated one
+    if (outKeys != NULL && (isEmpty || key != lastKey)) {
+      outKeys->push_back(key);
+    }
+  }
+}
+
+} // namespace curves
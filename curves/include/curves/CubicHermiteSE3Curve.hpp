@@ -9,7 +9,14 @@
 #pragma once
 
 #include <kindr/Core>
-
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "curves/ChunkedVector.hpp"
+#include "curves/CurveFile.hpp"
+#include "curves/EvaluationError.hpp"
+#include "curves/Instrumentation.hpp"
 #include "curves/LocalSupport2CoefficientManager.hpp"
 #include "curves/SamplingPolicy.hpp"
 #include "curves/SE3CompositionCurve.hpp"
@@ -18,60 +25,133 @@
 // wrapper class for Hermite-style coefficients (made of QuatTransformation and Vector6)
 namespace kindr {
 
+/// Hermite coefficient packed into 13 doubles without padding: the position, the rotation
+/// quaternion as returned by RotationQuaternion::vector() and the twist (linear, angular).
+/// The kindr types are only created by the accessors, so the coefficient is a plain array
+/// for the coefficient storage and binary curve files.
 template <typename Scalar>
 struct HermiteTransformation {
   typedef kindr::HomTransformQuatD Transform;
   typedef kindr::TwistGlobalD Twist;
+  static const size_t kSize = 13;
 
  public:
   HermiteTransformation();
   HermiteTransformation(const Transform& transform, const Twist& derivatives);
-  virtual ~HermiteTransformation();
 
   Transform getTransformation() const {
-    return transformation_;
+    return Transform(typename Transform::Position(getPosition()), getRotation());
   }
 
   Twist getTransformationDerivative() const {
-    return transformationDerivative_;
+    return Twist(getLinearVelocity(), getAngularVelocity());
   }
 
   void setTransformation(const Transform& transformation) {
-    transformation_ = transformation;
+    Eigen::Map<Eigen::Vector3d> position(values_);
+    Eigen::Map<Eigen::Vector4d> rotation(values_ + 3);
+    position = transformation.getPosition().vector();
+    rotation = transformation.getRotation().vector();
   }
 
   void setTransformationDerivative(const Twist& transformationDerivative) {
-    transformationDerivative_ = transformationDerivative;
+    Eigen::Map<Eigen::Matrix<double, 6, 1> > twist(values_ + 7);
+    twist = transformationDerivative.getVector();
+  }
+
+  Eigen::Vector3d getPosition() const {
+    return Eigen::Map<const Eigen::Vector3d>(values_);
+  }
+
+  typename Transform::Rotation getRotation() const {
+    return typename Transform::Rotation(Eigen::Vector4d(Eigen::Map<const Eigen::Vector4d>(values_ + 3)));
+  }
+
+  Eigen::Vector3d getLinearVelocity() const {
+    return Eigen::Map<const Eigen::Vector3d>(values_ + 7);
+  }
+
+  Eigen::Vector3d getAngularVelocity() const {
+    return Eigen::Map<const Eigen::Vector3d>(values_ + 10);
+  }
+
+  /// The packed values, see above.
+  const double* data() const {
+    return values_;
+  }
+
+  double* data() {
+    return values_;
   }
 
  private:
-  Transform transformation_;
-  Twist transformationDerivative_;
+  double values_[kSize];
 };
 
 template <typename Scalar>
-HermiteTransformation<Scalar>::HermiteTransformation() {};
+HermiteTransformation<Scalar>::HermiteTransformation() {
+  setTransformation(Transform());
+  setTransformationDerivative(Twist());
+}
 
 template <typename Scalar>
 HermiteTransformation<Scalar>::HermiteTransformation(const Transform& transform,
-                                                     const Twist& derivatives) :
-                                                     transformation_(transform),
-                                                     transformationDerivative_(derivatives) {};
+                                                     const Twist& derivatives) {
+  setTransformation(transform);
+  setTransformationDerivative(derivatives);
+}
 
-template <typename Scalar>
-HermiteTransformation<Scalar>::~HermiteTransformation() {};
+static_assert(sizeof(HermiteTransformation<double>) == HermiteTransformation<double>::kSize * sizeof(double),
+              "Hermite coefficients are expected to be packed.");
 
 }
 
 namespace curves {
 
+/// Packs a pose as position followed by the quaternion (w, x, y, z).
+template <>
+struct CoefficientPacking<kindr::HomTransformQuatD> {
+  static const size_t kSize = 7;
+
+  static void pack(const kindr::HomTransformQuatD& transform, double* values) {
+    Eigen::Map<Eigen::Vector3d> position(values);
+    Eigen::Map<Eigen::Vector4d> rotation(values + 3);
+    position = transform.getPosition().vector();
+    rotation = transform.getRotation().vector();
+  }
+
+  static void unpack(const double* values, kindr::HomTransformQuatD* transform) {
+    transform->getPosition() = kindr::HomTransformQuatD::Position(Eigen::Vector3d(Eigen::Map<const Eigen::Vector3d>(values)));
+    transform->getRotation() = kindr::HomTransformQuatD::Rotation(Eigen::Vector4d(Eigen::Map<const Eigen::Vector4d>(values + 3)));
+  }
+};
+
+/// Packs a Hermite coefficient as the pose followed by the twist (linear, angular), which is
+/// its own layout.
+template <>
+struct CoefficientPacking<kindr::HermiteTransformation<double> > {
+  typedef kindr::HermiteTransformation<double> HermiteCoefficient;
+  static const size_t kSize = HermiteCoefficient::kSize;
+
+  static void pack(const HermiteCoefficient& coefficient, double* values) {
+    std::copy(coefficient.data(), coefficient.data() + kSize, values);
+  }
+
+  static void unpack(const double* values, HermiteCoefficient* coefficient) {
+    std::copy(values, values + kSize, coefficient->data());
+  }
+};
+
 typedef SE3Curve::ValueType ValueType;
 typedef SE3Curve::DerivativeType DerivativeType;
 typedef kindr::HermiteTransformation<double> Coefficient;
-typedef LocalSupport2CoefficientManager<Coefficient>::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
-typedef LocalSupport2CoefficientManager<Coefficient>::CoefficientIter CoefficientIter;
+typedef LocalSupport2CoefficientManager<Coefficient, CopyOnWriteCoefficientStorage<Coefficient> > CoefficientManager;
+typedef CoefficientManager::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
+typedef CoefficientManager::CoefficientIter CoefficientIter;
 
 /// Implements the Cubic Hermite curve class. See KimKimShin paper.
+/// The coefficients are kept in a CopyOnWriteCoefficientStorage, so copying the curve, e.g.
+/// as a snapshot for a planner, is O(1) and extending it afterwards only copies the last chunk.
 /// The Hermite interpolation function is defined, with the respective Jacobians regarding  A and B:
 //
 /// Translations:
@@ -101,6 +181,24 @@ class CubicHermiteSE3Curve : public SE3Curve {
   friend class SamplingPolicy;
  public:
   typedef kindr::HermiteTransformation<double> Coefficient;
+  typedef CoefficientManager::Cursor CoefficientCursor;
+
+  /// \brief Pose of frame B in frame A and its first two time derivatives, see evaluateState.
+  ///
+  /// The twists and accelerations have the linear part in (0,1,2) and the angular part in
+  /// (3,4,5). They are the velocities and accelerations of frame B as seen from frame A,
+  /// expressed in frame A and in frame B respectively.
+  struct State {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    ValueType pose;
+    /// The global velocities of evaluateDerivative.
+    Vector6d twistA;
+    Vector6d twistB;
+    Vector6d accelerationA;
+    Vector6d accelerationB;
+  };
+  typedef std::vector<State, Eigen::aligned_allocator<State> > StateVector;
 
   CubicHermiteSE3Curve();
   virtual ~CubicHermiteSE3Curve();
@@ -130,10 +228,25 @@ class CubicHermiteSE3Curve : public SE3Curve {
   /// Extend the curve so that it can be evaluated at these times.
   /// Try to make the curve fit to the values.
   /// Note: Assumes that extend times strictly increase the curve time
+  ///
+  /// The slopes are maintained incrementally, in O(1) per sample: a new knot gets the slope
+  /// of the segment before it and the previous knot its Catmull-Rom slope, the other knots
+  /// are not touched. Unless knots are simplified or dropped by the window, or an
+  /// interpolated knot of the sampling policy is pending, the curve equals
+  /// fitCurveWithDerivatives through its knots with the slopes of the first and last segment
+  /// as boundary derivatives, so it never needs a refit.
+  /// An enabled segment cache is only updated for the last segments.
   virtual void extend(const std::vector<Time>& times,
                       const std::vector<ValueType>& values,
                       std::vector<Key>* outKeys = NULL);
 
+  /// \brief Append one sample to a streamed curve in O(1), see extend above.
+  ///
+  /// The sample is written into the last coefficient of the curve, either a new knot or the
+  /// interpolated knot of the sampling policy, whose key is returned. The time must be after
+  /// getMaxTime().
+  Key extend(Time time, const ValueType& value);
+
   /// \brief Fit a new curve to these data points.
   ///
   /// The existing curve will be cleared.fitCurveWithDerivatives
@@ -148,6 +261,14 @@ class CubicHermiteSE3Curve : public SE3Curve {
                         const DerivativeType& finalDerivative = DerivativeType(),
                         std::vector<Key>* outKeys = NULL);
 
+  /// \brief Fit a new curve through the values with the given derivatives as knot tangents.
+  ///
+  /// No slopes are estimated, the derivatives are used like those of evaluateDerivative.
+  virtual void fitCurveWithDerivatives(const std::vector<Time>& times,
+                                       const std::vector<ValueType>& values,
+                                       const std::vector<DerivativeType>& derivatives,
+                                       std::vector<Key>* outKeys = NULL);
+
   virtual void fitPeriodicCurve(const std::vector<Time>& times,
                                 const std::vector<ValueType>& values,
                                 std::vector<Key>* outKeys = NULL);
@@ -159,6 +280,50 @@ class CubicHermiteSE3Curve : public SE3Curve {
   /// Evaluate the curve derivatives.
   virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder) const;
 
+  /// Evaluate the ambient space of the curve, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const;
+
+  /// Evaluate the curve derivatives, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder,
+                          CoefficientCursor* cursor) const;
+
+  /// Evaluate the ambient space of the curve without any output on failure.
+  /// Failures are counted, see getEvaluationErrorCounters(). The cursor may be NULL.
+  EvaluationError tryEvaluate(ValueType& value, Time time, CoefficientCursor* cursor = NULL) const;
+
+  /// Evaluate the curve derivatives without any output on failure.
+  /// Failures are counted, see getEvaluationErrorCounters(). The cursor may be NULL.
+  EvaluationError tryEvaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder,
+                                        CoefficientCursor* cursor = NULL) const;
+
+  /// Evaluate the pose, twist and acceleration at once, sharing the segment lookup and the
+  /// interpolation of the rotation. Failures are counted like those of tryEvaluate.
+  bool evaluateState(State& state, Time time, CoefficientCursor* cursor = NULL) const;
+
+  /// Evaluate the states at multiple times. Sorted times are evaluated walking the segments
+  /// linearly, see evaluate.
+  bool evaluateStates(const std::vector<Time>& times, StateVector* states) const;
+
+  /// Number of failed evaluations of this curve, by error.
+  const EvaluationErrorCounters& getEvaluationErrorCounters() const {
+    return evaluationErrors_;
+  }
+
+  void resetEvaluationErrorCounters() {
+    evaluationErrors_.reset();
+  }
+
+  /// Evaluate the ambient space of the curve at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+  /// Evaluate the curve derivatives at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                                  unsigned int derivativeOrder) const;
+
   virtual void setTimeRange(Time minTime, Time maxTime);
 
   bool evaluateLinearAcceleration(kindr::Acceleration3D& linearAcceleration, Time time);
@@ -207,6 +372,34 @@ class CubicHermiteSE3Curve : public SE3Curve {
   ///        and the angular velocity (3,4,5).
   virtual Vector6d evaluateDerivativeB(unsigned derivativeOrder, Time time);
 
+  /// \brief Precompute the parts of the interpolation which only depend on the segment.
+  ///
+  /// Evaluations then blend the cached segment data instead of recomputing the relative
+  /// rotation of the segment for every query. The cache is rebuilt when the curve is fitted,
+  /// updated for the last segments when it is extended and only used while the coefficients
+  /// are unchanged. Disabled by default.
+  void setSegmentCacheEnabled(bool enabled);
+
+  bool isSegmentCacheEnabled() const;
+
+  /// \brief Compute the Catmull-Rom slopes of fitCurve only when a segment next to the knot
+  ///        is first evaluated.
+  ///
+  /// fitCurve then only copies the poses, which pays off for long curves of which only a
+  /// few segments are evaluated. Computed slopes are memoized, also for concurrent
+  /// evaluations, and written into the coefficients before the curve is extended or saved.
+  /// Fits with a window (see setWindow) or with times that are not strictly increasing
+  /// compute all slopes up front. Disabled by default.
+  void setLazySlopesEnabled(bool enabled);
+
+  bool isLazySlopesEnabled() const;
+
+  /// \brief Number of threads used to fit the curve, 0 for all hardware threads. Defaults to 1.
+  ///
+  /// The slopes of the knots and the segment cache are computed in parallel, which pays
+  /// off for curves with many thousand knots.
+  void setNumberOfFitThreads(unsigned int numThreads);
+
   // set the minimum sampling period
   void setMinSamplingPeriod(Time time);
 
@@ -214,14 +407,50 @@ class CubicHermiteSE3Curve : public SE3Curve {
   ///   eg. 4 will add a coefficient every 4 extend
   void setSamplingRatio(const int ratio);
 
+  /// \brief Only keep the coefficients needed for the most recent part of the curve.
+  ///
+  /// See LocalSupport2CoefficientManager::setWindow. Old coefficients are dropped as the
+  /// curve is extended, so a curve that is extended forever uses bounded memory.
+  void setWindow(Time maxDuration, size_t maxCoefficients = 0);
+
   // clear the curve
   virtual void clear();
 
-  /// \brief Perform a rigid transformation on the left side of the curve
+  /// \brief Perform a rigid transformation on the left side of the curve, see below. Uses the
+  ///        number of fit threads.
   void transformCurve(const ValueType T);
 
+  /// \brief Perform a rigid transformation on the left side of the curve on up to numThreads
+  ///        threads, 0 for all hardware threads.
+  ///
+  /// The knots are transformed in place in the contiguous coefficient storage and their
+  /// global twists are rotated into the new frame. Keys and times are kept.
+  void transformCurve(const ValueType& T, unsigned int numThreads);
+
+  /// \brief Remove the knots which the segment between their neighbours reproduces within
+  ///        the tolerance, see selectKnots. Returns the number of removed knots.
+  ///
+  /// The slopes of the kept knots are not changed, so the curve stays C1 and a removed knot
+  /// only needs the Hermite segment spanning it to be checked.
+  size_t simplify(const KnotTolerance& tolerance);
+
+  /// \brief Remove knots while the curve is extended, see SamplingPolicy::setSimplificationTolerance.
+  ///
+  /// Every knot added by the default extend policy is checked once its slope is final, against
+  /// the segment between the knots around it, so extend stays constant time.
+  void setSimplificationTolerance(const KnotTolerance& tolerance);
+
   void saveCurveTimesAndValues(const std::string& filename) const;
 
+  /// \brief Save the coefficients to a binary curve file, see CurveFile.hpp.
+  bool saveCurveBinary(const std::string& filename) const;
+
+  /// \brief Replace the curve by the coefficients of a binary curve file.
+  bool loadCurveBinary(const std::string& filename);
+
+  /// \brief Replace the curve by the coefficients of a mapped binary curve file.
+  bool loadCurve(const MappedCurveFile& file);
+
   void saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const;
 
   void saveCorrectionCurveAtTimes(const std::string& filename, std::vector<Time> times) const {};
@@ -267,8 +496,107 @@ class CubicHermiteSE3Curve : public SE3Curve {
 
   void saveCorrectionCurveTimesAndValues(const std::string& filename) const {};
  private:
-  LocalSupport2CoefficientManager<Coefficient> manager_;
+  /// \brief The time independent parts of the interpolation between two coefficients.
+  struct Segment {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Eigen::Vector3d positionA;
+    Eigen::Vector3d positionB;
+    Eigen::Vector3d velocityA;
+    Eigen::Vector3d velocityB;
+    kindr::RotationQuaternionPD rotationA;
+    /// w_1, w_2 and w_3 of the rotation spline, see above.
+    Eigen::Vector3d w1;
+    Eigen::Vector3d w2;
+    Eigen::Vector3d w3;
+    /// Duration of the segment.
+    double dt;
+  };
+
+  /// \brief Compute the segment between the coefficients a and b.
+  Segment getSegment(CoefficientIter a, CoefficientIter b) const;
+
+  /// \brief The cached segment starting at coefficient a, NULL if the cache is not valid.
+  const Segment* getCachedSegment(CoefficientIter a) const;
+
+  /// \brief Rebuild the segment cache if it is enabled.
+  void updateSegmentCache();
+
+  /// \brief Update the segment cache after the curve was extended, given the number of
+  ///        cached segments which the extension does not change and the time of the knot
+  ///        ending them. Rebuilds the cache if knots before were dropped by the window.
+  void updateSegmentCacheTail(size_t numUnchanged, Time unchangedEndTime);
+
+  /// \brief Slopes of a lazy fit, see setLazySlopesEnabled. Copies of the curve share them,
+  ///        as they share the coefficient stamp until either of them is changed.
+  struct LazySlopes {
+    enum State : unsigned char { Missing, Computing, Ready };
+
+    /// Coefficient stamp of the manager after the fit.
+    size_t stamp;
+    /// Slope of knot i once states[i] is Ready.
+    std::vector<DerivativeType> slopes;
+    std::unique_ptr<std::atomic<unsigned char>[]> states;
+  };
+
+  /// \brief The slope of the knot at it, computed and memoized if the fit was lazy.
+  DerivativeType getSlope(CoefficientIter it) const;
+
+  /// \brief True if the fit was lazy and the coefficients do not hold all slopes yet.
+  bool hasLazySlopes() const;
+
+  /// \brief Write the slopes of a lazy fit into the coefficients of manager, a copy of manager_.
+  void writeLazySlopes(CoefficientManager* manager) const;
+
+  /// \brief Write the slopes of a lazy fit into the coefficients before they are modified.
+  void materializeLazySlopes();
+
+  /// \brief Interpolate the transformation between the coefficients a and b.
+  ValueType interpolate(Time time, CoefficientIter a, CoefficientIter b) const;
+
+  /// \brief Interpolate the transformation along a segment starting at timeA.
+  ValueType interpolate(Time time, Time timeA, const Segment& segment) const;
+
+  /// \brief Interpolate the global velocities between the coefficients a and b.
+  DerivativeType interpolateDerivative(Time time, CoefficientIter a, CoefficientIter b) const;
+
+  /// \brief Interpolate the global velocities along a segment starting at timeA.
+  DerivativeType interpolateDerivative(Time time, Time timeA, const Segment& segment) const;
+
+  /// \brief Interpolate the state along a segment starting at timeA.
+  void interpolateState(Time time, Time timeA, const Segment& segment, State* state) const;
+
+  /// \brief The state of the curve if it is only defined at time, see evaluate.
+  void getSingleKnotState(State* state) const;
+
+  /// \brief Remove the third last knot if the segment between its neighbours reproduces it
+  ///        and the knots removed before, see defaultExtend.
+  void simplifyEnd(const KnotTolerance& tolerance);
+
+  CoefficientManager manager_;
   SamplingPolicy hermitePolicy_;
+
+  bool segmentCacheEnabled_;
+
+  bool lazySlopesEnabled_;
+
+  /// Slopes of the last fit if it was lazy.
+  std::shared_ptr<LazySlopes> lazySlopes_;
+
+  unsigned int numFitThreads_;
+
+  /// Segment i starts at coefficient i. Shared with copies of the curve, see ChunkedVector.
+  ChunkedVector<Segment> segments_;
+
+  /// Coefficient stamp of the manager when the segments were computed.
+  size_t segmentsStamp_;
+
+  /// Knots removed by simplifyEnd since the last kept one.
+  std::vector<Time> removedTimes_;
+  std::vector<ValueType, Eigen::aligned_allocator<ValueType> > removedValues_;
+
+  /// Failed evaluations, counted from const evaluation methods.
+  mutable EvaluationErrorCounters evaluationErrors_;
 };
 
 typedef kindr::HomogeneousTransformationPosition3RotationQuaternionD SE3;
@@ -287,19 +615,33 @@ SE3 inverseTransformation(SE3 T);
 SE3 invertAndComposeImplementation(SE3 A, SE3 B);
 
 // implements the special (extend) policies for Cubic Hermite curves
+//
+// Measurements which do not become a knot are written into an interpolated knot at the end
+// of the curve, which exists while measurementsSinceLastExtend_ > 0. It is moved in place to
+// every new measurement and becomes the next knot, so the coefficients are not removed and
+// inserted again for every measurement.
 template <>
 inline Key SamplingPolicy::defaultExtend<CubicHermiteSE3Curve, ValueType>(const Time& time,
                   const ValueType& value,
                   CubicHermiteSE3Curve* curve) {
+  // The interpolated knot is moved in place, which needs a mutable iterator. The other
+  // knots are only read, through const iterators which leave chunks shared with copies.
+  typedef TimeToKeyCoefficientMap::iterator MutableCoefficientIter;
 
   DerivativeType derivative;
+  const bool hasInterpolatedKnot = measurementsSinceLastExtend_ > 0 && curve->manager_.size() > 1;
+  MutableCoefficientIter end = curve->manager_.coefficientEnd();
+  if (hasInterpolatedKnot) {
+    --end;
+  }
+  const size_t numKnots = curve->manager_.size() - (hasInterpolatedKnot ? 1 : 0);
   //cases:
 
   // manager is empty
-  if (curve->manager_.size() == 0) {
+  if (numKnots == 0) {
     derivative.setZero();
     // 1 value in manager (2 in total)
-  } else if (curve->manager_.size() == 1) {
+  } else if (numKnots == 1) {
     // get latest coefficient from manager
     CoefficientIter last = curve->manager_.coefficientBegin();
     // calculate slope
@@ -312,13 +654,12 @@ inline Key SamplingPolicy::defaultExtend<CubicHermiteSE3Curve, ValueType>(const
     Coefficient updated(last->second.coefficient.getTransformation(), derivative);
     curve->manager_.updateCoefficientByKey(last->second.key, updated);
     // more than 1 values in manager
-  } else if (curve->manager_.size() > 1) {
+  } else {
     // get latest 2 coefficients from manager
-    CoefficientIter rVal0, rVal1;
-    CoefficientIter last = --curve->manager_.coefficientEnd();
-    curve->manager_.getCoefficientsAt(last->first,
-                               &rVal0,
-                               &rVal1);
+    CoefficientIter rVal1 = end;
+    --rVal1;
+    CoefficientIter rVal0 = rVal1;
+    --rVal0;
 
     // update derivative of previous coefficient
     DerivativeType derivative0;
@@ -333,37 +674,42 @@ inline Key SamplingPolicy::defaultExtend<CubicHermiteSE3Curve, ValueType>(const
   }
   measurementsSinceLastExtend_ = 0;
   lastExtend_ = time;
-  return curve->manager_.insertCoefficient(time, Coefficient(value, derivative));
+  Key key;
+  if (hasInterpolatedKnot) {
+    // the interpolated coefficient becomes the new knot
+    key = CoefficientIter(end)->second.key;
+    curve->manager_.modifyCoefficient(end, time, Coefficient(value, derivative));
+  } else {
+    key = curve->manager_.insertCoefficient(time, Coefficient(value, derivative));
+  }
+  curve->simplifyEnd(simplificationTolerance_);
+  return key;
 }
 
 template <>
 inline Key SamplingPolicy::interpolationExtend<CubicHermiteSE3Curve, ValueType>(const Time& time,
                         const ValueType& value,
                         CubicHermiteSE3Curve* curve) {
-  DerivativeType derivative;
+  typedef TimeToKeyCoefficientMap::iterator MutableCoefficientIter;
+
+  MutableCoefficientIter last = --curve->manager_.coefficientEnd();
+  const CoefficientIter lastRead = last;
   if (measurementsSinceLastExtend_ == 0) {
-    // extend curve with new interpolation coefficient if necessary
-    CoefficientIter rValInterp = --curve->manager_.coefficientEnd();
-    CoefficientIter last = --curve->manager_.coefficientEnd();
-    derivative = last->second.coefficient.getTransformationDerivative();
-  } else {
-    // assumes the interpolation coefficient is already set (at end of curve)
-    // assumes same velocities as last Coefficient
-    CoefficientIter rVal0, rValInterp;
-    CoefficientIter last = --curve->manager_.coefficientEnd();
-    curve->manager_.getCoefficientsAt(last->first,
-                               &rVal0,
-                               &rValInterp);
-
-    derivative = curve->calculateSlope(rVal0->first, time,
-                                       rVal0->second.coefficient.getTransformation(), value);
-
-    // update the interpolated coefficient with given values and velocities from last coefficeint
-    curve->manager_.removeCoefficientAtTime(rValInterp->first);
+    // extend curve with new interpolation coefficient, with the velocities of the last coefficient
+    ++measurementsSinceLastExtend_;
+    return curve->manager_.insertCoefficient(time, Coefficient(value, lastRead->second.coefficient.getTransformationDerivative()));
   }
+  // assumes the interpolation coefficient is already set (at end of curve)
+  CoefficientIter rVal0 = lastRead;
+  --rVal0;
+  const DerivativeType derivative = curve->calculateSlope(rVal0->first, time,
+                                                          rVal0->second.coefficient.getTransformation(), value);
 
+  // move the interpolated coefficient to the given values in place
   ++measurementsSinceLastExtend_;
-  return curve->manager_.insertCoefficient(time, Coefficient(value, derivative));
+  const Key key = lastRead->second.key;
+  curve->manager_.modifyCoefficient(last, time, Coefficient(value, derivative));
+  return key;
 }
 
 template<>
@@ -371,21 +717,38 @@ inline void SamplingPolicy::extend<CubicHermiteSE3Curve, ValueType>(const std::v
                                                              const std::vector<ValueType>& values,
                                                              CubicHermiteSE3Curve* curve,
                                                              std::vector<Key>* outKeys) {
-  for (int i = 0; i < times.size(); ++i) {
+  // Which measurements become knots only depends on the counters of the policy, so the
+  // interpolated knot is only written for the last measurement before a knot or the end of
+  // the batch. The measurements in between are superseded and only counted.
+  for (size_t i = 0; i < times.size(); ++i) {
     // ensure time strictly increases
-    CHECK((times[i] > curve->manager_.getMaxTime()) || curve->manager_.size() == 0) << "curve can only be extended into the future. Requested = "
+    CHECK((times[i] > curve->manager_.getMaxTime() && (i == 0 || times[i] > times[i - 1]))
+          || curve->manager_.size() == 0) << "curve can only be extended into the future. Requested = "
         << times[i] << " < curve max time = " << curve->manager_.getMaxTime();
-    if (curve->manager_.size() == 0) {
-      defaultExtend(times[i], values[i], curve);
-    } else if((measurementsSinceLastExtend_ >= minimumMeasurements_ &&
-        lastExtend_ + minSamplingPeriod_ < times[i])) {
-      // delete interpolated coefficient
-      CoefficientIter last = --curve->manager_.coefficientEnd();
-      curve->manager_.removeCoefficientAtTime(last->first);
-      // todo write outkeys
-      defaultExtend(times[i], values[i], curve);
+    const bool isEmpty = curve->manager_.size() == 0;
+    const Key lastKey = isEmpty ? Key() : (CoefficientIter(curve->manager_.coefficientEnd()) - 1)->second.key;
+    Key key;
+    if (isEmpty) {
+      CURVES_INSTRUMENT_COUNT("CubicHermiteSE3Curve::extend::default");
+      key = defaultExtend(times[i], values[i], curve);
+    } else if (measurementsSinceLastExtend_ >= minimumMeasurements_ &&
+        lastExtend_ + minSamplingPeriod_ < times[i]) {
+      CURVES_INSTRUMENT_COUNT("CubicHermiteSE3Curve::extend::replaceInterpolated");
+      key = defaultExtend(times[i], values[i], curve);
+    } else if (measurementsSinceLastExtend_ == 0 || i + 1 == times.size() ||
+        (measurementsSinceLastExtend_ + 1 >= minimumMeasurements_ &&
+         lastExtend_ + minSamplingPeriod_ < times[i + 1])) {
+      CURVES_INSTRUMENT_COUNT("CubicHermiteSE3Curve::extend::interpolate");
+      key = interpolationExtend(times[i], values[i], curve);
     } else {
-      interpolationExtend(times[i], values[i], curve);
+      CURVES_INSTRUMENT_COUNT("CubicHermiteSE3Curve::extend::skipInterpolated");
+      ++measurementsSinceLastExtend_;
+      continue;
+    }
+    // like insertCoefficients, only return the keys of new coefficients, not of the moved
+    // interpolated one
+    if (outKeys != NULL && (isEmpty || key != lastKey)) {
+      outKeys->push_back(key);
     }
   }
 }
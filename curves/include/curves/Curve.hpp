@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 namespace curves {
 
 typedef double Time;
@@ -53,6 +56,31 @@ class Curve
 //  /// Evaluate the curve derivatives.
   virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const = 0;
 
+  /// Evaluate the ambient space of the curve at multiple times.
+  /// The default implementation evaluates every time separately. Curves with local support
+  /// override it to walk their segments linearly, so sorted times cost O(N + segments).
+  /// @returns false if the evaluation failed for any of the times.
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+    values->resize(times.size());
+    bool success = true;
+    for (size_t i = 0; i < times.size(); ++i) {
+      success &= evaluate((*values)[i], times[i]);
+    }
+    return success;
+  }
+
+  /// Evaluate the curve derivatives at multiple times.
+  /// @returns false if the evaluation failed for any of the times.
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                                  unsigned derivativeOrder) const {
+    derivatives->resize(times.size());
+    bool success = true;
+    for (size_t i = 0; i < times.size(); ++i) {
+      success &= evaluateDerivative((*derivatives)[i], times[i], derivativeOrder);
+    }
+    return success;
+  }
+
   ///@}
 
   /// \name Methods to fit the curve based on data.
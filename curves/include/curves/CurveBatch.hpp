@@ -0,0 +1,296 @@
+/*
+ * CurveBatch.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "curves/CubicHermiteE3Curve.hpp"
+#include "curves/Curve.hpp"
+#include "curves/ParallelFor.hpp"
+#include "curves/PolynomialSplineVectorSpaceCurve.hpp"
+
+namespace curves {
+
+/// \brief Many piecewise polynomial curves in R^N, evaluated together.
+///
+/// The segments of all curves are copied into flat arrays, with the coefficients of a
+/// segment stored from the highest to the lowest power of the time since the segment
+/// start, like PolynomialSpline. The coefficients of the segment active for each curve are
+/// kept in a structure of arrays with one column per coefficient and dimension, so
+/// evaluating all curves is a Horner scheme on whole columns which Eigen vectorizes.
+/// The active segments are only gathered again when a curve moves to another segment,
+/// which is rare when the evaluation times advance in small steps.
+///
+/// Curves sharing the segment times of all dimensions can be added, e.g.
+/// PolynomialSplineVectorSpaceCurve and CubicHermiteE3Curve (as cubic polynomials).
+/// Later changes to an added curve are not reflected in the batch. Times outside of a
+/// curve are clamped to its first or last segment. The evaluations are const but update
+/// the active segments, so a batch must not be evaluated from several threads at once.
+template <int N, unsigned int SplineOrder = 5>
+class CurveBatch {
+ public:
+  static constexpr unsigned int splineOrder = SplineOrder;
+  static constexpr unsigned int numCoefficients = SplineOrder + 1;
+
+  /// Values of all curves, one row per curve, one column per dimension.
+  typedef Eigen::Matrix<double, Eigen::Dynamic, N> ValueMatrix;
+
+  CurveBatch() :
+      numThreads_(1) {
+    segmentOffsets_.push_back(0);
+  }
+
+  /// \brief Remove all curves.
+  void clear() {
+    segmentOffsets_.assign(1, 0);
+    segmentStartTimes_.clear();
+    segmentDurations_.clear();
+    segmentCoefficients_.clear();
+    activeSegments_.clear();
+    activeCoefficients_.resize(0, numCoefficients * N);
+    activeStartTimes_.resize(0);
+    activeDurations_.resize(0);
+  }
+
+  /// \brief Number of curves.
+  size_t size() const {
+    return activeSegments_.size();
+  }
+
+  bool isEmpty() const {
+    return activeSegments_.empty();
+  }
+
+  /// \brief Number of threads of the evaluations, 0 for all hardware threads. Defaults to 1.
+  void setNumberOfThreads(unsigned int numThreads) {
+    numThreads_ = numThreads;
+  }
+
+  /// \brief Append a copy of the splines of a curve and return its index. The splines of
+  ///        all dimensions must have the same durations, else std::invalid_argument is thrown.
+  template <typename SplineType>
+  size_t addCurve(const PolynomialSplineVectorSpaceCurve<SplineType, N>& curve) {
+    static_assert(SplineType::splineOrder <= SplineOrder, "The spline order exceeds the order of the batch.");
+    const typename PolynomialSplineVectorSpaceCurve<SplineType, N>::Container& first = curve.containers_.at(0);
+    const size_t numSegments = first.getSplines().size();
+    for (int j = 1; j < N; ++j) {
+      const auto& splines = curve.containers_.at(j).getSplines();
+      if (splines.size() != numSegments) {
+        throw std::invalid_argument("CurveBatch::addCurve: the dimensions have different segments.");
+      }
+      for (size_t i = 0; i < numSegments; ++i) {
+        if (splines[i].getSplineDuration() != first.getSplines()[i].getSplineDuration()) {
+          throw std::invalid_argument("CurveBatch::addCurve: the dimensions have different segments.");
+        }
+      }
+    }
+
+    double startTime = 0.0;
+    const unsigned int offset = SplineOrder - SplineType::splineOrder;
+    for (size_t i = 0; i < numSegments; ++i) {
+      const double duration = first.getSplines()[i].getSplineDuration();
+      double* coefficients = addSegment(startTime, duration);
+      for (int j = 0; j < N; ++j) {
+        const auto& splineCoefficients = curve.containers_.at(j).getSplines()[i].getCoefficients();
+        for (unsigned int k = 0; k < SplineType::coefficientCount; ++k) {
+          coefficients[(offset + k) * N + j] = splineCoefficients[k];
+        }
+      }
+      startTime += duration;
+    }
+    return finishCurve();
+  }
+
+  /// \brief Append a copy of the segments of a Hermite curve and return its index.
+  size_t addCurve(const CubicHermiteE3Curve& curve) {
+    static_assert(N == 3, "Hermite curves are three dimensional.");
+    static_assert(SplineOrder >= 3, "Hermite curves need a batch of at least third order.");
+    typedef CubicHermiteE3Curve::CoefficientIter CoefficientIter;
+    const unsigned int offset = SplineOrder - 3;
+    if (curve.manager_.size() == 1) {
+      double* coefficients = addSegment(curve.manager_.getMinTime(), 0.0);
+      Eigen::Map<Eigen::Vector3d>(coefficients + SplineOrder * N) =
+          curve.manager_.coefficientBegin()->second.coefficient.getPosition();
+    } else if (curve.manager_.size() > 1) {
+      CoefficientIter a = curve.manager_.coefficientBegin();
+      CoefficientIter b = a;
+      for (++b; b != curve.manager_.coefficientEnd(); ++a, ++b) {
+        const double dt = b->first - a->first;
+        const Eigen::Vector3d pA = a->second.coefficient.getPosition();
+        const Eigen::Vector3d pB = b->second.coefficient.getPosition();
+        const Eigen::Vector3d vA = a->second.coefficient.getVelocity();
+        const Eigen::Vector3d vB = b->second.coefficient.getVelocity();
+        // Hermite basis expanded in the powers of the time since the segment start.
+        double* coefficients = addSegment(a->first, dt);
+        Eigen::Map<Eigen::Vector3d>(coefficients + offset * N) = (2.0 * (pA - pB) + dt * (vA + vB)) / (dt * dt * dt);
+        Eigen::Map<Eigen::Vector3d>(coefficients + (offset + 1) * N) = (3.0 * (pB - pA) - dt * (2.0 * vA + vB)) / (dt * dt);
+        Eigen::Map<Eigen::Vector3d>(coefficients + (offset + 2) * N) = vA;
+        Eigen::Map<Eigen::Vector3d>(coefficients + (offset + 3) * N) = pA;
+      }
+    }
+    return finishCurve();
+  }
+
+  /// \brief Evaluate all curves at the same time. Returns false if the time is outside
+  ///        of a curve or a curve is empty, whose values are clamped or zero.
+  bool evaluate(Time time, ValueMatrix* values) const {
+    return evaluateDerivative(time, 0, values);
+  }
+
+  /// \brief Evaluate curve i at times(i).
+  bool evaluate(const Eigen::Ref<const Eigen::VectorXd>& times, ValueMatrix* values) const {
+    return evaluateDerivative(times, 0, values);
+  }
+
+  /// \brief Evaluate the derivatives of all curves at the same time, 0 for the values.
+  bool evaluateDerivative(Time time, unsigned int derivativeOrder, ValueMatrix* values) const {
+    return evaluateBlocks(derivativeOrder, values, [time](size_t) { return time; });
+  }
+
+  /// \brief Evaluate the derivative of curve i at times(i), 0 for the values.
+  bool evaluateDerivative(const Eigen::Ref<const Eigen::VectorXd>& times, unsigned int derivativeOrder,
+                          ValueMatrix* values) const {
+    CHECK_EQ(static_cast<size_t>(times.size()), size());
+    return evaluateBlocks(derivativeOrder, values, [&times](size_t i) { return times(i); });
+  }
+
+ private:
+  /// Number of curves evaluated together by one thread, sized to stay in the L1 cache.
+  static const size_t kBlockSize = 256;
+
+  /// n*(n-1)*...*(n-d+1), the factor of t^(n-d) in the d-th derivative of t^n.
+  static double fallingFactorial(unsigned int n, unsigned int d) {
+    double value = 1.0;
+    for (unsigned int i = 0; i < d; ++i) {
+      value *= n - i;
+    }
+    return value;
+  }
+
+  double* addSegment(double startTime, double duration) {
+    segmentStartTimes_.push_back(startTime);
+    segmentDurations_.push_back(duration);
+    segmentCoefficients_.resize(segmentCoefficients_.size() + numCoefficients * N, 0.0);
+    return segmentCoefficients_.data() + segmentCoefficients_.size() - numCoefficients * N;
+  }
+
+  size_t finishCurve() {
+    segmentOffsets_.push_back(segmentStartTimes_.size());
+    const size_t index = activeSegments_.size();
+    activeSegments_.push_back(0);
+    activeCoefficients_.conservativeResize(index + 1, numCoefficients * N);
+    activeStartTimes_.conservativeResize(index + 1);
+    activeDurations_.conservativeResize(index + 1);
+    setActiveSegment(index, segmentOffsets_[index]);
+    return index;
+  }
+
+  /// Copy the segment into the row of curve i of the active coefficients.
+  void setActiveSegment(size_t i, size_t segment) const {
+    activeSegments_[i] = segment;
+    if (segment == segmentOffsets_[i + 1]) {
+      // Empty curve.
+      activeCoefficients_.row(i).setZero();
+      activeStartTimes_(i) = 0.0;
+      activeDurations_(i) = 0.0;
+      return;
+    }
+    activeCoefficients_.row(i) = Eigen::Map<const Eigen::RowVectorXd>(
+        segmentCoefficients_.data() + segment * numCoefficients * N, numCoefficients * N);
+    activeStartTimes_(i) = segmentStartTimes_[segment];
+    activeDurations_(i) = segmentDurations_[segment];
+  }
+
+  /// Make the segment of curve i active at time, returns false if the time is outside of the curve.
+  bool updateActiveSegment(size_t i, Time time) const {
+    const size_t begin = segmentOffsets_[i];
+    const size_t end = segmentOffsets_[i + 1];
+    if (begin == end) {
+      return false;
+    }
+    const double* startTimes = segmentStartTimes_.data();
+    const bool inside = time >= startTimes[begin] && time <= startTimes[end - 1] + segmentDurations_[end - 1];
+    size_t segment = activeSegments_[i];
+    const bool afterSegment = segment + 1 < end && time >= startTimes[segment + 1];
+    if (time < startTimes[segment] || afterSegment) {
+      // Times advancing in small steps move to the next segment, anything else searches.
+      if (afterSegment && (segment + 2 == end || time < startTimes[segment + 2])) {
+        ++segment;
+      } else {
+        const size_t next = std::upper_bound(startTimes + begin, startTimes + end, time) - startTimes;
+        segment = next == begin ? begin : next - 1;
+      }
+      if (segment != activeSegments_[i]) {
+        setActiveSegment(i, segment);
+      }
+    }
+    return inside;
+  }
+
+  template <class TimeFunction>
+  bool evaluateBlocks(unsigned int derivativeOrder, ValueMatrix* values, const TimeFunction& getTime) const {
+    CHECK_NOTNULL(values);
+    CHECK_LE(derivativeOrder, SplineOrder);
+    values->resize(size(), N);
+    const size_t numBlocks = (size() + kBlockSize - 1) / kBlockSize;
+    std::vector<char> success(numBlocks, 1);
+    parallelFor(0, numBlocks, [&](size_t blockIndex) {
+      const size_t begin = blockIndex * kBlockSize;
+      const size_t count = std::min(kBlockSize, size() - begin);
+      Eigen::Array<double, Eigen::Dynamic, 1> tau(count);
+      for (size_t i = 0; i < count; ++i) {
+        const Time time = getTime(begin + i);
+        if (!updateActiveSegment(begin + i, time)) {
+          success[blockIndex] = 0;
+        }
+        tau(i) = time - activeStartTimes_(begin + i);
+      }
+      tau = tau.max(0.0).min(activeDurations_.segment(begin, count));
+
+      const auto coefficients = activeCoefficients_.middleRows(begin, count);
+      for (int j = 0; j < N; ++j) {
+        auto value = values->col(j).segment(begin, count).array();
+        value = fallingFactorial(SplineOrder, derivativeOrder) * coefficients.col(j);
+        for (unsigned int k = 1; k + derivativeOrder < numCoefficients; ++k) {
+          value = value * tau + fallingFactorial(SplineOrder - k, derivativeOrder) * coefficients.col(k * N + j);
+        }
+      }
+    }, numThreads_, 4);
+    return std::find(success.begin(), success.end(), 0) == success.end();
+  }
+
+  unsigned int numThreads_;
+
+  /// Segments of curve i are [segmentOffsets_[i], segmentOffsets_[i + 1]).
+  std::vector<size_t> segmentOffsets_;
+  std::vector<double> segmentStartTimes_;
+  std::vector<double> segmentDurations_;
+  /// numCoefficients * N per segment, coefficient k of dimension j at k * N + j.
+  std::vector<double> segmentCoefficients_;
+
+  /// Active segment of each curve and its coefficients, start time and duration.
+  mutable std::vector<size_t> activeSegments_;
+  mutable Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic> activeCoefficients_;
+  mutable Eigen::Array<double, Eigen::Dynamic, 1> activeStartTimes_;
+  mutable Eigen::Array<double, Eigen::Dynamic, 1> activeDurations_;
+};
+
+template <int N, unsigned int SplineOrder>
+constexpr unsigned int CurveBatch<N, SplineOrder>::splineOrder;
+
+template <int N, unsigned int SplineOrder>
+constexpr unsigned int CurveBatch<N, SplineOrder>::numCoefficients;
+
+template <int N, unsigned int SplineOrder>
+const size_t CurveBatch<N, SplineOrder>::kBlockSize;
+
+} // namespace curves
@@ -0,0 +1,63 @@
+/*
+ * CurveCursor.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// \brief Evaluates a curve at increasing times without searching for every query.
+///
+/// The cursor remembers the segment of the last query. When the next time falls into
+/// the same or one of the following segments, the search through the coefficients is
+/// skipped. Any time can be queried, going backwards only costs a regular search.
+///
+/// The cursor checks the revision of the curve's coefficient manager before reusing
+/// its segment, so it stays valid when the curve is extended between two queries: after
+/// an extend() the next query simply searches again. The cursor itself is not shared,
+/// every thread evaluating the curve uses its own.
+///
+/// Like evaluating the curve without a cursor, this is not safe while another thread
+/// extends the curve, the check can not cover a change during the query. A real-time
+/// thread reading a curve that another thread extends uses ConcurrentCurve::Cursor.
+///
+/// CurveType has to provide a CoefficientCursor type and cursor overloads of
+/// evaluate() and evaluateDerivative(), like CubicHermiteSE3Curve, CubicHermiteE3Curve
+/// and SlerpSE3Curve.
+template <class CurveType>
+class CurveCursor {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  explicit CurveCursor(const CurveType& curve) : curve_(curve) {}
+
+  /// Evaluate the ambient space of the curve.
+  bool evaluate(ValueType& value, Time time) {
+    return curve_.evaluate(value, time, &cursor_);
+  }
+
+  /// Evaluate the curve derivatives.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder) {
+    return curve_.evaluateDerivative(derivative, time, derivativeOrder, &cursor_);
+  }
+
+  /// Forget the remembered segment.
+  void reset() {
+    cursor_.reset();
+  }
+
+  const CurveType& getCurve() const {
+    return curve_;
+  }
+
+ private:
+  const CurveType& curve_;
+  typename CurveType::CoefficientCursor cursor_;
+};
+
+} // namespace
@@ -0,0 +1,153 @@
+/*
+ * CurveFile.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/Curve.hpp"
+#include <Eigen/Core>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <glog/logging.h>
+
+namespace curves {
+
+/// \brief What a binary curve file contains.
+enum class CurveFileContent : uint32_t {
+  /// Coefficient times and packed coefficients of a coefficient manager.
+  Coefficients = 1,
+  /// Durations and coefficients of the splines of a spline container.
+  Splines = 2
+};
+
+/// \brief Header of the binary curve files.
+///
+/// A file is this header followed by two packed arrays of doubles: one time per entry
+/// (the spline duration for Splines), then valuesPerEntry values per entry. The data is
+/// stored in host byte order; a file written on a machine of other endianness fails the
+/// magic number check. The header size is a multiple of 8, so the arrays of a mapped
+/// file are aligned.
+struct CurveFileHeader {
+  static const uint32_t kMagic = 0x43525643; // "CVRC"
+  static const uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t content;
+  uint32_t valuesPerEntry;
+  uint64_t size;
+  uint64_t reserved;
+};
+
+/// \brief Write a binary curve file. Returns false if the file could not be written.
+bool writeCurveFile(const std::string& filename, CurveFileContent content, size_t valuesPerEntry,
+                    const std::vector<double>& times, const std::vector<double>& values);
+
+/// \brief Read-only memory mapped view of a binary curve file.
+///
+/// Opening only maps and validates the file, the times and values are read in place.
+/// The pages are shared by all processes mapping the same file.
+class MappedCurveFile {
+ public:
+  MappedCurveFile();
+  ~MappedCurveFile();
+
+  /// \brief Map the file. Returns false if it can not be mapped or is not a valid curve file.
+  bool open(const std::string& filename);
+
+  void close();
+
+  bool isOpen() const;
+
+  CurveFileContent getContent() const;
+
+  /// \brief Number of entries.
+  size_t size() const;
+
+  size_t getValuesPerEntry() const;
+
+  /// \brief The sorted coefficient times or the spline durations, size() of them.
+  const double* getTimes() const;
+
+  /// \brief The values of entry i, getValuesPerEntry() of them.
+  const double* getValues(size_t i) const;
+
+ private:
+  MappedCurveFile(const MappedCurveFile&);
+  MappedCurveFile& operator=(const MappedCurveFile&);
+
+  void* data_;
+  size_t length_;
+  const CurveFileHeader* header_;
+};
+
+/// \brief Packing of coefficients into the values of a binary curve file.
+///
+/// Specialize for every coefficient type to be saved, with a static kSize and
+/// static pack(const Coefficient&, double*) and unpack(const double*, Coefficient*).
+template <class Coefficient>
+struct CoefficientPacking;
+
+template <int N>
+struct CoefficientPacking<Eigen::Matrix<double, N, 1> > {
+  static const size_t kSize = N;
+
+  static void pack(const Eigen::Matrix<double, N, 1>& coefficient, double* values) {
+    Eigen::Map<Eigen::Matrix<double, N, 1> > packed(values);
+    packed = coefficient;
+  }
+
+  static void unpack(const double* values, Eigen::Matrix<double, N, 1>* coefficient) {
+    *coefficient = Eigen::Map<const Eigen::Matrix<double, N, 1> >(values);
+  }
+};
+
+/// \brief Save the coefficients of a coefficient manager to a binary curve file.
+template <class Manager>
+bool saveCoefficientsBinary(const std::string& filename, const Manager& manager) {
+  typedef typename Manager::CoefficientType Coefficient;
+  typedef CoefficientPacking<Coefficient> Packing;
+  std::vector<double> times;
+  std::vector<double> values;
+  times.reserve(manager.size());
+  values.resize(manager.size() * Packing::kSize);
+  size_t i = 0;
+  for (typename Manager::CoefficientIter it = manager.coefficientBegin(); it != manager.coefficientEnd(); ++it, ++i) {
+    times.push_back(it->first);
+    Packing::pack(it->second.coefficient, &values[i * Packing::kSize]);
+  }
+  return writeCurveFile(filename, CurveFileContent::Coefficients, Packing::kSize, times, values);
+}
+
+/// \brief Replace the coefficients of a coefficient manager with those of a mapped curve file.
+template <class Manager>
+bool loadCoefficients(const MappedCurveFile& file, Manager* manager, std::vector<Key>* outKeys = NULL) {
+  CHECK_NOTNULL(manager);
+  typedef typename Manager::CoefficientType Coefficient;
+  typedef CoefficientPacking<Coefficient> Packing;
+  if (!file.isOpen() || file.getContent() != CurveFileContent::Coefficients ||
+      file.getValuesPerEntry() != Packing::kSize) {
+    return false;
+  }
+  const std::vector<Time> times(file.getTimes(), file.getTimes() + file.size());
+  std::vector<Coefficient> coefficients(file.size());
+  for (size_t i = 0; i < file.size(); ++i) {
+    Packing::unpack(file.getValues(i), &coefficients[i]);
+  }
+  manager->clear();
+  manager->insertCoefficients(times, coefficients, outKeys);
+  return true;
+}
+
+/// \brief Replace the coefficients of a coefficient manager with those of a binary curve file.
+template <class Manager>
+bool loadCoefficientsBinary(const std::string& filename, Manager* manager, std::vector<Key>* outKeys = NULL) {
+  MappedCurveFile file;
+  return file.open(filename) && loadCoefficients(file, manager, outKeys);
+}
+
+} // namespace curves
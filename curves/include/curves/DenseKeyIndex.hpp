@@ -0,0 +1,188 @@
+/*
+ * DenseKeyIndex.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/Curve.hpp"
+#include <boost/unordered_map.hpp>
+#include <glog/logging.h>
+#include <cstddef>
+#include <vector>
+
+namespace curves {
+
+/// \brief Maps keys to values by indexing an array with the key.
+///
+/// The keys of a curve come from the KeyGenerator and are increasing, so they usually occupy
+/// a dense range. The index keeps one slot per key of that range, starting at the smallest
+/// key, and a bitmap of the slots in use. Lookups are an array access and adding a key
+/// after all others is amortized O(1). Erasing the smallest keys, as a sliding window does,
+/// is amortized O(1) as well: the unused slots at the front are only dropped once they
+/// make up half of the array.
+///
+/// The KeyGenerator is shared by all curves, so curves built at the same time leave each
+/// other gaps in their key ranges. As long as there are at most kMaxSlotsPerKey slots per
+/// key (or kMinSlots slots in total), the index stays an array. A key which would exceed
+/// that, or which lies before the range, switches the index to a hash map until it is
+/// emptied. The array thus never grows beyond kMaxSlotsPerKey slots per key it held.
+///
+/// The slots are kept in arrays with the interface of std::vector, e.g. ChunkedVector for
+/// indices which copies share. The hash map is copied along with the index.
+template <class Value, class ValueArray = std::vector<Value>, class FlagArray = std::vector<bool> >
+class DenseKeyIndex {
+ public:
+  /// Slots the array may always use.
+  static const size_t kMinSlots = 64;
+  /// Slots per key in the index beyond which it switches to a hash map.
+  static const size_t kMaxSlotsPerKey = 4;
+
+  DenseKeyIndex() : firstKey_(0), head_(0), size_(0), isSparse_(false) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// Whether the keys are too far apart for the array and are hashed instead.
+  bool isSparse() const { return isSparse_; }
+
+  void clear() {
+    values_.clear();
+    valid_.clear();
+    sparseValues_.clear();
+    firstKey_ = 0;
+    head_ = 0;
+    size_ = 0;
+    isSparse_ = false;
+  }
+
+  /// The value of key, NULL if the key is not in the index.
+  const Value* find(Key key) const {
+    if (isSparse_) {
+      const typename SparseMap::const_iterator it = sparseValues_.find(key);
+      return it == sparseValues_.end() ? NULL : &it->second;
+    }
+    if (key < firstKey_ || key - firstKey_ >= values_.size() || !getValid()[key - firstKey_]) {
+      return NULL;
+    }
+    return &getValues()[key - firstKey_];
+  }
+
+  /// Set the value of key, adding the key if it is not in the index yet.
+  void set(Key key, const Value& value) {
+    if (!isSparse_ && !values_.empty() && !fitsSlots(key)) {
+      makeSparse();
+    }
+    if (isSparse_) {
+      const std::pair<typename SparseMap::iterator, bool> result = sparseValues_.insert(std::make_pair(key, value));
+      if (result.second) {
+        ++size_;
+      } else {
+        result.first->second = value;
+      }
+      return;
+    }
+    if (values_.empty()) {
+      firstKey_ = key;
+      head_ = 0;
+    }
+    const size_t slot = key - firstKey_;
+    if (slot >= values_.size()) {
+      values_.resize(slot + 1);
+      valid_.resize(slot + 1, false);
+    }
+    if (!getValid()[slot]) {
+      valid_[slot] = true;
+      ++size_;
+      if (slot < head_) {
+        head_ = slot;
+      }
+    }
+    values_[slot] = value;
+  }
+
+  /// Remove key from the index. It is an error if the key is not in the index.
+  void erase(Key key) {
+    CHECK(find(key) != NULL) << "Key " << key << " is not in the index.";
+    --size_;
+    if (size_ == 0) {
+      clear();
+      return;
+    }
+    if (isSparse_) {
+      sparseValues_.erase(key);
+      return;
+    }
+    valid_[key - firstKey_] = false;
+    while (!getValid()[head_]) {
+      ++head_;
+    }
+    while (!getValid().back()) {
+      values_.pop_back();
+      valid_.pop_back();
+    }
+    if (2 * head_ >= values_.size()) {
+      values_.erase(values_.begin(), values_.begin() + head_);
+      valid_.erase(valid_.begin(), valid_.begin() + head_);
+      firstKey_ += head_;
+      head_ = 0;
+    }
+  }
+
+ private:
+  typedef boost::unordered_map<Key, Value> SparseMap;
+
+  /// Read access, which does not copy shared slots.
+  const ValueArray& getValues() const {
+    return values_;
+  }
+
+  const FlagArray& getValid() const {
+    return valid_;
+  }
+
+  /// Whether the array can hold key within the bound on the slots per key.
+  bool fitsSlots(Key key) const {
+    if (key < firstKey_) {
+      return false;
+    }
+    const size_t end = key - firstKey_ < values_.size() ? values_.size() : key - firstKey_ + 1;
+    const size_t numSlots = end - head_;
+    return numSlots <= kMinSlots || numSlots <= kMaxSlotsPerKey * (size_ + 1);
+  }
+
+  /// Move the keys of the array into the hash map.
+  void makeSparse() {
+    sparseValues_.reserve(size_);
+    for (size_t slot = head_; slot < values_.size(); ++slot) {
+      if (getValid()[slot]) {
+        sparseValues_.insert(std::make_pair(firstKey_ + slot, getValues()[slot]));
+      }
+    }
+    values_.clear();
+    valid_.clear();
+    firstKey_ = 0;
+    head_ = 0;
+    isSparse_ = true;
+  }
+
+  /// Key of the first slot.
+  Key firstKey_;
+
+  /// One value per key from firstKey_ on, and whether the key is in the index.
+  ValueArray values_;
+  FlagArray valid_;
+
+  /// No key of the first head_ slots is in the index.
+  size_t head_;
+
+  /// Number of keys in the index.
+  size_t size_;
+
+  /// The values by key once the keys are too sparse for the array.
+  SparseMap sparseValues_;
+  bool isSparse_;
+};
+
+} // namespace curves
@@ -0,0 +1,88 @@
+/*
+ * EvaluationError.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace curves {
+
+/// \brief Reason why a curve could not be evaluated.
+enum class EvaluationError {
+  None = 0,
+  /// The curve has no coefficients.
+  Empty,
+  /// The time is outside of [getMinTime(), getMaxTime()].
+  OutOfRange,
+  /// The requested derivative order is not implemented.
+  UnsupportedDerivative
+};
+
+/// \brief Human readable name of an evaluation error, for user side reporting.
+inline const char* getEvaluationErrorName(EvaluationError error) {
+  switch (error) {
+    case EvaluationError::None: return "None";
+    case EvaluationError::Empty: return "Empty";
+    case EvaluationError::OutOfRange: return "OutOfRange";
+    case EvaluationError::UnsupportedDerivative: return "UnsupportedDerivative";
+  }
+  return "Unknown";
+}
+
+/// \brief Number of failed evaluations of a curve, by error.
+///
+/// Evaluations do not log. Failures are counted here instead, with relaxed atomic
+/// increments, so that the counters can be polled from any thread.
+class EvaluationErrorCounters {
+ public:
+  EvaluationErrorCounters() {
+    reset();
+  }
+
+  EvaluationErrorCounters(const EvaluationErrorCounters& other) {
+    *this = other;
+  }
+
+  EvaluationErrorCounters& operator=(const EvaluationErrorCounters& other) {
+    for (size_t i = 0; i < kNumErrors; ++i) {
+      counts_[i].store(other.counts_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  /// \brief Count count failures with this error and return the error.
+  EvaluationError record(EvaluationError error, size_t count = 1) {
+    counts_[static_cast<size_t>(error)].fetch_add(count, std::memory_order_relaxed);
+    return error;
+  }
+
+  /// \brief Number of failures with this error since construction or the last reset.
+  size_t getCount(EvaluationError error) const {
+    return counts_[static_cast<size_t>(error)].load(std::memory_order_relaxed);
+  }
+
+  /// \brief Number of failures since construction or the last reset.
+  size_t getTotalCount() const {
+    size_t total = 0;
+    for (size_t i = 1; i < kNumErrors; ++i) {
+      total += counts_[i].load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  void reset() {
+    for (size_t i = 0; i < kNumErrors; ++i) {
+      counts_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static const size_t kNumErrors = static_cast<size_t>(EvaluationError::UnsupportedDerivative) + 1;
+  std::atomic<size_t> counts_[kNumErrors];
+};
+
+} // namespace curves
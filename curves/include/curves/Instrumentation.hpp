@@ -0,0 +1,146 @@
+/*
+ * Instrumentation.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Instrumentation is compiled in if CURVES_ENABLE_INSTRUMENTATION is defined, e.g. with
+// the CMake option CURVES_INSTRUMENTATION. Otherwise the macros below expand to nothing.
+#ifdef CURVES_ENABLE_INSTRUMENTATION
+
+/// \brief Time the rest of the enclosing scope in nanoseconds.
+#define CURVES_INSTRUMENT_SCOPE(name) \
+  CURVES_INSTRUMENT_SCOPE_UNITS(name, 1)
+
+/// \brief Time the rest of the enclosing scope, which processes units items (e.g. knots).
+#define CURVES_INSTRUMENT_SCOPE_UNITS(name, units) \
+  static ::curves::InstrumentationProbe& CURVES_INSTRUMENT_NAME(curvesProbe_) = \
+      ::curves::InstrumentationProbe::get(name); \
+  const ::curves::InstrumentationTimer CURVES_INSTRUMENT_NAME(curvesTimer_)( \
+      CURVES_INSTRUMENT_NAME(curvesProbe_), units)
+
+/// \brief Record a value, e.g. a search depth.
+#define CURVES_INSTRUMENT_VALUE(name, value) \
+  do { \
+    static ::curves::InstrumentationProbe& curvesProbe = ::curves::InstrumentationProbe::get(name); \
+    curvesProbe.record(value); \
+  } while (false)
+
+/// \brief Count an event.
+#define CURVES_INSTRUMENT_COUNT(name) CURVES_INSTRUMENT_VALUE(name, 1)
+
+#define CURVES_INSTRUMENT_NAME(prefix) CURVES_INSTRUMENT_CONCATENATE(prefix, __LINE__)
+#define CURVES_INSTRUMENT_CONCATENATE(a, b) CURVES_INSTRUMENT_CONCATENATE_IMPL(a, b)
+#define CURVES_INSTRUMENT_CONCATENATE_IMPL(a, b) a##b
+
+#else
+
+#define CURVES_INSTRUMENT_SCOPE(name) do {} while (false)
+#define CURVES_INSTRUMENT_SCOPE_UNITS(name, units) do {} while (false)
+#define CURVES_INSTRUMENT_VALUE(name, value) do {} while (false)
+#define CURVES_INSTRUMENT_COUNT(name) do {} while (false)
+
+#endif
+
+namespace curves {
+
+/// \brief Statistics of one probe at one instant.
+struct InstrumentationSnapshot {
+  /// Number of buckets of the histogram, bucket i counts values in [2^(i-1), 2^i).
+  static const size_t kNumBuckets = 40;
+
+  std::string name;
+  /// Number of recorded values.
+  uint64_t count;
+  /// Sum and maximum of the recorded values, nanoseconds for timed scopes.
+  uint64_t sum;
+  uint64_t max;
+  /// Sum of the units processed by timed scopes, e.g. sum / units is the time per knot.
+  uint64_t units;
+  std::array<uint64_t, kNumBuckets> histogram;
+};
+
+/// \brief A named set of counters, safe to update from any thread.
+///
+/// Probes are created on first use by the instrumentation macros and live until the
+/// end of the program. Recording a value costs a few relaxed atomic additions.
+class InstrumentationProbe {
+ public:
+  /// \brief The probe with this name, created if it does not exist yet.
+  static InstrumentationProbe& get(const std::string& name);
+
+  void record(uint64_t value, uint64_t units = 1) {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    units_.fetch_add(units, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+    histogram_[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  InstrumentationSnapshot getSnapshot() const;
+
+  void reset();
+
+ private:
+  explicit InstrumentationProbe(const std::string& name);
+  InstrumentationProbe(const InstrumentationProbe&);
+  InstrumentationProbe& operator=(const InstrumentationProbe&);
+
+  static size_t getBucket(uint64_t value) {
+    size_t bucket = 0;
+    while (value != 0 && bucket + 1 < InstrumentationSnapshot::kNumBuckets) {
+      value >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  friend class InstrumentationRegistry;
+
+  const std::string name_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+  std::atomic<uint64_t> units_;
+  std::array<std::atomic<uint64_t>, InstrumentationSnapshot::kNumBuckets> histogram_;
+};
+
+/// \brief Records the time from its construction to its destruction in a probe.
+class InstrumentationTimer {
+ public:
+  InstrumentationTimer(InstrumentationProbe& probe, uint64_t units) :
+      probe_(probe),
+      units_(units),
+      start_(std::chrono::steady_clock::now()) {
+  }
+
+  ~InstrumentationTimer() {
+    const std::chrono::nanoseconds duration = std::chrono::steady_clock::now() - start_;
+    probe_.record(duration.count() > 0 ? duration.count() : 0, units_);
+  }
+
+ private:
+  InstrumentationProbe& probe_;
+  const uint64_t units_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+/// \brief Statistics of all probes created so far, sorted by name. Without
+///        CURVES_ENABLE_INSTRUMENTATION the curves do not create any probes.
+std::vector<InstrumentationSnapshot> getInstrumentationSnapshot();
+
+/// \brief Reset the statistics of all probes.
+void resetInstrumentation();
+
+} // namespace curves
@@ -16,8 +16,14 @@ class KeyGenerator
 {
  public:
 
+  /// \brief Get a new key. Keys are increasing and unique within the process.
+  /// Lock free, safe to call from several threads.
   static size_t getNextKey();
 
+  /// \brief Reserve n consecutive keys with a single atomic operation.
+  /// \return the first key of the range [first, first + n).
+  static size_t reserveKeys(size_t n);
+
 };
 
 } // namespace curves
@@ -0,0 +1,39 @@
+/*
+ * KeyedCoefficient.hpp
+ *
+ *  Created on: Oct 10, 2014
+ *      Author: Paul Furgale, Abel Gawel, Renaud Dube, Péter Fankhauser
+ *   Institute: ETH Zurich, Autonomous Systems Lab
+ */
+
+#pragma once
+
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// A coefficient together with the key that identifies it. This is the element
+/// stored by the coefficient storage policies of LocalSupport2CoefficientManager.
+template <class Coefficient>
+struct KeyedCoefficient {
+  Key key;
+  Coefficient coefficient;
+
+  KeyedCoefficient(const Key key, const Coefficient& coefficient) :
+    key(key), coefficient(coefficient) {}
+
+  KeyedCoefficient() {};
+
+  bool equals(const KeyedCoefficient& other) const {
+    //todo Note: here we assume that == operator is implemented by the coefficient.
+    //Could not use gtsam traits as the gtsam namespace is not visible to this class.
+    //Is this correct?
+    return key == other.key && coefficient == other.coefficient;
+  }
+
+  bool operator==(const KeyedCoefficient& other) const {
+    return this->equals(other);
+  }
+};
+
+} // namespace
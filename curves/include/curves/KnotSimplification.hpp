@@ -0,0 +1,78 @@
+/*
+ * KnotSimplification.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace curves {
+
+/// \brief Tolerances for removing knots from a curve, see selectKnots.
+struct KnotTolerance {
+  KnotTolerance() : translation(-1.0), rotation(-1.0), maxRemovedKnots(16) {}
+
+  KnotTolerance(double translation, double rotation, size_t maxRemovedKnots = 16)
+      : translation(translation), rotation(rotation), maxRemovedKnots(maxRemovedKnots) {}
+
+  /// False for the default tolerances, which keep all knots.
+  bool isEnabled() const {
+    return translation >= 0.0 && rotation >= 0.0;
+  }
+
+  /// True if value is within the tolerances of the knot value expected, for transformations
+  /// like SE3Config::ValueType.
+  template <class Transformation>
+  bool isWithin(const Transformation& expected, const Transformation& value) const {
+    return (value.getPosition() - expected.getPosition()).norm() <= translation
+        && value.getRotation().getDisparityAngle(expected.getRotation()) <= rotation;
+  }
+
+  /// Maximal distance of the position [m].
+  double translation;
+  /// Maximal angle of the rotation [rad].
+  double rotation;
+  /// Maximal number of consecutive knots removed, which bounds the cost of the search.
+  size_t maxRemovedKnots;
+};
+
+/// \brief Select the knots to keep, so that every removed knot is reproduced by the segment
+///        that replaces it.
+///
+/// The knots are walked greedily from the first one: the segment from the last kept knot a
+/// is stretched to later knots c as long as reproduces(a, c, b) holds for every knot b in
+/// between, but over at most maxRemovedKnots knots. The first and last knots are kept.
+/// This takes O(numKnots * maxRemovedKnots) calls of reproduces.
+/// Returns the number of removed knots, keep[i] is false for them.
+template <class Function>
+size_t selectKnots(size_t numKnots, size_t maxRemovedKnots, const Function& reproduces,
+                   std::vector<bool>* keep) {
+  keep->assign(numKnots, true);
+  size_t numRemoved = 0;
+  size_t a = 0;
+  while (a + 2 < numKnots) {
+    size_t c = a + 2;
+    while (c < numKnots && c - a - 1 <= maxRemovedKnots) {
+      bool reproducesAll = true;
+      for (size_t b = a + 1; b < c && reproducesAll; ++b) {
+        reproducesAll = reproduces(a, c, b);
+      }
+      if (!reproducesAll) {
+        break;
+      }
+      ++c;
+    }
+    // The segment from a reaches c - 1, the knots in between are removed.
+    for (size_t b = a + 1; b + 1 < c; ++b) {
+      (*keep)[b] = false;
+      ++numRemoved;
+    }
+    a = c - 1;
+  }
+  return numRemoved;
+}
+
+} // namespace curves
@@ -9,63 +9,76 @@
 #include <curves/LocalSupport2CoefficientManager.hpp>
 
 #include <iostream>
-#include <curves/LocalSupport2CoefficientManager.hpp>
+#include <iterator>
+#include <curves/Instrumentation.hpp>
 #include <curves/KeyGenerator.hpp>
 #include <glog/logging.h>
 
 namespace curves {
 
-template <class Coefficient>
-LocalSupport2CoefficientManager<Coefficient>::LocalSupport2CoefficientManager() {
+template <class Coefficient, class Storage>
+LocalSupport2CoefficientManager<Coefficient, Storage>::LocalSupport2CoefficientManager() :
+    revision_(getNewRevision()),
+    coefficientStamp_(getNewCoefficientStamp()),
+    windowDuration_(0),
+    windowSize_(0) {
 }
 
-template <class Coefficient>
-LocalSupport2CoefficientManager<Coefficient>::~LocalSupport2CoefficientManager() {
+template <class Coefficient, class Storage>
+LocalSupport2CoefficientManager<Coefficient, Storage>::LocalSupport2CoefficientManager(
+    const LocalSupport2CoefficientManager& other) :
+    timeToCoefficient_(other.timeToCoefficient_),
+    revision_(getNewRevision()),
+    coefficientStamp_(other.getCoefficientStamp()),
+    windowDuration_(other.windowDuration_),
+    windowSize_(other.windowSize_) {
+}
+
+template <class Coefficient, class Storage>
+LocalSupport2CoefficientManager<Coefficient, Storage>&
+LocalSupport2CoefficientManager<Coefficient, Storage>::operator=(const LocalSupport2CoefficientManager& other) {
+  if (this != &other) {
+    timeToCoefficient_ = other.timeToCoefficient_;
+    windowDuration_ = other.windowDuration_;
+    windowSize_ = other.windowSize_;
+    incrementRevision();
+    coefficientStamp_.store(other.getCoefficientStamp(), std::memory_order_release);
+  }
+  return *this;
+}
+
+template <class Coefficient, class Storage>
+LocalSupport2CoefficientManager<Coefficient, Storage>::~LocalSupport2CoefficientManager() {
 }
 
 /// Compare this Coefficient manager with another for equality.
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::equals(const LocalSupport2CoefficientManager& other,
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::equals(const LocalSupport2CoefficientManager& other,
                                                           double tol) const {
-  bool equal = true;
-  equal &= keyToCoefficient_.size() == other.keyToCoefficient_.size();
-  equal &= timeToCoefficient_.size() == other.timeToCoefficient_.size();
+  bool equal = timeToCoefficient_.size() == other.timeToCoefficient_.size();
   if (equal) {
     CoefficientIter it1, it2;
-    it1 = keyToCoefficient_.begin();
-    it2 = other.keyToCoefficient_.begin();
-    for( ; it1 != keyToCoefficient_.end(); ++it1, ++it2) {
+    it1 = timeToCoefficient_.begin();
+    it2 = other.timeToCoefficient_.begin();
+    for( ; it1 != timeToCoefficient_.end(); ++it1, ++it2) {
       equal &= it1->first == it2->first;
       equal &= it1->second.equals(it2->second);
     }
-
-    CoefficientIter it3, it4;
-    it3 = timeToCoefficient_.begin();
-    it4 = other.timeToCoefficient_.begin();
-    for( ; it3 != timeToCoefficient_.end(); ++it3, ++it4) {
-      equal &= it3->first == it4->first;
-      if (it3->second && it4->second) {
-        equal &= it3->second->equals(*(it4->second));
-      } else {
-        equal &= it3->second == it4->second;
-      }
-    }
-
   }
   return equal;
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::getKeys(std::vector<Key>* outKeys) const {
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::getKeys(std::vector<Key>* outKeys) const {
   CHECK_NOTNULL(outKeys);
   outKeys->clear();
   appendKeys(outKeys);
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::appendKeys(std::vector<Key>* outKeys) const {
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::appendKeys(std::vector<Key>* outKeys) const {
   CHECK_NOTNULL(outKeys);
-  outKeys->reserve(outKeys->size() + keyToCoefficient_.size());
+  outKeys->reserve(outKeys->size() + timeToCoefficient_.size());
   CoefficientIter it;
   it = timeToCoefficient_.begin();
   for( ; it != timeToCoefficient_.end(); ++it) {
@@ -73,8 +86,8 @@ void LocalSupport2CoefficientManager<Coefficient>::appendKeys(std::vector<Key>*
   }
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::getTimes(std::vector<Time>* outTimes) const {
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::getTimes(std::vector<Time>* outTimes) const {
   CHECK_NOTNULL(outTimes);
   outTimes->clear();
   outTimes->reserve(timeToCoefficient_.size());
@@ -85,194 +98,400 @@ void LocalSupport2CoefficientManager<Coefficient>::getTimes(std::vector<Time>* o
   }
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::getTimesInWindow(std::vector<Time>* outTimes,
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::getTimesInWindow(std::vector<Time>* outTimes,
                                                                     Time begTime, Time endTime) const {
   CHECK_EQ(endTime, getMaxTime()) << "Not implemented for window not at the end.";
   CHECK(begTime >= getMinTime()) << "Asked for times outside the curve.";
   CHECK_NOTNULL(outTimes);
 
   outTimes->clear();
-  CoefficientIter it = --(timeToCoefficient_.end());
-
-  do {
-    if (it->first >= begTime) {
-      outTimes->push_back(it->first);
-    }
-    --it;
-  } while (it->first >= begTime && it != timeToCoefficient_.begin());
-
-  std::reverse(outTimes->begin(),outTimes->end());
+  CoefficientIter it = timeToCoefficient_.lower_bound(begTime);
+  for( ; it != timeToCoefficient_.end(); ++it) {
+    outTimes->push_back(it->first);
+  }
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::print(const std::string& str) const {
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::print(const std::string& str) const {
   // \todo (Abel or Renaud)
 }
 
-template <class Coefficient>
-Key LocalSupport2CoefficientManager<Coefficient>::insertCoefficient(Time time, const Coefficient& coefficient) {
+template <class Coefficient, class Storage>
+Key LocalSupport2CoefficientManager<Coefficient, Storage>::insertCoefficient(Time time, const Coefficient& coefficient) {
   CoefficientIter it;
-  Key key;
 
   if (this->hasCoefficientAtTime(time, &it)) {
-    this->updateCoefficientByKey(it->second.key, coefficient);
-    key = it->second.key;
+    const Key key = it->second.key;
+    this->updateCoefficientByKey(key, coefficient);
+    return key;
+  }
+  return insertNewCoefficient(time, coefficient, KeyGenerator::getNextKey());
+}
+
+template <class Coefficient, class Storage>
+Key LocalSupport2CoefficientManager<Coefficient, Storage>::insertNewCoefficient(Time time, const Coefficient& coefficient,
+                                                                           Key key) {
+  if (timeToCoefficient_.empty() || time > getMaxTime()) {
+    timeToCoefficient_.insertAtEnd(time, KeyCoefficient(key, coefficient));
+    applyWindow();
   } else {
-    key = KeyGenerator::getNextKey();
-    std::pair<Time, KeyCoefficient> iterator(time, KeyCoefficient(key, coefficient));
-    std::pair<CoefficientIter, bool> success =
-        timeToCoefficient_.insert(iterator);
-    keyToCoefficient_[key] = success.first;
+    timeToCoefficient_.insert(time, KeyCoefficient(key, coefficient));
   }
+  incrementRevision();
   return key;
 }
 
 /// \brief insert coefficients. Optionally returns the keys for these coefficients
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::insertCoefficients(const std::vector<Time>& times,
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::insertCoefficients(const std::vector<Time>& times,
                                                                       const std::vector<Coefficient>& values,
                                                                       std::vector<Key>* outKeys) {
   CHECK_EQ(times.size(), values.size());
-  for(Key i = 0; i < times.size(); ++i) {
+  for (size_t i = 1; i < times.size(); ++i) {
+    if (!(times[i - 1] < times[i])) {
+      insertUnsortedCoefficients(times, values, outKeys);
+      return;
+    }
+  }
+  if (times.empty()) {
+    return;
+  }
+  if (outKeys != NULL) {
+    outKeys->reserve(outKeys->size() + times.size());
+  }
+  // One key per time is reserved up front. Keys of times which already have a coefficient stay unused.
+  Key nextKey = KeyGenerator::reserveKeys(times.size());
+  const bool appends = timeToCoefficient_.empty() || times.back() > getMaxTime();
+  if (timeToCoefficient_.empty() || times.front() > getMaxTime()) {
+    timeToCoefficient_.reserve(timeToCoefficient_.size() + times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+      timeToCoefficient_.insertAtEnd(times[i], KeyCoefficient(nextKey, values[i]));
+      if (outKeys != NULL) {
+        outKeys->push_back(nextKey);
+      }
+      ++nextKey;
+    }
+    applyWindow();
+    incrementRevision();
+    return;
+  }
+
+  // Walk the coefficients from the first one at or after times.front() alongside the times,
+  // overwrite the coefficients at existing times and merge the others with one insertSorted.
+  std::vector<Time> newTimes;
+  std::vector<KeyCoefficient, Eigen::aligned_allocator<KeyCoefficient> > newCoefficients;
+  newTimes.reserve(times.size());
+  newCoefficients.reserve(times.size());
+  bool updated = false;
+  CoefficientIter it = timeToCoefficient_.lower_bound(times.front());
+  const CoefficientIter end = timeToCoefficient_.end();
+  for (size_t i = 0; i < times.size(); ++i) {
+    const Time time = TimeToKeyCoefficientMap::storedTime(times[i]);
+    while (it != end && it->first < time) {
+      ++it;
+    }
+    Key key;
+    if (it != end && it->first == time) {
+      key = it->second.key;
+      timeToCoefficient_.findKey(key)->second.coefficient = values[i];
+      updated = true;
+    } else {
+      key = nextKey++;
+      newTimes.push_back(times[i]);
+      newCoefficients.push_back(KeyCoefficient(key, values[i]));
+    }
     if (outKeys != NULL) {
-      outKeys->push_back(insertCoefficient(times[i], values[i]));
+      outKeys->push_back(key);
+    }
+  }
+  if (!newTimes.empty()) {
+    timeToCoefficient_.insertSorted(newTimes.data(), newCoefficients.data(), newTimes.size());
+    if (appends) {
+      applyWindow();
+    }
+    incrementRevision();
+  } else if (updated) {
+    renewCoefficientStamp();
+  }
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::insertUnsortedCoefficients(const std::vector<Time>& times,
+                                                                              const std::vector<Coefficient>& values,
+                                                                              std::vector<Key>* outKeys) {
+  timeToCoefficient_.reserve(timeToCoefficient_.size() + times.size());
+  // One key per time is reserved up front. Keys of times which already have a coefficient stay unused.
+  Key nextKey = KeyGenerator::reserveKeys(times.size());
+  for(Key i = 0; i < times.size(); ++i) {
+    CoefficientIter it;
+    Key key;
+    if (this->hasCoefficientAtTime(times[i], &it)) {
+      key = it->second.key;
+      this->updateCoefficientByKey(key, values[i]);
     } else {
-      insertCoefficient(times[i], values[i]);
+      key = insertNewCoefficient(times[i], values[i], nextKey++);
+    }
+    if (outKeys != NULL) {
+      outKeys->push_back(key);
+    }
+  }
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::resetCoefficients(const std::vector<Time>& times,
+                                                                     const std::vector<Coefficient>& values,
+                                                                     std::vector<Key>* outKeys) {
+  CHECK_EQ(times.size(), values.size());
+  timeToCoefficient_.clear();
+  for (size_t i = 1; i < times.size(); ++i) {
+    if (!(times[i - 1] < times[i])) {
+      incrementRevision();
+      insertUnsortedCoefficients(times, values, outKeys);
+      return;
+    }
+  }
+  timeToCoefficient_.reserve(times.size());
+  if (outKeys != NULL) {
+    outKeys->reserve(outKeys->size() + times.size());
+  }
+  const Key firstKey = KeyGenerator::reserveKeys(times.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    timeToCoefficient_.insertAtEnd(times[i], KeyCoefficient(firstKey + i, values[i]));
+    if (outKeys != NULL) {
+      outKeys->push_back(firstKey + i);
     }
   }
+  applyWindow();
+  incrementRevision();
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::modifyCoefficientsValuesInBatch(const std::vector<Time>& times,
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::modifyCoefficientsValuesInBatch(const std::vector<Time>& times,
                                                                                    const std::vector<Coefficient>& values) {
   CHECK_EQ(times.size(), values.size());
+  if (times.empty()) {
+    return;
+  }
   // Get an iterator to the first coefficient
-  typename TimeToKeyCoefficientMap::iterator it = timeToCoefficient_.end();
-
-  do {
-    --it;
-  } while (it->first != times[0]);
+  typename TimeToKeyCoefficientMap::iterator it = timeToCoefficient_.find(times[0]);
+  CHECK(it != timeToCoefficient_.end()) << "No coefficient at time " << times[0];
 
   for (size_t i = 0; i < times.size(); ++i) {
     CHECK_EQ(it->first,times[i]);
     it->second.coefficient = values[i];
     ++it;
   }
+  renewCoefficientStamp();
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::addCoefficientAtEnd(Time time, const Coefficient& coefficient, std::vector<Key>* outKeys) {
-  CHECK(time > getMaxTime()) << "Time to add is not greater than curve max time";
+namespace internal {
 
-  Key key = KeyGenerator::getNextKey();
+template <class Iterator, class Function>
+void updateCoefficientValues(Iterator begin, Iterator end, const Function& update,
+                             unsigned int numThreads, std::random_access_iterator_tag) {
+  if (numThreads > 1) {
+    // Writing copies shared chunks of a CopyOnWriteCoefficientStorage, which is not
+    // thread-safe, so all coefficients are accessed for writing once before.
+    for (Iterator it = begin; it != end; ++it) {
+      static_cast<void>(it->second);
+    }
+  }
+  parallelFor(0, end - begin, [&](size_t i) {
+    update((begin + i)->second.coefficient);
+  }, numThreads);
+}
 
-  // Insert the coefficient with a hint that it goes at the end
-  CoefficientIter it = timeToCoefficient_.insert(--(timeToCoefficient_.end()),
-                                                 std::pair<Time, KeyCoefficient>(time, KeyCoefficient(key, coefficient)));
+template <class Iterator, class Function>
+void updateCoefficientValues(Iterator begin, Iterator end, const Function& update,
+                             unsigned int /*numThreads*/, std::bidirectional_iterator_tag) {
+  for (Iterator it = begin; it != end; ++it) {
+    update(it->second.coefficient);
+  }
+}
+
+} // namespace internal
+
+template <class Coefficient, class Storage>
+template <class Function>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::updateCoefficientValues(const Function& update,
+                                                                                   unsigned int numThreads) {
+  typedef typename TimeToKeyCoefficientMap::iterator Iterator;
+  internal::updateCoefficientValues(timeToCoefficient_.begin(), timeToCoefficient_.end(), update, numThreads,
+                                    typename std::iterator_traits<Iterator>::iterator_category());
+  renewCoefficientStamp();
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::addCoefficientAtEnd(Time time, const Coefficient& coefficient, std::vector<Key>* outKeys) {
+  CHECK(time > getMaxTime() || timeToCoefficient_.empty()) << "Time to add is not greater than curve max time";
 
-  keyToCoefficient_.insert(keyToCoefficient_.end(), std::pair<Key, CoefficientIter>(key,it));
+  Key key = KeyGenerator::getNextKey();
+  timeToCoefficient_.insertAtEnd(time, KeyCoefficient(key, coefficient));
+  applyWindow();
+  incrementRevision();
   if (outKeys != NULL) {
     outKeys->push_back(key);
   }
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::modifyCoefficient(typename TimeToKeyCoefficientMap::iterator it,
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::modifyCoefficient(typename TimeToKeyCoefficientMap::iterator it,
                                                                      Time time, const Coefficient& coefficient) {
   // This is used by slerp sampling policy.
   // In this case a new coefficient should be placed slightly later than the initial one.
-  CoefficientIter newIt = timeToCoefficient_.insert(it,std::pair<Time, KeyCoefficient>(time, KeyCoefficient(it->second.key, coefficient)));
-  // Update keyToCoefficient_
-  keyToCoefficient_[it->second.key] = newIt;
-  // Remove the old coefficient
+  CHECK(time == CoefficientIter(it)->first || !hasCoefficientAtTime(time))
+      << "There is already a coefficient at time " << time;
+  timeToCoefficient_.move(it, time, coefficient);
+  applyWindow();
+  incrementRevision();
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::reserve(size_t size) {
+  timeToCoefficient_.reserve(size);
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::removeCoefficientWithKey(Key key) {
+  typename TimeToKeyCoefficientMap::iterator it = timeToCoefficient_.findKey(key);
+  CHECK(it != timeToCoefficient_.end()) << "No coefficient with that key.";
   timeToCoefficient_.erase(it);
+  incrementRevision();
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::removeCoefficientAtTime(Time time) {
+  typename TimeToKeyCoefficientMap::iterator it = timeToCoefficient_.find(time);
+  CHECK(it != timeToCoefficient_.end()) << "No coefficient at that time.";
+  timeToCoefficient_.erase(it);
+  incrementRevision();
+}
+
+template <class Coefficient, class Storage>
+template <class Predicate>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::removeCoefficientsIf(const Predicate& remove) {
+  const size_t count = timeToCoefficient_.eraseIf([&remove](Time time, const KeyCoefficient& keyCoefficient) {
+    return remove(time, keyCoefficient.coefficient);
+  });
+  if (count > 0) {
+    incrementRevision();
+  }
+  return count;
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::removeCoefficientWithKey(Key key) {
-  CHECK(hasCoefficientWithKey(key)) << "No coefficient with that key.";
-  typename TimeToKeyCoefficientMap::iterator it1;
-  typename boost::unordered_map<Key, CoefficientIter>::iterator it2;
-  it2 = keyToCoefficient_.find(key);
-  it1 = timeToCoefficient_.find(it1->second->first);
-  timeToCoefficient_.erase(it1);
-  keyToCoefficient_.erase(it2);
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::removeCoefficientsBefore(Time time) {
+  const size_t count = std::distance(CoefficientIter(timeToCoefficient_.begin()), timeToCoefficient_.lower_bound(time));
+  if (count > 0) {
+    timeToCoefficient_.eraseFront(count);
+    incrementRevision();
+  }
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::removeCoefficientAtTime(Time time) {
-  CHECK(this->hasCoefficientAtTime(time)) << "No coefficient at that time.";
-  typename TimeToKeyCoefficientMap::iterator it1;
-  typename boost::unordered_map<Key, CoefficientIter>::iterator it2;
-  it1 = timeToCoefficient_.find(time);
-  it2 = keyToCoefficient_.find(it1->second.key);
-  timeToCoefficient_.erase(it1);
-  keyToCoefficient_.erase(it2);
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::setWindow(Time maxDuration, size_t maxSize) {
+  CHECK_GE(maxDuration, 0.0);
+  windowDuration_ = maxDuration;
+  windowSize_ = maxSize;
+  if (!timeToCoefficient_.empty()) {
+    applyWindow();
+    incrementRevision();
+  }
+}
+
+template <class Coefficient, class Storage>
+Time LocalSupport2CoefficientManager<Coefficient, Storage>::getWindowDuration() const {
+  return windowDuration_;
+}
+
+template <class Coefficient, class Storage>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::getWindowSize() const {
+  return windowSize_;
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::applyWindow() {
+  size_t count = 0;
+  if (windowSize_ > 0 && timeToCoefficient_.size() > windowSize_) {
+    count = timeToCoefficient_.size() - windowSize_;
+  }
+  if (windowDuration_ > 0) {
+    // Keep the last coefficient at or before the start of the window.
+    const Time windowStart = getMaxTime() - windowDuration_;
+    CoefficientIter it = timeToCoefficient_.begin();
+    std::advance(it, count);
+    for (++it; it != timeToCoefficient_.end() && it->first <= windowStart; ++it) {
+      ++count;
+    }
+  }
+  if (count > 0) {
+    timeToCoefficient_.eraseFront(count);
+  }
 }
 
 /// \brief return true if there is a coefficient at this time
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::hasCoefficientAtTime(Time time) const {
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::hasCoefficientAtTime(Time time) const {
   CoefficientIter it = timeToCoefficient_.find(time);
   return it != timeToCoefficient_.end();
 }
 
 /// \brief return true if there is a coefficient with this key
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::hasCoefficientWithKey(Key key) const {
-  CoefficientIter it = keyToCoefficient_.find(key);
-  return it != keyToCoefficient_.end();
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::hasCoefficientWithKey(Key key) const {
+  return timeToCoefficient_.findKey(key) != timeToCoefficient_.end();
 }
 
 /// \brief set the coefficient associated with this key
 ///
 /// This function fails if there is no coefficient associated
 /// with this key.
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::updateCoefficientByKey(Key key, const Coefficient& coefficient) {
-  typename  boost::unordered_map<Key, CoefficientIter>::iterator it = keyToCoefficient_.find(key);
-  CHECK(it != keyToCoefficient_.end()) << "Key " << key << " is not in the container.";
-  *const_cast<CoefficientType*>(&(it)->second->second.coefficient) = coefficient;
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::updateCoefficientByKey(Key key, const Coefficient& coefficient) {
+  typename TimeToKeyCoefficientMap::iterator it = timeToCoefficient_.findKey(key);
+  CHECK(it != timeToCoefficient_.end()) << "Key " << key << " is not in the container.";
+  it->second.coefficient = coefficient;
+  renewCoefficientStamp();
 }
 
 /// \brief get the coefficient associated with this key
-template <class Coefficient>
-Coefficient LocalSupport2CoefficientManager<Coefficient>::getCoefficientByKey(Key key) const {
-  typename  boost::unordered_map<Key, CoefficientIter>::const_iterator it = keyToCoefficient_.find(key);
-  CHECK(it != keyToCoefficient_.end() ) << "Key " << key << " is not in the container.";
-  return it->second->second.coefficient;
+template <class Coefficient, class Storage>
+Coefficient LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientByKey(Key key) const {
+  CoefficientIter it = timeToCoefficient_.findKey(key);
+  CHECK(it != timeToCoefficient_.end()) << "Key " << key << " is not in the container.";
+  return it->second.coefficient;
 }
-template <class Coefficient>
-Time LocalSupport2CoefficientManager<Coefficient>::getCoefficientTimeByKey(Key key) const {
-  typename  boost::unordered_map<Key, CoefficientIter>::const_iterator it = keyToCoefficient_.find(key);
-  CHECK(it != keyToCoefficient_.end()) << "Key " << key << " is not in the container.";
-  return it->second->first;
+template <class Coefficient, class Storage>
+Time LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientTimeByKey(Key key) const {
+  CoefficientIter it = timeToCoefficient_.findKey(key);
+  CHECK(it != timeToCoefficient_.end()) << "Key " << key << " is not in the container.";
+  return it->first;
 }
 
 
 /// \brief Get the coefficients that are active at a certain time.
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::getCoefficientsAt(Time time,
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientsAt(Time time,
                                                                      CoefficientIter* outCoefficient0,
                                                                      CoefficientIter* outCoefficient1) const {
   CHECK_NOTNULL(outCoefficient0);
   CHECK_NOTNULL(outCoefficient1);
   if( timeToCoefficient_.empty() ) {
-    LOG(INFO) << "No coefficients";
     return false;
   }
 
   CoefficientIter it;
 
-  if(time == getMaxTime()) {
-    it = timeToCoefficient_.end();
-    --it;
-  } else {
-    it = timeToCoefficient_.upper_bound(time);
+  // A time at the last coefficient belongs to the last segment. The storage compares the
+  // times, which may be rounded to its own time keys.
+  it = timeToCoefficient_.upper_bound(time);
+  if (it == timeToCoefficient_.end()) {
+    it = timeToCoefficient_.lower_bound(time);
   }
+  CURVES_INSTRUMENT_COUNT("LocalSupport2CoefficientManager::search");
   if(it == timeToCoefficient_.begin() || it == timeToCoefficient_.end()) {
-    LOG(INFO) << "time, " << time << ", is out of bounds: [" << getMinTime() << ", " << getMaxTime() << "]";
+    CURVES_INSTRUMENT_COUNT("LocalSupport2CoefficientManager::outOfRange");
     return false;
   }
   --it;
@@ -285,51 +504,163 @@ bool LocalSupport2CoefficientManager<Coefficient>::getCoefficientsAt(Time time,
   return true;
 }
 
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::advanceCoefficientsTo(Time time,
+                                                                         CoefficientIter* inOutCoefficient0,
+                                                                         CoefficientIter* inOutCoefficient1) const {
+  CHECK_NOTNULL(inOutCoefficient0);
+  CHECK_NOTNULL(inOutCoefficient1);
+  // Number of segments to walk before a binary search is cheaper.
+  const unsigned int maxSteps = 8;
+
+  CoefficientIter it0 = *inOutCoefficient0;
+  CoefficientIter it1 = *inOutCoefficient1;
+  if (time < it0->first) {
+    return getCoefficientsAt(time, inOutCoefficient0, inOutCoefficient1);
+  }
+
+  const CoefficientIter last = --timeToCoefficient_.end();
+  unsigned int steps = 0;
+  for (; time >= it1->first && it1 != last; ++steps) {
+    if (steps == maxSteps) {
+      CURVES_INSTRUMENT_COUNT("LocalSupport2CoefficientManager::advanceFallback");
+      return getCoefficientsAt(time, inOutCoefficient0, inOutCoefficient1);
+    }
+    it0 = it1;
+    ++it1;
+  }
+  CURVES_INSTRUMENT_VALUE("LocalSupport2CoefficientManager::advanceSteps", steps);
+  if (time > it1->first) {
+    // Past the end, unless the storage rounds time onto the last coefficient.
+    return getCoefficientsAt(time, inOutCoefficient0, inOutCoefficient1);
+  }
+
+  *inOutCoefficient0 = it0;
+  *inOutCoefficient1 = it1;
+  return true;
+}
+
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientsAt(Time time,
+                                                                              Cursor* cursor,
+                                                                              CoefficientIter* outCoefficient0,
+                                                                              CoefficientIter* outCoefficient1) const {
+  if (cursor == NULL) {
+    return getCoefficientsAt(time, outCoefficient0, outCoefficient1);
+  }
+  CHECK_NOTNULL(outCoefficient0);
+  CHECK_NOTNULL(outCoefficient1);
+
+  const size_t revision = getRevision();
+  bool success;
+  if (cursor->valid_ && cursor->revision_ == revision) {
+    CURVES_INSTRUMENT_COUNT("LocalSupport2CoefficientManager::cursorHit");
+    success = advanceCoefficientsTo(time, &cursor->coefficient0_, &cursor->coefficient1_);
+  } else {
+    CURVES_INSTRUMENT_COUNT("LocalSupport2CoefficientManager::cursorMiss");
+    success = getCoefficientsAt(time, &cursor->coefficient0_, &cursor->coefficient1_);
+  }
+  cursor->valid_ = success;
+  cursor->revision_ = revision;
+  if (success) {
+    *outCoefficient0 = cursor->coefficient0_;
+    *outCoefficient1 = cursor->coefficient1_;
+  }
+  return success;
+}
+
+template <class Coefficient, class Storage>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::getRevision() const {
+  return revision_.load(std::memory_order_acquire);
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::incrementRevision() {
+  revision_.store(getNewRevision(), std::memory_order_release);
+  renewCoefficientStamp();
+}
+
+template <class Coefficient, class Storage>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::getNewRevision() {
+  static std::atomic<size_t> lastRevision(0);
+  return lastRevision.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template <class Coefficient, class Storage>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientStamp() const {
+  return coefficientStamp_.load(std::memory_order_acquire);
+}
+
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::renewCoefficientStamp() {
+  coefficientStamp_.store(getNewCoefficientStamp(), std::memory_order_release);
+}
+
+template <class Coefficient, class Storage>
+size_t LocalSupport2CoefficientManager<Coefficient, Storage>::getNewCoefficientStamp() {
+  static std::atomic<size_t> lastStamp(0);
+  return lastStamp.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 /// \brief Get the coefficients that are active within a range \f$[t_s,t_e) \f$.
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::getCoefficientsInRange(
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientsInRange(
     Time startTime, Time endTime, CoefficientMap* outCoefficients) const {
 
-  if (startTime <= endTime && startTime <= this->getMaxTime()
-      && endTime >= this->getMinTime()) {
-    // be forgiving if start time is lower than definition of curve
-    if (startTime < this->getMinTime()) {
-      startTime = this->getMinTime();
-    }
-    // be forgiving if end time is greater than definition of curve
-    if (endTime > this->getMaxTime()) {
-      endTime = this->getMaxTime();
-    }
-    CoefficientIter it;
-    // set iterator to coefficient left or equal of start time
-    it = timeToCoefficient_.upper_bound(startTime);
-    it--;
-    // iterate through coefficients
-    for (; it != timeToCoefficient_.end() && it->first < endTime; ++it) {
-      (*outCoefficients)[it->second->key] = it->second->coefficient;
-    }
-    if (it != timeToCoefficient_.end()) {
-      (*outCoefficients)[it->second->key] = it->second->coefficient;
-    }
+  CHECK_NOTNULL(outCoefficients);
+  const CoefficientRange range = getCoefficientRange(startTime, endTime);
+  for (CoefficientIter it = range.begin(); it != range.end(); ++it) {
+    (*outCoefficients)[it->second.key] = it->second.coefficient;
   }
 }
 
 /// \brief Get all of the curve's coefficients.
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::getCoefficients(CoefficientMap* outCoefficients) const {
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficients(CoefficientMap* outCoefficients) const {
   CHECK_NOTNULL(outCoefficients);
   CoefficientIter it;
   it = timeToCoefficient_.begin();
   for( ; it != timeToCoefficient_.end(); ++it) {
-    (*outCoefficients)[it->second->key] = it->second->coefficient;
+    (*outCoefficients)[it->second.key] = it->second.coefficient;
   }
 }
 
+template <class Coefficient, class Storage>
+typename LocalSupport2CoefficientManager<Coefficient, Storage>::CoefficientRange
+LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientRange(Time startTime, Time endTime) const {
+  if (timeToCoefficient_.empty() || startTime > endTime || startTime > this->getMaxTime()
+      || endTime < this->getMinTime()) {
+    return CoefficientRange(timeToCoefficient_.end(), timeToCoefficient_.end());
+  }
+  // be forgiving if start time is lower than definition of curve
+  if (startTime < this->getMinTime()) {
+    startTime = this->getMinTime();
+  }
+  // be forgiving if end time is greater than definition of curve
+  if (endTime > this->getMaxTime()) {
+    endTime = this->getMaxTime();
+  }
+  // from the coefficient left or equal of start time to the first one at or after end time
+  CoefficientIter begin = timeToCoefficient_.upper_bound(startTime);
+  --begin;
+  CoefficientIter end = timeToCoefficient_.lower_bound(endTime);
+  if (end != timeToCoefficient_.end()) {
+    ++end;
+  }
+  return CoefficientRange(begin, end);
+}
+
+template <class Coefficient, class Storage>
+typename LocalSupport2CoefficientManager<Coefficient, Storage>::CoefficientRange
+LocalSupport2CoefficientManager<Coefficient, Storage>::getCoefficientRange() const {
+  return CoefficientRange(timeToCoefficient_.begin(), timeToCoefficient_.end());
+}
+
 /// \brief Set coefficients.
 ///
 /// If any of these coefficients doen't exist, there is an error
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::updateCoefficients(
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::updateCoefficients(
     const CoefficientMap& coefficients) {
   typename CoefficientMap::const_iterator it;
   it = coefficients.cbegin();
@@ -339,77 +670,71 @@ void LocalSupport2CoefficientManager<Coefficient>::updateCoefficients(
 }
 
 /// \brief return the number of coefficients
-template <class Coefficient>
-Key LocalSupport2CoefficientManager<Coefficient>::size() const {
+template <class Coefficient, class Storage>
+Key LocalSupport2CoefficientManager<Coefficient, Storage>::size() const {
   return timeToCoefficient_.size();
 }
 
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::empty() const {
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::empty() const {
   return timeToCoefficient_.empty();
 }
 
 /// \brief clear the coefficients
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::clear() {
-  keyToCoefficient_.clear();
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::clear() {
   timeToCoefficient_.clear();
+  incrementRevision();
 }
 
-template <class Coefficient>
-Time LocalSupport2CoefficientManager<Coefficient>::getMinTime() const {
+template <class Coefficient, class Storage>
+Time LocalSupport2CoefficientManager<Coefficient, Storage>::getMinTime() const {
   if (timeToCoefficient_.empty()) {
     return 0;
   }
   return timeToCoefficient_.begin()->first;
 }
 
-template <class Coefficient>
-Time LocalSupport2CoefficientManager<Coefficient>::getMaxTime() const {
+template <class Coefficient, class Storage>
+Time LocalSupport2CoefficientManager<Coefficient, Storage>::getMaxTime() const {
   if (timeToCoefficient_.empty()) {
     return 0;
   }
-  return timeToCoefficient_.rbegin()->first;
+  return (--timeToCoefficient_.end())->first;
 }
 
-template <class Coefficient>
-void LocalSupport2CoefficientManager<Coefficient>::checkInternalConsistency(bool doExit) const {
-  CHECK_EQ(keyToCoefficient_.size(), timeToCoefficient_.size());
+template <class Coefficient, class Storage>
+void LocalSupport2CoefficientManager<Coefficient, Storage>::checkInternalConsistency(bool doExit) const {
   CoefficientIter it;
-  typename boost::unordered_map<Key, CoefficientIter>::const_iterator itc;
+  CoefficientIter itc;
   for(it = timeToCoefficient_.begin() ; it != timeToCoefficient_.end(); ++it) {
     Key key = it->second.key;
-    itc = keyToCoefficient_.find(key);
-    CHECK_EQ(itc->first, itc->second->second.key);
-    CHECK( itc != keyToCoefficient_.end() ) << "Key " << key << " is not in the map";
+    itc = timeToCoefficient_.findKey(key);
+    CHECK( itc != timeToCoefficient_.end() ) << "Key " << key << " is not in the map";
     // This is probably the important one.
-    // Check that the itc->second iterator
-    // points to the same object as it->second.
-    // It is supposedly guaranteed by the
-    // unordered map interface that these
-    // pointers never get reallocated.
-    //todo the implementation differs from the comment above. Here only the
-    //equality between coefficients is checked
-    CHECK_EQ(itc->second->second.coefficient, it->second.coefficient);
+    // Check that the key lookup points to the same element as the time lookup.
+    CHECK(itc == it) << "Key " << key << " does not point to its coefficient";
+    CHECK_EQ(itc->first, it->first);
+    CoefficientIter next = it;
+    ++next;
+    if (next != timeToCoefficient_.end()) {
+      CHECK_LT(it->first, next->first) << "Coefficient times are not sorted";
+    }
   }
   if (doExit) {
     exit(0);
   }
 }
 
-template <class Coefficient>
-bool LocalSupport2CoefficientManager<Coefficient>::hasCoefficientAtTime(Time time, CoefficientIter *it, double tol) {
-  for ((*it) = timeToCoefficient_.begin();
-      (*it) != timeToCoefficient_.end(); ++(*it)) {
-    if ((*it)->first >= time-tol) {
-      if ((*it)->first <= time+tol) {
-        return true;
-      } else {
-        return false;
-      }
-    }
+template <class Coefficient, class Storage>
+bool LocalSupport2CoefficientManager<Coefficient, Storage>::hasCoefficientAtTime(Time time, CoefficientIter *it,
+                                                                              double tol) const {
+  if (tol == 0) {
+    *it = timeToCoefficient_.find(time);
+    return *it != timeToCoefficient_.end();
   }
-  return false;
+  *it = timeToCoefficient_.lower_bound(time - tol);
+  return *it != timeToCoefficient_.end() && (*it)->first <= time + tol;
 }
 
 } // namespace
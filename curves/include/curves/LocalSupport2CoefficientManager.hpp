@@ -9,8 +9,13 @@
 #pragma once
 
 #include "curves/Curve.hpp"
+#include "curves/MapCoefficientStorage.hpp"
+#include "curves/ParallelFor.hpp"
+#include "curves/SortedArrayCoefficientStorage.hpp"
 #include <Eigen/Core>
+#include <boost/range/iterator_range.hpp>
 #include <boost/unordered_map.hpp>
+#include <atomic>
 #include <vector>
 #include <map>
 
@@ -18,38 +23,58 @@ namespace curves {
 
 typedef size_t Key;
 
-template <class Coefficient>
+/// \brief Manages the coefficients of curves with a local support of two coefficients.
+///
+/// The Storage policy decides how the coefficients are laid out in memory. The default
+/// MapCoefficientStorage is node based and keeps iterators stable under insertion,
+/// SortedArrayCoefficientStorage keeps them in contiguous arrays for faster lookups
+/// and a smaller footprint on large curves. NanosecondCoefficientStorage does the same
+/// with integer nanosecond times, so that time lookups and hasCoefficientAtTime compare
+/// integers and knots closer than half a nanosecond are merged.
+template <class Coefficient, class Storage = MapCoefficientStorage<Coefficient> >
 class LocalSupport2CoefficientManager {
  public:
   typedef Coefficient CoefficientType;
+  typedef Storage StorageType;
+  typedef typename Storage::KeyCoefficient KeyCoefficient;
 
-  struct KeyCoefficient {
-    Key key;
-    CoefficientType coefficient;
-
-    KeyCoefficient(const Key key, const Coefficient& coefficient) :
-      key(key), coefficient(coefficient) {}
-
-    KeyCoefficient() {};
-
-    bool equals(const KeyCoefficient& other) const {
-      //todo Note: here we assume that == operator is implemented by the coefficient.
-      //Could not use gtsam traits as the gtsam namespace is not visible to this class.
-      //Is this correct?
-      return key == other.key && coefficient == other.coefficient;
-    }
-
-    bool operator==(const KeyCoefficient& other) const {
-      return this->equals(other);
-    }
-  };
-
-  typedef std::map<Time, KeyCoefficient> TimeToKeyCoefficientMap;
-  typedef typename TimeToKeyCoefficientMap::const_iterator CoefficientIter;
+  typedef Storage TimeToKeyCoefficientMap;
+  typedef typename Storage::const_iterator CoefficientIter;
+  /// Consecutive coefficients in time order, a view which does not copy them.
+  typedef boost::iterator_range<CoefficientIter> CoefficientRange;
   /// Key/Coefficient pairs
   typedef boost::unordered_map<size_t, Coefficient> CoefficientMap;
 
+  /// \brief Remembers the active pair of coefficients between two queries.
+  ///
+  /// Queries at increasing times through the same cursor start from the last
+  /// segment instead of searching the whole curve. The cursor stores the
+  /// revision of the manager it was filled from; once coefficients are added,
+  /// moved or removed it is ignored and refilled by a regular search, so it
+  /// never hands out iterators that were invalidated in the meantime. No two
+  /// managers share a revision, so a cursor is not reused with a copy either.
+  ///
+  /// The check only covers changes between two queries. Like the manager itself,
+  /// the cursor must not be used while another thread modifies the manager, see
+  /// ConcurrentCurve::Cursor for that.
+  class Cursor {
+   public:
+    Cursor() : revision_(0), valid_(false) {}
+
+    /// Forget the remembered segment.
+    void reset() { valid_ = false; }
+
+   private:
+    friend class LocalSupport2CoefficientManager;
+    CoefficientIter coefficient0_;
+    CoefficientIter coefficient1_;
+    size_t revision_;
+    bool valid_;
+  };
+
   LocalSupport2CoefficientManager();
+  LocalSupport2CoefficientManager(const LocalSupport2CoefficientManager& other);
+  LocalSupport2CoefficientManager& operator=(const LocalSupport2CoefficientManager& other);
   virtual ~LocalSupport2CoefficientManager();
 
   /// Compare this Coefficient manager with another for equality.
@@ -76,6 +101,15 @@ class LocalSupport2CoefficientManager {
   void modifyCoefficientsValuesInBatch(const std::vector<Time>& times,
                                        const std::vector<Coefficient>& values);
 
+  /// \brief Call update(coefficient) on every coefficient to change it in place.
+  ///
+  /// Nothing is copied or allocated, times, keys and cursors stay valid. Storages with
+  /// random access iterators are split over up to numThreads threads (0 for all hardware
+  /// threads, see parallelFor), others are updated in time order. The calls for different
+  /// coefficients must be independent.
+  template <class Function>
+  void updateCoefficientValues(const Function& update, unsigned int numThreads = 1);
+
 
   /// \brief insert a coefficient at a time and return
   ///        the key for the coefficient
@@ -87,16 +121,31 @@ class LocalSupport2CoefficientManager {
   ///
   /// If outKeys is not NULL, this function will not check if
   /// it is empty; new keys will be appended to this vector.
+  ///
+  /// Strictly increasing times are inserted in bulk: times after the curve are appended
+  /// without lookups, other ones are merged into the storage in a single pass
+  /// (see the storage's insertSorted), instead of one insertion per time.
   void insertCoefficients(const std::vector<Time>& times,
                           const std::vector<Coefficient>& values,
                           std::vector<Key>* outKeys = NULL);
 
+  /// \brief Replace all coefficients by new ones. Optionally returns their keys.
+  ///
+  /// Strictly increasing times are appended to the emptied storage in a single pass,
+  /// without any lookups. Other times fall back to insertCoefficients.
+  void resetCoefficients(const std::vector<Time>& times,
+                         const std::vector<Coefficient>& values,
+                         std::vector<Key>* outKeys = NULL);
+
   /// \brief Efficient function for adding a coefficient at the end of the map
   void addCoefficientAtEnd(Time time, const Coefficient& coefficient, std::vector<Key>* outKeys = NULL);
 
   /// \brief Modify a coefficient by specifying a new time and value
   void modifyCoefficient(typename TimeToKeyCoefficientMap::iterator it, Time time, const Coefficient& coefficient);
 
+  /// \brief Reserve memory for a number of coefficients, if the storage supports it.
+  void reserve(size_t size);
+
   /// \brief Remove the coefficient with this key.
   ///
   /// It is an error if the key does not exist.
@@ -107,6 +156,32 @@ class LocalSupport2CoefficientManager {
   /// It is an error if there is no coefficient at this time.
   void removeCoefficientAtTime(Time time);
 
+  /// \brief Remove the coefficients for which remove(time, coefficient) is true.
+  ///
+  /// remove is called once per coefficient in time order. The coefficients are removed in
+  /// a single pass over the storage and the remaining ones keep their keys. Returns the
+  /// number of removed coefficients.
+  template <class Predicate>
+  size_t removeCoefficientsIf(const Predicate& remove);
+
+  /// \brief Remove all coefficients before this time.
+  ///
+  /// The oldest coefficients are removed in amortized constant time per coefficient
+  /// with SortedArrayCoefficientStorage.
+  void removeCoefficientsBefore(Time time);
+
+  /// \brief Turn the manager into a sliding window over the most recent coefficients.
+  ///
+  /// Whenever a coefficient is added after all others, the oldest coefficients are removed
+  /// until at most maxSize are left and the curve is still defined over the last maxDuration,
+  /// i.e. one coefficient at or before getMaxTime() - maxDuration is kept. The remaining
+  /// coefficients keep their keys. A limit of zero disables it, the default.
+  void setWindow(Time maxDuration, size_t maxSize = 0);
+
+  Time getWindowDuration() const;
+
+  size_t getWindowSize() const;
+
   /// \brief return true if there is a coefficient at this time
   bool hasCoefficientAtTime(Time time) const;
 
@@ -137,6 +212,41 @@ class LocalSupport2CoefficientManager {
   bool getCoefficientsAt(Time time, CoefficientIter* outCoefficient0,
                          CoefficientIter* outCoefficient1) const;
 
+  /// \brief Move a pair of active coefficients forward to a later time.
+  ///
+  /// The pair must have been filled by a previous successful call to getCoefficientsAt
+  /// or advanceCoefficientsTo. The search walks forward from this pair, so evaluating
+  /// sorted times costs O(1) amortized per query. Times before the pair or far ahead
+  /// of it fall back to getCoefficientsAt.
+  ///
+  /// @returns true if it was successful
+  bool advanceCoefficientsTo(Time time, CoefficientIter* inOutCoefficient0,
+                             CoefficientIter* inOutCoefficient1) const;
+
+  /// \brief Get the coefficients that are active at a certain time, starting from a cursor.
+  ///
+  /// If the cursor holds a segment at or before time, the search walks forward from it,
+  /// which is O(1) for monotonic queries. The cursor is updated on success. A NULL
+  /// cursor makes this equivalent to getCoefficientsAt(time, outCoefficient0, outCoefficient1).
+  ///
+  /// @returns true if it was successful
+  bool getCoefficientsAt(Time time, Cursor* cursor, CoefficientIter* outCoefficient0,
+                         CoefficientIter* outCoefficient1) const;
+
+  /// \brief Revision of the structure, renewed by every insertion, move and removal.
+  ///
+  /// Revisions increase and are unique in the process, copies get a new one. Changing
+  /// the value of an existing coefficient does not count as a structural change.
+  size_t getRevision() const;
+
+  /// \brief Stamp identifying the current coefficients, times and values.
+  ///
+  /// Any change, including a change of value, gives the manager a new stamp that no
+  /// manager had before. Copies share the stamp of the original until one of them
+  /// changes. Data derived from the coefficients can be cached along with the stamp.
+  /// Changes made through the non-const iterators are not tracked.
+  size_t getCoefficientStamp() const;
+
   /// \brief Get the coefficients that are active within a range \f$[t_s,t_e) \f$.
   void getCoefficientsInRange(Time startTime,
                               Time endTime,
@@ -145,6 +255,15 @@ class LocalSupport2CoefficientManager {
   /// \brief Get all of the curve's coefficients.
   void getCoefficients(CoefficientMap* outCoefficients) const;
 
+  /// \brief View of the coefficients that are active within a range \f$[t_s,t_e) \f$.
+  ///
+  /// Selects the same coefficients as getCoefficientsInRange, in time order and without
+  /// copying them. The view is invalidated by the same operations as the iterators.
+  CoefficientRange getCoefficientRange(Time startTime, Time endTime) const;
+
+  /// \brief View of all coefficients in time order.
+  CoefficientRange getCoefficientRange() const;
+
   /// \brief Set coefficients.
   ///
   /// If any of these coefficients doen't exist, there is an error
@@ -187,13 +306,43 @@ class LocalSupport2CoefficientManager {
   void checkInternalConsistency(bool doExit = false) const;
 
  private:
-  /// Key to coefficient mapping
-  boost::unordered_map<Key, CoefficientIter> keyToCoefficient_;
+  /// Mark a structural change, invalidating all cursors.
+  void incrementRevision();
+
+  /// A revision no manager has used before.
+  static size_t getNewRevision();
+
+  /// Mark a change of coefficient values.
+  void renewCoefficientStamp();
+
+  /// A stamp no manager has used before.
+  static size_t getNewCoefficientStamp();
 
-  /// Time to coefficient mapping
+  /// Remove the oldest coefficients which are outside of the window.
+  void applyWindow();
+
+  /// Time and key to coefficient mapping
   TimeToKeyCoefficientMap timeToCoefficient_;
 
-  bool hasCoefficientAtTime(Time time, CoefficientIter *it, double tol = 0);
+  /// Revision of the structure, used to validate cursors.
+  std::atomic<size_t> revision_;
+
+  /// Stamp of the current coefficients.
+  std::atomic<size_t> coefficientStamp_;
+
+  /// Window limits, zero if unlimited.
+  Time windowDuration_;
+  size_t windowSize_;
+
+  bool hasCoefficientAtTime(Time time, CoefficientIter *it, double tol = 0) const;
+
+  /// Insert a coefficient at a time that has none yet, under the given key.
+  Key insertNewCoefficient(Time time, const Coefficient& coefficient, Key key);
+
+  /// Insert coefficients one at a time, for times which are not strictly increasing.
+  void insertUnsortedCoefficients(const std::vector<Time>& times,
+                                  const std::vector<Coefficient>& values,
+                                  std::vector<Key>* outKeys);
 
 };
 
@@ -0,0 +1,177 @@
+/*
+ * MapCoefficientStorage.hpp
+ *
+ *  Created on: Oct 10, 2014
+ *      Author: Paul Furgale, Abel Gawel, Renaud Dube, Péter Fankhauser
+ *   Institute: ETH Zurich, Autonomous Systems Lab
+ */
+
+#pragma once
+
+#include "curves/DenseKeyIndex.hpp"
+#include "curves/KeyedCoefficient.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+
+namespace curves {
+
+/// \brief Node based coefficient storage for LocalSupport2CoefficientManager.
+///
+/// Coefficients are kept in a std::map sorted by time, and a DenseKeyIndex of map
+/// iterators gives access by key. Iterators stay valid until the element they point to is erased.
+///
+/// A storage policy provides std::map like iterators (it->first is the time,
+/// it->second the KeyedCoefficient), time and key lookups, and the insert / erase
+/// primitives the manager is built on.
+///
+/// The map allocates its nodes with (a rebind of) Allocator. With a NodePoolAllocator
+/// the nodes freed by erasing coefficients are reused by later insertions.
+template <class Coefficient, class Allocator = std::allocator<KeyedCoefficient<Coefficient> > >
+class MapCoefficientStorage {
+ public:
+  typedef KeyedCoefficient<Coefficient> KeyCoefficient;
+  typedef typename Allocator::template rebind<std::pair<const Time, KeyCoefficient> >::other TimeAllocator;
+  typedef std::map<Time, KeyCoefficient, std::less<Time>, TimeAllocator> TimeToKeyCoefficientMap;
+  typedef typename TimeToKeyCoefficientMap::iterator iterator;
+  typedef typename TimeToKeyCoefficientMap::const_iterator const_iterator;
+
+  MapCoefficientStorage() {}
+
+  MapCoefficientStorage(const MapCoefficientStorage& other) :
+    timeToCoefficient_(other.timeToCoefficient_) {
+    rebuildKeyIndex();
+  }
+
+  MapCoefficientStorage& operator=(const MapCoefficientStorage& other) {
+    if (this != &other) {
+      timeToCoefficient_ = other.timeToCoefficient_;
+      rebuildKeyIndex();
+    }
+    return *this;
+  }
+
+  iterator begin() { return timeToCoefficient_.begin(); }
+  iterator end() { return timeToCoefficient_.end(); }
+  const_iterator begin() const { return timeToCoefficient_.begin(); }
+  const_iterator end() const { return timeToCoefficient_.end(); }
+
+  size_t size() const { return timeToCoefficient_.size(); }
+  bool empty() const { return timeToCoefficient_.empty(); }
+
+  void clear() {
+    keyToCoefficient_.clear();
+    timeToCoefficient_.clear();
+  }
+
+  /// Nodes are allocated one by one, there is nothing to reserve.
+  void reserve(size_t /*size*/) {}
+
+  iterator find(Time time) { return timeToCoefficient_.find(time); }
+  const_iterator find(Time time) const { return timeToCoefficient_.find(time); }
+
+  /// First coefficient at or after time.
+  const_iterator lower_bound(Time time) const { return timeToCoefficient_.lower_bound(time); }
+
+  /// Time a coefficient inserted at time is stored at, times are stored as they are.
+  static Time storedTime(Time time) { return time; }
+
+  /// First coefficient strictly after time.
+  const_iterator upper_bound(Time time) const { return timeToCoefficient_.upper_bound(time); }
+
+  /// Coefficient with this key, end() if there is none.
+  iterator findKey(Key key) {
+    const iterator* it = keyToCoefficient_.find(key);
+    return it == NULL ? timeToCoefficient_.end() : *it;
+  }
+
+  const_iterator findKey(Key key) const {
+    const iterator* it = keyToCoefficient_.find(key);
+    return it == NULL ? timeToCoefficient_.end() : const_iterator(*it);
+  }
+
+  /// Insert a coefficient. There must not be a coefficient at this time yet.
+  iterator insert(Time time, const KeyCoefficient& keyCoefficient) {
+    iterator it = timeToCoefficient_.insert(std::make_pair(time, keyCoefficient)).first;
+    keyToCoefficient_.set(keyCoefficient.key, it);
+    return it;
+  }
+
+  /// Insert a coefficient after all the others in amortized constant time.
+  iterator insertAtEnd(Time time, const KeyCoefficient& keyCoefficient) {
+    iterator it = timeToCoefficient_.insert(timeToCoefficient_.end(), std::make_pair(time, keyCoefficient));
+    keyToCoefficient_.set(keyCoefficient.key, it);
+    return it;
+  }
+
+  /// Insert count coefficients with strictly increasing times, none of which has a
+  /// coefficient yet. Every insertion is hinted with the coefficient following it, so
+  /// this is linear in count and the number of coefficients in between.
+  void insertSorted(const Time* times, const KeyCoefficient* keyCoefficients, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    iterator hint = timeToCoefficient_.lower_bound(times[0]);
+    for (size_t i = 0; i < count; ++i) {
+      while (hint != timeToCoefficient_.end() && hint->first < times[i]) {
+        ++hint;
+      }
+      iterator it = timeToCoefficient_.insert(hint, std::make_pair(times[i], keyCoefficients[i]));
+      keyToCoefficient_.set(keyCoefficients[i].key, it);
+    }
+  }
+
+  /// Move the coefficient at it to a new time and value, keeping its key.
+  iterator move(iterator it, Time time, const Coefficient& coefficient) {
+    const Key key = it->second.key;
+    iterator newIt = timeToCoefficient_.insert(it, std::make_pair(time, KeyCoefficient(key, coefficient)));
+    keyToCoefficient_.set(key, newIt);
+    timeToCoefficient_.erase(it);
+    return newIt;
+  }
+
+  void erase(iterator it) {
+    keyToCoefficient_.erase(it->second.key);
+    timeToCoefficient_.erase(it);
+  }
+
+  /// Erase the count oldest coefficients.
+  void eraseFront(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      erase(timeToCoefficient_.begin());
+    }
+  }
+
+  /// Erase the coefficients for which remove(time, keyCoefficient) is true. It is called
+  /// once per coefficient in time order. Returns the number of erased coefficients.
+  template <class Predicate>
+  size_t eraseIf(const Predicate& remove) {
+    size_t count = 0;
+    for (iterator it = timeToCoefficient_.begin(); it != timeToCoefficient_.end();) {
+      if (remove(it->first, static_cast<const KeyCoefficient&>(it->second))) {
+        keyToCoefficient_.erase(it->second.key);
+        it = timeToCoefficient_.erase(it);
+        ++count;
+      } else {
+        ++it;
+      }
+    }
+    return count;
+  }
+
+ private:
+  void rebuildKeyIndex() {
+    keyToCoefficient_.clear();
+    for (iterator it = timeToCoefficient_.begin(); it != timeToCoefficient_.end(); ++it) {
+      keyToCoefficient_.set(it->second.key, it);
+    }
+  }
+
+  /// Time to coefficient mapping
+  TimeToKeyCoefficientMap timeToCoefficient_;
+
+  /// Key to coefficient mapping
+  DenseKeyIndex<iterator> keyToCoefficient_;
+};
+
+} // namespace
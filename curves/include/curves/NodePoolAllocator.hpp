@@ -0,0 +1,147 @@
+/*
+ * NodePoolAllocator.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace curves {
+
+/// \brief Free list pool for small objects of a few different sizes.
+///
+/// Memory is taken from the heap in chunks and handed out again after it is freed, it is
+/// only returned to the heap when the pool is destroyed. Not thread-safe.
+class NodePool {
+ public:
+  /// Objects larger than this are allocated on the heap directly.
+  static const size_t kMaxObjectSize = 256;
+
+  /// \brief Number of objects of one size allocated from the heap at once.
+  explicit NodePool(size_t objectsPerChunk = 64);
+  ~NodePool();
+
+  void* allocate(size_t size);
+  void deallocate(void* pointer, size_t size);
+
+ private:
+  NodePool(const NodePool&);
+  NodePool& operator=(const NodePool&);
+
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  static const size_t kAlignment = 16;
+  static const size_t kNumSizeClasses = kMaxObjectSize / kAlignment;
+
+  static size_t getSizeClass(size_t size) {
+    return (size + kAlignment - 1) / kAlignment - 1;
+  }
+
+  void addChunk(size_t sizeClass);
+
+  size_t objectsPerChunk_;
+  FreeNode* freeLists_[kNumSizeClasses];
+  std::vector<void*> chunks_;
+};
+
+/// \brief Allocator drawing single objects from a NodePool.
+///
+/// Node based containers allocate one object at a time, these come from the pool, so
+/// erasing and inserting again does not call malloc. Arrays, like the bucket array of a
+/// hash map, are allocated on the heap. The pool is shared by all copies and rebinds of an
+/// allocator, but a copied container gets a new pool, so containers can be used by
+/// different threads.
+template <class T>
+class NodePoolAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  template <class U>
+  struct rebind {
+    typedef NodePoolAllocator<U> other;
+  };
+
+  NodePoolAllocator() :
+      pool_(std::make_shared<NodePool>()) {
+  }
+
+  NodePoolAllocator(const NodePoolAllocator& other) :
+      pool_(other.pool_) {
+  }
+
+  template <class U>
+  NodePoolAllocator(const NodePoolAllocator<U>& other) :
+      pool_(other.pool_) {
+  }
+
+  /// Containers copied with this allocator get a pool of their own.
+  NodePoolAllocator select_on_container_copy_construction() const {
+    return NodePoolAllocator();
+  }
+
+  T* allocate(size_t n, const void* /*hint*/ = 0) {
+    if (n == 1) {
+      return static_cast<T*>(pool_->allocate(sizeof(T)));
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n) {
+    if (n == 1) {
+      pool_->deallocate(pointer, sizeof(T));
+    } else {
+      ::operator delete(pointer);
+    }
+  }
+
+  template <class U, class... Args>
+  void construct(U* pointer, Args&&... args) {
+    ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+  }
+
+  template <class U>
+  void destroy(U* pointer) {
+    pointer->~U();
+  }
+
+  size_t max_size() const {
+    return size_t(-1) / sizeof(T);
+  }
+
+  template <class U>
+  bool operator==(const NodePoolAllocator<U>& other) const {
+    return pool_ == other.pool_;
+  }
+
+  template <class U>
+  bool operator!=(const NodePoolAllocator<U>& other) const {
+    return pool_ != other.pool_;
+  }
+
+ private:
+  template <class U>
+  friend class NodePoolAllocator;
+
+  std::shared_ptr<NodePool> pool_;
+};
+
+} // namespace curves
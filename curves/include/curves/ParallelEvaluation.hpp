@@ -0,0 +1,89 @@
+/*
+ * ParallelEvaluation.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <glog/logging.h>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "curves/Curve.hpp"
+#include "curves/CurveCursor.hpp"
+#include "curves/ParallelFor.hpp"
+
+namespace curves {
+
+/// Number of times evaluated by a thread at once, large enough to hide the thread handling.
+static const size_t kDefaultEvaluationChunkSize = 4096;
+
+/// \brief Evaluate a curve at numTimes times into the preallocated buffer values.
+///
+/// The times are split into chunks which are taken by up to numThreads threads
+/// (0 for all hardware threads), see parallelForChunks. Every chunk is evaluated with
+/// its own CurveCursor, so sorted times only search for the first segment of a chunk.
+/// CurveType has to support CurveCursor. Returns false if any evaluation failed.
+template <class CurveType>
+bool evaluateInParallel(const CurveType& curve, const Time* times, size_t numTimes,
+                        typename CurveType::ValueType* values, unsigned int numThreads = 0,
+                        size_t chunkSize = kDefaultEvaluationChunkSize) {
+  std::atomic<bool> success(true);
+  parallelForChunks(0, numTimes, chunkSize, [&](size_t begin, size_t end) {
+    CurveCursor<CurveType> cursor(curve);
+    bool chunkSuccess = true;
+    for (size_t i = begin; i < end; ++i) {
+      chunkSuccess = cursor.evaluate(values[i], times[i]) && chunkSuccess;
+    }
+    if (!chunkSuccess) {
+      success = false;
+    }
+  }, numThreads);
+  return success;
+}
+
+/// \brief Evaluate a curve at all times, see evaluateInParallel above.
+template <class CurveType>
+bool evaluateInParallel(const CurveType& curve, const std::vector<Time>& times,
+                        std::vector<typename CurveType::ValueType>* values, unsigned int numThreads = 0,
+                        size_t chunkSize = kDefaultEvaluationChunkSize) {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  return evaluateInParallel(curve, times.data(), times.size(), values->data(), numThreads, chunkSize);
+}
+
+/// \brief Evaluate the derivatives of a curve at numTimes times into the preallocated buffer
+///        derivatives, split over threads like evaluateInParallel.
+template <class CurveType>
+bool evaluateDerivativeInParallel(const CurveType& curve, const Time* times, size_t numTimes,
+                                  unsigned int derivativeOrder, typename CurveType::DerivativeType* derivatives,
+                                  unsigned int numThreads = 0, size_t chunkSize = kDefaultEvaluationChunkSize) {
+  std::atomic<bool> success(true);
+  parallelForChunks(0, numTimes, chunkSize, [&](size_t begin, size_t end) {
+    CurveCursor<CurveType> cursor(curve);
+    bool chunkSuccess = true;
+    for (size_t i = begin; i < end; ++i) {
+      chunkSuccess = cursor.evaluateDerivative(derivatives[i], times[i], derivativeOrder) && chunkSuccess;
+    }
+    if (!chunkSuccess) {
+      success = false;
+    }
+  }, numThreads);
+  return success;
+}
+
+/// \brief Evaluate the derivatives of a curve at all times, see evaluateDerivativeInParallel above.
+template <class CurveType>
+bool evaluateDerivativeInParallel(const CurveType& curve, const std::vector<Time>& times,
+                                  unsigned int derivativeOrder,
+                                  std::vector<typename CurveType::DerivativeType>* derivatives,
+                                  unsigned int numThreads = 0, size_t chunkSize = kDefaultEvaluationChunkSize) {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  return evaluateDerivativeInParallel(curve, times.data(), times.size(), derivativeOrder, derivatives->data(),
+                                      numThreads, chunkSize);
+}
+
+} // namespace curves
@@ -0,0 +1,96 @@
+/*
+ * ParallelFor.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace curves {
+
+/// \brief Number of threads to use for a requested thread count, 0 meaning all hardware threads.
+inline unsigned int getNumberOfThreads(unsigned int numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::thread::hardware_concurrency();
+  }
+  return std::max(numThreads, 1u);
+}
+
+/// \brief Call function(i) for every i in [begin, end) on up to numThreads threads.
+///
+/// The range is split into one contiguous block per thread, the first block runs in the
+/// calling thread. No more threads are started than there are blocks of at least
+/// minBlockSize indices, so small ranges run serially. numThreads = 0 uses all hardware
+/// threads. The calls for different i must be independent and must not throw.
+template <class Function>
+void parallelFor(size_t begin, size_t end, const Function& function,
+                 unsigned int numThreads = 0, size_t minBlockSize = 1024) {
+  if (end <= begin) {
+    return;
+  }
+  const size_t count = end - begin;
+  const size_t numBlocks = std::max<size_t>(1, std::min<size_t>(getNumberOfThreads(numThreads),
+                                                                count / std::max<size_t>(minBlockSize, 1)));
+  const size_t blockSize = (count + numBlocks - 1) / numBlocks;
+
+  std::vector<std::thread> threads;
+  threads.reserve(numBlocks - 1);
+  for (size_t blockBegin = begin + blockSize; blockBegin < end; blockBegin += blockSize) {
+    const size_t blockEnd = std::min(blockBegin + blockSize, end);
+    threads.push_back(std::thread([&function, blockBegin, blockEnd]() {
+      for (size_t i = blockBegin; i < blockEnd; ++i) {
+        function(i);
+      }
+    }));
+  }
+  const size_t firstBlockEnd = std::min(begin + blockSize, end);
+  for (size_t i = begin; i < firstBlockEnd; ++i) {
+    function(i);
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+
+/// \brief Call function(chunkBegin, chunkEnd) for chunks of chunkSize indices of [begin, end)
+///        on up to numThreads threads.
+///
+/// Threads take the next unprocessed chunk until none is left, so threads finishing early
+/// take over the work of slower ones. The calling thread processes chunks as well and no
+/// more threads are started than there are chunks. numThreads = 0 uses all hardware
+/// threads. The calls for different chunks must be independent and must not throw.
+template <class Function>
+void parallelForChunks(size_t begin, size_t end, size_t chunkSize, const Function& function,
+                       unsigned int numThreads = 0) {
+  if (end <= begin) {
+    return;
+  }
+  chunkSize = std::max<size_t>(chunkSize, 1);
+  const size_t numChunks = (end - begin + chunkSize - 1) / chunkSize;
+  std::atomic<size_t> nextChunk(0);
+  const auto processChunks = [&]() {
+    for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+      const size_t chunkBegin = begin + chunk * chunkSize;
+      function(chunkBegin, std::min(chunkBegin + chunkSize, end));
+    }
+  };
+
+  const size_t numWorkers = std::min<size_t>(getNumberOfThreads(numThreads), numChunks);
+  std::vector<std::thread> threads;
+  threads.reserve(numWorkers - 1);
+  for (size_t i = 1; i < numWorkers; ++i) {
+    threads.push_back(std::thread(processChunks));
+  }
+  processChunks();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+}
+
+} // namespace curves
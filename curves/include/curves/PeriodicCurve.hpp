@@ -0,0 +1,174 @@
+/*
+ * PeriodicCurve.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <glog/logging.h>
+#include <cmath>
+#include <vector>
+
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// \brief Evaluates a curve periodically, repeating [getMinTime(), getMaxTime()) forever.
+///
+/// Any time is mapped into the base period of the curve with one fmod, so many cycles, e.g.
+/// of a gait, are evaluated without unrolling the curve into more knots. The curve is best
+/// fitted with matching ends, like CubicHermiteSE3Curve::fitPeriodicCurve does, the end of
+/// the period evaluates to the start. The wrapper refers to the curve and follows changes of
+/// its time range.
+///
+/// CurveType has to provide evaluate() and evaluateDerivative(), single and batched, like
+/// CubicHermiteE3Curve, CubicHermiteSE3Curve and PolynomialSplineQuinticVector3Curve.
+template <class CurveType>
+class PeriodicCurve {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  explicit PeriodicCurve(const CurveType& curve) : curve_(curve) {}
+
+  /// The duration of one period.
+  Time getPeriod() const {
+    return curve_.getMaxTime() - curve_.getMinTime();
+  }
+
+  /// Map time into [getMinTime(), getMaxTime()) of the curve.
+  Time wrapTime(Time time) const {
+    const Time minTime = curve_.getMinTime();
+    const Time period = curve_.getMaxTime() - minTime;
+    Time offset = std::fmod(time - minTime, period);
+    if (offset < 0.0) {
+      offset += period;
+    }
+    // Rounding of the addition above may land on the end of the period.
+    return offset < period ? minTime + offset : minTime;
+  }
+
+  /// Evaluate the curve at the wrapped time. Returns false if the period is empty.
+  bool evaluate(ValueType& value, Time time) const {
+    return getPeriod() > 0.0 && curve_.evaluate(value, wrapTime(time));
+  }
+
+  /// Evaluate the curve derivatives at the wrapped time.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder) const {
+    return getPeriod() > 0.0 && curve_.evaluateDerivative(derivative, wrapTime(time), derivativeOrder);
+  }
+
+  /// Evaluate the curve at many times, possibly over many cycles, with one batched evaluation
+  /// of the curve. Sorted times only search for a segment once per cycle.
+  bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+    CHECK_NOTNULL(values);
+    std::vector<Time> wrappedTimes;
+    if (!wrapTimes(times, &wrappedTimes)) {
+      values->resize(times.size());
+      return false;
+    }
+    return curve_.evaluate(wrappedTimes, values);
+  }
+
+  /// Evaluate the curve derivatives at many times, see evaluate above.
+  bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                          unsigned int derivativeOrder) const {
+    CHECK_NOTNULL(derivatives);
+    std::vector<Time> wrappedTimes;
+    if (!wrapTimes(times, &wrappedTimes)) {
+      derivatives->resize(times.size());
+      return false;
+    }
+    return curve_.evaluateDerivative(wrappedTimes, derivatives, derivativeOrder);
+  }
+
+  const CurveType& getCurve() const {
+    return curve_;
+  }
+
+ private:
+  bool wrapTimes(const std::vector<Time>& times, std::vector<Time>* wrappedTimes) const {
+    if (!(getPeriod() > 0.0)) {
+      return false;
+    }
+    wrappedTimes->resize(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+      (*wrappedTimes)[i] = wrapTime(times[i]);
+    }
+    return true;
+  }
+
+  const CurveType& curve_;
+};
+
+/// \brief Evaluates a periodic curve at increasing times without searching for every query.
+///
+/// Like CurveCursor, but when the wrapped time jumps back into an earlier cycle, the cursor
+/// restarts from a copy positioned at the first segment instead of searching, so walking
+/// over many cycles never searches the coefficients. The cursor is not shared between threads.
+///
+/// CurveType has to support CurveCursor, like CubicHermiteSE3Curve, CubicHermiteE3Curve
+/// and SlerpSE3Curve.
+template <class CurveType>
+class PeriodicCurveCursor {
+ public:
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  explicit PeriodicCurveCursor(const PeriodicCurve<CurveType>& curve)
+      : curve_(curve), lastTime_(0.0), hasLastTime_(false), hasStartCursor_(false) {}
+
+  /// Evaluate the ambient space of the curve.
+  bool evaluate(ValueType& value, Time time) {
+    Time wrappedTime;
+    return prepare(time, &wrappedTime) && curve_.getCurve().evaluate(value, wrappedTime, &cursor_);
+  }
+
+  /// Evaluate the curve derivatives.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned int derivativeOrder) {
+    Time wrappedTime;
+    return prepare(time, &wrappedTime)
+        && curve_.getCurve().evaluateDerivative(derivative, wrappedTime, derivativeOrder, &cursor_);
+  }
+
+  /// Forget the remembered segments, e.g. after the curve was refitted.
+  void reset() {
+    cursor_.reset();
+    startCursor_.reset();
+    hasLastTime_ = false;
+    hasStartCursor_ = false;
+  }
+
+ private:
+  /// Wrap the time and restart the cursor at the first segment if it went back.
+  bool prepare(Time time, Time* wrappedTime) {
+    if (!(curve_.getPeriod() > 0.0)) {
+      return false;
+    }
+    *wrappedTime = curve_.wrapTime(time);
+    if (hasLastTime_ && *wrappedTime < lastTime_) {
+      if (!hasStartCursor_) {
+        ValueType value;
+        hasStartCursor_ = curve_.getCurve().evaluate(value, curve_.getCurve().getMinTime(), &startCursor_);
+      }
+      if (hasStartCursor_) {
+        cursor_ = startCursor_;
+      }
+    }
+    lastTime_ = *wrappedTime;
+    hasLastTime_ = true;
+    return true;
+  }
+
+  const PeriodicCurve<CurveType>& curve_;
+  typename CurveType::CoefficientCursor cursor_;
+
+  /// Positioned at the first segment, copied into cursor_ when wrapping around.
+  typename CurveType::CoefficientCursor startCursor_;
+  Time lastTime_;
+  bool hasLastTime_;
+  bool hasStartCursor_;
+};
+
+} // namespace curves
@@ -0,0 +1,965 @@
+/*
+ * PolynomialSplineContainer-inl.hpp
+ *
+ *  Created on: Dec 8, 2014
+ *      Author: C. Dario Bellicoso, Peter Fankhauser
+ */
+
+#include "curves/PolynomialSplineContainer.hpp"
+#include "curves/Instrumentation.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+// boost
+#include <boost/math/special_functions/pow.hpp>
+
+namespace curves {
+
+template <typename SplineType_>
+constexpr double PolynomialSplineContainerT<SplineType_>::undefinedValue;
+
+template <typename SplineType_>
+constexpr unsigned int PolynomialSplineContainerT<SplineType_>::continuityOrder;
+
+
+template <typename SplineType_>
+PolynomialSplineContainerT<SplineType_>::PolynomialSplineContainerT():
+    timeOffset_(0.0),
+    containerTime_(0.0),
+    containerDuration_(0.0),
+    activeSplineIdx_(0),
+    uniformSplineDuration_(0.0),
+    lastActiveSplineIdx_(0),
+    solverType_(SolverType::DenseQR)
+{
+  // Make sure that the container is correctly emptied
+  reset();
+}
+
+template <typename SplineType_>
+PolynomialSplineContainerT<SplineType_>::PolynomialSplineContainerT(const PolynomialSplineContainerT& other):
+    splines_(other.splines_),
+    timeOffset_(other.timeOffset_),
+    containerTime_(other.containerTime_),
+    containerDuration_(other.containerDuration_),
+    activeSplineIdx_(other.activeSplineIdx_),
+    splineStartTimes_(other.splineStartTimes_),
+    splineBounds_(other.splineBounds_),
+    modifiedSplines_(other.modifiedSplines_),
+    uniformSplineDuration_(other.uniformSplineDuration_),
+    lastActiveSplineIdx_(0),
+    solverType_(other.solverType_),
+    factorization_(other.factorization_)
+{
+
+}
+
+template <typename SplineType_>
+PolynomialSplineContainerT<SplineType_>& PolynomialSplineContainerT<SplineType_>::operator=(const PolynomialSplineContainerT& other)
+{
+  splines_ = other.splines_;
+  splineStartTimes_ = other.splineStartTimes_;
+  splineBounds_ = other.splineBounds_;
+  modifiedSplines_ = other.modifiedSplines_;
+  uniformSplineDuration_ = other.uniformSplineDuration_;
+  lastActiveSplineIdx_.store(0, std::memory_order_relaxed);
+  timeOffset_ = other.timeOffset_;
+  containerTime_ = other.containerTime_;
+  containerDuration_ = other.containerDuration_;
+  activeSplineIdx_ = other.activeSplineIdx_;
+  solverType_ = other.solverType_;
+  factorization_ = other.factorization_;
+  return *this;
+}
+
+
+template <typename SplineType_>
+PolynomialSplineContainerT<SplineType_>::~PolynomialSplineContainerT()
+{
+  // TODO Auto-generated destructor stub
+}
+
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::advance(double dt)
+{
+  // Check container size
+//  if (containerSize == 0 || containerSize == activeSplineIdx_) {
+////    throw std::runtime_error("splinecontainer::advance");
+//    return false;
+//  }
+
+  if (splines_.empty() || containerTime_ >= containerDuration_ || activeSplineIdx_ == static_cast<int>(splines_.size())) {
+    return false;
+  }
+
+//  // Advance time from 0 to tf
+//  if (time_ < splines_[activeSplineIdx_].getSplineDuration()) {
+//    time_ += dt;
+//  } else {
+//    // Reset time
+//    time_ = 0.0;
+//    timeOffset_ += splines_[activeSplineIdx_].getSplineDuration();
+//    activeSplineIdx_++;
+//  }
+
+  containerTime_ += dt;
+
+  const double activeSplineDuration = getSplines()[activeSplineIdx_].getSplineDuration();
+  if ((containerTime_ - timeOffset_ >= activeSplineDuration)) {
+    if (activeSplineIdx_ < static_cast<int>(splines_.size()) - 1) {
+      timeOffset_ += activeSplineDuration;
+    }
+    activeSplineIdx_++;
+  }
+
+  return true;
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setContainerTime(double t)
+{
+  containerTime_ = t;
+  activeSplineIdx_ = getActiveSplineIndexAtTime(t, timeOffset_);
+}
+
+/*
+ * aijh:
+ *  i --> spline id (1,...,n)
+ *  j --> spline coefficient aj (a5,...,a1,a0)
+ *  h --> dimX, dimY
+ *
+ * Coefficient vector is:
+ *    q = [a15x a14x ... a10x a15y ... a10y a25x ... a20y ... an5x ... an0y]
+ */
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::getCoeffIndex(int splineIdx, int aIdx) const {
+  return splineIdx*SplineType::coefficientCount + aIdx;
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::getSplineColumnIndex(int splineIdx) const
+{
+  return getCoeffIndex(splineIdx, 0);
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setData(const std::vector<double>& knotPositions,
+                                                      const std::vector<double>& knotValues,
+                                                      double initialVelocity, double initialAcceleration,
+                                                      double finalVelocity, double finalAcceleration) {
+  CURVES_INSTRUMENT_SCOPE_UNITS("PolynomialSplineContainer::setData", knotPositions.size());
+  reset();
+
+  std::vector<double> tfs;// (num_splines);
+  for (unsigned int i=0; i<knotPositions.size()-1; i++) {
+    tfs.push_back(knotPositions[i+1]-knotPositions[i]);
+  }
+
+  const std::shared_ptr<const ConstraintFactorization> factorization = getFactorization(tfs);
+
+  Eigen::MatrixXd b(factorization->getNumConstraints(), 1);
+  getConstraintValues(Eigen::Map<const Eigen::VectorXd>(knotValues.data(), knotValues.size()),
+                      initialVelocity, initialAcceleration, finalVelocity, finalAcceleration, b.col(0));
+
+  const Eigen::MatrixXd coeffs = factorization->solve(b);
+  setSplines(tfs, coeffs.col(0));
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setData(const std::vector<double>& knotPositions,
+                                                      const std::vector<double>& knotValues,
+                                                      const std::vector<double>& knotVelocities,
+                                                      const std::vector<double>& knotAccelerations) {
+  if (knotValues.size() != knotPositions.size() || knotVelocities.size() != knotPositions.size() ||
+      knotAccelerations.size() != knotPositions.size()) {
+    throw std::invalid_argument("PolynomialSplineContainerT::setData: inconsistent number of knots.");
+  }
+  reset();
+  if (knotPositions.size() < 2) {
+    return;
+  }
+
+  splines_.reserve(knotPositions.size() - 1);
+  splineStartTimes_.reserve(knotPositions.size() - 1);
+  for (unsigned int i=0; i<knotPositions.size()-1; i++) {
+    const SplineOptions options(knotPositions[i+1]-knotPositions[i],
+                                knotValues[i], knotValues[i+1],
+                                knotVelocities[i], knotVelocities[i+1],
+                                knotAccelerations[i], knotAccelerations[i+1]);
+    SplineType spline;
+    spline.computeCoefficients(options);
+    addSpline(std::move(spline));
+  }
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setData(const std::vector<double>& knotPositions,
+                                                      const Eigen::MatrixXd& knotValues,
+                                                      const Eigen::VectorXd& initialVelocities,
+                                                      const Eigen::VectorXd& initialAccelerations,
+                                                      const Eigen::VectorXd& finalVelocities,
+                                                      const Eigen::VectorXd& finalAccelerations,
+                                                      const std::vector<PolynomialSplineContainerT*>& containers) {
+  if (containers.empty()) {
+    return;
+  }
+  const Eigen::Index numKnots = knotPositions.size();
+  const Eigen::Index numContainers = containers.size();
+  if (knotValues.rows() != numKnots || knotValues.cols() != numContainers ||
+      initialVelocities.size() != numContainers || initialAccelerations.size() != numContainers ||
+      finalVelocities.size() != numContainers || finalAccelerations.size() != numContainers) {
+    throw std::invalid_argument("PolynomialSplineContainerT::setData: inconsistent number of knots or containers.");
+  }
+  CURVES_INSTRUMENT_SCOPE_UNITS("PolynomialSplineContainer::setDataMultiple", knotPositions.size() * containers.size());
+
+  std::vector<double> tfs;// (num_splines);
+  for (unsigned int i=0; i<knotPositions.size()-1; i++) {
+    tfs.push_back(knotPositions[i+1]-knotPositions[i]);
+  }
+
+  // The constraint matrix only depends on the knot positions, all containers share its factorization.
+  PolynomialSplineContainerT& solverContainer = *containers.front();
+  const std::shared_ptr<const ConstraintFactorization> factorization = solverContainer.getFactorization(tfs);
+
+  Eigen::MatrixXd b(factorization->getNumConstraints(), containers.size());
+  for (unsigned int j = 0; j < containers.size(); j++) {
+    solverContainer.getConstraintValues(knotValues.col(j), initialVelocities(j), initialAccelerations(j),
+                                        finalVelocities(j), finalAccelerations(j), b.col(j));
+  }
+
+  const Eigen::MatrixXd coeffs = factorization->solve(b);
+  for (unsigned int j = 0; j < containers.size(); j++) {
+    containers[j]->factorization_ = factorization;
+    containers[j]->reset();
+    containers[j]->setSplines(tfs, coeffs.col(j));
+  }
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::appendKnot(double duration, double knotValue,
+                                                         double finalVelocity, double finalAcceleration,
+                                                         unsigned int tailWindow) {
+  if (splines_.empty() || !(duration > 0.0)) {
+    return false;
+  }
+
+  const unsigned int num_tail_splines = std::min<size_t>(tailWindow, splines_.size());
+  if (num_tail_splines == 0) {
+    SplineType spline;
+    spline.computeCoefficients(SplineOptions(duration, getEndPosition(), knotValue, getEndVelocity(),
+                                             finalVelocity, getEndAcceleration(), finalAcceleration));
+    return addSpline(std::move(spline));
+  }
+
+  // Fit the tail splines and the new one again, starting from the state at the beginning of the tail.
+  const unsigned int first_tail_spline = splines_.size() - num_tail_splines;
+  std::vector<double> tfs;
+  Eigen::VectorXd knotValues(num_tail_splines + 2);
+  const SplineList& splines = getSplines();
+  for (unsigned int i = first_tail_spline; i < splines.size(); i++) {
+    tfs.push_back(splines[i].getSplineDuration());
+    knotValues(i - first_tail_spline) = splines[i].getPositionAtTime(0.0);
+  }
+  tfs.push_back(duration);
+  knotValues(num_tail_splines) = getEndPosition();
+  knotValues(num_tail_splines + 1) = knotValue;
+  const double initialVelocity = splines[first_tail_spline].getVelocityAtTime(0.0);
+  const double initialAcceleration = splines[first_tail_spline].getAccelerationAtTime(0.0);
+
+  const std::shared_ptr<const ConstraintFactorization> factorization = getFactorization(tfs);
+  Eigen::MatrixXd b(factorization->getNumConstraints(), 1);
+  getConstraintValues(knotValues, initialVelocity, initialAcceleration, finalVelocity, finalAcceleration, b.col(0));
+  const Eigen::MatrixXd coeffs = factorization->solve(b);
+
+  containerDuration_ = splineStartTimes_[first_tail_spline];
+  splines_.resize(first_tail_spline);
+  splineStartTimes_.resize(first_tail_spline);
+  splineBounds_.resize(first_tail_spline);
+  modifiedSplines_.resize(first_tail_spline);
+  setSplines(tfs, coeffs.col(0));
+  return true;
+}
+
+template <typename SplineType_>
+PolynomialSplineContainerT<SplineType_>::ConstraintFactorization::ConstraintFactorization(
+    const Eigen::SparseMatrix<double>& A, const std::vector<double>& tfs, SolverType solverType) :
+    tfs_(tfs),
+    solverType_(solverType),
+    numConstraints_(A.rows()),
+    useSparse_(false)
+{
+  const unsigned int num_splines = tfs.size();
+  constexpr auto num_coeffs_spline = SplineType::coefficientCount;
+  const unsigned int num_coeffs = num_splines*num_coeffs_spline;
+
+  if (solverType_ == SolverType::SparseMinimumNorm) {
+    // The system is underdetermined. Its minimum norm solution is x = A^T (A A^T)^-1 b.
+    // Every constraint involves at most two neighbouring splines, so A A^T is banded
+    // and its factorization is linear in the number of splines. The coefficients are
+    // expressed in the normalized spline time t/tf and the constraints scaled to unit
+    // norm, which keeps A A^T well conditioned for any spline duration.
+    columnScale_.resize(num_coeffs);
+    for (unsigned int i = 0; i < num_splines; i++) {
+      for (unsigned int k = 0; k < num_coeffs_spline; k++) {
+        columnScale_(i*num_coeffs_spline + k) =
+            tfs[i] > 0.0 ? std::pow(tfs[i], -int(num_coeffs_spline - 1 - k)) : 1.0;
+      }
+    }
+    scaledA_ = A * columnScale_.asDiagonal();
+    rowScale_ = Eigen::VectorXd::Zero(scaledA_.rows());
+    for (int col = 0; col < scaledA_.outerSize(); ++col) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(scaledA_, col); it; ++it) {
+        rowScale_(it.row()) += it.value()*it.value();
+      }
+    }
+    rowScale_ = rowScale_.cwiseSqrt().cwiseInverse();
+    scaledA_ = rowScale_.asDiagonal() * scaledA_;
+
+    sparseSolver_.compute(scaledA_ * scaledA_.transpose());
+    useSparse_ = (sparseSolver_.info() == Eigen::Success);
+    if (useSparse_) {
+      return;
+    }
+    std::cerr << "PolynomialSplineContainerT::setData: sparse factorization failed, using dense QR." << std::endl;
+  }
+
+  denseSolver_.compute(Eigen::MatrixXd(A));
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::ConstraintFactorization::matches(const std::vector<double>& tfs,
+                                                                               SolverType solverType) const
+{
+  return solverType == solverType_ && tfs == tfs_;
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::ConstraintFactorization::getNumConstraints() const
+{
+  return numConstraints_;
+}
+
+template <typename SplineType_>
+Eigen::MatrixXd PolynomialSplineContainerT<SplineType_>::ConstraintFactorization::solve(const Eigen::MatrixXd& b) const
+{
+  if (useSparse_) {
+    const Eigen::MatrixXd scaledB = rowScale_.asDiagonal() * b;
+    return columnScale_.asDiagonal() * (scaledA_.transpose() * sparseSolver_.solve(scaledB));
+  }
+  return denseSolver_.solve(b);
+}
+
+template <typename SplineType_>
+std::shared_ptr<const typename PolynomialSplineContainerT<SplineType_>::ConstraintFactorization>
+PolynomialSplineContainerT<SplineType_>::getFactorization(const std::vector<double>& tfs)
+{
+  if (!factorization_ || !factorization_->matches(tfs, solverType_)) {
+    CURVES_INSTRUMENT_SCOPE_UNITS("PolynomialSplineContainer::factorize", tfs.size());
+    Eigen::SparseMatrix<double> A;
+    getConstraintMatrix(tfs, A);
+    factorization_ = std::make_shared<const ConstraintFactorization>(A, tfs, solverType_);
+  }
+  return factorization_;
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setSplines(const std::vector<double>& tfs,
+                                                         const Eigen::Ref<const Eigen::VectorXd>& coeffs) {
+  constexpr auto num_coeffs_spline = SplineType::coefficientCount;
+  SplineType spline;
+
+  splines_.reserve(tfs.size());
+  splineStartTimes_.reserve(tfs.size());
+  for (unsigned int i = 0; i <tfs.size(); i++) {
+    spline.setCoefficientsAndDuration(coeffs.segment<num_coeffs_spline>(getSplineColumnIndex(i)), tfs[i]);
+    this->addSpline(spline);
+  }
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getDerivativeTimeVector(unsigned int derivativeOrder, double tk,
+                                                                      TimeVectorType& timeVec) {
+  constexpr unsigned int order = SplineType::splineOrder;
+  for (unsigned int k = 0; k < SplineType::coefficientCount; k++) {
+    // Coefficient k belongs to t^(order-k).
+    const unsigned int power = order - k;
+    if (power < derivativeOrder) {
+      timeVec(k) = 0.0;
+      continue;
+    }
+    double factor = 1.0;
+    for (unsigned int d = 0; d < derivativeOrder; d++) {
+      factor *= power - d;
+    }
+    timeVec(k) = factor*std::pow(tk, int(power - derivativeOrder));
+  }
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getConstraintMatrix(const std::vector<double>& tfs,
+                                                                  Eigen::SparseMatrix<double>& A) const {
+  const unsigned int num_splines = tfs.size();
+  constexpr auto num_coeffs_spline = SplineType::coefficientCount;
+  const unsigned int num_coeffs = num_splines*num_coeffs_spline;
+
+  const unsigned int num_constraints = getNumConstraints(num_splines);
+
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(num_constraints*2*num_coeffs_spline);
+
+  // Adds the row vector scale*timeVec at (row, first coefficient of spline splineIdx).
+  auto setBlock = [&triplets, this](int row, int splineIdx, const TimeVectorType& timeVec,
+                                    double scale) {
+    for (unsigned int k = 0; k < num_coeffs_spline; k++) {
+      if (timeVec(k) != 0.0) {
+        triplets.push_back(Eigen::Triplet<double>(row, getSplineColumnIndex(splineIdx) + k, scale*timeVec(k)));
+      }
+    }
+  };
+
+  // time containers
+  std::array<TimeVectorType, continuityOrder + 1> timeVecs, timeVecsTf;
+  for (unsigned int d = 0; d <= continuityOrder; d++) {
+    getDerivativeTimeVector(d, 0.0, timeVecs[d]);
+  }
+
+  // Initial conditions: position and derivatives up to the continuity order
+  int constraintIdx = 0;
+  for (unsigned int d = 0; d <= continuityOrder; d++) {
+    setBlock(constraintIdx++, 0, timeVecs[d], 1.0);
+  }
+
+  // Final conditions
+  for (unsigned int d = 0; d <= continuityOrder; d++) {
+    getDerivativeTimeVector(d, tfs.back(), timeVecsTf[d]);
+    setBlock(constraintIdx++, num_splines-1, timeVecsTf[d], 1.0);
+  }
+  /***************************/
+
+
+  /**********************************
+   * Set spline junction conditions *
+   **********************************/
+  for (size_t k=0; k<num_splines-1; k++) {
+
+    const int prevSplineId = k;
+    const int nextSplineId = k+1;
+
+    for (unsigned int d = 0; d <= continuityOrder; d++) {
+      getDerivativeTimeVector(d, tfs[k], timeVecsTf[d]);
+    }
+
+    // Position at the end of the previous and at the start of the next spline
+    setBlock(constraintIdx++, prevSplineId, timeVecsTf[0], 1.0);
+    setBlock(constraintIdx++, nextSplineId, timeVecs[0], 1.0);
+
+    // Continuous derivatives, velocity and acceleration for quintic splines
+    for (unsigned int d = 1; d <= continuityOrder; d++) {
+      setBlock(constraintIdx, prevSplineId, timeVecsTf[d], 1.0);
+      setBlock(constraintIdx++, nextSplineId, timeVecs[d], -1.0);
+    }
+  }
+  /**********************************/
+
+  A.resize(num_constraints, num_coeffs);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getConstraintValues(const Eigen::Ref<const Eigen::VectorXd>& knotValues,
+                                                                  double initialVelocity, double initialAcceleration,
+                                                                  double finalVelocity, double finalAcceleration,
+                                                                  Eigen::Ref<Eigen::VectorXd> b) const {
+  // Same constraint order as in getConstraintMatrix.
+  const unsigned int num_splines = knotValues.size()-1;
+  const double initialDerivatives[] = {initialVelocity, initialAcceleration};
+  const double finalDerivatives[] = {finalVelocity, finalAcceleration};
+  b.setZero();
+  int constraintIdx = 0;
+  b(constraintIdx++) = knotValues(0);
+  for (unsigned int d = 1; d <= continuityOrder; d++) {
+    b(constraintIdx++) = d <= 2 ? initialDerivatives[d-1] : 0.0;
+  }
+  b(constraintIdx++) = knotValues(num_splines);
+  for (unsigned int d = 1; d <= continuityOrder; d++) {
+    b(constraintIdx++) = d <= 2 ? finalDerivatives[d-1] : 0.0;
+  }
+  for (size_t k=0; k<num_splines-1; k++) {
+    b(constraintIdx++) = knotValues(k+1);
+    b(constraintIdx++) = knotValues(k+1);
+    constraintIdx += continuityOrder;
+  }
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::setSolverType(SolverType solverType) {
+  solverType_ = solverType;
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::SolverType PolynomialSplineContainerT<SplineType_>::getSolverType() const {
+  return solverType_;
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::getActiveSplineIndex() const
+{
+  return activeSplineIdx_;
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::addSpline(const SplineType& spline)
+{
+  updateUniformSplineDuration(spline.getSplineDuration());
+  splines_.push_back(spline);
+  splineStartTimes_.push_back(containerDuration_);
+  splineBounds_.push_back(computeSplineBounds(spline, 0.0, spline.getSplineDuration()));
+  modifiedSplines_.push_back(false);
+  containerDuration_ += spline.getSplineDuration();
+  return true;
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::addSpline(SplineType&& spline) {
+  updateUniformSplineDuration(spline.getSplineDuration());
+  splineStartTimes_.push_back(containerDuration_);
+  containerDuration_ += spline.getSplineDuration();
+  splineBounds_.push_back(computeSplineBounds(spline, 0.0, spline.getSplineDuration()));
+  modifiedSplines_.push_back(false);
+  splines_.emplace_back(spline);
+  return true;
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::updateUniformSplineDuration(double splineDuration) {
+  if (splines_.empty()) {
+    uniformSplineDuration_ = splineDuration > 0.0 ? splineDuration : 0.0;
+  } else if (std::abs(splineDuration - uniformSplineDuration_) > 1e-9 * uniformSplineDuration_) {
+    uniformSplineDuration_ = 0.0;
+  }
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::reset()
+{
+  splines_.clear();
+  splineStartTimes_.clear();
+  splineBounds_.clear();
+  modifiedSplines_.clear();
+  uniformSplineDuration_ = 0.0;
+  lastActiveSplineIdx_.store(0, std::memory_order_relaxed);
+  activeSplineIdx_ = 0;
+  containerDuration_ = 0.0;
+  resetTime();
+  return true;
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::resetTime()
+{
+  timeOffset_ = 0.0;
+  containerTime_ = 0.0;
+  activeSplineIdx_ = 0;
+  return true;
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getContainerDuration() const
+{
+  return containerDuration_;
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::SplineType* PolynomialSplineContainerT<SplineType_>::getSpline(int splineIndex)
+{
+  SplineType* spline = &splines_.at(splineIndex);
+  modifiedSplines_[splineIndex] = true;
+  return spline;
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getContainerTime() const
+{
+  return containerTime_;
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::isEmpty() const
+{
+  return splines_.empty();
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::hasUniformSplineDuration() const
+{
+  return uniformSplineDuration_ > 0.0;
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getPosition() const
+{
+  if (splines_.empty()) return 0.0;
+  if (activeSplineIdx_ == static_cast<int>(splines_.size()))
+    return splines_.at(activeSplineIdx_ - 1).getPositionAtTime(containerTime_ - timeOffset_);
+  return splines_.at(activeSplineIdx_).getPositionAtTime(containerTime_ - timeOffset_);
+}
+
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getVelocity() const {
+  if (splines_.empty()) return 0.0;
+  if (activeSplineIdx_ == static_cast<int>(splines_.size()))
+    return splines_.at(activeSplineIdx_ - 1).getVelocityAtTime(containerTime_ - timeOffset_);
+  return splines_.at(activeSplineIdx_).getVelocityAtTime(containerTime_ - timeOffset_);
+}
+
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getAcceleration() const
+{
+  if (splines_.empty()) return 0.0;
+  if (activeSplineIdx_ == static_cast<int>(splines_.size()))
+    return splines_.at(activeSplineIdx_ - 1).getAccelerationAtTime(containerTime_ - timeOffset_);
+  return splines_.at(activeSplineIdx_).getAccelerationAtTime(containerTime_ - timeOffset_);
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getPositionAtTime(double t) const
+{
+  double timeOffset = 0.0;
+  int activeSplineIdx = getActiveSplineIndexAtTime(t, timeOffset);
+
+  if (activeSplineIdx < 0) {
+    return splines_.at(0).getPositionAtTime(0.0);
+  }
+  if (activeSplineIdx == static_cast<int>(splines_.size())) {
+    return splines_.at(activeSplineIdx - 1).getPositionAtTime(
+        splines_.at(activeSplineIdx - 1).getSplineDuration());
+  }
+  return splines_.at(activeSplineIdx).getPositionAtTime(t - timeOffset);
+}
+
+template <typename SplineType_>
+template <unsigned int derivativeOrder>
+void PolynomialSplineContainerT<SplineType_>::getDerivativeAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times,
+                                                                   Eigen::Ref<Eigen::ArrayXd> values) const
+{
+  using Scalar = typename SplineType::Scalar;
+  using ScalarArray = typename SplineType::EigenArrayType;
+  if (times.size() != values.size()) {
+    throw std::invalid_argument("PolynomialSplineContainerT::getDerivativeAtTimes: inconsistent number of times.");
+  }
+  if (splines_.empty()) {
+    throw std::out_of_range("PolynomialSplineContainerT::getDerivativeAtTimes: empty container.");
+  }
+  CURVES_INSTRUMENT_SCOPE_UNITS("PolynomialSplineContainer::getDerivativeAtTimes", times.size());
+  // Times relative to their spline and the values, in the scalar type of the splines.
+  ScalarArray localTimes(times.size());
+  ScalarArray localValues(times.size());
+  int splineIdx = 0;
+  Eigen::Index begin = 0;
+  while (begin < times.size()) {
+    double timeOffset = 0.0;
+    splineIdx = getActiveSplineIndexAtTime(times(begin), timeOffset, splineIdx);
+    Eigen::Index end = begin + 1;
+    double nextTimeOffset;
+    while (end < times.size() && getActiveSplineIndexAtTime(times(end), nextTimeOffset, splineIdx) == splineIdx) {
+      ++end;
+    }
+    const Eigen::Index count = end - begin;
+    localTimes.segment(begin, count) = (times.segment(begin, count) - timeOffset).template cast<Scalar>();
+    splines_[splineIdx].template getDerivativeAtTimes<derivativeOrder>(localTimes.segment(begin, count),
+                                                                       localValues.segment(begin, count));
+    begin = end;
+  }
+  values = localValues.template cast<double>();
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getPositionsAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times,
+                                                                  Eigen::Ref<Eigen::ArrayXd> positions) const
+{
+  getDerivativeAtTimes<0>(times, positions);
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getVelocitiesAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times,
+                                                                   Eigen::Ref<Eigen::ArrayXd> velocities) const
+{
+  getDerivativeAtTimes<1>(times, velocities);
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::getAccelerationsAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times,
+                                                                      Eigen::Ref<Eigen::ArrayXd> accelerations) const
+{
+  getDerivativeAtTimes<2>(times, accelerations);
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::isActiveSplineAtTime(int splineIdx, double t) const {
+  // The active spline is the first one which has not ended at time t, or the last one.
+  if (splineIdx < 0 || splineIdx >= static_cast<int>(splines_.size())) {
+    return false;
+  }
+  if (splineIdx > 0 &&
+      t - splineStartTimes_[splineIdx - 1] < splines_[splineIdx - 1].getSplineDuration()) {
+    return false;
+  }
+  return splineIdx == static_cast<int>(splines_.size()) - 1 ||
+         t - splineStartTimes_[splineIdx] < splines_[splineIdx].getSplineDuration();
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::findActiveSplineIndexAtTime(double t) const {
+  if (uniformSplineDuration_ > 0.0) {
+    // The start times are sums of equal durations, so the index is off by one at most.
+    const int lastIdx = splines_.size() - 1;
+    const double index = std::floor(t / uniformSplineDuration_);
+    const int guessIdx = !(index > 0.0) ? 0 : (index >= lastIdx ? lastIdx : static_cast<int>(index));
+    for (int idx = guessIdx - 1; idx <= guessIdx + 1; ++idx) {
+      if (isActiveSplineAtTime(idx, t)) {
+        return idx;
+      }
+    }
+  }
+
+  int lowerIdx = 0;
+  int upperIdx = splines_.size() - 1;
+  while (lowerIdx < upperIdx) {
+    const int midIdx = (lowerIdx + upperIdx) / 2;
+    if (t - splineStartTimes_[midIdx] < splines_[midIdx].getSplineDuration()) {
+      upperIdx = midIdx;
+    } else {
+      lowerIdx = midIdx + 1;
+    }
+  }
+  return lowerIdx;
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::getActiveSplineIndexAtTime(double t, double& timeOffset) const {
+  return getActiveSplineIndexAtTime(t, timeOffset, lastActiveSplineIdx_.load(std::memory_order_relaxed));
+}
+
+template <typename SplineType_>
+int PolynomialSplineContainerT<SplineType_>::getActiveSplineIndexAtTime(double t, double& timeOffset,
+                                                                        int startSplineIdx) const {
+  if (splines_.empty()) return -1;
+
+  int activeSplineIdx;
+  if (isActiveSplineAtTime(startSplineIdx, t)) {
+    activeSplineIdx = startSplineIdx;
+  } else if (isActiveSplineAtTime(startSplineIdx + 1, t)) {
+    activeSplineIdx = startSplineIdx + 1;
+  } else {
+    activeSplineIdx = findActiveSplineIndexAtTime(t);
+  }
+
+  lastActiveSplineIdx_.store(activeSplineIdx, std::memory_order_relaxed);
+  timeOffset = splineStartTimes_[activeSplineIdx];
+  return activeSplineIdx;
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getVelocityAtTime(double t) const
+{
+  double timeOffset = 0.0;
+  int activeSplineIdx = getActiveSplineIndexAtTime(t, timeOffset);
+  if (activeSplineIdx < 0) {
+    return splines_.at(0).getVelocityAtTime(0.0);
+  }
+  if (activeSplineIdx == static_cast<int>(splines_.size())) {
+    return splines_.at(activeSplineIdx - 1).getVelocityAtTime(
+        splines_.at(activeSplineIdx - 1).getSplineDuration());
+  }
+  return splines_.at(activeSplineIdx).getVelocityAtTime(t - timeOffset);
+}
+
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getAccelerationAtTime(double t) const
+{
+  double timeOffset = 0.0;
+  int activeSplineIdx = getActiveSplineIndexAtTime(t, timeOffset);
+  if (activeSplineIdx < 0) {
+    return splines_.at(0).getAccelerationAtTime(0.0);
+  }
+  if (activeSplineIdx == static_cast<int>(splines_.size())) {
+    return splines_.at(activeSplineIdx - 1).getAccelerationAtTime(
+        splines_.at(activeSplineIdx - 1).getSplineDuration());
+  }
+  return splines_.at(activeSplineIdx).getAccelerationAtTime(t - timeOffset);
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::State PolynomialSplineContainerT<SplineType_>::evaluateState(double t) const
+{
+  double timeOffset = 0.0;
+  int activeSplineIdx = getActiveSplineIndexAtTime(t, timeOffset);
+  std::array<typename SplineType::Scalar, 3> derivatives;
+  if (activeSplineIdx < 0) {
+    splines_.at(0).template getDerivativesAtTime<2>(0.0, derivatives);
+  } else if (activeSplineIdx == static_cast<int>(splines_.size())) {
+    const SplineType& spline = splines_.at(activeSplineIdx - 1);
+    spline.template getDerivativesAtTime<2>(spline.getSplineDuration(), derivatives);
+  } else {
+    splines_.at(activeSplineIdx).template getDerivativesAtTime<2>(t - timeOffset, derivatives);
+  }
+  State state;
+  state.position = derivatives[0];
+  state.velocity = derivatives[1];
+  state.acceleration = derivatives[2];
+  return state;
+}
+
+template <typename SplineType_>
+void PolynomialSplineContainerT<SplineType_>::Bounds::merge(const Bounds& other)
+{
+  minPosition = std::min(minPosition, other.minPosition);
+  maxPosition = std::max(maxPosition, other.maxPosition);
+  minVelocity = std::min(minVelocity, other.minVelocity);
+  maxVelocity = std::max(maxVelocity, other.maxVelocity);
+  minAcceleration = std::min(minAcceleration, other.minAcceleration);
+  maxAcceleration = std::max(maxAcceleration, other.maxAcceleration);
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::Bounds
+PolynomialSplineContainerT<SplineType_>::computeSplineBounds(const SplineType& spline, double t0, double t1)
+{
+  using Scalar = typename SplineType::Scalar;
+  Scalar minValue, maxValue;
+  Bounds bounds;
+  spline.template getDerivativeBounds<0>(t0, t1, minValue, maxValue);
+  bounds.minPosition = minValue;
+  bounds.maxPosition = maxValue;
+  spline.template getDerivativeBounds<1>(t0, t1, minValue, maxValue);
+  bounds.minVelocity = minValue;
+  bounds.maxVelocity = maxValue;
+  spline.template getDerivativeBounds<2>(t0, t1, minValue, maxValue);
+  bounds.minAcceleration = minValue;
+  bounds.maxAcceleration = maxValue;
+  return bounds;
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::Bounds
+PolynomialSplineContainerT<SplineType_>::getSplineBounds(int splineIndex) const
+{
+  const SplineType& spline = splines_.at(splineIndex);
+  if (modifiedSplines_[splineIndex]) {
+    return computeSplineBounds(spline, 0.0, spline.getSplineDuration());
+  }
+  return splineBounds_[splineIndex];
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::Bounds
+PolynomialSplineContainerT<SplineType_>::getBounds(double t0, double t1) const
+{
+  const double startTime = std::max(0.0, std::min(t0, containerDuration_));
+  const double endTime = std::max(startTime, std::min(t1, containerDuration_));
+  double firstOffset, lastOffset;
+  const int firstIdx = getActiveSplineIndexAtTime(startTime, firstOffset);
+  const int lastIdx = getActiveSplineIndexAtTime(endTime, lastOffset, firstIdx);
+  if (firstIdx < 0) {
+    throw std::out_of_range("PolynomialSplineContainerT::getBounds: the container is empty.");
+  }
+
+  // The first and last spline may only be covered partially.
+  const SplineType& firstSpline = splines_[firstIdx];
+  const bool isFirstCovered = !modifiedSplines_[firstIdx] && startTime <= firstOffset
+      && (lastIdx > firstIdx || endTime - firstOffset >= firstSpline.getSplineDuration());
+  Bounds bounds = isFirstCovered ? splineBounds_[firstIdx]
+      : computeSplineBounds(firstSpline, startTime - firstOffset,
+                            lastIdx > firstIdx ? firstSpline.getSplineDuration() : endTime - firstOffset);
+  for (int i = firstIdx + 1; i < lastIdx; i++) {
+    bounds.merge(getSplineBounds(i));
+  }
+  if (lastIdx > firstIdx) {
+    const SplineType& lastSpline = splines_[lastIdx];
+    bounds.merge(!modifiedSplines_[lastIdx] && endTime - lastOffset >= lastSpline.getSplineDuration()
+        ? splineBounds_[lastIdx] : computeSplineBounds(lastSpline, 0.0, endTime - lastOffset));
+  }
+  return bounds;
+}
+
+template <typename SplineType_>
+typename PolynomialSplineContainerT<SplineType_>::Bounds
+PolynomialSplineContainerT<SplineType_>::getBounds() const
+{
+  return getBounds(0.0, containerDuration_);
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getEndPosition() const
+{
+  double lastSplineDuration = splines_.at(splines_.size() - 1).getSplineDuration();
+  return splines_.at(splines_.size() - 1).getPositionAtTime(lastSplineDuration);
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getEndVelocity() const
+{
+  double lastSplineDuration = splines_.at(splines_.size() - 1).getSplineDuration();
+  return splines_.at(splines_.size() - 1).getVelocityAtTime(lastSplineDuration);
+}
+
+template <typename SplineType_>
+double PolynomialSplineContainerT<SplineType_>::getEndAcceleration() const
+{
+  double lastSplineDuration = splines_.at(splines_.size() - 1).getSplineDuration();
+  return splines_.at(splines_.size() - 1).getAccelerationAtTime(lastSplineDuration);
+}
+
+template <typename SplineType_>
+const typename PolynomialSplineContainerT<SplineType_>::SplineList& PolynomialSplineContainerT<SplineType_>::getSplines() const {
+  return splines_;
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::saveBinary(const std::string& filename) const {
+  constexpr auto num_coeffs_spline = SplineType::coefficientCount;
+  std::vector<double> durations;
+  std::vector<double> coefficients;
+  durations.reserve(splines_.size());
+  coefficients.reserve(splines_.size()*num_coeffs_spline);
+  for (const auto& spline : splines_) {
+    durations.push_back(spline.getSplineDuration());
+    coefficients.insert(coefficients.end(), spline.getCoefficients().begin(), spline.getCoefficients().end());
+  }
+  return writeCurveFile(filename, CurveFileContent::Splines, num_coeffs_spline, durations, coefficients);
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::loadBinary(const std::string& filename) {
+  MappedCurveFile file;
+  return file.open(filename) && load(file);
+}
+
+template <typename SplineType_>
+bool PolynomialSplineContainerT<SplineType_>::load(const MappedCurveFile& file) {
+  constexpr auto num_coeffs_spline = SplineType::coefficientCount;
+  if (!file.isOpen() || file.getContent() != CurveFileContent::Splines ||
+      file.getValuesPerEntry() != num_coeffs_spline) {
+    return false;
+  }
+  reset();
+  splines_.reserve(file.size());
+  splineStartTimes_.reserve(file.size());
+  for (size_t i = 0; i < file.size(); ++i) {
+    typename SplineType::SplineCoefficients coefficients;
+    std::copy(file.getValues(i), file.getValues(i) + num_coeffs_spline, coefficients.begin());
+    addSpline(SplineType(std::move(coefficients), file.getTimes()[i]));
+  }
+  return true;
+}
+
+} /* namespace */
@@ -7,21 +7,75 @@
 
 #pragma once
 
+#include "curves/ChunkedVector.hpp"
+#include "curves/CurveFile.hpp"
 #include "curves/polynomial_splines.hpp"
 #include <Eigen/Core>
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <array>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <vector>
 
 namespace curves {
 
-class PolynomialSplineContainer {
+/*! A sequence of polynomial splines of odd order. Fits are continuous up to the derivative
+ *  of order (order-1)/2, e.g. velocities for cubic and accelerations for quintic splines.
+ *  Boundary conditions of higher derivatives are ignored.
+ *  Times and fits are computed in double precision, the splines store and evaluate their
+ *  coefficients in their own scalar type, e.g. float for PolynomialSplineContainerf.
+ *  The splines are kept in copy-on-write chunks, so copying a container is O(1) and the copy
+ *  keeps sharing all splines which the original does not modify afterwards.
+ */
+template <typename SplineType_>
+class PolynomialSplineContainerT {
  public:
 
-  using SplineType = PolynomialSplineQuintic;
-  using SplineList = std::vector<SplineType>;
+  using SplineType = SplineType_;
+  using SplineList = ChunkedVector<SplineType>;
+
+  static_assert(SplineType::splineOrder % 2 == 1, "The spline order must be odd.");
+
+  //! Highest derivative which is continuous at the knots of a fit.
+  static constexpr unsigned int continuityOrder = (SplineType::splineOrder - 1) / 2;
+
+  /*! Linear solver used by setData. The junction constraints leave the system
+   *  underdetermined, so the solvers generally pick different splines through the knots.
+   *    DenseQR:           column pivoting QR of the dense system, O(n^3) in the number of splines.
+   *    SparseMinimumNorm: minimum norm solution using the band structure of the system, O(n).
+   */
+  enum class SolverType {
+    DenseQR,
+    SparseMinimumNorm
+  };
+
+  //! Position, velocity and acceleration at one instant.
+  struct State {
+    double position;
+    double velocity;
+    double acceleration;
+  };
+
+  //! Minimum and maximum position, velocity and acceleration over a time interval.
+  struct Bounds {
+    double minPosition;
+    double maxPosition;
+    double minVelocity;
+    double maxVelocity;
+    double minAcceleration;
+    double maxAcceleration;
+
+    //! Extend the bounds to hold other as well.
+    void merge(const Bounds& other);
+  };
 
-  PolynomialSplineContainer();
-  virtual ~PolynomialSplineContainer();
+  PolynomialSplineContainerT();
+  PolynomialSplineContainerT(const PolynomialSplineContainerT& other);
+  PolynomialSplineContainerT& operator=(const PolynomialSplineContainerT& other);
+  virtual ~PolynomialSplineContainerT();
 
   bool advance(double dt);
   bool addSpline(const SplineType& spline);
@@ -39,6 +93,41 @@ class PolynomialSplineContainer {
   double getVelocityAtTime(double t) const;
   double getAccelerationAtTime(double t) const;
 
+  //! Get position, velocity and acceleration at time t with a single spline lookup.
+  State evaluateState(double t) const;
+
+  /*! Evaluate the derivative of order derivativeOrder at all times, like getPositionAtTime
+   *  and its siblings. Consecutive times in the same spline are evaluated by one call of the
+   *  vectorized array kernel of the spline, so sorted times cost one spline lookup per spline
+   *  and O(1) per time. Unsorted times are correct but split into shorter runs. Throws
+   *  std::invalid_argument if the sizes differ and std::out_of_range if the container is empty.
+   */
+  template<unsigned int derivativeOrder>
+  void getDerivativeAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times, Eigen::Ref<Eigen::ArrayXd> values) const;
+
+  //! Get the positions at all times, see getDerivativeAtTimes.
+  void getPositionsAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times, Eigen::Ref<Eigen::ArrayXd> positions) const;
+
+  //! Get the velocities at all times, see getDerivativeAtTimes.
+  void getVelocitiesAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times, Eigen::Ref<Eigen::ArrayXd> velocities) const;
+
+  //! Get the accelerations at all times, see getDerivativeAtTimes.
+  void getAccelerationsAtTimes(const Eigen::Ref<const Eigen::ArrayXd>& times,
+                               Eigen::Ref<Eigen::ArrayXd> accelerations) const;
+
+  /*! Get the bounds of the position, velocity and acceleration over the times [t0, t1],
+   *  clamped to the container. The bounds of every spline are computed when it is added,
+   *  so only the splines partially covered by [t0, t1] are searched for their extrema.
+   *  The container must not be empty.
+   */
+  Bounds getBounds(double t0, double t1) const;
+
+  //! Get the bounds of the whole container, see getBounds.
+  Bounds getBounds() const;
+
+  //! Get the cached bounds of the spline splineIndex over its whole duration.
+  Bounds getSplineBounds(int splineIndex) const;
+
   double getEndPosition() const;
   double getEndVelocity() const;
   double getEndAcceleration() const;
@@ -46,9 +135,23 @@ class PolynomialSplineContainer {
   double getContainerTime() const;
 
   int getActiveSplineIndex() const;
+
+  /*! Get the index of the spline active at time t and its start time (timeOffset).
+   *  The lookup is a binary search over the spline start times, O(log n). Queries
+   *  landing in the same spline as the previous query are answered in O(1), as are all
+   *  queries if the splines are of equal duration (see hasUniformSplineDuration).
+   */
   int getActiveSplineIndexAtTime(double t, double& timeOffset) const;
+
+  /*! Get the index of the spline active at time t, trying the spline startSplineIdx
+   *  and the one after it first. Walking sorted times costs O(1) amortized per query.
+   */
+  int getActiveSplineIndexAtTime(double t, double& timeOffset, int startSplineIdx) const;
   bool isEmpty() const;
 
+  //! True if all splines have the same duration, up to a relative tolerance of 1e-9.
+  bool hasUniformSplineDuration() const;
+
   virtual void setData(const std::vector<double>& knotPositions,
                        const std::vector<double>& knotValues,
                        double initialVelocity,
@@ -56,23 +159,172 @@ class PolynomialSplineContainer {
                        double finalVelocity,
                        double finalAcceleration);
 
+  /*! Build one spline per knot interval which meets the knot values, velocities and
+   *  accelerations at both ends. Every spline is computed on its own, no system is solved,
+   *  so this costs O(n). Throws std::invalid_argument if the sizes differ.
+   */
+  void setData(const std::vector<double>& knotPositions,
+               const std::vector<double>& knotValues,
+               const std::vector<double>& knotVelocities,
+               const std::vector<double>& knotAccelerations);
+
+  /*! Fit several containers to the same knot positions. Column j of knotValues
+   *  (knots x containers) and entry j of the boundary conditions are fitted by containers[j].
+   *  The constraint matrix only depends on the knot positions, so it is built and factorized
+   *  once and all containers are solved together, using the solver type of the first container.
+   */
+  static void setData(const std::vector<double>& knotPositions,
+                      const Eigen::MatrixXd& knotValues,
+                      const Eigen::VectorXd& initialVelocities,
+                      const Eigen::VectorXd& initialAccelerations,
+                      const Eigen::VectorXd& finalVelocities,
+                      const Eigen::VectorXd& finalAccelerations,
+                      const std::vector<PolynomialSplineContainerT*>& containers);
+
+  /*! Append a knot duration after the end of the container. The new spline starts at the end
+   *  state of the container, so the container stays C2 continuous, and reaches knotValue with
+   *  the final velocity and acceleration. Only the new spline is computed, in O(1).
+   *  With a tailWindow > 0 the last tailWindow splines are fitted again together with the new
+   *  one, as setData would do for these knots starting from the state at the beginning of the
+   *  window. This costs O(tailWindow) with SolverType::SparseMinimumNorm, and the factorization
+   *  is reused while the durations in the window do not change.
+   *  Returns false if the container is empty or the duration is not positive.
+   */
+  bool appendKnot(double duration, double knotValue, double finalVelocity = 0.0,
+                  double finalAcceleration = 0.0, unsigned int tailWindow = 0);
+
+  //! Set the solver used by setData. Defaults to SolverType::DenseQR.
+  void setSolverType(SolverType solverType);
+  SolverType getSolverType() const;
+
+  //! Get a spline for modification. Its duration must not be changed. Its bounds are
+  //! computed on every query from then on. The pointer is invalidated by copying the container.
   SplineType* getSpline(int splineIndex);
 
   void setContainerTime(double t);
 
   const SplineList& getSplines() const;
 
+  //! Save the spline durations and coefficients to a binary curve file, see CurveFile.hpp.
+  bool saveBinary(const std::string& filename) const;
+
+  //! Replace the splines by those of a binary curve file.
+  bool loadBinary(const std::string& filename);
+
+  //! Replace the splines by those of a mapped binary curve file.
+  bool load(const MappedCurveFile& file);
+
   static constexpr double undefinedValue = std::numeric_limits<double>::quiet_NaN();
 
  protected:
   int getCoeffIndex(int splineIdx, int aIdx) const;
   int getSplineColumnIndex(int splineIdx) const;
 
+  //! Number of rows of the constraint matrix of a fit with numSplines splines.
+  static unsigned int getNumConstraints(unsigned int numSplines) {
+    return 2*(continuityOrder + 1) + (numSplines - 1)*(continuityOrder + 2);
+  }
+
+  //! Time vector of the fit, in double precision independently of the spline scalar type.
+  using TimeVectorType = Eigen::Matrix<double, 1, SplineType::coefficientCount>;
+
+  //! Derivative of order derivativeOrder of the time vector tau at time tk.
+  static void getDerivativeTimeVector(unsigned int derivativeOrder, double tk, TimeVectorType& timeVec);
+
+  //! Assemble the constraint matrix A of A*coeffs = b for splines of durations tfs.
+  void getConstraintMatrix(const std::vector<double>& tfs, Eigen::SparseMatrix<double>& A) const;
+
+  //! Assemble the right hand side b of A*coeffs = b.
+  void getConstraintValues(const Eigen::Ref<const Eigen::VectorXd>& knotValues,
+                           double initialVelocity, double initialAcceleration,
+                           double finalVelocity, double finalAcceleration,
+                           Eigen::Ref<Eigen::VectorXd> b) const;
+
+  //! Factorization of the constraint matrix of splines with durations tfs, solving A*coeffs = b.
+  class ConstraintFactorization {
+   public:
+    ConstraintFactorization(const Eigen::SparseMatrix<double>& A, const std::vector<double>& tfs,
+                            SolverType solverType);
+
+    //! True if this factorization was computed for these spline durations and solver.
+    bool matches(const std::vector<double>& tfs, SolverType solverType) const;
+
+    int getNumConstraints() const;
+
+    //! Solve A*coeffs = b for every column of b.
+    Eigen::MatrixXd solve(const Eigen::MatrixXd& b) const;
+
+   private:
+    std::vector<double> tfs_;
+    SolverType solverType_;
+    int numConstraints_;
+    bool useSparse_;
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> denseSolver_;
+    Eigen::SparseMatrix<double> scaledA_;
+    Eigen::VectorXd rowScale_;
+    Eigen::VectorXd columnScale_;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> sparseSolver_;
+  };
+
+  /*! Get the factorization for splines of durations tfs. The last one is kept, so refits
+   *  with unchanged timing and solver only cost a back-substitution.
+   */
+  std::shared_ptr<const ConstraintFactorization> getFactorization(const std::vector<double>& tfs);
+
+  //! Append the splines of durations tfs with the stacked coefficients coeffs.
+  void setSplines(const std::vector<double>& tfs, const Eigen::Ref<const Eigen::VectorXd>& coeffs);
+
+  //! Keep track of whether the splines are of equal duration, before appending one of splineDuration.
+  void updateUniformSplineDuration(double splineDuration);
+
+  //! Compute the bounds of spline over the times [t0, t1] relative to its start.
+  static Bounds computeSplineBounds(const SplineType& spline, double t0, double t1);
+
+  //! True if the spline splineIdx is the one active at time t.
+  bool isActiveSplineAtTime(int splineIdx, double t) const;
+
+  //! Search for the spline active at time t, O(1) for splines of equal duration and O(log n) otherwise.
+  int findActiveSplineIndexAtTime(double t) const;
+
   SplineList splines_;
   double timeOffset_;
   double containerTime_;
   double containerDuration_;
   int activeSplineIdx_;
+
+  //! Start time of each spline, i.e. the cumulative duration of the splines before it.
+  ChunkedVector<double> splineStartTimes_;
+
+  //! Bounds of each spline over its whole duration.
+  ChunkedVector<Bounds> splineBounds_;
+
+  //! True for the splines handed out by getSpline, whose cached bounds may be outdated.
+  ChunkedVector<unsigned char> modifiedSplines_;
+
+  //! Duration of all splines if it is the same for all of them, 0 otherwise.
+  double uniformSplineDuration_;
+
+  //! Spline found by the last lookup, tried first by getActiveSplineIndexAtTime.
+  mutable std::atomic<int> lastActiveSplineIdx_;
+
+  //! Solver used by setData.
+  SolverType solverType_;
+
+  //! Factorization of the last fit, shared with copies and containers fitted together. It is immutable.
+  std::shared_ptr<const ConstraintFactorization> factorization_;
 };
 
+using PolynomialSplineContainer = PolynomialSplineContainerT<PolynomialSplineQuintic>;
+using PolynomialSplineCubicContainer = PolynomialSplineContainerT<PolynomialSplineCubic>;
+using PolynomialSplineContainerf = PolynomialSplineContainerT<PolynomialSplineQuinticf>;
+using PolynomialSplineCubicContainerf = PolynomialSplineContainerT<PolynomialSplineCubicf>;
+
+// Instantiated in PolynomialSplineContainer.cpp.
+extern template class PolynomialSplineContainerT<PolynomialSplineCubic>;
+extern template class PolynomialSplineContainerT<PolynomialSplineQuintic>;
+extern template class PolynomialSplineContainerT<PolynomialSplineCubicf>;
+extern template class PolynomialSplineContainerT<PolynomialSplineQuinticf>;
+
 } /* namespace */
+
+#include "curves/PolynomialSplineContainer-inl.hpp"
@@ -0,0 +1,206 @@
+/*
+ * PolynomialSplineSampler.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include "curves/PolynomialSplineContainer.hpp"
+
+// std
+#include <array>
+#include <stdexcept>
+
+namespace curves {
+
+/*! Samples a spline container at a fixed period with forward differences.
+ *
+ *  The position, velocity and acceleration of the active spline are kept as forward difference
+ *  tables for the period dt, so a tick only costs a few additions per derivative (12 for quintic
+ *  splines) instead of evaluating the polynomials. The tables are seeded from the derivatives
+ *  of the spline when a tick enters a new spline, which bounds the accumulated rounding error
+ *  to the ticks within one spline. Tick times are computed as startTime + tick*dt, so the
+ *  time itself does not drift. After the end of the container, the end state is returned.
+ *
+ *  The sampler refers to the container, which must not be changed while sampling:
+ *
+ *    for (PolynomialSplineSampler<PolynomialSplineContainer> sampler(container, 0.0025);
+ *         !sampler.isAtEnd(); ++sampler) {
+ *      const PolynomialSplineContainer::State& state = *sampler;
+ *    }
+ */
+template <typename ContainerType_>
+class PolynomialSplineSampler {
+ public:
+  using ContainerType = ContainerType_;
+  using SplineType = typename ContainerType::SplineType;
+  using State = typename ContainerType::State;
+
+  static constexpr unsigned int splineOrder = SplineType::splineOrder;
+
+  //! Start sampling the container at startTime with period dt. Throws std::invalid_argument
+  //! if the container is empty, dt is not positive or startTime is negative.
+  PolynomialSplineSampler(const ContainerType& container, double dt, double startTime = 0.0)
+      : container_(container),
+        dt_(dt),
+        startTime_(startTime),
+        tick_(0),
+        time_(startTime),
+        splineIdx_(0),
+        splineEndTime_(0.0),
+        isAtEnd_(false)
+  {
+    if (container.isEmpty() || !(dt > 0.0) || startTime < 0.0) {
+      throw std::invalid_argument("PolynomialSplineSampler: empty container, non-positive period or negative start time.");
+    }
+    seed();
+  }
+
+  //! Get the position, velocity and acceleration at the current tick.
+  const State& getState() const {
+    return state_;
+  }
+
+  //! Get the time of the current tick.
+  double getTime() const {
+    return time_;
+  }
+
+  //! Get the number of ticks since the start.
+  unsigned long getTick() const {
+    return tick_;
+  }
+
+  //! True once the current tick is past the end of the container. The end state is held from then on.
+  bool isAtEnd() const {
+    return isAtEnd_;
+  }
+
+  //! Move to the next tick.
+  void advance() {
+    ++tick_;
+    time_ = startTime_ + tick_*dt_;
+    if (isAtEnd_) {
+      return;
+    }
+    if (time_ >= splineEndTime_) {
+      seed();
+      return;
+    }
+    step(positionDifferences_);
+    step(velocityDifferences_);
+    step(accelerationDifferences_);
+    state_.position = positionDifferences_[0];
+    state_.velocity = velocityDifferences_[0];
+    state_.acceleration = accelerationDifferences_[0];
+  }
+
+  const State& operator*() const {
+    return state_;
+  }
+
+  const State* operator->() const {
+    return &state_;
+  }
+
+  PolynomialSplineSampler& operator++() {
+    advance();
+    return *this;
+  }
+
+ private:
+  //! Add every difference of the table to the one of the next lower order.
+  template <size_t size>
+  static void step(std::array<double, size>& differences) {
+    for (size_t j = 0; j + 1 < size; j++) {
+      differences[j] += differences[j + 1];
+    }
+  }
+
+  /*! Set up the forward differences of the derivative of order offset from the Taylor
+   *  coefficients of the spline at the current time. The differences of the powers of the
+   *  tick index, j!*S(d, j) with the Stirling numbers of the second kind, are all positive,
+   *  so the differences are sums without the cancellation of differencing sampled values.
+   */
+  template <size_t size>
+  void seedDifferences(const std::array<double, splineOrder + 1>& taylor, unsigned int offset,
+                       std::array<double, size>& differences) const {
+    // Row d of the table holds the differences j!*S(d, j) of k^d at k = 0.
+    std::array<double, size> powerDifferences;
+    powerDifferences.fill(0.0);
+    powerDifferences[0] = 1.0;
+    differences.fill(0.0);
+    double power = 1.0;
+    for (size_t d = 0; d < size; d++) {
+      if (d > 0) {
+        for (size_t j = d; j > 0; j--) {
+          powerDifferences[j] = j*(powerDifferences[j] + powerDifferences[j - 1]);
+        }
+        powerDifferences[0] = 0.0;
+        power *= dt_;
+      }
+      const double coefficient = taylor[d + offset]*getFallingFactorial(d + offset, offset)*power;
+      for (size_t j = 0; j <= d; j++) {
+        differences[j] += coefficient*powerDifferences[j];
+      }
+    }
+  }
+
+  //! d*(d-1)*...*(d-offset+1), the factor of the Taylor coefficient d in the derivative of order offset.
+  static double getFallingFactorial(unsigned int d, unsigned int offset) {
+    double factor = 1.0;
+    for (unsigned int i = 0; i < offset; i++) {
+      factor *= d - i;
+    }
+    return factor;
+  }
+
+  //! Seed the tables at the current time from the spline active at that time.
+  void seed() {
+    double timeOffset;
+    splineIdx_ = container_.getActiveSplineIndexAtTime(time_, timeOffset, splineIdx_);
+    const SplineType& spline = container_.getSplines()[splineIdx_];
+    const double localTime = time_ - timeOffset;
+    isAtEnd_ = time_ > container_.getContainerDuration();
+    splineEndTime_ = timeOffset + spline.getSplineDuration();
+
+    std::array<typename SplineType::Scalar, splineOrder + 1> derivatives;
+    spline.template getDerivativesAtTime<splineOrder>(localTime, derivatives);
+    std::array<double, splineOrder + 1> taylor;
+    double factorial = 1.0;
+    for (unsigned int d = 0; d <= splineOrder; d++) {
+      factorial *= d > 0 ? d : 1;
+      taylor[d] = derivatives[d]/factorial;
+    }
+    seedDifferences(taylor, 0, positionDifferences_);
+    seedDifferences(taylor, 1, velocityDifferences_);
+    seedDifferences(taylor, 2, accelerationDifferences_);
+    state_.position = positionDifferences_[0];
+    state_.velocity = velocityDifferences_[0];
+    state_.acceleration = accelerationDifferences_[0];
+  }
+
+  const ContainerType& container_;
+  double dt_;
+  double startTime_;
+  unsigned long tick_;
+  double time_;
+
+  //! The spline of the current tick and the time at which it ends.
+  int splineIdx_;
+  double splineEndTime_;
+  bool isAtEnd_;
+
+  //! Forward differences of the position, velocity and acceleration, the value first.
+  std::array<double, splineOrder + 1> positionDifferences_;
+  std::array<double, splineOrder> velocityDifferences_;
+  std::array<double, splineOrder - 1> accelerationDifferences_;
+
+  State state_;
+};
+
+template <typename ContainerType_>
+constexpr unsigned int PolynomialSplineSampler<ContainerType_>::splineOrder;
+
+} /* namespace */
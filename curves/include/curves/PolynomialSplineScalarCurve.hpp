@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
+#include <Eigen/Core>
 #include <glog/logging.h>
 
 #include "curves/Curve.hpp"
@@ -25,14 +30,40 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
   typedef Curve<ScalarCurveConfig> Parent;
   typedef typename Parent::ValueType ValueType;
   typedef typename Parent::DerivativeType DerivativeType;
+  typedef PolynomialSplineContainerT<SplineType> Container;
 
   PolynomialSplineScalarCurve()
       : Curve<ScalarCurveConfig>(),
-        minTime_(0.0)
+        container_(new Container()),
+        minTime_(0.0),
+        backContainer_(new Container()),
+        backMinTime_(0.0),
+        asyncFitState_(AsyncFitState::Idle)
   {
   }
 
-  virtual ~PolynomialSplineScalarCurve() {}
+  //! Copies the current curve. An asynchronous fit in progress is not copied.
+  PolynomialSplineScalarCurve(const PolynomialSplineScalarCurve& other)
+      : Curve<ScalarCurveConfig>(other),
+        container_(new Container(*other.container_)),
+        minTime_(other.minTime_),
+        backContainer_(new Container()),
+        backMinTime_(0.0),
+        asyncFitState_(AsyncFitState::Idle)
+  {
+  }
+
+  PolynomialSplineScalarCurve& operator=(const PolynomialSplineScalarCurve& other)
+  {
+    *container_ = *other.container_;
+    minTime_ = other.minTime_;
+    return *this;
+  }
+
+  virtual ~PolynomialSplineScalarCurve()
+  {
+    waitForAsyncFit();
+  }
 
   virtual void print(const std::string& str = "") const
   {
@@ -65,13 +96,13 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
 
   virtual Time getMaxTime() const
   {
-    return container_.getContainerDuration() + minTime_;
+    return container_->getContainerDuration() + minTime_;
   }
 
   virtual bool evaluate(ValueType& value, Time time) const
   {
     time -= minTime_;
-    value = container_.getPositionAtTime(time);
+    value = container_->getPositionAtTime(time);
     return true;
   }
 
@@ -80,11 +111,11 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
     time -= minTime_;
     switch (derivativeOrder) {
       case(1): {
-        value = container_.getVelocityAtTime(time);
+        value = container_->getVelocityAtTime(time);
       } break;
 
       case(2): {
-        value = container_.getAccelerationAtTime(time);
+        value = container_->getAccelerationAtTime(time);
       } break;
 
       default:
@@ -94,16 +125,141 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
     return true;
   }
 
+  //! Evaluate the value and its first and second derivatives at time with a single spline lookup.
+  bool evaluateState(ValueType& value, DerivativeType& velocity, DerivativeType& acceleration, Time time) const
+  {
+    const typename Container::State state = container_->evaluateState(time - minTime_);
+    value = state.position;
+    velocity = state.velocity;
+    acceleration = state.acceleration;
+    return true;
+  }
+
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const
+  {
+    CHECK_NOTNULL(values);
+    if (container_->isEmpty()) {
+      return Parent::evaluate(times, values);
+    }
+    evaluateAtTimes<0>(times, values);
+    return true;
+  }
+
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* values,
+                                  unsigned derivativeOrder) const
+  {
+    CHECK_NOTNULL(values);
+    if (container_->isEmpty() || derivativeOrder < 1 || derivativeOrder > 2) {
+      return Parent::evaluateDerivative(times, values, derivativeOrder);
+    }
+    if (derivativeOrder == 1) {
+      evaluateAtTimes<1>(times, values);
+    } else {
+      evaluateAtTimes<2>(times, values);
+    }
+    return true;
+  }
+
+  /*! Append knots after the end of the curve with zero final velocity and acceleration, see
+   *  PolynomialSplineContainer::appendKnot. The existing splines are kept. An empty curve is
+   *  fitted to the knots instead.
+   */
   virtual void extend(const std::vector<Time>& times, const std::vector<ValueType>& values,
                       std::vector<Key>* outKeys)
   {
-    throw std::runtime_error("extend is not yet implemented!");
+    CHECK_EQ(times.size(), values.size());
+    if (container_->isEmpty()) {
+      fitCurve(times, values, outKeys);
+      return;
+    }
+    for (size_t i = 0; i < times.size(); ++i) {
+      CHECK(container_->appendKnot(times[i] - getMaxTime(), values[i]))
+          << "The curve can only be extended into the future.";
+    }
+  }
+
+  /*! Fit the curve to the knots on a worker thread, into a second container (back buffer).
+   *  The current curve stays unchanged and can be evaluated meanwhile. The finished fit
+   *  replaces it in the next call of advance or swapAsyncFit. Returns false, and does not
+   *  start a fit, while the previous asynchronous fit has not been swapped in.
+   */
+  bool fitCurveAsync(const std::vector<Time>& times, const std::vector<ValueType>& values,
+                     double initialVelocity = 0.0, double initialAcceleration = 0.0,
+                     double finalVelocity = 0.0, double finalAcceleration = 0.0)
+  {
+    CHECK(!times.empty());
+    if (asyncFitState_.load(std::memory_order_acquire) != AsyncFitState::Idle) {
+      return false;
+    }
+    if (asyncFitThread_.joinable()) {
+      asyncFitThread_.join();
+    }
+    backContainer_->setSolverType(container_->getSolverType());
+    asyncFitState_.store(AsyncFitState::Fitting, std::memory_order_relaxed);
+    asyncFitThread_ = std::thread([this, times, values, initialVelocity, initialAcceleration,
+                                   finalVelocity, finalAcceleration]() {
+      backContainer_->setData(times, values, initialVelocity, initialAcceleration, finalVelocity,
+                              finalAcceleration);
+      backMinTime_ = times.front();
+      asyncFitState_.store(AsyncFitState::Ready, std::memory_order_release);
+    });
+    return true;
+  }
+
+  /*! Replace the curve by a finished asynchronous fit, if there is one. The containers are
+   *  exchanged by pointer, so this takes O(1) and does not allocate. The curve time of advance
+   *  is kept. Must be called from the thread evaluating the curve. Returns true if swapped.
+   */
+  bool swapAsyncFit()
+  {
+    if (asyncFitState_.load(std::memory_order_acquire) != AsyncFitState::Ready) {
+      return false;
+    }
+    const Time time = container_->isEmpty() ? backMinTime_ : getTime();
+    container_.swap(backContainer_);
+    std::swap(minTime_, backMinTime_);
+    container_->setContainerTime(time - minTime_);
+    asyncFitState_.store(AsyncFitState::Idle, std::memory_order_release);
+    return true;
+  }
+
+  //! True while an asynchronous fit runs or waits to be swapped in.
+  bool isAsyncFitPending() const
+  {
+    return asyncFitState_.load(std::memory_order_acquire) != AsyncFitState::Idle;
+  }
+
+  //! Block until the worker thread of the asynchronous fit has finished. Does not swap it in.
+  void waitForAsyncFit()
+  {
+    if (asyncFitThread_.joinable()) {
+      asyncFitThread_.join();
+    }
+  }
+
+  //! Advance the curve time by dt, after swapping in a finished asynchronous fit.
+  bool advance(double dt)
+  {
+    swapAsyncFit();
+    return container_->advance(dt);
+  }
+
+  //! The curve time moved forward by advance, starting at getMinTime.
+  Time getTime() const
+  {
+    return container_->getContainerTime() + minTime_;
+  }
+
+  //! Set the solver used by the fitCurve methods working on knots.
+  void setSolverType(typename Container::SolverType solverType)
+  {
+    container_->setSolverType(solverType);
   }
 
   virtual void fitCurve(const std::vector<Time>& times, const std::vector<ValueType>& values,
                         std::vector<Key>* outKeys = NULL)
   {
-    container_.setData(times, values, 0.0, 0.0, 0.0, 0.0);
+    container_->setData(times, values, 0.0, 0.0, 0.0, 0.0);
     minTime_ = times.front();
   }
 
@@ -112,25 +268,70 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
                         double finalVelocity, double finalAcceleration,
                         std::vector<Key>* outKeys = NULL)
   {
-    container_.setData(times, values, initialVelocity, initialAcceleration, finalVelocity,
+    container_->setData(times, values, initialVelocity, initialAcceleration, finalVelocity,
                        finalAcceleration);
     minTime_ = times.front();
   }
 
+  /*! Fit a curve which meets the values and their first and second derivatives at all knots,
+   *  with one spline per knot interval computed on its own. No system is solved.
+   */
+  virtual void fitCurve(const std::vector<Time>& times, const std::vector<ValueType>& values,
+                        const std::vector<DerivativeType>& firstDerivatives,
+                        const std::vector<DerivativeType>& secondDerivatives,
+                        std::vector<Key>* outKeys = NULL)
+  {
+    container_->setData(times, values, firstDerivatives, secondDerivatives);
+    minTime_ = times.front();
+  }
+
+  /*! Fit several curves to the same knot times. Column j of values (knots x curves) is
+   *  fitted by curves[j]. The spline system only depends on the knot times, so it is
+   *  solved once for all curves, with the solver type of the first curve.
+   */
+  static void fitCurves(const std::vector<Time>& times, const Eigen::MatrixXd& values,
+                        const std::vector<PolynomialSplineScalarCurve*>& curves)
+  {
+    std::vector<Container*> containers;
+    containers.reserve(curves.size());
+    for (auto curve : curves) {
+      containers.push_back(curve->container_.get());
+      curve->minTime_ = times.front();
+    }
+    const Eigen::VectorXd zero = Eigen::VectorXd::Zero(curves.size());
+    Container::setData(times, values, zero, zero, zero, zero, containers);
+  }
+
+  //! Get the splines of the curve, which start at getMinTime().
+  const Container& getSplineContainer() const
+  {
+    return *container_;
+  }
+
+  //! Replace the splines of the curve by given ones, starting at minTime, without a fit.
+  void setSplines(typename Container::SplineList splines, Time minTime)
+  {
+    container_->reset();
+    for (auto& spline : splines) {
+      container_->addSpline(std::move(spline));
+    }
+    minTime_ = minTime;
+  }
+
   virtual void fitCurve(const std::vector<SplineOptions>& optionList,
                         std::vector<Key>* outKeys = NULL)
   {
     for (const auto& options : optionList) {
-      PolynomialSplineQuintic spline;
+      SplineType spline;
       spline.computeCoefficients(options);
-      container_.addSpline(spline);
+      container_->addSpline(spline);
     }
     minTime_ = 0.0;
   }
 
   virtual void clear()
   {
-    container_.reset();
+    container_->reset();
     minTime_ = 0.0;
   }
 
@@ -140,12 +341,35 @@ class PolynomialSplineScalarCurve : public Curve<ScalarCurveConfig>
   }
 
  private:
-  PolynomialSplineContainer container_;
+  //! Evaluate the derivative of order derivativeOrder at sorted times, one array kernel call per spline.
+  template<unsigned int derivativeOrder>
+  void evaluateAtTimes(const std::vector<Time>& times, std::vector<double>* values) const
+  {
+    values->resize(times.size());
+    const Eigen::ArrayXd localTimes = Eigen::Map<const Eigen::ArrayXd>(times.data(), times.size()) - minTime_;
+    container_->template getDerivativeAtTimes<derivativeOrder>(
+        localTimes, Eigen::Map<Eigen::ArrayXd>(values->data(), values->size()));
+  }
+
+  enum class AsyncFitState {
+    Idle,
+    Fitting,
+    Ready
+  };
+
+  //! Container evaluated by the curve (front buffer).
+  std::unique_ptr<Container> container_;
   Time minTime_;
+
+  //! Container written by the asynchronous fit (back buffer).
+  std::unique_ptr<Container> backContainer_;
+  Time backMinTime_;
+  std::atomic<AsyncFitState> asyncFitState_;
+  std::thread asyncFitThread_;
 };
 
 typedef PolynomialSplineScalarCurve<PolynomialSplineQuintic> PolynomialSplineQuinticScalarCurve;
-//typedef PolynomialSplineScalarCurve<PolynomialSplineCubic> PolynomialSplineCubicScalarCurve;
+typedef PolynomialSplineScalarCurve<PolynomialSplineCubic> PolynomialSplineCubicScalarCurve;
 //typedef PolynomialSplineScalarCurve<PolynomialSplineLinear> PolynomialSplineLinearScalarCurve;
 
 } // namespace
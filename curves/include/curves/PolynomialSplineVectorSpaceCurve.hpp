@@ -26,6 +26,10 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
   typedef VectorSpaceCurve<N> Parent;
   typedef typename Parent::ValueType ValueType;
   typedef typename Parent::DerivativeType DerivativeType;
+  typedef PolynomialSplineContainerT<SplineType> Container;
+
+  template <int, unsigned int>
+  friend class CurveBatch;
 
   PolynomialSplineVectorSpaceCurve()
       : VectorSpaceCurve<N>(),
@@ -52,6 +56,23 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
     return containers_.at(0).getContainerDuration();
   }
 
+  //! The knot times, where the splines start and the last one ends.
+  void getCurveTimes(std::vector<Time>* outTimes) const
+  {
+    CHECK_NOTNULL(outTimes);
+    outTimes->clear();
+    const Container& container = containers_.at(0);
+    if (container.isEmpty()) {
+      return;
+    }
+    Time time = 0.0;
+    outTimes->push_back(time);
+    for (const auto& spline : container.getSplines()) {
+      time += spline.getSplineDuration();
+      outTimes->push_back(time);
+    }
+  }
+
   virtual bool evaluate(ValueType& value, Time time) const
   {
     for (size_t i = 0; i < N; ++i) {
@@ -77,22 +98,140 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
     return true;
   }
 
+  //! Evaluate the value and its first and second derivatives at time with a single spline lookup per dimension.
+  bool evaluateState(ValueType& value, DerivativeType& velocity, DerivativeType& acceleration, Time time) const
+  {
+    for (size_t i = 0; i < N; ++i) {
+      const typename Container::State state = containers_.at(i).evaluateState(time);
+      value(i) = state.position;
+      velocity(i) = state.velocity;
+      acceleration(i) = state.acceleration;
+    }
+    return true;
+  }
+
+  /*! Get the componentwise bounds of the value and its first and second derivatives over the
+   *  times [t0, t1], see PolynomialSplineContainer::getBounds. Returns false if the curve is empty.
+   */
+  bool getBounds(Time t0, Time t1, ValueType& minValue, ValueType& maxValue,
+                 DerivativeType& minVelocity, DerivativeType& maxVelocity,
+                 DerivativeType& minAcceleration, DerivativeType& maxAcceleration) const
+  {
+    if (containers_.at(0).isEmpty()) {
+      return false;
+    }
+    for (size_t i = 0; i < N; ++i) {
+      const typename Container::Bounds bounds = containers_.at(i).getBounds(t0, t1);
+      minValue(i) = bounds.minPosition;
+      maxValue(i) = bounds.maxPosition;
+      minVelocity(i) = bounds.minVelocity;
+      maxVelocity(i) = bounds.maxVelocity;
+      minAcceleration(i) = bounds.minAcceleration;
+      maxAcceleration(i) = bounds.maxAcceleration;
+    }
+    return true;
+  }
+
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const
+  {
+    CHECK_NOTNULL(values);
+    values->resize(times.size());
+    for (size_t j = 0; j < N; ++j) {
+      const Container& container = containers_.at(j);
+      if (container.isEmpty()) {
+        return Parent::evaluate(times, values);
+      }
+      const auto& splines = container.getSplines();
+      int splineIdx = 0;
+      double timeOffset = 0.0;
+      for (size_t i = 0; i < times.size(); ++i) {
+        splineIdx = container.getActiveSplineIndexAtTime(times[i], timeOffset, splineIdx);
+        (*values)[i](j) = splines[splineIdx].getPositionAtTime(times[i] - timeOffset);
+      }
+    }
+    return true;
+  }
+
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* values,
+                                  unsigned derivativeOrder) const
+  {
+    CHECK_NOTNULL(values);
+    if (derivativeOrder < 1 || derivativeOrder > 2) {
+      return false;
+    }
+    values->resize(times.size());
+    for (size_t j = 0; j < N; ++j) {
+      const Container& container = containers_.at(j);
+      if (container.isEmpty()) {
+        return Parent::evaluateDerivative(times, values, derivativeOrder);
+      }
+      const auto& splines = container.getSplines();
+      int splineIdx = 0;
+      double timeOffset = 0.0;
+      for (size_t i = 0; i < times.size(); ++i) {
+        splineIdx = container.getActiveSplineIndexAtTime(times[i], timeOffset, splineIdx);
+        if (derivativeOrder == 1) {
+          (*values)[i](j) = splines[splineIdx].getVelocityAtTime(times[i] - timeOffset);
+        } else {
+          (*values)[i](j) = splines[splineIdx].getAccelerationAtTime(times[i] - timeOffset);
+        }
+      }
+    }
+    return true;
+  }
+
+  /*! Append knots after the end of the curve with zero final velocities and accelerations, see
+   *  PolynomialSplineContainer::appendKnot. The existing splines are kept. An empty curve is
+   *  fitted to the knots instead.
+   */
   virtual void extend(const std::vector<Time>& times, const std::vector<ValueType>& values,
                       std::vector<Key>* outKeys)
   {
-    throw std::runtime_error("PolynomialSplineVectorSpaceCurve::extend is not yet implemented!");
+    CHECK_EQ(times.size(), values.size());
+    if (containers_.at(0).isEmpty()) {
+      fitCurve(times, values, outKeys);
+      return;
+    }
+    for (size_t i = 0; i < times.size(); ++i) {
+      const double duration = times[i] - getMaxTime();
+      for (size_t j = 0; j < N; ++j) {
+        CHECK(containers_.at(j).appendKnot(duration, values[i](j)))
+            << "The curve can only be extended into the future.";
+      }
+    }
+  }
+
+  //! Get the splines of one dimension of the curve.
+  const Container& getSplineContainer(size_t dimension) const
+  {
+    return containers_.at(dimension);
+  }
+
+  //! Replace the splines of one dimension by given ones without a fit. All dimensions must
+  //! be given splines of the same durations.
+  void setSplines(size_t dimension, typename Container::SplineList splines, Time minTime)
+  {
+    Container& container = containers_.at(dimension);
+    container.reset();
+    for (auto& spline : splines) {
+      container.addSpline(std::move(spline));
+    }
+    minTime_ = minTime;
+  }
+
+  //! Set the solver used by the fitCurve methods working on knots.
+  void setSolverType(typename Container::SolverType solverType)
+  {
+    for (auto& container : containers_) {
+      container.setSolverType(solverType);
+    }
   }
 
   virtual void fitCurve(const std::vector<Time>& times, const std::vector<ValueType>& values,
                         std::vector<Key>* outKeys = NULL)
   {
-    minTime_ = times.front();
-    for (size_t i = 0; i < N; ++i) {
-      std::vector<double> scalarValues;
-      scalarValues.reserve(times.size());
-      for (size_t t = 0; t < times.size(); ++t) scalarValues.push_back(values.at(t)(i));
-      containers_.at(i).setData(times, scalarValues, 0.0, 0.0, 0.0, 0.0);
-    }
+    const DerivativeType zero = DerivativeType::Zero();
+    fitCurve(times, values, zero, zero, zero, zero);
   }
 
   virtual void fitCurve(const std::vector<Time>& times,
@@ -103,13 +242,18 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
                         const DerivativeType& finalAcceleration)
   {
     minTime_ = times.front();
-    for (size_t i = 0; i < N; ++i) {
-      std::vector<double> scalarValues;
-      scalarValues.reserve(times.size());
-      for (size_t t = 0; t < times.size(); ++t) scalarValues.push_back(values.at(t)(i));
-      containers_.at(i).setData(times, scalarValues, initialVelocity(i), initialAcceleration(i),
-                                finalVelocity(i), finalAcceleration(i));
+    // All dimensions share the knot times, so the spline system is solved once for all of them.
+    Eigen::MatrixXd knotValues(times.size(), N);
+    for (size_t t = 0; t < times.size(); ++t) {
+      knotValues.row(t) = values.at(t).transpose();
+    }
+    std::vector<Container*> containers;
+    containers.reserve(N);
+    for (auto& container : containers_) {
+      containers.push_back(&container);
     }
+    Container::setData(times, knotValues, initialVelocity, initialAcceleration,
+                       finalVelocity, finalAcceleration, containers);
   }
 
   virtual void fitCurve(const std::vector<Time>& times, const std::vector<ValueType>& values,
@@ -117,19 +261,21 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
                         const std::vector<DerivativeType>& secondDerivatives,
                         std::vector<Key>* outKeys = NULL)
   {
+    CHECK_EQ(times.size(), values.size());
+    CHECK_EQ(times.size(), firstDerivatives.size());
+    CHECK_EQ(times.size(), secondDerivatives.size());
     minTime_ = times.front();
+    // All derivatives are given, so every spline is computed on its own.
+    std::vector<double> knotValues(times.size());
+    std::vector<double> knotVelocities(times.size());
+    std::vector<double> knotAccelerations(times.size());
     for (size_t i = 0; i < N; ++i) {
-      std::vector<double> scalarValues, scalarFirstDerivates, scalarSecondDerivates;
-      scalarValues.reserve(times.size());
       for (size_t t = 0; t < times.size(); ++t) {
-        scalarValues.push_back(values.at(t)(i));
-        scalarFirstDerivates.push_back(firstDerivatives.at(t)(i));
-        scalarSecondDerivates.push_back(secondDerivatives.at(t)(i));
+        knotValues[t] = values[t](i);
+        knotVelocities[t] = firstDerivatives[t](i);
+        knotAccelerations[t] = secondDerivatives[t](i);
       }
-      // TODO Copy all derivates, right now only first and last are supported.
-      containers_.at(i).setData(times, scalarValues,
-                                *(scalarFirstDerivates.begin()), *(scalarSecondDerivates.begin()),
-                                *(scalarFirstDerivates.end() - 1), *(scalarSecondDerivates.end() - 1));
+      containers_.at(i).setData(times, knotValues, knotVelocities, knotAccelerations);
     }
   }
 
@@ -154,7 +300,7 @@ class PolynomialSplineVectorSpaceCurve : public VectorSpaceCurve<N>
   }
 
  private:
-  std::vector<PolynomialSplineContainer> containers_;
+  std::vector<Container> containers_;
   Time minTime_;
 };
 
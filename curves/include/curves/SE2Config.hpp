@@ -8,14 +8,113 @@
 #define SE2CONFIG_H_
 
 #include <Eigen/Core>
-#include "gtsam/geometry/Pose2.h"
+#include <cmath>
 
 namespace curves {
 
 typedef Eigen::Matrix<double, 3, 1> Vector3d;
 
+/// \brief Rigid transformation in the plane, a position and a heading angle.
+///
+/// The rotation is only stored as its angle, wrapped to [-pi, pi), so a transformation is
+/// three unaligned doubles and needs no aligned allocator. Rotation matrices are built on
+/// demand from one sine and cosine.
+class SE2Transformation {
+ public:
+  typedef Eigen::Matrix<double, 2, 1, Eigen::DontAlign> Position;
+
+  SE2Transformation() : position_(Position::Zero()), angle_(0.0) {}
+
+  SE2Transformation(const Eigen::Vector2d& position, double angle)
+      : position_(position), angle_(wrapAngle(angle)) {}
+
+  SE2Transformation(double x, double y, double angle)
+      : position_(x, y), angle_(wrapAngle(angle)) {}
+
+  Eigen::Vector2d getPosition() const {
+    return position_;
+  }
+
+  double x() const {
+    return position_.x();
+  }
+
+  double y() const {
+    return position_.y();
+  }
+
+  /// The heading angle in [-pi, pi).
+  double getAngle() const {
+    return angle_;
+  }
+
+  Eigen::Matrix2d getRotationMatrix() const {
+    return getRotationMatrix(angle_);
+  }
+
+  /// Transform a point from the frame of the transformation into the reference frame.
+  Eigen::Vector2d transform(const Eigen::Vector2d& point) const {
+    return getRotationMatrix() * point + Eigen::Vector2d(position_);
+  }
+
+  SE2Transformation operator*(const SE2Transformation& other) const {
+    return SE2Transformation(transform(other.getPosition()), angle_ + other.angle_);
+  }
+
+  SE2Transformation inverse() const {
+    return SE2Transformation(-(getRotationMatrix().transpose() * Eigen::Vector2d(position_)), -angle_);
+  }
+
+  /// \brief Logarithm as the twist coordinates (rho_x, rho_y, theta).
+  Vector3d logarithm() const {
+    // V is a scaled rotation, its inverse is the transpose over the determinant.
+    const Eigen::Matrix2d V = getV(angle_);
+    const Eigen::Vector2d rho = V.transpose() * Eigen::Vector2d(position_) / V.col(0).squaredNorm();
+    return Vector3d(rho.x(), rho.y(), angle_);
+  }
+
+  /// \brief Exponential of the twist coordinates (rho_x, rho_y, theta), see logarithm.
+  static SE2Transformation exponential(const Vector3d& twist) {
+    return SE2Transformation(getV(twist.z()) * twist.head<2>(), twist.z());
+  }
+
+  /// Wrap an angle to [-pi, pi).
+  static double wrapAngle(double angle) {
+    return angle - 2.0 * M_PI * std::floor((angle + M_PI) / (2.0 * M_PI));
+  }
+
+  static Eigen::Matrix2d getRotationMatrix(double angle) {
+    const double c = std::cos(angle);
+    const double s = std::sin(angle);
+    Eigen::Matrix2d rotation;
+    rotation << c, -s, s, c;
+    return rotation;
+  }
+
+ private:
+  /// The left Jacobian of SO(2), which maps rho to the position of the exponential.
+  static Eigen::Matrix2d getV(double theta) {
+    double a, b;
+    if (std::abs(theta) < 1e-4) {
+      const double theta2 = theta * theta;
+      a = 1.0 - theta2 / 6.0;
+      b = 0.5 * theta - theta * theta2 / 24.0;
+    } else {
+      a = std::sin(theta) / theta;
+      b = (1.0 - std::cos(theta)) / theta;
+    }
+    Eigen::Matrix2d V;
+    V << a, -b, b, a;
+    return V;
+  }
+
+  Position position_;
+  double angle_;
+};
+
 struct SE2Config {
-  typedef gtsam::Pose2 ValueType;
+  typedef SE2Transformation ValueType;
+  /// The linear velocity in the reference frame and the angular velocity (vx, vy, omega).
   typedef Vector3d DerivativeType;
 };
 
@@ -28,6 +28,18 @@ class SE2Curve : public Curve<SE2Config> {
   typedef Parent::ValueType ValueType;
   typedef Parent::DerivativeType DerivativeType;
 
+  /// \brief Set the minimum sampling period
+  virtual void setMinSamplingPeriod(Time time) = 0;
+
+  /// \brief Set the sampling ratio.
+  ///   eg. 4 will add a coefficient every 4 extend
+  virtual void setSamplingRatio(const int ratio) = 0;
+
+  virtual void getCurveTimes(std::vector<Time>* outTimes) const = 0;
+
+  virtual bool isEmpty() const = 0;
+
+  virtual int size() const = 0;
 };
 
 }  // namespace curves
@@ -11,7 +11,9 @@
 //     on base is computed resulting in
 //     interpolation(corr(t1) * base(t1), corr(t2) * base(t2), alpha)
 
+#ifndef COMPOSITION_STRATEGY
 #define COMPOSITION_STRATEGY 1
+#endif
 
 #include "curves/SE3CompositionCurve.hpp"
 #include "curves/helpers.hpp"
@@ -19,7 +21,9 @@
 namespace curves{
 
 template <class C1, class C2>
-SE3CompositionCurve<C1, C2>::SE3CompositionCurve() {
+SE3CompositionCurve<C1, C2>::SE3CompositionCurve() :
+    correctionCache_(std::make_shared<CorrectionCache>()),
+    numThreads_(1) {
 
 }
 
@@ -167,6 +171,7 @@ void SE3CompositionCurve<C1, C2>::extend(const std::vector<Time>& times,
     correctionValues.push_back(correctionCurve_.evaluate(correctionCurve_.getMinTime()));
     correctionCurve_.extend(correctionTimes, correctionValues);
   }
+  invalidateCorrectionCache();
 
   //Compute the base curve updates accounting for the corrections
   std::vector<ValueType> newValues;
@@ -184,19 +189,15 @@ void SE3CompositionCurve<C1, C2>::foldInCorrections() {
   std::vector<Time> times;
   std::vector<ValueType> newValues;
   baseCurve_.manager_.getTimes(&times);
-  for (std::vector<Time>::const_iterator it = times.begin(); it != times.end(); ++it) {
-    newValues.push_back(this->evaluate(*it));
-  }
+  CHECK(this->evaluate(times, &newValues)) << "Unable to evaluate the curve at the base times.";
   baseCurve_.clear();
   baseCurve_.extend(times,newValues);
   times.clear();
-  newValues.clear();
   correctionCurve_.manager_.getTimes(&times);
-  for (std::vector<Time>::const_iterator it = times.begin(); it != times.end(); ++it) {
-    newValues.push_back(ValueType(ValueType::Position(0,0,0), ValueType::Rotation(1,0,0,0)));
-  }
+  newValues.assign(times.size(), ValueType(ValueType::Position(0,0,0), ValueType::Rotation(1,0,0,0)));
   correctionCurve_.clear();
   correctionCurve_.extend(times,newValues);
+  invalidateCorrectionCache();
 }
 
 template <class C1, class C2>
@@ -217,70 +218,166 @@ void SE3CompositionCurve<C1, C2>::setCorrectionTimes(const std::vector<Time>& ti
   // Redefine the correction curve
   correctionCurve_.clear();
   correctionCurve_.extend(times, values);
+  invalidateCorrectionCache();
 
   CHECK_EQ(correctionCurve_.getMinTime(), baseCurve_.getMinTime()) << "Min time of correction curve and base curve are different";
   CHECK_EQ(correctionCurve_.getMaxTime(), baseCurve_.getMaxTime()) << "Min time of correction curve and base curve are different";
 }
 
+#if COMPOSITION_STRATEGY == 2
+SE3Curve::ValueType transformationPower(SE3Curve::ValueType T, double alpha);
+#endif
+
 template <class C1, class C2>
-typename SE3CompositionCurve<C1, C2>::ValueType SE3CompositionCurve<C1, C2>::evaluate(Time time) const{
+bool SE3CompositionCurve<C1, C2>::evaluate(ValueType& value, Time time) const {
+  Cursor cursor;
+  return evaluate(value, time, &cursor);
+}
 
+template <class C1, class C2>
+bool SE3CompositionCurve<C1, C2>::evaluate(ValueType& value, Time time, Cursor* cursor) const {
+  CHECK_NOTNULL(cursor);
 #if COMPOSITION_STRATEGY == 1
   // (1) corr(t) * base(t) is implemented
-  return correctionCurve_.evaluate(time) * baseCurve_.evaluate(time);
+  ValueType correction, base;
+  if (!correctionCurve_.evaluate(correction, time, &cursor->correction) ||
+      !baseCurve_.evaluate(base, time, &cursor->base)) {
+    return false;
+  }
+  value = correction * base;
+  return true;
 #elif COMPOSITION_STRATEGY == 2
   // (2) corr is evaluated at the coefficient times (t1, t2) where the interpolation
   //     on base is computed resulting in
   //     interpolation(corr(t1) * base(t1), corr(t2) * base(t2), alpha)
-  if (time == 0) {
-    return correctionCurve_.evaluate(time) * baseCurve_.evaluate(time);
+  // The base curve interpolates its coefficients, so base(t1) and base(t2) are
+  // read from the bracketing coefficients.
+  typename C1::CoefficientIter it1, it2;
+  if (!baseCurve_.manager_.getCoefficientsAt(time, &cursor->base, &it1, &it2)) {
+    // The base curve might only be defined at this one time.
+    if (baseCurve_.size() != 1 || time != baseCurve_.getMinTime()) {
+      return false;
+    }
+    it1 = it2 = baseCurve_.manager_.coefficientBegin();
   }
 
-  typename C2::CoefficientIter it1, it2;
-  baseCurve_.manager_.getCoefficientsAt(time, &it1, &it2);
-  //todo Is it true that the value of a curve at a time where a coefficient
-  // is defined is always only dependent on this coefficient?
-  if(it1->first == time || it2->first == time) {
-    return correctionCurve_.evaluate(time) * baseCurve_.evaluate(time);
-  } else {
-    Time tA, tB;
-    ValueType A, B, dA, dB, T_W_A, T_W_B;
-    //if the iterators returned are in order ( last element bug)
-    if (it1->first < it2->first) {
-      tA = it1->first;
-      tB = it2->first;
-    } else {
-      tA = it2->first;
-      tB = it1->first;
+  ValueType dA;
+  if (it1->first == time || it2->first == time) {
+    const typename C1::CoefficientIter it = (it1->first == time) ? it1 : it2;
+    if (!getCorrectionAtBaseTime(it->first, &dA, &cursor->correction)) {
+      return false;
     }
+    value = dA * it->second.coefficient;
+    return true;
+  }
 
-    double alpha = double(time - tA)/double(tB - tA);
+  ValueType dB;
+  if (!getCorrectionAtBaseTime(it1->first, &dA, &cursor->correction) ||
+      !getCorrectionAtBaseTime(it2->first, &dB, &cursor->correction)) {
+    return false;
+  }
+  const ValueType T_W_A = dA * it1->second.coefficient;
+  const ValueType T_W_B = dB * it2->second.coefficient;
+  const double alpha = double(time - it1->first)/double(it2->first - it1->first);
 
-    A = baseCurve_.evaluate(tA);
-    B = baseCurve_.evaluate(tB);
-    dA = correctionCurve_.evaluate(tA);
-    dB = correctionCurve_.evaluate(tB);
+  // T_W_I = T_W_A * (inv(T_W_A) * T_W_B)^alpha
+  value = T_W_A * transformationPower(T_W_A.inverted() * T_W_B, alpha);
+  return true;
+#endif
+}
 
-    T_W_A = dA * A;
-    T_W_B = dB * B;
+template <class C1, class C2>
+typename SE3CompositionCurve<C1, C2>::ValueType SE3CompositionCurve<C1, C2>::evaluate(Time time) const{
+  ValueType value;
+  CHECK(evaluate(value, time)) << "Unable to evaluate the composed curve at time " << time;
+  return value;
+}
 
-    //Implementation of T_W_I = T_W_A*exp(alpha*log(inv(T_W_A)*T_W_B))
-    using namespace kindr::minimal;
-    ValueType T_A_B = invertAndComposeImplementation(T_W_A, T_W_B, boost::none, boost::none);
-    gtsam::Vector6 log_T_A_B = transformationLogImplementation(T_A_B, boost::none);
-    gtsam::Vector6 log_T_A_I = vectorScalingImplementation<int(6)>(log_T_A_B, alpha, boost::none, boost::none);
-    ValueType T_A_I = transformationExpImplementation(log_T_A_I, boost::none);
-    return composeImplementation(T_W_A, T_A_I, boost::none, boost::none);
+template <class C1, class C2>
+bool SE3CompositionCurve<C1, C2>::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  CHECK_NOTNULL(values);
+#if COMPOSITION_STRATEGY == 1
+  values->resize(times.size());
+  const size_t minBlockSize = 1024;
+  const size_t numBlocks = std::max<size_t>(1, std::min<size_t>(getNumberOfThreads(numThreads_),
+                                                                times.size() / minBlockSize));
+  const size_t blockSize = (times.size() + numBlocks - 1) / numBlocks;
+  std::vector<char> blockSuccess(numBlocks, 0);
+  parallelFor(0, numBlocks, [&](size_t block) {
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, times.size());
+    std::vector<Time> blockTimes;
+    if (numBlocks > 1) {
+      blockTimes.assign(times.begin() + begin, times.begin() + end);
+    }
+    const std::vector<Time>& queryTimes = (numBlocks > 1) ? blockTimes : times;
+    std::vector<ValueType> corrections, bases;
+    bool success = correctionCurve_.evaluate(queryTimes, &corrections);
+    success = baseCurve_.evaluate(queryTimes, &bases) && success;
+    for (size_t i = 0; i < queryTimes.size(); ++i) {
+      (*values)[begin + i] = corrections[i] * bases[i];
+    }
+    blockSuccess[block] = success;
+  }, numThreads_, 1);
+  return std::find(blockSuccess.begin(), blockSuccess.end(), 0) == blockSuccess.end();
+#elif COMPOSITION_STRATEGY == 2
+  // Strategy (2) interpolates between base coefficients, which evaluate(value, time, cursor)
+  // does with the cached corrections.
+  values->resize(times.size());
+  Cursor cursor;
+  for (size_t i = 0; i < times.size(); ++i) {
+    if (!evaluate((*values)[i], times[i], &cursor)) {
+      return false;
+    }
   }
+  return true;
 #endif
 }
 
+template <class C1, class C2>
+void SE3CompositionCurve<C1, C2>::setNumberOfThreads(unsigned int numThreads) {
+  numThreads_ = numThreads;
+}
+
+template <class C1, class C2>
+bool SE3CompositionCurve<C1, C2>::getCorrectionAtBaseTime(Time time, SE3Curve::ValueType* value,
+                                                          typename C2::CoefficientCursor* cursor) const {
+  CorrectionCache& cache = *correctionCache_;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    typename TimeToValueMap::const_iterator it = cache.values.find(time);
+    if (it != cache.values.end()) {
+      *value = it->second;
+      return true;
+    }
+  }
+  // Evaluate outside the lock, a concurrent query inserting the same value first is harmless.
+  if (!correctionCurve_.evaluate(*value, time, cursor)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.values.insert(typename TimeToValueMap::value_type(time, *value));
+  return true;
+}
+
+template <class C1, class C2>
+void SE3CompositionCurve<C1, C2>::invalidateCorrectionCache() {
+  // Copies may still share the old cache, so it is replaced instead of cleared.
+  correctionCache_ = std::make_shared<CorrectionCache>();
+}
+
 template <class C1, class C2>
 typename SE3CompositionCurve<C1, C2>::DerivativeType SE3CompositionCurve<C1, C2>::evaluateDerivative(Time time,
                                                                                                      unsigned derivativeOrder) const{
   //todo
 }
 
+template <class C1, class C2>
+bool SE3CompositionCurve<C1, C2>::evaluateDerivative(DerivativeType& derivative, Time time,
+                                                     unsigned derivativeOrder) const {
+  return false;
+}
+
 template <class C1, class C2>
 void SE3CompositionCurve<C1, C2>::setTimeRange(Time minTime, Time maxTime){
   //todo
@@ -350,17 +447,20 @@ template <class C1, class C2>
 void SE3CompositionCurve<C1, C2>::clear(){
   baseCurve_.clear();
   correctionCurve_.clear();
+  invalidateCorrectionCache();
 }
 
 template <class C1, class C2>
 void SE3CompositionCurve<C1, C2>::removeCorrectionCoefficientAtTime(Time time) {
   CHECK(correctionCurve_.manager_.hasCoefficientAtTime(time));
   correctionCurve_.manager_.removeCoefficientAtTime(time);
+  invalidateCorrectionCache();
 }
 template <class C1, class C2>
 void SE3CompositionCurve<C1, C2>::setCorrectionCoefficientAtTime(Time time, ValueType value) {
   CHECK(correctionCurve_.manager_.hasCoefficientAtTime(time));
   correctionCurve_.manager_.insertCoefficient(time, value);
+  invalidateCorrectionCache();
 }
 
 template <class C1, class C2>
@@ -379,6 +479,7 @@ void SE3CompositionCurve<C1, C2>::resetCorrectionCurve(const std::vector<Time>&
 
   // Redefine the correction curve
   correctionCurve_.fitCurve(times, values);
+  invalidateCorrectionCache();
 
   CHECK_EQ(correctionCurve_.getMinTime(), baseCurve_.getMinTime()) << "Min time of correction curve and base curve are different";
   CHECK_EQ(correctionCurve_.getMaxTime(), baseCurve_.getMaxTime()) << "Min time of correction curve and base curve are different";
@@ -417,10 +518,12 @@ template <class C1, class C2>
 void SE3CompositionCurve<C1, C2>::saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const {
   Eigen::VectorXd v(7);
 
+  std::vector<ValueType> values;
+  CHECK(evaluate(times, &values)) << "Unable to evaluate the curve at the given times.";
   std::vector<Eigen::VectorXd> curveValues;
-  ValueType val;
+  curveValues.reserve(times.size());
   for (size_t i = 0; i < times.size(); ++i) {
-    val = evaluate(times[i]);
+    const ValueType& val = values[i];
     v << val.getPosition().x(), val.getPosition().y(), val.getPosition().z(),
         val.getRotation().w(), val.getRotation().x(), val.getRotation().y(), val.getRotation().z();
     curveValues.push_back(v);
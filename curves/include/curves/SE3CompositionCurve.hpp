@@ -4,7 +4,12 @@
  * @author Renaud Dubé, Abel Gawel, Mike Bosse
  */
 
+#include "curves/ParallelFor.hpp"
 #include "curves/SE3Curve.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #pragma once
 
@@ -22,10 +27,39 @@ class SE3CompositionCurve : public SE3Curve {
   C1 baseCurve_;
   C2 correctionCurve_;
 
+  typedef std::map<Time, SE3Curve::ValueType, std::less<Time>,
+      Eigen::aligned_allocator<std::pair<const Time, SE3Curve::ValueType> > > TimeToValueMap;
+
+  /// \brief Correction values at the base coefficient times, filled by the const evaluate.
+  /// The mutex makes concurrent evaluations of one curve safe.
+  struct CorrectionCache {
+    std::mutex mutex;
+    TimeToValueMap values;
+  };
+
+  /// Copies of the curve share the cache until one of them changes its correction curve,
+  /// which replaces its cache by an empty one, see invalidateCorrectionCache.
+  std::shared_ptr<CorrectionCache> correctionCache_;
+
+  unsigned int numThreads_;
+
+  /// \brief Get the correction at a base coefficient time, from the cache if possible.
+  bool getCorrectionAtBaseTime(Time time, SE3Curve::ValueType* value,
+                               typename C2::CoefficientCursor* cursor) const;
+
+  /// \brief Forget the cached corrections, call after modifying the correction curve.
+  void invalidateCorrectionCache();
+
  public:
   typedef SE3Curve::ValueType ValueType;
   typedef SE3Curve::DerivativeType DerivativeType;
 
+  /// \brief Segments of the last query of both curves, see evaluate(ValueType&, Time, Cursor*).
+  struct Cursor {
+    typename C1::CoefficientCursor base;
+    typename C2::CoefficientCursor correction;
+  };
+
   SE3CompositionCurve();
   ~SE3CompositionCurve();
 
@@ -82,9 +116,32 @@ class SE3CompositionCurve : public SE3Curve {
     /// \brief Add coefficients to the correction curve at given times.
     void setCorrectionTimes(const std::vector<Time>& times);
 
+    /// \brief Evaluate the ambient space of the curve.
+    ///
+    /// With the second composition strategy the corrections at the base coefficient
+    /// times are cached. The cache is locked, so like the other curves a composed curve
+    /// can be evaluated by several threads as long as none of them modifies it.
+    virtual bool evaluate(ValueType& value, Time time) const;
+
+    /// \brief Evaluate the ambient space of the curve, searching both curves through cursor.
+    ///
+    /// Queries at increasing times reuse the segments found before. A cursor must not be
+    /// shared between threads.
+    bool evaluate(ValueType& value, Time time, Cursor* cursor) const;
+
     /// Evaluate the ambient space of the curve.
     virtual ValueType evaluate(Time time) const;
 
+    /// \brief Evaluate the curve at many times.
+    ///
+    /// Both curves are evaluated with their batch evaluation, split into blocks on
+    /// the threads set with setNumberOfThreads. Sorted times are fastest.
+    virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+    /// \brief Set the number of threads used for batch evaluations and foldInCorrections,
+    ///        0 meaning all hardware threads. Defaults to 1.
+    void setNumberOfThreads(unsigned int numThreads);
+
     /// Evaluate the curve derivatives.
     /// linear 1st derivative has following behaviour:
     /// - time is out of bound --> error
@@ -94,6 +151,9 @@ class SE3CompositionCurve : public SE3Curve {
     /// derivatives of order >1 equal 0
     virtual DerivativeType evaluateDerivative(Time time, unsigned derivativeOrder) const;
 
+    /// \brief Derivatives of the composed curve are not implemented yet, always returns false.
+    virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const;
+
     virtual void setTimeRange(Time minTime, Time maxTime);
 
     /// \brief Evaluate the angular velocity of Frame b as seen from Frame a, expressed in Frame a.
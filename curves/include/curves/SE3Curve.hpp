@@ -11,6 +11,7 @@
 #include "curves/SE3Config.hpp"
 #include "curves/Curve.hpp"
 #include <Eigen/Core>
+#include <vector>
 
 namespace curves {
 
@@ -88,6 +89,17 @@ class SE3Curve : public Curve<SE3Config> {
   /// \brief Perform a rigid transformation on the left side of the curve
   virtual void transformCurve(const ValueType T) = 0;
 
+  /// \brief Transform points from Frame b to Frame a, each with the pose at its own time,
+  ///        e.g. to de-skew a lidar scan.
+  ///
+  /// Consecutive points with the same time form a bucket, the pose of which is evaluated once
+  /// with the batched evaluate() and converted to a rotation matrix once. The buckets are then
+  /// transformed as 3xN blocks, which Eigen vectorizes. Points sorted by time only search for
+  /// each segment once. Points at times outside of the curve are set to NaN and false is
+  /// returned, all points are if the curve fails to evaluate. pointsOut must not be pointsIn.
+  bool transformPoints(const std::vector<Time>& times, const Eigen::Matrix3Xd& pointsIn,
+                       Eigen::Matrix3Xd* pointsOut) const;
+
   virtual void saveCurveTimesAndValues(const std::string& filename) const = 0;
 
   virtual void saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const = 0;
@@ -148,4 +160,11 @@ class SE3Curve : public Curve<SE3Config> {
 
 };
 
+/// \brief Perform the same rigid transformation on the left side of all curves.
+///
+/// Distinct curves are transformed concurrently on up to numThreads threads (0 for all
+/// hardware threads), one thread per curve, see parallelFor.
+void transformCurves(const std::vector<SE3Curve*>& curves, const SE3Curve::ValueType& T,
+                     unsigned int numThreads = 1);
+
 } // namespace
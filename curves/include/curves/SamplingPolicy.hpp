@@ -9,6 +9,8 @@
 
 #include <typeinfo>
 
+#include "curves/KnotSimplification.hpp"
+
 namespace curves {
 
 class SamplingPolicy {
@@ -18,6 +20,7 @@ class SamplingPolicy {
   int minimumMeasurements_;
   Time minSamplingPeriod_;
   Time lastExtend_;
+  KnotTolerance simplificationTolerance_;
 
  public:
 
@@ -93,6 +96,16 @@ class SamplingPolicy {
   void setMeasurementsSinceLastExtend_(int num) {
     measurementsSinceLastExtend_ = num;
   }
+
+  /// Remove knots while extending if the curve reproduces them within the tolerance, see
+  /// KnotTolerance. Disabled by default.
+  void setSimplificationTolerance(const KnotTolerance& tolerance) {
+    simplificationTolerance_ = tolerance;
+  }
+
+  const KnotTolerance& getSimplificationTolerance() const {
+    return simplificationTolerance_;
+  }
 };
 
 } // namespace curves
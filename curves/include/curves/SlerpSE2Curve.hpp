@@ -7,27 +7,31 @@
 #ifndef CURVES_SLERP_SE2_CURVE_HPP
 #define CURVES_SLERP_SE2_CURVE_HPP
 
+#include <glog/logging.h>
+
 #include "SE2Curve.hpp"
+#include "EvaluationError.hpp"
 #include "LocalSupport2CoefficientManager.hpp"
-//#include "SE2CompositionCurve.hpp"
-#include "gtsam/nonlinear/NonlinearFactorGraph.h"
 #include "SamplingPolicy.hpp"
+#include "SortedArrayCoefficientStorage.hpp"
 
 namespace curves {
 
 /// Implements the Slerp (Spherical linear interpolation) curve class.
 /// The Slerp interpolation function is defined as, with the respective Jacobians regarding  A and B:
 /// \f[ T = A(A^{-1}B)^{\alpha} \f]
+///
+/// The coefficients are SE2Transformation, three doubles with the rotation as an angle, so
+/// planar motion is interpolated without the quaternions and 6-DoF storage of SlerpSE3Curve.
 class SlerpSE2Curve : public SE2Curve {
-  //friend class SE2CompositionCurve<SlerpSE2Curve, SlerpSE2Curve>;
-  //friend class SE2CompositionCurve<SlerpSE2Curve, CubicHermiteSE2Curve>;
   friend class SamplingPolicy;
  public:
   typedef SE2Curve::ValueType ValueType;
   typedef SE2Curve::DerivativeType DerivativeType;
   typedef ValueType Coefficient;
-  typedef LocalSupport2CoefficientManager<Coefficient>::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
-  typedef LocalSupport2CoefficientManager<Coefficient>::CoefficientIter CoefficientIter;
+  typedef LocalSupport2CoefficientManager<Coefficient, SortedArrayCoefficientStorage<Coefficient> > CoefficientManager;
+  typedef CoefficientManager::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
+  typedef CoefficientManager::CoefficientIter CoefficientIter;
 
   SlerpSE2Curve();
   virtual ~SlerpSE2Curve();
@@ -67,32 +71,29 @@ class SlerpSE2Curve : public SE2Curve {
                 const std::vector<ValueType>& values);
 
   /// Evaluate the ambient space of the curve.
-  virtual ValueType evaluate(Time time) const;
-
-  /// Evaluate the curve derivatives.
-  /// linear 1st derivative has following behaviour:
-  /// - time is out of bound --> error
-  /// - time is between 2 coefficients --> take slope between the 2 coefficients
-  /// - time is on coefficient (not last coefficient) --> take slope between coefficient and next coefficients
-  /// - time is on last coefficient --> take slope between last-1 and last coefficient
-  /// derivatives of order >1 equal 0
-  virtual DerivativeType evaluateDerivative(Time time, unsigned derivativeOrder) const;
-
-  /// \brief Get an evaluator at this time
-  virtual gtsam::Expression<ValueType> getValueExpression(const Time& time) const;
+  virtual bool evaluate(ValueType& value, Time time) const;
 
-  virtual gtsam::Expression<DerivativeType> getDerivativeExpression(const Time& time, unsigned derivativeOrder) const;
+  /// Evaluate the ambient space of the curve. Fails if the time is out of bounds.
+  ValueType evaluate(Time time) const;
 
-  virtual void setTimeRange(Time minTime, Time maxTime);
-
-  /// Initialize a GTSAM values structure with the desired keys
-  virtual void initializeGTSAMValues(gtsam::KeySet keys, gtsam::Values* values) const;
-
-  /// Initialize a GTSAM values structure for all keys
-  virtual void initializeGTSAMValues(gtsam::Values* values) const;
-
-  // updates the relevant curve coefficients from the GTSAM values structure
-  virtual void updateFromGTSAMValues(const gtsam::Values& values);
+  /// Evaluate the curve derivatives.
+  /// The twist is constant along a segment, the 1st derivative is the global linear velocity
+  /// and the angular velocity of the segment. Derivatives of order >1 equal 0.
+  virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const;
+
+  /// Evaluate the ambient space of the curve at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+  /// Evaluate the curve derivatives at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                                  unsigned derivativeOrder) const;
+
+  /// Number of failed evaluations of this curve, by error.
+  const EvaluationErrorCounters& getEvaluationErrorCounters() const {
+    return evaluationErrors_;
+  }
 
   // set minimum sampling period
   void setMinSamplingPeriod(Time time);
@@ -103,29 +104,27 @@ class SlerpSE2Curve : public SE2Curve {
 
   virtual void clear();
 
-  /// \brief Add factors to constrain the variables active at this time.
-  void addPriorFactors(gtsam::NonlinearFactorGraph* graph, Time priorTime) const;
-
   /// \brief Perform a rigid transformation on the left side of the curve
   void transformCurve(const ValueType T);
 
-  virtual Time getTimeAtKey(gtsam::Key key) const;
-
-  void saveCurveTimesAndValues(const std::string& filename) const;
+  void getCurveTimes(std::vector<Time>* outTimes) const;
 
  private:
-  LocalSupport2CoefficientManager<Coefficient> manager_;
-  SamplingPolicy slerpPolicy_;
-};
+  /// \brief Interpolate between the coefficients a and b given log(inv(T_W_A)*T_W_B).
+  ValueType interpolate(Time time, CoefficientIter a, CoefficientIter b, const Vector3d& twist) const;
 
-typedef gtsam::Pose2 SE2;
-typedef gtsam::Rot2 SO2;
+  /// \brief Derivative between the coefficients a and b given log(inv(T_W_A)*T_W_B).
+  DerivativeType interpolateDerivative(Time time, CoefficientIter a, CoefficientIter b,
+                                       const Vector3d& twist, unsigned derivativeOrder) const;
 
-SE2 transformationPower(SE2  T, double alpha);
+  CoefficientManager manager_;
+  SamplingPolicy slerpPolicy_;
 
-SE2 composeTransformations(SE2 A, SE2 B);
+  /// Failed evaluations, counted from const evaluation methods.
+  mutable EvaluationErrorCounters evaluationErrors_;
+};
 
-SE2 inverseTransformation(SE2 T);
+typedef SE2Transformation SE2;
 
 // extend policy for slerp curves
 template<>
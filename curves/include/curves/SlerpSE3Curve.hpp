@@ -9,6 +9,8 @@
 #pragma once
 
 #include "SE3Curve.hpp"
+#include "EvaluationError.hpp"
+#include "Instrumentation.hpp"
 #include "LocalSupport2CoefficientManager.hpp"
 #include "kindr/Core"
 #include "SE3CompositionCurve.hpp"
@@ -28,8 +30,23 @@ class SlerpSE3Curve : public SE3Curve {
   typedef SE3Curve::ValueType ValueType;
   typedef SE3Curve::DerivativeType DerivativeType;
   typedef ValueType Coefficient;
-  typedef LocalSupport2CoefficientManager<Coefficient>::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
-  typedef LocalSupport2CoefficientManager<Coefficient>::CoefficientIter CoefficientIter;
+  typedef LocalSupport2CoefficientManager<Coefficient, SortedArrayCoefficientStorage<Coefficient> > CoefficientManager;
+  typedef CoefficientManager::TimeToKeyCoefficientMap TimeToKeyCoefficientMap;
+  typedef CoefficientManager::CoefficientIter CoefficientIter;
+  typedef CoefficientManager::Cursor CoefficientCursor;
+
+  /// \brief Interpolation between two coefficients.
+  ///
+  /// Exact:       T = A(A^{-1}B)^{alpha}, through the logarithm and exponential of SE(3).
+  /// Approximate: The rotation follows a normalized quaternion lerp with a polynomial
+  ///              correction of alpha, within getMaxAngularError of the exact rotation, and
+  ///              the position is interpolated linearly. No logarithm or trigonometric
+  ///              function is evaluated. The position deviates from the screw motion of
+  ///              the exact mode on segments with large rotations.
+  enum class InterpolationMode {
+    Exact,
+    Approximate
+  };
 
   SlerpSE3Curve();
   virtual ~SlerpSE3Curve();
@@ -69,7 +86,10 @@ class SlerpSE3Curve : public SE3Curve {
                 const std::vector<ValueType>& values);
 
   /// Evaluate the ambient space of the curve.
-  virtual ValueType evaluate(Time time) const;
+  virtual bool evaluate(ValueType& value, Time time) const;
+
+  /// Evaluate the ambient space of the curve. Fails if the time is out of bounds.
+  ValueType evaluate(Time time) const;
 
   /// Evaluate the curve derivatives.
   /// linear 1st derivative has following behaviour:
@@ -78,10 +98,59 @@ class SlerpSE3Curve : public SE3Curve {
   /// - time is on coefficient (not last coefficient) --> take slope between coefficient and next coefficients
   /// - time is on last coefficient --> take slope between last-1 and last coefficient
   /// derivatives of order >1 equal 0
-  virtual DerivativeType evaluateDerivative(Time time, unsigned derivativeOrder) const;
+  virtual bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const;
+
+  /// Evaluate the curve derivatives. Fails if the time is out of bounds.
+  DerivativeType evaluateDerivative(Time time, unsigned derivativeOrder) const;
+
+  /// Evaluate the ambient space of the curve, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const;
+
+  /// Evaluate the curve derivatives, starting the segment search from a cursor.
+  /// The cursor may be NULL. See CurveCursor.
+  bool evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder,
+                          CoefficientCursor* cursor) const;
+
+  /// Evaluate the ambient space of the curve without any output on failure.
+  /// Failures are counted, see getEvaluationErrorCounters(). The cursor may be NULL.
+  EvaluationError tryEvaluate(ValueType& value, Time time, CoefficientCursor* cursor = NULL) const;
+
+  /// Evaluate the curve derivatives without any output on failure.
+  /// Failures are counted, see getEvaluationErrorCounters(). The cursor may be NULL.
+  EvaluationError tryEvaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder,
+                                        CoefficientCursor* cursor = NULL) const;
+
+  /// Number of failed evaluations of this curve, by error.
+  const EvaluationErrorCounters& getEvaluationErrorCounters() const {
+    return evaluationErrors_;
+  }
+
+  void resetEvaluationErrorCounters() {
+    evaluationErrors_.reset();
+  }
+
+  /// Evaluate the ambient space of the curve at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const;
+
+  /// Evaluate the curve derivatives at multiple times.
+  /// Sorted times are evaluated walking the segments linearly.
+  virtual bool evaluateDerivative(const std::vector<Time>& times, std::vector<DerivativeType>* derivatives,
+                                  unsigned derivativeOrder) const;
 
   virtual void setTimeRange(Time minTime, Time maxTime);
 
+  /// \brief Select the interpolation used by all evaluate methods, Exact by default.
+  ///        Derivatives are always evaluated exactly.
+  void setInterpolationMode(InterpolationMode mode);
+
+  InterpolationMode getInterpolationMode() const;
+
+  /// \brief Maximum angle in radians between the rotations of an interpolation mode and
+  ///        the exact rotations, for all segments of up to half a turn.
+  static double getMaxAngularError(InterpolationMode mode);
+
   /// \brief Evaluate the angular velocity of Frame b as seen from Frame a, expressed in Frame a.
   virtual Eigen::Vector3d evaluateAngularVelocityA(Time time);
 
@@ -133,13 +202,38 @@ class SlerpSE3Curve : public SE3Curve {
   ///   eg. 4 will add a coefficient every 4 extend
   void setSamplingRatio(const int ratio);
 
+  /// \brief Only keep the coefficients needed for the most recent part of the curve.
+  ///
+  /// See LocalSupport2CoefficientManager::setWindow. Old coefficients are dropped as the
+  /// curve is extended, so a curve that is extended forever uses bounded memory.
+  void setWindow(Time maxDuration, size_t maxCoefficients = 0);
+
   virtual void clear();
 
   /// \brief Perform a rigid transformation on the left side of the curve
   void transformCurve(const ValueType T);
 
+  /// \brief Remove the knots which the interpolation between their neighbours reproduces
+  ///        within the tolerance, see selectKnots. Returns the number of removed knots.
+  size_t simplify(const KnotTolerance& tolerance);
+
+  /// \brief Remove knots while the curve is extended, see SamplingPolicy::setSimplificationTolerance.
+  ///
+  /// Every appended knot is checked once, against the interpolation from the knot before
+  /// the last one, so extend stays constant time.
+  void setSimplificationTolerance(const KnotTolerance& tolerance);
+
   void saveCurveTimesAndValues(const std::string& filename) const;
 
+  /// \brief Save the coefficients to a binary curve file, see CurveFile.hpp.
+  bool saveCurveBinary(const std::string& filename) const;
+
+  /// \brief Replace the curve by the coefficients of a binary curve file.
+  bool loadCurveBinary(const std::string& filename);
+
+  /// \brief Replace the curve by the coefficients of a mapped binary curve file.
+  bool loadCurve(const MappedCurveFile& file);
+
   void saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const;
 
   void saveCorrectionCurveAtTimes(const std::string& filename, std::vector<Time> times) const {};
@@ -189,8 +283,35 @@ class SlerpSE3Curve : public SE3Curve {
   void saveCorrectionCurveTimesAndValues(const std::string& filename) const {};
 
  private:
-  LocalSupport2CoefficientManager<Coefficient> manager_;
+  /// \brief Interpolate between the coefficients a and b given log(inv(T_W_A)*T_W_B).
+  ValueType interpolate(Time time, CoefficientIter a, CoefficientIter b,
+                        const Eigen::Vector3d& phi, const Eigen::Vector3d& rho) const;
+
+  /// \brief Derivative between the coefficients a and b given log(inv(T_W_A)*T_W_B).
+  DerivativeType interpolateDerivative(Time time, CoefficientIter a, CoefficientIter b,
+                                       const Eigen::Vector3d& phi, const Eigen::Vector3d& rho,
+                                       unsigned derivativeOrder) const;
+
+  /// \brief Interpolate between the coefficients a and b with InterpolationMode::Approximate.
+  ValueType interpolateApproximately(Time time, CoefficientIter a, CoefficientIter b) const;
+
+  /// \brief Interpolate between the coefficients a and b with the interpolation mode.
+  ValueType interpolateSegment(Time time, CoefficientIter a, CoefficientIter b) const;
+
+  /// \brief Remove the knot before the last one if the interpolation from the knot before it
+  ///        to the last one reproduces it and the knots removed before, see extend.
+  void simplifyEnd(const KnotTolerance& tolerance);
+
+  CoefficientManager manager_;
   SamplingPolicy slerpPolicy_;
+  InterpolationMode interpolationMode_;
+
+  /// Knots removed by simplifyEnd since the last kept one.
+  std::vector<Time> removedTimes_;
+  std::vector<ValueType, Eigen::aligned_allocator<ValueType> > removedValues_;
+
+  /// Failed evaluations, counted from const evaluation methods.
+  mutable EvaluationErrorCounters evaluationErrors_;
 };
 
 typedef kindr::HomogeneousTransformationPosition3RotationQuaternionD SE3;
@@ -203,6 +324,16 @@ SE3 composeTransformations(SE3 A, SE3 B);
 
 SE3 inverseTransformation(SE3 T);
 
+/// \brief Logarithm of T, split into the rotation vector phi and the translational part rho.
+void transformationLogarithm(const SE3& T, Eigen::Vector3d* phi, Eigen::Vector3d* rho);
+
+/// \brief Exponential of the twist coordinates (rho, phi), the inverse of transformationLogarithm.
+SE3 transformationExponential(const Eigen::Vector3d& phi, const Eigen::Vector3d& rho);
+
+/// \brief Approximation of the slerp from a to b at alpha in [0, 1] along the shortest rotation,
+///        see SlerpSE3Curve::InterpolationMode::Approximate.
+SO3 approximateSlerp(const SO3& a, const SO3& b, double alpha);
+
 // extend policy for slerp curves
 template<>
 inline void SamplingPolicy::extend<SlerpSE3Curve, SE3>(const std::vector<Time>& times,
@@ -211,20 +342,27 @@ inline void SamplingPolicy::extend<SlerpSE3Curve, SE3>(const std::vector<Time>&
                                                        std::vector<Key>* outKeys) {
   //todo: deal with minSamplingPeriod_ when extending with multiple times
   if (times.size() != 1) {
+    CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::insertMultiple");
     curve->manager_.insertCoefficients(times, values, outKeys);
   } else {
     //If the curve is empty or of size 1, simply add the new coefficient
     if (curve->isEmpty() || curve->size() == 1) {
+      CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::insert");
       curve->manager_.insertCoefficients(times, values, outKeys);
     } else {
       if (minimumMeasurements_ == 1) {
+        CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::append");
         curve->manager_.addCoefficientAtEnd(times[0], values[0], outKeys);
+        curve->simplifyEnd(simplificationTolerance_);
       } else {
         ++measurementsSinceLastExtend_;
 
         if (measurementsSinceLastExtend_ == 1) {
+          CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::append");
           curve->manager_.addCoefficientAtEnd(times[0], values[0], outKeys);
+          curve->simplifyEnd(simplificationTolerance_);
         } else {
+          CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::modifyLast");
           SlerpSE3Curve::TimeToKeyCoefficientMap::iterator itPrev = (--curve->manager_.coefficientEnd());
           curve->manager_.modifyCoefficient(itPrev, times[0], values[0]);
         }
@@ -0,0 +1,422 @@
+/*
+ * SortedArrayCoefficientStorage.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/ChunkedVector.hpp"
+#include "curves/DenseKeyIndex.hpp"
+#include "curves/KeyedCoefficient.hpp"
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace curves {
+
+/// \brief Conversion between curve times and the time keys a coefficient storage sorts by.
+template <class TimeKey>
+struct CoefficientTimeKey;
+
+/// Times are stored as they are.
+template <>
+struct CoefficientTimeKey<Time> {
+  static Time fromTime(Time time) { return time; }
+  static Time toTime(Time key) { return key; }
+};
+
+/// Times are rounded to integer nanoseconds.
+template <>
+struct CoefficientTimeKey<int64_t> {
+  static int64_t fromTime(Time time) { return std::llround(time * 1e9); }
+  static Time toTime(int64_t key) { return static_cast<Time>(key) / 1e9; }
+};
+
+/// Arrays of SortedArrayCoefficientStorage: contiguous std::vectors.
+struct ContiguousCoefficientArrays {
+  template <class T>
+  using Array = std::vector<T, Eigen::aligned_allocator<T> >;
+
+  template <class Value>
+  using KeyIndex = DenseKeyIndex<Value>;
+};
+
+/// Arrays of SortedArrayCoefficientStorage: ChunkedVectors, which copies of the storage share
+/// until they are modified.
+struct CopyOnWriteCoefficientArrays {
+  template <class T>
+  using Array = ChunkedVector<T>;
+
+  template <class Value>
+  using KeyIndex = DenseKeyIndex<Value, ChunkedVector<Value>, ChunkedVector<unsigned char> >;
+};
+
+/// \brief Contiguous coefficient storage for LocalSupport2CoefficientManager.
+///
+/// The knot times and the key/coefficient pairs are kept in two parallel arrays
+/// sorted by time (structure of arrays), so that time lookups only touch the dense
+/// time array. Lookups start with an interpolation guess, which lands next to the
+/// answer for evenly sampled curves, and fall back to an exponential and binary
+/// search, keeping the worst case logarithmic. Key lookups go through a DenseKeyIndex
+/// of the coefficient times, followed by a time lookup.
+///
+/// Appending at the end and erasing the oldest coefficients with eraseFront() are
+/// amortized O(1), inserting or erasing elsewhere is O(n). Erased coefficients at the
+/// front are only dropped from the arrays once they make up half of them, so a sliding
+/// window of coefficients does not move the remaining ones on every step.
+/// Iterators are positions into the arrays: they survive appends, but not inserts
+/// or erases before them.
+///
+/// With TimeKey int64_t the times are stored and searched as integer nanoseconds
+/// (see CoefficientTimeKey) and only converted back to Time when read through an
+/// iterator. Times closer than half a nanosecond then fall onto the same coefficient,
+/// and large absolute times, e.g. since the epoch, are sorted without rounding errors.
+///
+/// With Arrays CopyOnWriteCoefficientArrays the arrays are ChunkedVectors, see
+/// CopyOnWriteCoefficientStorage.
+template <class Coefficient, class TimeKey = Time, class Arrays = ContiguousCoefficientArrays>
+class SortedArrayCoefficientStorage {
+ public:
+  typedef KeyedCoefficient<Coefficient> KeyCoefficient;
+  typedef CoefficientTimeKey<TimeKey> TimeKeyConversion;
+  typedef typename Arrays::template Array<TimeKey> TimeArray;
+  typedef typename Arrays::template Array<KeyCoefficient> CoefficientArray;
+
+  /// Position in the storage. Dereferencing a non-const iterator gives write access to the
+  /// coefficient, which copies its chunk if a CopyOnWriteCoefficientStorage shares it with a
+  /// copy. Reads therefore go through const iterators, which non-const ones convert to.
+  template <bool IsConst>
+  class Iterator {
+   public:
+    typedef typename std::conditional<IsConst, const SortedArrayCoefficientStorage,
+                                      SortedArrayCoefficientStorage>::type StorageType;
+    typedef typename std::conditional<IsConst, const KeyCoefficient, KeyCoefficient>::type Entry;
+
+    /// View of one element with the interface of a std::map value.
+    struct Reference {
+      const Time first;
+      Entry& second;
+
+      Reference(Time time, Entry& keyCoefficient) :
+        first(time), second(keyCoefficient) {}
+
+      const Reference* operator->() const { return this; }
+    };
+
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef std::pair<const Time, KeyCoefficient> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Reference reference;
+    typedef Reference pointer;
+
+    Iterator() : storage_(NULL), index_(0) {}
+
+    Iterator(StorageType* storage, size_t index) : storage_(storage), index_(index) {}
+
+    operator Iterator<true>() const { return Iterator<true>(storage_, index_); }
+
+    Reference operator*() const {
+      const size_t i = storage_->head_ + index_;
+      const TimeArray& times = storage_->times_;
+      return Reference(TimeKeyConversion::toTime(times[i]), storage_->coefficients_[i]);
+    }
+
+    Reference operator->() const { return **this; }
+
+    Reference operator[](difference_type n) const { return *(*this + n); }
+
+    Iterator& operator++() { ++index_; return *this; }
+    Iterator& operator--() { --index_; return *this; }
+    Iterator operator++(int) { Iterator it(*this); ++index_; return it; }
+    Iterator operator--(int) { Iterator it(*this); --index_; return it; }
+    Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+    Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(storage_, index_ + n); }
+    Iterator operator-(difference_type n) const { return Iterator(storage_, index_ - n); }
+
+    template <bool OtherIsConst>
+    difference_type operator-(const Iterator<OtherIsConst>& other) const {
+      return difference_type(index_) - difference_type(other.index());
+    }
+
+    template <bool OtherIsConst>
+    bool operator==(const Iterator<OtherIsConst>& other) const { return index_ == other.index(); }
+    template <bool OtherIsConst>
+    bool operator!=(const Iterator<OtherIsConst>& other) const { return index_ != other.index(); }
+    template <bool OtherIsConst>
+    bool operator<(const Iterator<OtherIsConst>& other) const { return index_ < other.index(); }
+    template <bool OtherIsConst>
+    bool operator>(const Iterator<OtherIsConst>& other) const { return index_ > other.index(); }
+    template <bool OtherIsConst>
+    bool operator<=(const Iterator<OtherIsConst>& other) const { return index_ <= other.index(); }
+    template <bool OtherIsConst>
+    bool operator>=(const Iterator<OtherIsConst>& other) const { return index_ >= other.index(); }
+
+    /// Position of the element in the storage.
+    size_t index() const { return index_; }
+
+   private:
+    StorageType* storage_;
+    size_t index_;
+  };
+
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  SortedArrayCoefficientStorage() : head_(0) {}
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  size_t size() const { return times_.size() - head_; }
+  bool empty() const { return size() == 0; }
+
+  void clear() {
+    times_.clear();
+    coefficients_.clear();
+    keyToTime_.clear();
+    head_ = 0;
+  }
+
+  /// Reserve memory for size coefficients.
+  void reserve(size_t size) {
+    times_.reserve(head_ + size);
+    coefficients_.reserve(head_ + size);
+  }
+
+  iterator find(Time time) { return iterator(this, findIndex(TimeKeyConversion::fromTime(time))); }
+  const_iterator find(Time time) const {
+    return const_iterator(this, findIndex(TimeKeyConversion::fromTime(time)));
+  }
+
+  /// First coefficient at or after time.
+  const_iterator lower_bound(Time time) const {
+    const TimeKey timeKey = TimeKeyConversion::fromTime(time);
+    const size_t index = upperBoundIndex(timeKey);
+    return const_iterator(this, (index > 0 && times_[head_ + index - 1] == timeKey) ? index - 1 : index);
+  }
+
+  /// First coefficient strictly after time.
+  const_iterator upper_bound(Time time) const {
+    return const_iterator(this, upperBoundIndex(TimeKeyConversion::fromTime(time)));
+  }
+
+  /// Time a coefficient inserted at time is stored at, which is rounded to the time key.
+  static Time storedTime(Time time) { return TimeKeyConversion::toTime(TimeKeyConversion::fromTime(time)); }
+
+  /// Coefficient with this key, end() if there is none.
+  iterator findKey(Key key) { return iterator(this, findKeyIndex(key)); }
+  const_iterator findKey(Key key) const { return const_iterator(this, findKeyIndex(key)); }
+
+  /// Insert a coefficient. There must not be a coefficient at this time yet.
+  iterator insert(Time time, const KeyCoefficient& keyCoefficient) {
+    return insertAtTimeKey(TimeKeyConversion::fromTime(time), keyCoefficient);
+  }
+
+  /// Insert a coefficient after all the others in amortized constant time.
+  iterator insertAtEnd(Time time, const KeyCoefficient& keyCoefficient) {
+    const TimeKey timeKey = TimeKeyConversion::fromTime(time);
+    times_.push_back(timeKey);
+    coefficients_.push_back(keyCoefficient);
+    keyToTime_.set(keyCoefficient.key, timeKey);
+    return iterator(this, size() - 1);
+  }
+
+  /// Insert count coefficients with strictly increasing times, none of which has a
+  /// coefficient yet. The arrays are grown once and merged from the back, so only the
+  /// coefficients after the first new time are moved, each of them once.
+  void insertSorted(const Time* times, const KeyCoefficient* keyCoefficients, size_t count) {
+    size_t read = times_.size();
+    times_.resize(read + count);
+    coefficients_.resize(read + count);
+    size_t write = times_.size();
+    for (size_t i = count; i > 0; --i) {
+      const TimeKey time = TimeKeyConversion::fromTime(times[i - 1]);
+      while (read > head_ && getTimes()[read - 1] > time) {
+        --read;
+        --write;
+        times_[write] = getTimes()[read];
+        coefficients_[write] = getCoefficients()[read];
+      }
+      --write;
+      times_[write] = time;
+      coefficients_[write] = keyCoefficients[i - 1];
+      keyToTime_.set(keyCoefficients[i - 1].key, time);
+    }
+  }
+
+  /// Move the coefficient at it to a new time and value, keeping its key.
+  iterator move(iterator it, Time time, const Coefficient& coefficient) {
+    return moveToTimeKey(it, TimeKeyConversion::fromTime(time), coefficient);
+  }
+
+  void erase(iterator it) {
+    const size_t i = head_ + it.index();
+    keyToTime_.erase(getCoefficients()[i].key);
+    times_.erase(times_.begin() + i);
+    coefficients_.erase(coefficients_.begin() + i);
+  }
+
+  /// Erase the count oldest coefficients.
+  void eraseFront(size_t count) {
+    CHECK_LE(count, size());
+    for (size_t i = head_; i < head_ + count; ++i) {
+      keyToTime_.erase(getCoefficients()[i].key);
+    }
+    head_ += count;
+    if (head_ >= size()) {
+      times_.erase(times_.begin(), times_.begin() + head_);
+      coefficients_.erase(coefficients_.begin(), coefficients_.begin() + head_);
+      head_ = 0;
+    }
+  }
+
+  /// Erase the coefficients for which remove(time, keyCoefficient) is true. It is called
+  /// once per coefficient in time order. The remaining coefficients are moved at most
+  /// once, so this is O(n) however many are erased. Returns the number of erased coefficients.
+  template <class Predicate>
+  size_t eraseIf(const Predicate& remove) {
+    size_t end = head_;
+    for (size_t i = head_; i < times_.size(); ++i) {
+      if (remove(TimeKeyConversion::toTime(getTimes()[i]), getCoefficients()[i])) {
+        keyToTime_.erase(getCoefficients()[i].key);
+        continue;
+      }
+      if (end != i) {
+        times_[end] = getTimes()[i];
+        coefficients_[end] = getCoefficients()[i];
+      }
+      ++end;
+    }
+    const size_t count = times_.size() - end;
+    times_.erase(times_.begin() + end, times_.end());
+    coefficients_.erase(coefficients_.begin() + end, coefficients_.end());
+    return count;
+  }
+
+ private:
+  /// Read access, which does not copy shared chunks of ChunkedVectors.
+  const TimeArray& getTimes() const {
+    return times_;
+  }
+
+  const CoefficientArray& getCoefficients() const {
+    return coefficients_;
+  }
+
+  iterator insertAtTimeKey(TimeKey time, const KeyCoefficient& keyCoefficient) {
+    const size_t index = upperBoundIndex(time);
+    times_.insert(times_.begin() + head_ + index, time);
+    coefficients_.insert(coefficients_.begin() + head_ + index, keyCoefficient);
+    keyToTime_.set(keyCoefficient.key, time);
+    return iterator(this, index);
+  }
+
+  iterator moveToTimeKey(iterator it, TimeKey time, const Coefficient& coefficient) {
+    size_t index = it.index();
+    const size_t i = head_ + index;
+    const Key key = getCoefficients()[i].key;
+    const bool keepsOrder = (index == 0 || getTimes()[i - 1] < time) &&
+                            (index + 1 == size() || time < getTimes()[i + 1]);
+    if (keepsOrder) {
+      times_[i] = time;
+      coefficients_[i].coefficient = coefficient;
+    } else {
+      times_.erase(times_.begin() + i);
+      coefficients_.erase(coefficients_.begin() + i);
+      index = upperBoundIndex(time);
+      times_.insert(times_.begin() + head_ + index, time);
+      coefficients_.insert(coefficients_.begin() + head_ + index, KeyCoefficient(key, coefficient));
+    }
+    keyToTime_.set(key, time);
+    return iterator(this, index);
+  }
+
+  /// Index of the first coefficient strictly after time.
+  size_t upperBoundIndex(TimeKey time) const {
+    const size_t n = size();
+    const typename TimeArray::const_iterator times = times_.begin() + head_;
+    if (n == 0 || time < times[0]) {
+      return 0;
+    }
+    if (time >= times[n - 1]) {
+      return n;
+    }
+
+    // Here times[0] <= time < times[n-1]. Guess the position assuming evenly spaced
+    // knots, then grow a bracket times[lo] <= time < times[hi] around the guess.
+    const size_t last = n - 1;
+    size_t guess = static_cast<size_t>(static_cast<double>(time - times[0]) /
+                                       static_cast<double>(times[last] - times[0]) * last);
+    guess = std::min(guess, last);
+    size_t lo, hi;
+    size_t step = 1;
+    if (times[guess] <= time) {
+      lo = guess;
+      hi = std::min(lo + step, last);
+      while (times[hi] <= time) {
+        lo = hi;
+        step *= 2;
+        hi = std::min(lo + step, last);
+      }
+    } else {
+      hi = guess;
+      lo = hi > step ? hi - step : 0;
+      while (times[lo] > time) {
+        hi = lo;
+        step *= 2;
+        lo = hi > step ? hi - step : 0;
+      }
+    }
+    return std::upper_bound(times + lo, times + hi, time) - times;
+  }
+
+  /// Index of the coefficient at exactly this time, size() if there is none.
+  size_t findIndex(TimeKey time) const {
+    const size_t index = upperBoundIndex(time);
+    return (index > 0 && times_[head_ + index - 1] == time) ? index - 1 : size();
+  }
+
+  size_t findKeyIndex(Key key) const {
+    const TimeKey* time = keyToTime_.find(key);
+    return time == NULL ? size() : findIndex(*time);
+  }
+
+  /// Sorted coefficient times, the first head_ of them are erased.
+  TimeArray times_;
+
+  /// Keys and coefficients, in the same order as times_.
+  CoefficientArray coefficients_;
+
+  /// Time of the coefficient with a key.
+  typename Arrays::template KeyIndex<TimeKey> keyToTime_;
+
+  /// Number of erased entries at the front of times_ and coefficients_.
+  size_t head_;
+};
+
+/// Sorted array storage indexed by integer nanoseconds.
+template <class Coefficient>
+using NanosecondCoefficientStorage = SortedArrayCoefficientStorage<Coefficient, int64_t>;
+
+/// \brief Sorted array storage which copies share until they are modified.
+///
+/// Copying the storage, and with it a LocalSupport2CoefficientManager or a curve, is O(1),
+/// so snapshots of a curve are cheap. Modifying the storage afterwards copies the chunks of
+/// ChunkSize coefficients it writes to, see ChunkedVector: extending a curve copies the last
+/// chunk and leaves the others shared with the snapshots. Lookups go through the chunk
+/// table, which makes them slightly slower than with the contiguous storage.
+template <class Coefficient>
+using CopyOnWriteCoefficientStorage = SortedArrayCoefficientStorage<Coefficient, Time, CopyOnWriteCoefficientArrays>;
+
+} // namespace
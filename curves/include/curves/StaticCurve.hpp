@@ -0,0 +1,152 @@
+/*
+ * StaticCurve.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "curves/ArcLengthTable.hpp"
+#include "curves/Curve.hpp"
+
+namespace curves {
+
+/// \brief Static dispatch of the curve interface, alongside the virtual one of Curve.
+///
+/// The methods of CurveType are called with qualified names, which binds them at compile
+/// time although they are virtual, so the evaluation is inlined into the loops of the
+/// generic algorithms below instead of a virtual call per sample. Any concrete curve type
+/// with the evaluate(), evaluateDerivative(), getMinTime() and getMaxTime() of Curve works,
+/// e.g. CubicHermiteE3Curve or PolynomialSplineQuinticVector3Curve. Abstract interfaces
+/// like SE3Curve have nothing to bind to and use the virtual methods instead.
+template <class CurveType>
+struct StaticCurve {
+  typedef typename CurveType::ValueType ValueType;
+  typedef typename CurveType::DerivativeType DerivativeType;
+
+  static Time getMinTime(const CurveType& curve) {
+    return curve.CurveType::getMinTime();
+  }
+
+  static Time getMaxTime(const CurveType& curve) {
+    return curve.CurveType::getMaxTime();
+  }
+
+  static bool evaluate(const CurveType& curve, ValueType& value, Time time) {
+    return curve.CurveType::evaluate(value, time);
+  }
+
+  static bool evaluateDerivative(const CurveType& curve, DerivativeType& derivative, Time time,
+                                 unsigned derivativeOrder) {
+    return curve.CurveType::evaluateDerivative(derivative, time, derivativeOrder);
+  }
+};
+
+/// \brief Evaluate the curve at many times without a virtual call per time.
+/// @returns false if the evaluation failed for any of the times.
+template <class CurveType, class Allocator>
+bool evaluateStatic(const CurveType& curve, const std::vector<Time>& times,
+                    std::vector<typename CurveType::ValueType, Allocator>* values) {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  bool success = true;
+  for (size_t i = 0; i < times.size(); ++i) {
+    success &= StaticCurve<CurveType>::evaluate(curve, (*values)[i], times[i]);
+  }
+  return success;
+}
+
+/// \brief Evaluate the curve derivatives at many times without a virtual call per time.
+/// @returns false if the evaluation failed for any of the times.
+template <class CurveType, class Allocator>
+bool evaluateDerivativeStatic(const CurveType& curve, const std::vector<Time>& times,
+                              std::vector<typename CurveType::DerivativeType, Allocator>* derivatives,
+                              unsigned derivativeOrder) {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  bool success = true;
+  for (size_t i = 0; i < times.size(); ++i) {
+    success &= StaticCurve<CurveType>::evaluateDerivative(curve, (*derivatives)[i], times[i], derivativeOrder);
+  }
+  return success;
+}
+
+namespace internal {
+
+inline void updateBounds(double value, double* lower, double* upper) {
+  *lower = std::min(*lower, value);
+  *upper = std::max(*upper, value);
+}
+
+template <class Derived, class Bound>
+void updateBounds(const Eigen::MatrixBase<Derived>& value, Bound* lower, Bound* upper) {
+  *lower = lower->cwiseMin(value);
+  *upper = upper->cwiseMax(value);
+}
+
+} // namespace internal
+
+/// \brief Coefficient-wise bounds of the values of a scalar or vector space curve, sampled
+///        at numSamples evenly spaced times over the whole curve, the ends included.
+/// @returns false if the curve cannot be evaluated.
+template <class CurveType>
+bool getBoundsStatic(const CurveType& curve, size_t numSamples, typename CurveType::ValueType* lower,
+                     typename CurveType::ValueType* upper) {
+  CHECK_NOTNULL(lower);
+  CHECK_NOTNULL(upper);
+  CHECK_GE(numSamples, 2u);
+  typedef StaticCurve<CurveType> Static;
+  const Time minTime = Static::getMinTime(curve);
+  const Time step = (Static::getMaxTime(curve) - minTime) / (numSamples - 1);
+  typename CurveType::ValueType value;
+  if (!Static::evaluate(curve, value, minTime)) {
+    return false;
+  }
+  *lower = value;
+  *upper = value;
+  for (size_t i = 1; i < numSamples; ++i) {
+    const Time time = i + 1 == numSamples ? Static::getMaxTime(curve) : minTime + i * step;
+    if (!Static::evaluate(curve, value, time)) {
+      return false;
+    }
+    internal::updateBounds(value, lower, upper);
+  }
+  return true;
+}
+
+/// \brief Arc length of the position of the curve between two times, integrated over
+///        numIntervals intervals with 5 point Gauss-Legendre quadrature of the speed, see
+///        ArcLengthTable. The derivative has to be accepted by getLinearSpeed.
+/// @returns false if the speed cannot be evaluated.
+template <class CurveType>
+bool getArcLengthStatic(const CurveType& curve, Time startTime, Time endTime, size_t numIntervals,
+                        double* length) {
+  CHECK_NOTNULL(length);
+  CHECK_GT(numIntervals, 0u);
+  static const double nodes[5] = {0.0, -0.5384693101056831, 0.5384693101056831,
+                                  -0.9061798459386640, 0.9061798459386640};
+  static const double weights[5] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665,
+                                    0.2369268850561891, 0.2369268850561891};
+  const Time intervalDuration = (endTime - startTime) / numIntervals;
+  const double halfDuration = 0.5 * intervalDuration;
+  typename CurveType::DerivativeType velocity;
+  *length = 0.0;
+  for (size_t k = 0; k < numIntervals; ++k) {
+    const Time center = startTime + (k + 0.5) * intervalDuration;
+    for (int i = 0; i < 5; ++i) {
+      if (!StaticCurve<CurveType>::evaluateDerivative(curve, velocity, center + halfDuration * nodes[i], 1)) {
+        return false;
+      }
+      *length += weights[i] * halfDuration * getLinearSpeed(velocity);
+    }
+  }
+  return true;
+}
+
+} // namespace curves
@@ -0,0 +1,310 @@
+/*
+ * StaticPolynomialSplineContainer.hpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#pragma once
+
+#include "curves/polynomial_splines.hpp"
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace curves {
+
+/*! A spline container of fixed capacity which never allocates after construction.
+ *
+ *  The splines and all workspaces of the fit are stored inline, with Eigen matrices whose
+ *  maximum size is fixed at compile time. It is meant for real-time loops, the size of an
+ *  object grows quadratically with MaxSegments. The fit solves the same system as
+ *  PolynomialSplineContainer::setData, picking its minimum norm solution like
+ *  SolverType::SparseMinimumNorm, with a dense factorization of O(MaxSegments^3).
+ */
+template <typename SplineType, unsigned int MaxSegments>
+class StaticPolynomialSplineContainer {
+ public:
+  static_assert(MaxSegments > 0, "The container needs room for at least one spline.");
+  static_assert(SplineType::coefficientCount >= 6,
+                "Continuous accelerations need splines of at least fifth order.");
+
+  static constexpr unsigned int maxSegments = MaxSegments;
+
+  //! Position, velocity and acceleration at one instant.
+  struct State {
+    double position;
+    double velocity;
+    double acceleration;
+  };
+
+  StaticPolynomialSplineContainer()
+      : numSplines_(0),
+        containerDuration_(0.0)
+  {
+  }
+
+  //! Remove all splines.
+  void reset()
+  {
+    numSplines_ = 0;
+    containerDuration_ = 0.0;
+  }
+
+  bool isEmpty() const
+  {
+    return numSplines_ == 0;
+  }
+
+  unsigned int size() const
+  {
+    return numSplines_;
+  }
+
+  double getContainerDuration() const
+  {
+    return containerDuration_;
+  }
+
+  const SplineType& getSpline(unsigned int splineIndex) const
+  {
+    return splines_[splineIndex];
+  }
+
+  //! Append a spline. Returns false if the container is full.
+  bool addSpline(const SplineType& spline)
+  {
+    if (numSplines_ == MaxSegments) {
+      return false;
+    }
+    splines_[numSplines_] = spline;
+    splineStartTimes_[numSplines_] = containerDuration_;
+    containerDuration_ += spline.getSplineDuration();
+    ++numSplines_;
+    return true;
+  }
+
+  /*! Fit splines through numKnots knots, see PolynomialSplineContainer::setData.
+   *  Returns false and leaves the container empty if there are fewer than two or more
+   *  than MaxSegments + 1 knots, the knot positions are not increasing or the fit fails.
+   */
+  bool setData(const double* knotPositions, const double* knotValues, unsigned int numKnots,
+               double initialVelocity, double initialAcceleration,
+               double finalVelocity, double finalAcceleration)
+  {
+    reset();
+    if (numKnots < 2 || numKnots > MaxSegments + 1) {
+      return false;
+    }
+    const unsigned int numSplines = numKnots - 1;
+    for (unsigned int i = 0; i < numSplines; ++i) {
+      durations_[i] = knotPositions[i + 1] - knotPositions[i];
+      if (!(durations_[i] > 0.0)) {
+        return false;
+      }
+    }
+
+    buildConstraints(numSplines);
+    getConstraintValues(knotValues, numSplines, initialVelocity, initialAcceleration,
+                        finalVelocity, finalAcceleration);
+
+    // Minimum norm solution of the scaled system, x = A^T (A A^T)^-1 b.
+    normalMatrix_.noalias() = constraintMatrix_ * constraintMatrix_.transpose();
+    solver_.compute(normalMatrix_);
+    if (solver_.info() != Eigen::Success) {
+      return false;
+    }
+    multipliers_ = solver_.solve(constraintValues_);
+    coefficients_.noalias() = constraintMatrix_.transpose() * multipliers_;
+
+    typename SplineType::EigenCoefficientVectorType splineCoefficients;
+    for (unsigned int i = 0; i < numSplines; ++i) {
+      splineCoefficients = coefficients_.template segment<numCoefficients>(i * numCoefficients).cwiseProduct(
+          columnScale_.template segment<numCoefficients>(i * numCoefficients));
+      SplineType spline;
+      spline.setCoefficientsAndDuration(splineCoefficients, durations_[i]);
+      addSpline(spline);
+    }
+    return true;
+  }
+
+  //! Fit splines through the knots, see setData above.
+  bool setData(const std::vector<double>& knotPositions, const std::vector<double>& knotValues,
+               double initialVelocity, double initialAcceleration,
+               double finalVelocity, double finalAcceleration)
+  {
+    if (knotPositions.size() != knotValues.size()) {
+      reset();
+      return false;
+    }
+    return setData(knotPositions.data(), knotValues.data(), knotPositions.size(), initialVelocity,
+                   initialAcceleration, finalVelocity, finalAcceleration);
+  }
+
+  //! Get the index of the spline active at time t. Times outside of the container are clamped.
+  unsigned int getActiveSplineIndexAtTime(double t) const
+  {
+    if (numSplines_ == 0) {
+      return 0;
+    }
+    const double* begin = splineStartTimes_.data();
+    const unsigned int index = std::upper_bound(begin, begin + numSplines_, t) - begin;
+    return index == 0 ? 0 : index - 1;
+  }
+
+  double getPositionAtTime(double t) const
+  {
+    return getDerivativeAtTime<0>(t);
+  }
+
+  double getVelocityAtTime(double t) const
+  {
+    return getDerivativeAtTime<1>(t);
+  }
+
+  double getAccelerationAtTime(double t) const
+  {
+    return getDerivativeAtTime<2>(t);
+  }
+
+  //! Get position, velocity and acceleration at time t with a single spline lookup.
+  State evaluateState(double t) const
+  {
+    State state = {0.0, 0.0, 0.0};
+    if (numSplines_ == 0) {
+      return state;
+    }
+    const unsigned int i = getActiveSplineIndexAtTime(t);
+    std::array<double, 3> derivatives;
+    splines_[i].template getDerivativesAtTime<2>(t - splineStartTimes_[i], derivatives);
+    state.position = derivatives[0];
+    state.velocity = derivatives[1];
+    state.acceleration = derivatives[2];
+    return state;
+  }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+ private:
+  static constexpr unsigned int numCoefficients = SplineType::coefficientCount;
+  static constexpr unsigned int maxConstraints = 4 * MaxSegments + 2;
+  static constexpr unsigned int maxCoefficients = numCoefficients * MaxSegments;
+
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor,
+                        maxConstraints, maxCoefficients> ConstraintMatrix;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor,
+                        maxConstraints, maxConstraints> NormalMatrix;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, maxConstraints, 1> ConstraintVector;
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, maxCoefficients, 1> CoefficientVector;
+
+  template<unsigned int derivativeOrder>
+  double getDerivativeAtTime(double t) const
+  {
+    if (numSplines_ == 0) {
+      return 0.0;
+    }
+    const unsigned int i = getActiveSplineIndexAtTime(t);
+    return splines_[i].template getDerivativeAtTime<derivativeOrder>(t - splineStartTimes_[i]);
+  }
+
+  /*! Build the constraint matrix of PolynomialSplineContainer::getConstraintMatrix. The
+   *  coefficients are expressed in the normalized spline time t/tf and the rows scaled to
+   *  unit norm, which keeps A A^T well conditioned for any spline duration.
+   */
+  void buildConstraints(unsigned int numSplines)
+  {
+    const unsigned int numConstraints = 4 * numSplines + 2;
+    constraintMatrix_.setZero(numConstraints, numCoefficients * numSplines);
+    columnScale_.resize(numCoefficients * numSplines);
+    for (unsigned int i = 0; i < numSplines; ++i) {
+      for (unsigned int k = 0; k < numCoefficients; ++k) {
+        columnScale_(i * numCoefficients + k) = std::pow(durations_[i], -int(numCoefficients - 1 - k));
+      }
+    }
+
+    typename SplineType::EigenTimeVectorType timeVec, dTimeVec, ddTimeVec;
+    typename SplineType::EigenTimeVectorType timeVecTf, dTimeVecTf, ddTimeVecTf;
+    SplineType::getTimeVector(timeVec, 0.0);
+    SplineType::getdTimeVector(dTimeVec, 0.0);
+    SplineType::getddTimeVector(ddTimeVec, 0.0);
+
+    // Initial and final position, velocity and acceleration.
+    unsigned int row = 0;
+    setBlock(row++, 0, timeVec, 1.0);
+    setBlock(row++, 0, dTimeVec, 1.0);
+    setBlock(row++, 0, ddTimeVec, 1.0);
+    SplineType::getTimeVector(timeVecTf, durations_[numSplines - 1]);
+    SplineType::getdTimeVector(dTimeVecTf, durations_[numSplines - 1]);
+    SplineType::getddTimeVector(ddTimeVecTf, durations_[numSplines - 1]);
+    setBlock(row++, numSplines - 1, timeVecTf, 1.0);
+    setBlock(row++, numSplines - 1, dTimeVecTf, 1.0);
+    setBlock(row++, numSplines - 1, ddTimeVecTf, 1.0);
+
+    // Junctions: positions at both sides, continuous velocity and acceleration.
+    for (unsigned int k = 0; k + 1 < numSplines; ++k) {
+      SplineType::getTimeVector(timeVecTf, durations_[k]);
+      SplineType::getdTimeVector(dTimeVecTf, durations_[k]);
+      SplineType::getddTimeVector(ddTimeVecTf, durations_[k]);
+      setBlock(row++, k, timeVecTf, 1.0);
+      setBlock(row++, k + 1, timeVec, 1.0);
+      setBlock(row, k, dTimeVecTf, 1.0);
+      setBlock(row++, k + 1, dTimeVec, -1.0);
+      setBlock(row, k, ddTimeVecTf, 1.0);
+      setBlock(row++, k + 1, ddTimeVec, -1.0);
+    }
+
+    rowScale_ = constraintMatrix_.rowwise().norm().cwiseInverse();
+    for (unsigned int r = 0; r < numConstraints; ++r) {
+      constraintMatrix_.row(r) *= rowScale_(r);
+    }
+  }
+
+  void setBlock(unsigned int row, unsigned int splineIndex,
+                const typename SplineType::EigenTimeVectorType& timeVec, double scale)
+  {
+    constraintMatrix_.row(row).template segment<numCoefficients>(splineIndex * numCoefficients) +=
+        scale * timeVec.cwiseProduct(
+            columnScale_.template segment<numCoefficients>(splineIndex * numCoefficients).transpose());
+  }
+
+  //! Same constraint order as in buildConstraints.
+  void getConstraintValues(const double* knotValues, unsigned int numSplines,
+                           double initialVelocity, double initialAcceleration,
+                           double finalVelocity, double finalAcceleration)
+  {
+    constraintValues_.setZero(4 * numSplines + 2);
+    unsigned int row = 0;
+    constraintValues_(row++) = knotValues[0];
+    constraintValues_(row++) = initialVelocity;
+    constraintValues_(row++) = initialAcceleration;
+    constraintValues_(row++) = knotValues[numSplines];
+    constraintValues_(row++) = finalVelocity;
+    constraintValues_(row++) = finalAcceleration;
+    for (unsigned int k = 0; k + 1 < numSplines; ++k) {
+      constraintValues_(row++) = knotValues[k + 1];
+      constraintValues_(row++) = knotValues[k + 1];
+      row += 2;
+    }
+    constraintValues_.array() *= rowScale_.array();
+  }
+
+  std::array<SplineType, MaxSegments> splines_;
+  std::array<double, MaxSegments> splineStartTimes_;
+  unsigned int numSplines_;
+  double containerDuration_;
+
+  // Workspaces of setData.
+  std::array<double, MaxSegments> durations_;
+  ConstraintMatrix constraintMatrix_;
+  NormalMatrix normalMatrix_;
+  Eigen::LDLT<NormalMatrix> solver_;
+  ConstraintVector constraintValues_;
+  ConstraintVector rowScale_;
+  ConstraintVector multipliers_;
+  CoefficientVector coefficients_;
+  CoefficientVector columnScale_;
+};
+
+} // namespace curves
@@ -15,4 +15,7 @@ namespace curves {
 using PolynomialSplineCubic   = PolynomialSpline<3>;
 using PolynomialSplineQuintic = PolynomialSpline<5>;
 
+using PolynomialSplineCubicf   = PolynomialSpline<3, float>;
+using PolynomialSplineQuinticf = PolynomialSpline<5, float>;
+
 }
@@ -8,15 +8,13 @@
 #pragma once
 
 // stl
+#include <array>
 #include <vector>
 #include <iostream>
 
 // eigen
 #include <Eigen/Core>
-#include <Eigen/QR>
-
-// boost
-#include <boost/math/special_functions/pow.hpp>
+#include <Eigen/LU>
 
 namespace curves {
 
@@ -65,9 +63,49 @@ struct SplineOptions {
 
 namespace spline_traits {
 
-// Main struct template.
+namespace internal {
+
+// Compile-time list of the indices 0, ..., N-1.
+template<unsigned int... Indices_>
+struct index_list {};
+
+template<unsigned int N_, unsigned int... Indices_>
+struct make_index_list : make_index_list<N_-1, N_-1, Indices_...> {};
+
+template<unsigned int... Indices_>
+struct make_index_list<0, Indices_...> {
+  using type = index_list<Indices_...>;
+};
+
+constexpr double factorial(unsigned int n) {
+  return n == 0 ? 1.0 : n * factorial(n - 1);
+}
+
+//! Column k of the derivative of the given order of the time vector at time 0.
+constexpr double timeVectorAtZero(unsigned int splineOrder, unsigned int k, unsigned int derivativeOrder) {
+  return splineOrder - k == derivativeOrder ? factorial(derivativeOrder) : 0.0;
+}
+
+template<typename TimeVectorType_, unsigned int... Indices_>
+constexpr TimeVectorType_ getTimeVectorAtZero(unsigned int splineOrder, unsigned int derivativeOrder,
+                                              index_list<Indices_...>) {
+  return TimeVectorType_{{ static_cast<typename TimeVectorType_::value_type>(
+      timeVectorAtZero(splineOrder, Indices_, derivativeOrder))... }};
+}
+
+} // namespace internal
+
+/*! Time vectors and coefficients of a spline of any order.
+ *
+ *  The coefficients are stored from the highest to the lowest power of time. Splines
+ *  are defined by (SplineOrder_+2)/2 conditions at time 0 and (SplineOrder_+1)/2 at time
+ *  tf, namely position, velocity and acceleration, with all higher derivatives zero.
+ *  compute() uses the closed form solution of these conditions instead of a linear solve.
+ *  Core_ is the scalar type of the time vectors and coefficients, e.g. double or float.
+ */
 template<typename Core_, int SplineOrder_>
 struct spline_rep {
+  static_assert(SplineOrder_ > 0, "Splines need to be at least of first order.");
 
   static constexpr unsigned int splineOrder = SplineOrder_;
   static constexpr unsigned int numCoefficients = SplineOrder_+1;
@@ -75,104 +113,148 @@ struct spline_rep {
   using TimeVectorType = std::array<Core_, numCoefficients>;
   using SplineCoefficients = std::array<Core_, numCoefficients>;
 
-  static inline TimeVectorType tau(Core_ tk) noexcept;
-  static inline TimeVectorType dtau(Core_ tk) noexcept;
-  static inline TimeVectorType ddtau(Core_ tk) noexcept;
-
-  static bool compute(const SplineOptions& opts, SplineCoefficients& coefficients);
-};
-
-// Specialization for third order splines.
-template<>
-struct spline_rep<double, 3> {
-
-  static constexpr unsigned int splineOrder = 3;
-  static constexpr unsigned int numCoefficients = splineOrder+1;
-
-  using TimeVectorType = std::array<double, numCoefficients>;
-  using SplineCoefficients = std::array<double, numCoefficients>;
-
-  static inline TimeVectorType tau(double tk) noexcept {
-    return { boost::math::pow<3>(tk), boost::math::pow<2>(tk), tk, 1.0 };
+  static inline TimeVectorType tau(Core_ tk) noexcept {
+    TimeVectorType timeVector;
+    Core_ power = 1;
+    for (unsigned int j = 0; j < numCoefficients; ++j) {
+      timeVector[splineOrder - j] = power;
+      power *= tk;
+    }
+    return timeVector;
   }
 
-  static inline TimeVectorType dtau(double tk) noexcept {
-    return { 3.0*boost::math::pow<2>(tk), 2.0*tk, 1.0, 0.0 };
+  static inline TimeVectorType dtau(Core_ tk) noexcept {
+    TimeVectorType timeVector;
+    timeVector[splineOrder] = 0;
+    Core_ power = 1;
+    for (unsigned int j = 1; j < numCoefficients; ++j) {
+      timeVector[splineOrder - j] = j * power;
+      power *= tk;
+    }
+    return timeVector;
   }
 
-  static inline TimeVectorType ddtau(double tk) noexcept {
-    return { 6.0*tk, 2.0, 0.0, 0.0 };
+  static inline TimeVectorType ddtau(Core_ tk) noexcept {
+    TimeVectorType timeVector;
+    timeVector[splineOrder] = 0;
+    timeVector[splineOrder - 1] = 0;
+    Core_ power = 1;
+    for (unsigned int j = 2; j < numCoefficients; ++j) {
+      timeVector[splineOrder - j] = j * (j - 1) * power;
+      power *= tk;
+    }
+    return timeVector;
   }
 
-  static constexpr TimeVectorType   tauZero{{ 0.0, 0.0, 0.0, 1.0 }};
-  static constexpr TimeVectorType  dtauZero{{ 0.0, 0.0, 1.0, 0.0 }};
-  static constexpr TimeVectorType ddtauZero{{ 0.0, 2.0, 0.0, 0.0 }};
-
+  static constexpr TimeVectorType tauZero = internal::getTimeVectorAtZero<TimeVectorType>(
+      splineOrder, 0, typename internal::make_index_list<numCoefficients>::type());
+  static constexpr TimeVectorType dtauZero = internal::getTimeVectorAtZero<TimeVectorType>(
+      splineOrder, 1, typename internal::make_index_list<numCoefficients>::type());
+  static constexpr TimeVectorType ddtauZero = internal::getTimeVectorAtZero<TimeVectorType>(
+      splineOrder, 2, typename internal::make_index_list<numCoefficients>::type());
+
+  /*! Compute the coefficients of the spline. In the normalized time s = t/tf the
+   *  conditions at s = 0 give the low order coefficients directly, the ones at s = 1 are
+   *  solved with a precomputed inverse. Returns false and sets a constant spline at pos0
+   *  if tf is not positive. The solution is computed in double precision for any Core_.
+   */
   static bool compute(const SplineOptions& opts, SplineCoefficients& coefficients) {
-
-    Eigen::Matrix<double, numCoefficients, 1> b;
-    b << opts.pos0_, opts.vel0_, opts.posT_, opts.velT_;
-
-    Eigen::Matrix<double, numCoefficients, numCoefficients> A;
-    A << Eigen::Map<const Eigen::Matrix<double, 1, numCoefficients>>(tauZero.data()),
-         Eigen::Map<const Eigen::Matrix<double, 1, numCoefficients>>(dtauZero.data()),
-         Eigen::Map<Eigen::Matrix<double, 1, numCoefficients>>((tau(opts.tf_)).data()),
-         Eigen::Map<Eigen::Matrix<double, 1, numCoefficients>>((dtau(opts.tf_)).data());
-
-    Eigen::Map<Eigen::VectorXd>(coefficients.data(), numCoefficients, 1) = A.colPivHouseholderQr().solve(b);
-
+    const double tf = opts.tf_;
+    if (!(tf > 0.0)) {
+      coefficients.fill(Core_(0));
+      coefficients[splineOrder] = static_cast<Core_>(opts.pos0_);
+      return false;
+    }
+
+    const double initialConditions[3] = { opts.pos0_, opts.vel0_, opts.acc0_ };
+    const double finalConditions[3] = { opts.posT_, opts.velT_, opts.accT_ };
+
+    // Coefficients in normalized time, from the lowest power.
+    double normalized[numCoefficients];
+    double tfPower = 1.0;
+    for (unsigned int k = 0; k < numStartConditions; ++k) {
+      normalized[k] = k < 3 ? tfPower * initialConditions[k] / internal::factorial(k) : 0.0;
+      tfPower *= tf;
+    }
+
+    // Conditions at s = 1, minus the contribution of the low order coefficients.
+    EndConditionVector rhs;
+    tfPower = 1.0;
+    for (unsigned int k = 0; k < numEndConditions; ++k) {
+      rhs(k) = k < 3 ? tfPower * finalConditions[k] : 0.0;
+      for (unsigned int j = k; j < numStartConditions; ++j) {
+        rhs(k) -= getFallingFactorial(j, k) * normalized[j];
+      }
+      tfPower *= tf;
+    }
+    Eigen::Map<EndConditionVector>(normalized + numStartConditions) = getEndConditionInverse() * rhs;
+
+    tfPower = 1.0;
+    for (unsigned int j = 0; j < numCoefficients; ++j) {
+      coefficients[splineOrder - j] = static_cast<Core_>(normalized[j] / tfPower);
+      tfPower *= tf;
+    }
     return true;
   }
-};
-
 
-// Specialization for fifth order splines.
-template<>
-struct spline_rep<double, 5> {
+ private:
+  static constexpr unsigned int numStartConditions = (numCoefficients + 1) / 2;
+  static constexpr unsigned int numEndConditions = numCoefficients / 2;
 
-  static constexpr unsigned int splineOrder = 5;
-  static constexpr unsigned int numCoefficients = splineOrder+1;
+  using EndConditionMatrix = Eigen::Matrix<double, numEndConditions, numEndConditions>;
+  using EndConditionVector = Eigen::Matrix<double, numEndConditions, 1>;
 
-  using TimeVectorType = std::array<double, numCoefficients>;
-  using SplineCoefficients = std::array<double, numCoefficients>;
-
-  static inline TimeVectorType tau(double tk) noexcept {
-    return { boost::math::pow<5>(tk), boost::math::pow<4>(tk), boost::math::pow<3>(tk),
-             boost::math::pow<2>(tk), tk, 1.0};
+  //! j!/(j-k)!, the k-th derivative of s^j at s = 1.
+  static double getFallingFactorial(unsigned int j, unsigned int k) {
+    double value = 1.0;
+    for (unsigned int i = 0; i < k; ++i) {
+      value *= j - i;
+    }
+    return value;
   }
 
-  static inline TimeVectorType dtau(double tk) noexcept {
-    return { 5.0*boost::math::pow<4>(tk), 4.0*boost::math::pow<3>(tk), 3.0*boost::math::pow<2>(tk),
-             2.0*tk, 1.0, 0.0};
+  //! Inverse of the conditions at s = 1 on the high order coefficients, computed once.
+  static const EndConditionMatrix& getEndConditionInverse() {
+    static const EndConditionMatrix inverse = computeEndConditionInverse();
+    return inverse;
   }
 
-  static inline TimeVectorType ddtau(double tk) noexcept {
-    return { 20.0*boost::math::pow<3>(tk), 12.0*boost::math::pow<2>(tk), 6.0*tk,
-              2.0, 0.0, 0.0};
+  static EndConditionMatrix computeEndConditionInverse() {
+    EndConditionMatrix endConditions;
+    for (unsigned int k = 0; k < numEndConditions; ++k) {
+      for (unsigned int j = 0; j < numEndConditions; ++j) {
+        endConditions(k, j) = getFallingFactorial(j + numStartConditions, k);
+      }
+    }
+    return endConditions.fullPivLu().inverse();
   }
+};
 
-  static constexpr TimeVectorType   tauZero{{ 0.0, 0.0, 0.0, 0.0, 0.0, 1.0 }};
-  static constexpr TimeVectorType  dtauZero{{ 0.0, 0.0, 0.0, 0.0, 1.0, 0.0 }};
-  static constexpr TimeVectorType ddtauZero{{ 0.0, 0.0, 0.0, 2.0, 0.0, 0.0 }};
+template<typename Core_, int SplineOrder_>
+constexpr unsigned int spline_rep<Core_, SplineOrder_>::splineOrder;
 
-  static bool compute(const SplineOptions& opts, SplineCoefficients& coefficients) {
-    Eigen::Matrix<double, numCoefficients, 1> b;
-    b << opts.pos0_, opts.vel0_, opts.acc0_, opts.posT_, opts.velT_, opts.accT_;
+template<typename Core_, int SplineOrder_>
+constexpr unsigned int spline_rep<Core_, SplineOrder_>::numCoefficients;
 
-    Eigen::Matrix<double, numCoefficients, numCoefficients> A;
-    A << Eigen::Map<const Eigen::Matrix<double, 1, numCoefficients>>(tauZero.data()),
-         Eigen::Map<const Eigen::Matrix<double, 1, numCoefficients>>(dtauZero.data()),
-         Eigen::Map<const Eigen::Matrix<double, 1, numCoefficients>>(ddtauZero.data()),
-         Eigen::Map<Eigen::Matrix<double, 1, numCoefficients>>((tau(opts.tf_)).data()),
-         Eigen::Map<Eigen::Matrix<double, 1, numCoefficients>>((dtau(opts.tf_)).data()),
-         Eigen::Map<Eigen::Matrix<double, 1, numCoefficients>>((ddtau(opts.tf_)).data());
+template<typename Core_, int SplineOrder_>
+constexpr typename spline_rep<Core_, SplineOrder_>::TimeVectorType spline_rep<Core_, SplineOrder_>::tauZero;
 
-    Eigen::Map<Eigen::VectorXd>(coefficients.data(), numCoefficients, 1) = A.colPivHouseholderQr().solve(b);
+template<typename Core_, int SplineOrder_>
+constexpr typename spline_rep<Core_, SplineOrder_>::TimeVectorType spline_rep<Core_, SplineOrder_>::dtauZero;
 
-    return true;
-  }
+template<typename Core_, int SplineOrder_>
+constexpr typename spline_rep<Core_, SplineOrder_>::TimeVectorType spline_rep<Core_, SplineOrder_>::ddtauZero;
 
-};
+template<typename Core_, int SplineOrder_>
+constexpr unsigned int spline_rep<Core_, SplineOrder_>::numStartConditions;
+
+template<typename Core_, int SplineOrder_>
+constexpr unsigned int spline_rep<Core_, SplineOrder_>::numEndConditions;
+
+extern template struct spline_rep<double, 3>;
+extern template struct spline_rep<double, 5>;
+extern template struct spline_rep<float, 3>;
+extern template struct spline_rep<float, 5>;
 
 }
 
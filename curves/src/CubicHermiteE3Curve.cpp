@@ -6,6 +6,8 @@
  */
 
 #include <curves/CubicHermiteE3Curve.hpp>
+#include <curves/Instrumentation.hpp>
+#include <curves/ParallelEvaluation.hpp>
 
 namespace curves {
 
@@ -54,19 +56,26 @@ bool CubicHermiteE3Curve::writeEvalToFile(const std::string& filename, int nSamp
   fprintf(fp, "\n");
 
   Time dt = (getMaxTime()-getMinTime())/(nSamples-1);
-  ValueType position;
-  DerivativeType velocity;
+  std::vector<Time> times;
   for (Time t = getMinTime(); t < getMaxTime(); t+=dt) {
-    if(!evaluate(position, t)) {
-      std::cout << "Could not evaluate at time " << t << std::endl;
-      fclose(fp);
-      return false;
-    }
-    if(!evaluateDerivative(velocity, t, 1)) {
-      std::cout << "Could not evaluate derivative at time " << t << std::endl;
-      fclose(fp);
-      return false;
-    }
+    times.push_back(t);
+  }
+  std::vector<ValueType> positions;
+  std::vector<DerivativeType> velocities;
+  if(!evaluateInParallel(*this, times, &positions)) {
+    std::cout << "Could not evaluate the curve" << std::endl;
+    fclose(fp);
+    return false;
+  }
+  if(!evaluateDerivativeInParallel(*this, times, 1, &velocities)) {
+    std::cout << "Could not evaluate the curve derivative" << std::endl;
+    fclose(fp);
+    return false;
+  }
+  for (size_t i = 0; i < times.size(); ++i) {
+    const Time t = times[i];
+    const ValueType& position = positions[i];
+    const DerivativeType& velocity = velocities[i];
     fprintf(fp, "%lf ", t);
     fprintf(fp, "%lf %lf %lf ", position.x(), position.y(), position.z());
     fprintf(fp, "%lf %lf %lf ", velocity.x(), velocity.y(), velocity.z());
@@ -88,9 +97,7 @@ Time CubicHermiteE3Curve::getMaxTime() const {
 }
 
 bool CubicHermiteE3Curve::isEmpty() const {
-  std::vector<Time> outTimes;
-  manager_.getTimes(&outTimes);
-  return outTimes.empty();
+  return manager_.empty();
 }
 
 // return number of coefficients curve is composed of
@@ -98,6 +105,10 @@ int CubicHermiteE3Curve::size() const {
   return manager_.size();
 }
 
+void CubicHermiteE3Curve::getCurveTimes(std::vector<Time>* outTimes) const {
+  manager_.getTimes(outTimes);
+}
+
 /// \brief calculate the slope between 2 coefficients
 CubicHermiteE3Curve::DerivativeType CubicHermiteE3Curve::calculateSlope(const Time& timeA,
                               const Time& timeB,
@@ -124,7 +135,7 @@ void CubicHermiteE3Curve::extend(const std::vector<Time>& times,
 void CubicHermiteE3Curve::fitCurve(const std::vector<Time>& times,
                       const std::vector<ValueType>& values,
                       std::vector<Key>* outKeys) {
-  fitCurveWithDerivatives(times, values, DerivativeType(), DerivativeType(), outKeys);
+  fitCurveWithDerivatives(times, values, DerivativeType::Zero(), DerivativeType::Zero(), outKeys);
 }
 
 void CubicHermiteE3Curve::fitPeriodicCurve(const std::vector<Time>& times,
@@ -146,6 +157,7 @@ void CubicHermiteE3Curve::fitCurveWithDerivatives(const std::vector<Time>& times
                       const DerivativeType& finalDerivative,
                       std::vector<Key>* outKeys) {
   assert(times.size() == values.size());
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteE3Curve::fitCurve", times.size());
 
   // construct the Hemrite coefficients
   std::vector<Coefficient> coefficients;
@@ -182,6 +194,11 @@ void CubicHermiteE3Curve::fitCurveWithDerivatives(const std::vector<Time>& times
 
 /// Evaluate the ambient space of the curve.
 bool CubicHermiteE3Curve::evaluate(ValueType& value, Time time) const {
+  return evaluate(value, time, NULL);
+}
+
+bool CubicHermiteE3Curve::evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteE3Curve::evaluate");
   // Check if the curve is only defined at this one time
    if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
      value =  manager_.coefficientBegin()->second.coefficient.getPosition();
@@ -189,7 +206,7 @@ bool CubicHermiteE3Curve::evaluate(ValueType& value, Time time) const {
    }
    else {
      CoefficientIter a, b;
-     bool success = manager_.getCoefficientsAt(time, &a, &b);
+     bool success = manager_.getCoefficientsAt(time, cursor, &a, &b);
      if(!success) {
        std::cerr << "Unable to get the coefficients at time " << time << std::endl;
        return false;
@@ -234,6 +251,14 @@ bool CubicHermiteE3Curve::evaluate(ValueType& value, Time time) const {
 bool CubicHermiteE3Curve::evaluateDerivative(DerivativeType& derivative, Time time,
                                              unsigned int derivativeOrder) const
 {
+  return evaluateDerivative(derivative, time, derivativeOrder, NULL);
+}
+
+bool CubicHermiteE3Curve::evaluateDerivative(DerivativeType& derivative, Time time,
+                                             unsigned int derivativeOrder,
+                                             CoefficientCursor* cursor) const
+{
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteE3Curve::evaluateDerivative");
   if (derivativeOrder == 1) {
     // Check if the curve is only defined at this one time
       if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
@@ -242,7 +267,7 @@ bool CubicHermiteE3Curve::evaluateDerivative(DerivativeType& derivative, Time ti
       }
       else {
         CoefficientIter a, b;
-        bool success = manager_.getCoefficientsAt(time, &a, &b);
+        bool success = manager_.getCoefficientsAt(time, cursor, &a, &b);
         if(!success) {
           std::cerr << "Unable to get the coefficients at time " << time << std::endl;
           return false;
@@ -328,6 +353,188 @@ bool CubicHermiteE3Curve::evaluateLinearAcceleration(Acceleration& linearAcceler
    return true;
 }
 
+namespace {
+
+/// Hermite basis: row i holds the factors of alpha^i for the knot terms
+/// (p_A, p_B, dt * v_A, dt * v_B), see beta0 to beta3 in evaluate.
+Eigen::Matrix4d getHermiteBasis() {
+  Eigen::Matrix4d basis;
+  basis <<  1.0,  0.0,  0.0,  0.0,
+            0.0,  0.0,  1.0,  0.0,
+           -3.0,  3.0, -2.0, -1.0,
+            2.0, -2.0,  1.0,  1.0;
+  return basis;
+}
+
+} // namespace
+
+bool CubicHermiteE3Curve::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  return evaluateAtTimes(times, 0, values);
+}
+
+bool CubicHermiteE3Curve::evaluateDerivative(const std::vector<Time>& times,
+                                             std::vector<DerivativeType>* derivatives,
+                                             unsigned int derivativeOrder) const {
+  if (derivativeOrder < 1 || derivativeOrder > 2) {
+    std::cerr << "CubicHermiteE3Curve::evaluateDerivative: higher order derivatives are not implemented!";
+    return false;
+  }
+  return evaluateAtTimes(times, derivativeOrder, derivatives);
+}
+
+bool CubicHermiteE3Curve::evaluateAtTimes(const std::vector<Time>& times, unsigned int derivativeOrder,
+                                          std::vector<Eigen::Vector3d>* values) const {
+  CHECK_NOTNULL(values);
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteE3Curve::evaluateAtTimes", times.size());
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> ValueMatrix;
+  values->resize(times.size());
+  Eigen::Map<ValueMatrix> valueMatrix(values->data()->data(), times.size(), 3);
+  if (manager_.empty()) {
+    valueMatrix.setZero();
+    return times.empty();
+  }
+
+  static const Eigen::Matrix4d basis = getHermiteBasis();
+  // Rows of the time powers, or of their derivatives with respect to time.
+  Eigen::Matrix<double, Eigen::Dynamic, 4, Eigen::RowMajor> powers(times.size(), 4);
+  Eigen::Matrix<double, 4, 3> knots;
+  Eigen::Matrix<double, 4, 3> segmentCoefficients;
+  // Times [segmentBegin, i) are in the segment starting at segment and not evaluated yet.
+  size_t segmentBegin = 0;
+  CoefficientIter segment = manager_.coefficientEnd();
+  auto evaluateSegment = [&](size_t end) {
+    if (segment != manager_.coefficientEnd() && end > segmentBegin) {
+      valueMatrix.middleRows(segmentBegin, end - segmentBegin).noalias() =
+          powers.middleRows(segmentBegin, end - segmentBegin) * segmentCoefficients;
+    }
+    segment = manager_.coefficientEnd();
+  };
+
+  CoefficientIter a, b;
+  bool hasSegment = false;
+  bool success = true;
+  for (size_t i = 0; i < times.size(); ++i) {
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluateSegment(i);
+      // A curve defined at a single time is only defined at its knot.
+      if (manager_.getMinTime() == times[i] && manager_.getMaxTime() == times[i]) {
+        const Coefficient& knot = manager_.coefficientBegin()->second.coefficient;
+        const Eigen::Vector3d knotValue = derivativeOrder == 0 ? knot.getPosition()
+            : derivativeOrder == 1 ? knot.getVelocity() : Eigen::Vector3d::Zero();
+        valueMatrix.row(i) = knotValue.transpose();
+      } else {
+        std::cerr << "Unable to get the coefficients at time " << times[i] << std::endl;
+        valueMatrix.row(i).setZero();
+        success = false;
+      }
+      continue;
+    }
+    const double dt = b->first - a->first;
+    if (a != segment) {
+      evaluateSegment(i);
+      knots.row(0) = a->second.coefficient.getPosition().transpose();
+      knots.row(1) = b->second.coefficient.getPosition().transpose();
+      knots.row(2) = dt * a->second.coefficient.getVelocity().transpose();
+      knots.row(3) = dt * b->second.coefficient.getVelocity().transpose();
+      segmentCoefficients.noalias() = basis * knots;
+      segmentBegin = i;
+      segment = a;
+    }
+    const double alpha = (times[i] - a->first) / dt;
+    switch (derivativeOrder) {
+      case 0:
+        powers.row(i) << 1.0, alpha, alpha * alpha, alpha * alpha * alpha;
+        break;
+      case 1:
+        powers.row(i) << 0.0, 1.0 / dt, 2.0 * alpha / dt, 3.0 * alpha * alpha / dt;
+        break;
+      default:
+        powers.row(i) << 0.0, 0.0, 2.0 / (dt * dt), 6.0 * alpha / (dt * dt);
+        break;
+    }
+  }
+  evaluateSegment(times.size());
+  return success;
+}
+
+bool CubicHermiteE3Curve::evaluateWithJacobians(const std::vector<Time>& times, KnotJacobians* jacobians,
+                                                unsigned int derivativeOrder) const {
+  CHECK_NOTNULL(jacobians);
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteE3Curve::evaluateWithJacobians", times.size());
+  if (derivativeOrder > 2) {
+    std::cerr << "CubicHermiteE3Curve::evaluateWithJacobians: higher order derivatives are not implemented!";
+    return false;
+  }
+  jacobians->resize(times.size());
+  if (manager_.empty()) {
+    return times.empty();
+  }
+
+  static const Eigen::Matrix4d basis = getHermiteBasis();
+  const Eigen::Matrix3d identity = Eigen::Matrix3d::Identity();
+  Eigen::RowVector4d powers;
+  Eigen::RowVector4d weights;
+  CoefficientIter a, b;
+  bool hasSegment = false;
+  bool success = true;
+  for (size_t i = 0; i < times.size(); ++i) {
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    KnotJacobians::JacobianBlock& jacobianA = jacobians->getJacobian(i, 0);
+    KnotJacobians::JacobianBlock& jacobianB = jacobians->getJacobian(i, 1);
+    if (!hasSegment) {
+      const CoefficientIter knot = times[i] <= manager_.getMinTime() ? manager_.coefficientBegin()
+          : std::prev(manager_.coefficientEnd());
+      jacobians->setKeys(i, knot->second.key, knot->second.key);
+      jacobians->getValue(i).setZero();
+      jacobianA.setZero();
+      jacobianB.setZero();
+      // A curve defined at a single time is only defined at its knot.
+      if (manager_.getMinTime() == times[i] && manager_.getMaxTime() == times[i]) {
+        const Coefficient& coefficient = knot->second.coefficient;
+        if (derivativeOrder == 0) {
+          jacobians->getValue(i) = coefficient.getPosition();
+          jacobianA.leftCols<3>() = identity;
+        } else if (derivativeOrder == 1) {
+          jacobians->getValue(i) = coefficient.getVelocity();
+          jacobianA.rightCols<3>() = identity;
+        }
+      } else {
+        std::cerr << "Unable to get the coefficients at time " << times[i] << std::endl;
+        success = false;
+      }
+      continue;
+    }
+    const double dt = b->first - a->first;
+    const double alpha = (times[i] - a->first) / dt;
+    switch (derivativeOrder) {
+      case 0:
+        powers << 1.0, alpha, alpha * alpha, alpha * alpha * alpha;
+        break;
+      case 1:
+        powers << 0.0, 1.0 / dt, 2.0 * alpha / dt, 3.0 * alpha * alpha / dt;
+        break;
+      default:
+        powers << 0.0, 0.0, 2.0 / (dt * dt), 6.0 * alpha / (dt * dt);
+        break;
+    }
+    // Weights of the knot terms (p_A, p_B, dt * v_A, dt * v_B).
+    weights.noalias() = powers * basis;
+    const Coefficient& coefficientA = a->second.coefficient;
+    const Coefficient& coefficientB = b->second.coefficient;
+    jacobians->getValue(i) = weights(0) * coefficientA.getPosition() + weights(1) * coefficientB.getPosition()
+        + weights(2) * dt * coefficientA.getVelocity() + weights(3) * dt * coefficientB.getVelocity();
+    jacobianA.leftCols<3>() = weights(0) * identity;
+    jacobianA.rightCols<3>() = weights(2) * dt * identity;
+    jacobianB.leftCols<3>() = weights(1) * identity;
+    jacobianB.rightCols<3>() = weights(3) * dt * identity;
+    jacobians->setKeys(i, a->second.key, b->second.key);
+  }
+  return success;
+}
+
 void CubicHermiteE3Curve::clear() {
   manager_.clear();
 }
@@ -0,0 +1,296 @@
+/*
+ * CubicHermiteSE2Curve.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <curves/CubicHermiteSE2Curve.hpp>
+#include <iostream>
+
+namespace curves {
+
+CubicHermiteSE2Curve::CubicHermiteSE2Curve() : SE2Curve() {}
+
+CubicHermiteSE2Curve::~CubicHermiteSE2Curve() {}
+
+void CubicHermiteSE2Curve::print(const std::string& str) const {
+  std::cout << "=========================================" << std::endl;
+  std::cout << "======= Cubic Hermite SE2 CURVE =========" << std::endl;
+  std::cout << str << std::endl;
+  std::cout << "num of coefficients: " << manager_.size() << std::endl;
+  std::cout << "dimension: " << 3 << std::endl;
+  std::cout << "curve defined between times: " << manager_.getMinTime() <<
+      " and " << manager_.getMaxTime() <<std::endl;
+  std::cout <<"=========================================" <<std::endl;
+  for (CoefficientIter it = manager_.coefficientBegin(); it != manager_.coefficientEnd(); ++it) {
+    const ValueType& value = it->second.coefficient.getTransformation();
+    std::cout << "coefficient " << it->second.key << ": x " << value.x() << " y " << value.y()
+              << " theta " << value.getAngle() << " | time: " << it->first << std::endl;
+  }
+  std::cout <<"=========================================" <<std::endl;
+}
+
+Time CubicHermiteSE2Curve::getMaxTime() const {
+  return manager_.getMaxTime();
+}
+
+Time CubicHermiteSE2Curve::getMinTime() const {
+  return manager_.getMinTime();
+}
+
+bool CubicHermiteSE2Curve::isEmpty() const {
+  return manager_.empty();
+}
+
+int CubicHermiteSE2Curve::size() const {
+  return manager_.size();
+}
+
+CubicHermiteSE2Curve::DerivativeType CubicHermiteSE2Curve::calculateSlope(const Time& timeA,
+                                                                          const Time& timeB,
+                                                                          const ValueType& coeffA,
+                                                                          const ValueType& coeffB) const {
+  const double inverseDeltaTime = 1.0 / (timeB - timeA);
+  const Eigen::Vector2d velocity = (coeffB.getPosition() - coeffA.getPosition()) * inverseDeltaTime;
+  return DerivativeType(velocity.x(), velocity.y(),
+                        SE2Transformation::wrapAngle(coeffB.getAngle() - coeffA.getAngle()) * inverseDeltaTime);
+}
+
+void CubicHermiteSE2Curve::fitCurve(const std::vector<Time>& times,
+                                    const std::vector<ValueType>& values,
+                                    std::vector<Key>* outKeys) {
+  fitCurveWithDerivatives(times, values, DerivativeType::Zero(), DerivativeType::Zero(), outKeys);
+}
+
+void CubicHermiteSE2Curve::fitCurveWithDerivatives(const std::vector<Time>& times,
+                                                   const std::vector<ValueType>& values,
+                                                   const DerivativeType& initialDerivative,
+                                                   const DerivativeType& finalDerivative,
+                                                   std::vector<Key>* outKeys) {
+  CHECK_EQ(times.size(), values.size());
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE2Curve::fitCurve", times.size());
+  clear();
+
+  // use Catmull-Rom interpolation for derivatives on knot points
+  std::vector<Coefficient> coefficients(times.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    DerivativeType derivative;
+    if (i == 0) {
+      derivative = initialDerivative;
+    } else if (i == times.size() - 1) {
+      derivative = finalDerivative;
+    } else {
+      derivative = calculateSlope(times[i-1], times[i+1], values[i-1], values[i+1]);
+    }
+    coefficients[i] = Coefficient(values[i], derivative);
+  }
+  manager_.resetCoefficients(times, coefficients, outKeys);
+}
+
+void CubicHermiteSE2Curve::fitCurveWithDerivatives(const std::vector<Time>& times,
+                                                   const std::vector<ValueType>& values,
+                                                   const std::vector<DerivativeType>& derivatives,
+                                                   std::vector<Key>* outKeys) {
+  CHECK_EQ(times.size(), values.size());
+  CHECK_EQ(times.size(), derivatives.size());
+  clear();
+
+  std::vector<Coefficient> coefficients(times.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    coefficients[i] = Coefficient(values[i], derivatives[i]);
+  }
+  manager_.resetCoefficients(times, coefficients, outKeys);
+}
+
+void CubicHermiteSE2Curve::extend(const std::vector<Time>& times,
+                                  const std::vector<ValueType>& values,
+                                  std::vector<Key>* outKeys) {
+  CHECK_EQ(times.size(), values.size()) << "number of times and number of coefficients don't match";
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE2Curve::extend", times.size());
+  hermitePolicy_.extend<CubicHermiteSE2Curve, ValueType>(times, values, this, outKeys);
+}
+
+bool CubicHermiteSE2Curve::evaluate(ValueType& value, Time time) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteSE2Curve::evaluate");
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty);
+    return false;
+  }
+  // Check if the curve is only defined at this one time
+  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
+    value = manager_.coefficientBegin()->second.coefficient.getTransformation();
+    return true;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, &a, &b)) {
+    evaluationErrors_.record(EvaluationError::OutOfRange);
+    return false;
+  }
+  const Vector3d pose = interpolate(time, a, b, 0);
+  value = ValueType(pose.x(), pose.y(), pose.z());
+  return true;
+}
+
+SE2Transformation CubicHermiteSE2Curve::evaluate(Time time) const {
+  ValueType value;
+  CHECK(evaluate(value, time)) << "Unable to get the coefficients at time " << time;
+  return value;
+}
+
+bool CubicHermiteSE2Curve::evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteSE2Curve::evaluateDerivative");
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty);
+    return false;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, &a, &b)) {
+    evaluationErrors_.record(EvaluationError::OutOfRange);
+    return false;
+  }
+  derivative = interpolate(time, a, b, derivativeOrder);
+  return true;
+}
+
+bool CubicHermiteSE2Curve::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b;
+  for (size_t i = 0; i < times.size(); ++i) {
+    // Check if the curve is only defined at this one time
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      (*values)[i] = manager_.coefficientBegin()->second.coefficient.getTransformation();
+      continue;
+    }
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    const Vector3d pose = interpolate(times[i], a, b, 0);
+    (*values)[i] = ValueType(pose.x(), pose.y(), pose.z());
+  }
+  return success;
+}
+
+bool CubicHermiteSE2Curve::evaluateDerivative(const std::vector<Time>& times,
+                                              std::vector<DerivativeType>* derivatives,
+                                              unsigned derivativeOrder) const {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b;
+  for (size_t i = 0; i < times.size(); ++i) {
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    (*derivatives)[i] = interpolate(times[i], a, b, derivativeOrder);
+  }
+  return success;
+}
+
+Vector3d CubicHermiteSE2Curve::interpolate(Time time, CoefficientIter a, CoefficientIter b,
+                                           unsigned derivativeOrder) const {
+  const ValueType& T_W_A = a->second.coefficient.getTransformation();
+  const ValueType& T_W_B = b->second.coefficient.getTransformation();
+  // Efficient and exact evaluation at the coefficients
+  if (derivativeOrder == 0 && time == a->first) {
+    return Vector3d(T_W_A.x(), T_W_A.y(), T_W_A.getAngle());
+  }
+  if (derivativeOrder == 0 && time == b->first) {
+    return Vector3d(T_W_B.x(), T_W_B.y(), T_W_B.getAngle());
+  }
+
+  const double dt = b->first - a->first;
+  const double s = (time - a->first) / dt;
+  const double s2 = s * s;
+  // The derivatives of the basis polynomials h00, h10, h01 and h11 with respect to s,
+  // scaled to the derivative with respect to time. h00 = 1 - h01.
+  double h01, h10, h11, scaling;
+  switch (derivativeOrder) {
+    case 0:
+      h01 = 3.0 * s2 - 2.0 * s2 * s;
+      h10 = s2 * s - 2.0 * s2 + s;
+      h11 = s2 * s - s2;
+      scaling = 1.0;
+      break;
+    case 1:
+      h01 = 6.0 * s - 6.0 * s2;
+      h10 = 3.0 * s2 - 4.0 * s + 1.0;
+      h11 = 3.0 * s2 - 2.0 * s;
+      scaling = 1.0 / dt;
+      break;
+    case 2:
+      h01 = 6.0 - 12.0 * s;
+      h10 = 6.0 * s - 4.0;
+      h11 = 6.0 * s - 2.0;
+      scaling = 1.0 / (dt * dt);
+      break;
+    case 3:
+      h01 = -12.0;
+      h10 = 6.0;
+      h11 = 6.0;
+      scaling = 1.0 / (dt * dt * dt);
+      break;
+    default:
+      // cubic polynomials, higher derivatives are zero
+      return Vector3d::Zero();
+  }
+
+  // The angle of B is unwrapped to the shortest rotation from A.
+  const Vector3d delta(T_W_B.x() - T_W_A.x(), T_W_B.y() - T_W_A.y(),
+                       SE2Transformation::wrapAngle(T_W_B.getAngle() - T_W_A.getAngle()));
+  Vector3d result = scaling * (h01 * delta + dt * (h10 * a->second.coefficient.getTransformationDerivative()
+                                                   + h11 * b->second.coefficient.getTransformationDerivative()));
+  if (derivativeOrder == 0) {
+    result += Vector3d(T_W_A.x(), T_W_A.y(), T_W_A.getAngle());
+  }
+  return result;
+}
+
+void CubicHermiteSE2Curve::setMinSamplingPeriod(Time time) {
+  hermitePolicy_.setMinSamplingPeriod(time);
+}
+
+///   eg. 4 will add a coefficient every 4 extend
+void CubicHermiteSE2Curve::setSamplingRatio(const int ratio) {
+  hermitePolicy_.setMinimumMeasurements(ratio);
+}
+
+void CubicHermiteSE2Curve::clear() {
+  manager_.clear();
+}
+
+void CubicHermiteSE2Curve::transformCurve(const ValueType T) {
+  // Apply a rigid transformation to every coefficient (on the left side), in place. The
+  // velocities are rotated, the angular velocity does not change in the plane.
+  const Eigen::Matrix2d rotation = T.getRotationMatrix();
+  manager_.updateCoefficientValues([&T, &rotation](Coefficient& coefficient) {
+    DerivativeType derivative = coefficient.getTransformationDerivative();
+    derivative.head<2>() = rotation * derivative.head<2>();
+    coefficient = Coefficient(T * coefficient.getTransformation(), derivative);
+  });
+}
+
+void CubicHermiteSE2Curve::getCurveTimes(std::vector<Time>* outTimes) const {
+  manager_.getTimes(outTimes);
+}
+
+} // namespace curves
@@ -6,14 +6,23 @@
  *   Institute: ETH Zurich, Autonomous Systems Lab
  */
 
+#include <functional>
 #include <iostream>
 
 #include "curves/CubicHermiteSE3Curve.hpp"
 #include "curves/SlerpSE3Curve.hpp"
+#include "curves/ParallelEvaluation.hpp"
+#include "curves/ParallelFor.hpp"
+#include "curves/Instrumentation.hpp"
 
 namespace curves {
 
-CubicHermiteSE3Curve::CubicHermiteSE3Curve() : SE3Curve() {
+CubicHermiteSE3Curve::CubicHermiteSE3Curve() :
+    SE3Curve(),
+    segmentCacheEnabled_(false),
+    lazySlopesEnabled_(false),
+    numFitThreads_(1),
+    segmentsStamp_(0) {
   hermitePolicy_.setMinimumMeasurements(4);
 }
 
@@ -57,19 +66,26 @@ bool CubicHermiteSE3Curve::writeEvalToFile(const std::string& filename, int nSam
   fprintf(fp, "\n");
 
   Time dt = (getMaxTime()-getMinTime())/(nSamples-1);
-  ValueType pose;
-  DerivativeType twist;
+  std::vector<Time> times;
   for (Time t = getMinTime(); t < getMaxTime(); t+=dt) {
-    if(!evaluate(pose, t)) {
-      std::cout << "Could not evaluate at time " << t << std::endl;
-      fclose(fp);
-      return false;
-    }
-    if(!evaluateDerivative(twist, t, 1)) {
-      std::cout << "Could not evaluate derivative at time " << t << std::endl;
-      fclose(fp);
-      return false;
-    }
+    times.push_back(t);
+  }
+  std::vector<ValueType> poses;
+  std::vector<DerivativeType> twists;
+  if(!evaluateInParallel(*this, times, &poses)) {
+    std::cout << "Could not evaluate the curve" << std::endl;
+    fclose(fp);
+    return false;
+  }
+  if(!evaluateDerivativeInParallel(*this, times, 1, &twists)) {
+    std::cout << "Could not evaluate the curve derivative" << std::endl;
+    fclose(fp);
+    return false;
+  }
+  for (size_t i = 0; i < times.size(); ++i) {
+    const Time t = times[i];
+    const ValueType& pose = poses[i];
+    const DerivativeType& twist = twists[i];
     fprintf(fp, "%lf ", t);
     fprintf(fp, "%lf %lf %lf ", pose.getPosition().x(), pose.getPosition().y(), pose.getPosition().z());
     fprintf(fp, "%lf %lf %lf %lf ", pose.getRotation().w(), pose.getRotation().x(), pose.getRotation().y(), pose.getRotation().z());
@@ -91,9 +107,7 @@ Time CubicHermiteSE3Curve::getMinTime() const {
 }
 
 bool CubicHermiteSE3Curve::isEmpty() const {
-  std::vector<Time> outTimes;
-  manager_.getTimes(&outTimes);
-  return outTimes.empty();
+  return manager_.empty();
 }
 
 int CubicHermiteSE3Curve::size() const {
@@ -113,13 +127,35 @@ void CubicHermiteSE3Curve::fitCurveWithDerivatives(const std::vector<Time>& time
                                     std::vector<Key>* outKeys)
 {
   CHECK_EQ(times.size(), values.size());
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE3Curve::fitCurve", times.size());
   clear();
 
   // construct the Hemrite coefficients
-  std::vector<Coefficient> coefficients;
+  std::vector<Coefficient> coefficients(times.size());
+  if (lazySlopesEnabled_ && times.size() > 2 && manager_.getWindowDuration() == 0 &&
+      manager_.getWindowSize() == 0 && std::adjacent_find(times.begin(), times.end(),
+                                                          std::greater_equal<Time>()) == times.end()) {
+    // Only the boundary derivatives are stored, the other slopes are computed by getSlope.
+    for (size_t i = 0; i < times.size(); ++i) {
+      coefficients[i] = Coefficient(values[i], DerivativeType());
+    }
+    coefficients.front() = Coefficient(values.front(), initialDerivative);
+    coefficients.back() = Coefficient(values.back(), finalDerivative);
+    manager_.resetCoefficients(times, coefficients, outKeys);
+    lazySlopes_ = std::make_shared<LazySlopes>();
+    lazySlopes_->stamp = manager_.getCoefficientStamp();
+    lazySlopes_->slopes.resize(times.size());
+    lazySlopes_->states.reset(new std::atomic<unsigned char>[times.size()]);
+    for (size_t i = 0; i < times.size(); ++i) {
+      lazySlopes_->states[i].store(LazySlopes::Missing, std::memory_order_relaxed);
+    }
+    updateSegmentCache();
+    return;
+  }
+
   // fill the coefficients with ValueType and DerivativeType
   // use Catmull-Rom interpolation for derivatives on knot points
-  for (size_t i = 0; i < times.size(); ++i) {
+  parallelFor(0, times.size(), [&](size_t i) {
     DerivativeType derivative;
     // catch the boundaries (i == 0 && i == max)
     if (i == 0) {
@@ -139,10 +175,29 @@ void CubicHermiteSE3Curve::fitCurveWithDerivatives(const std::vector<Time>& time
       // Other keys.
       derivative = calculateSlope(times[i-1], times[i+1], values[i-1], values[i+1]);
     }
-    coefficients.push_back(Coefficient(values[i], derivative));
-  }
+    coefficients[i] = Coefficient(values[i], derivative);
+  }, numFitThreads_);
 
-  manager_.insertCoefficients(times, coefficients, outKeys);
+  manager_.resetCoefficients(times, coefficients, outKeys);
+  updateSegmentCache();
+}
+
+void CubicHermiteSE3Curve::fitCurveWithDerivatives(const std::vector<Time>& times,
+                                                   const std::vector<ValueType>& values,
+                                                   const std::vector<DerivativeType>& derivatives,
+                                                   std::vector<Key>* outKeys)
+{
+  CHECK_EQ(times.size(), values.size());
+  CHECK_EQ(times.size(), derivatives.size());
+  clear();
+
+  std::vector<Coefficient> coefficients(times.size());
+  parallelFor(0, times.size(), [&](size_t i) {
+    coefficients[i] = Coefficient(values[i], derivatives[i]);
+  }, numFitThreads_);
+
+  manager_.resetCoefficients(times, coefficients, outKeys);
+  updateSegmentCache();
 }
 
 void CubicHermiteSE3Curve::fitPeriodicCurve(const std::vector<Time>& times,
@@ -174,6 +229,7 @@ CubicHermiteSE3Curve::DerivativeType CubicHermiteSE3Curve::calculateSlope(const
 void CubicHermiteSE3Curve::extend(const std::vector<Time>& times,
                                   const std::vector<ValueType>& values,
                                   std::vector<Key>* outKeys) {
+  materializeLazySlopes();
 
   // New values in extend first need to be checked if they can be added to curve
   // otherwise the most recent coefficient will be an interpolation based on the last
@@ -186,193 +242,572 @@ void CubicHermiteSE3Curve::extend(const std::vector<Time>& times,
   // - default extend if curve is empty
   // - interpolation extend otherwise
 
-//  CHECK_EQ(times.size(), values.size()) << "number of times and number of coefficients don't match";
-//  hermitePolicy_.extend<CubicHermiteSE3Curve, ValueType>(times, values, this, outKeys);
-  throw std::runtime_error("CubicHermiteSE3Curve::extend is not implemented!");
+  CHECK_EQ(times.size(), values.size()) << "number of times and number of coefficients don't match";
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE3Curve::extend", times.size());
+
+  // The policies only change the last two knots, the interpolated one and the knot before
+  // them, which simplifyEnd may remove. The segments ending before these are kept.
+  const bool isSegmentCacheValid = segmentCacheEnabled_ && segmentsStamp_ == manager_.getCoefficientStamp();
+  const size_t numUnchangedSegments = isSegmentCacheValid && manager_.size() > 4 ? manager_.size() - 4 : 0;
+  const Time unchangedEndTime = numUnchangedSegments > 0
+      ? (CoefficientIter(manager_.coefficientBegin()) + numUnchangedSegments)->first : Time(0);
+
+  hermitePolicy_.extend<CubicHermiteSE3Curve, ValueType>(times, values, this, outKeys);
+
+  if (numUnchangedSegments > 0) {
+    updateSegmentCacheTail(numUnchangedSegments, unchangedEndTime);
+  } else {
+    updateSegmentCache();
+  }
+}
+
+Key CubicHermiteSE3Curve::extend(Time time, const ValueType& value) {
+  extend(std::vector<Time>(1, time), std::vector<ValueType>(1, value));
+  return (CoefficientIter(manager_.coefficientEnd()) - 1)->second.key;
 }
 
 
 bool CubicHermiteSE3Curve::evaluate(ValueType& value, Time time) const {
+  return evaluate(value, time, NULL);
+}
+
+bool CubicHermiteSE3Curve::evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const {
+  return tryEvaluate(value, time, cursor) == EvaluationError::None;
+}
+
+EvaluationError CubicHermiteSE3Curve::tryEvaluate(ValueType& value, Time time, CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteSE3Curve::evaluate");
+  if (manager_.size() == 0) {
+    return evaluationErrors_.record(EvaluationError::Empty);
+  }
   // Check if the curve is only defined at this one time
   if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
     value =  manager_.coefficientBegin()->second.coefficient.getTransformation();
-    return true;
+    return EvaluationError::None;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, cursor, &a, &b)) {
+    return evaluationErrors_.record(EvaluationError::OutOfRange);
+  }
+  value = interpolate(time, a, b);
+  return EvaluationError::None;
+}
+
+bool CubicHermiteSE3Curve::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
   }
-  else {
-    CoefficientIter a, b;
-    bool success = manager_.getCoefficientsAt(time, &a, &b);
-    if(!success) {
-      std::cerr << "Unable to get the coefficients at time " << time << std::endl;
-      return false;
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b;
+  // The segment data is only recomputed when the query moves to another segment.
+  Segment segment;
+  const Segment* currentSegment = NULL;
+  CoefficientIter currentA;
+  for (size_t i = 0; i < times.size(); ++i) {
+    // Check if the curve is only defined at this one time
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      (*values)[i] = manager_.coefficientBegin()->second.coefficient.getTransformation();
+      continue;
+    }
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
     }
+    if (currentSegment == NULL || a != currentA) {
+      currentSegment = getCachedSegment(a);
+      if (currentSegment == NULL) {
+        segment = getSegment(a, b);
+        currentSegment = &segment;
+      }
+      currentA = a;
+    }
+    (*values)[i] = interpolate(times[i], a->first, *currentSegment);
+  }
+  return success;
+}
 
-    // read out transformation from coefficient
-    const SE3 T_W_A = a->second.coefficient.getTransformation();
-    const SE3 T_W_B = b->second.coefficient.getTransformation();
-
-    // read out derivative from coefficient
-    const Twist d_W_A = a->second.coefficient.getTransformationDerivative();
-    const Twist d_W_B = b->second.coefficient.getTransformationDerivative();
-
-    // make alpha
-    const double dt_sec = (b->first - a->first);// * 1e-9;
-    const double alpha = double(time - a->first)/(b->first - a->first);
-
-    // Implemantation of Hermite Interpolation not easy and not fun (without expressions)!
-
-    // translational part (easy):
-    const double alpha2 = alpha * alpha;
-    const double alpha3 = alpha2 * alpha;
-
-    const double beta0 = 2.0 * alpha3 - 3.0 * alpha2 + 1.0;
-    const double beta1 = -2.0 * alpha3 + 3.0 * alpha2;
-    const double beta2 = alpha3 - 2.0 * alpha2 + alpha;
-    const double beta3 = alpha3 - alpha2;
-
-    /**************************************************************************************
-     *  Translational part:
-     **************************************************************************************/
-    const SE3::Position translation(T_W_A.getPosition().vector() * beta0
-                                  + T_W_B.getPosition().vector() * beta1
-                                  + d_W_A.getTranslationalVelocity().vector() * (beta2 * dt_sec)
-                                  + d_W_B.getTranslationalVelocity().vector() * (beta3 * dt_sec));
-
-    /**************************************************************************************
-     *  Rotational part:
-     **************************************************************************************/
-    const double dt_sec_third = dt_sec / 3.0;
-    const Eigen::Vector3d scaled_d_W_A = dt_sec_third * d_W_A.getRotationalVelocity().vector();
-    const Eigen::Vector3d scaled_d_W_B = dt_sec_third * d_W_B.getRotationalVelocity().vector();
-
-    // d_W_A contains the global angular velocity, but we need the local angular velocity.
-    const Eigen::Vector3d w1 = T_W_A.getRotation().inverseRotate(scaled_d_W_A);
-    const Eigen::Vector3d w3 = T_W_B.getRotation().inverseRotate(scaled_d_W_B);
-    const RotationQuaternion expW1_inv = RotationQuaternion().exponentialMap(-w1);
-    const RotationQuaternion expW3_inv = RotationQuaternion().exponentialMap(-w3);
-    const RotationQuaternion expW1_Inv_qWB_expW3 = expW1_inv * T_W_A.getRotation().inverted() * T_W_B.getRotation() * expW3_inv;
-    const Eigen::Vector3d w2 = expW1_Inv_qWB_expW3.logarithmicMap();
-
-    const double dBeta1 = alpha3 - 3.0 * alpha2 + 3.0 * alpha;
-    const double dBeta2 = -2.0 * alpha3 + 3.0 * alpha2;
-    const double dBeta3 = alpha3;
-
-    const SO3 w1_dBeta1_exp = RotationQuaternion().exponentialMap(dBeta1 * w1);
-    const SO3 w2_dBeta2_exp = RotationQuaternion().exponentialMap(dBeta2 * w2);
-    const SO3 w3_dBeta3_exp = RotationQuaternion().exponentialMap(dBeta3 * w3);
-
-    const RotationQuaternion rotation = T_W_A.getRotation() * w1_dBeta1_exp * w2_dBeta2_exp * w3_dBeta3_exp;
-
-    value = SE3(translation, rotation);
-    return true;
+CubicHermiteSE3Curve::Segment CubicHermiteSE3Curve::getSegment(CoefficientIter a, CoefficientIter b) const {
+  // read out the packed coefficients
+  const Coefficient& coefficientA = a->second.coefficient;
+  const Coefficient& coefficientB = b->second.coefficient;
+  const RotationQuaternion rotationB = coefficientB.getRotation();
+
+  Segment segment;
+  segment.dt = (b->first - a->first);// * 1e-9;
+  segment.positionA = coefficientA.getPosition();
+  segment.positionB = coefficientB.getPosition();
+  segment.rotationA = coefficientA.getRotation();
+  Eigen::Vector3d angularVelocityA, angularVelocityB;
+  if (hasLazySlopes()) {
+    const DerivativeType slopeA = getSlope(a);
+    const DerivativeType slopeB = getSlope(b);
+    segment.velocityA = slopeA.getTranslationalVelocity().vector();
+    segment.velocityB = slopeB.getTranslationalVelocity().vector();
+    angularVelocityA = slopeA.getRotationalVelocity().vector();
+    angularVelocityB = slopeB.getRotationalVelocity().vector();
+  } else {
+    segment.velocityA = coefficientA.getLinearVelocity();
+    segment.velocityB = coefficientB.getLinearVelocity();
+    angularVelocityA = coefficientA.getAngularVelocity();
+    angularVelocityB = coefficientB.getAngularVelocity();
+  }
+
+  const double dt_sec_third = segment.dt / 3.0;
+  const Eigen::Vector3d scaled_d_W_A = dt_sec_third * angularVelocityA;
+  const Eigen::Vector3d scaled_d_W_B = dt_sec_third * angularVelocityB;
+
+  // d_W_A contains the global angular velocity, but we need the local angular velocity.
+  segment.w1 = segment.rotationA.inverseRotate(scaled_d_W_A);
+  segment.w3 = rotationB.inverseRotate(scaled_d_W_B);
+  const RotationQuaternion expW1_inv = RotationQuaternion().exponentialMap(-segment.w1);
+  const RotationQuaternion expW3_inv = RotationQuaternion().exponentialMap(-segment.w3);
+  const RotationQuaternion expW1_Inv_qWB_expW3 = expW1_inv * segment.rotationA.inverted() * rotationB * expW3_inv;
+  segment.w2 = expW1_Inv_qWB_expW3.logarithmicMap();
+  return segment;
+}
+
+const CubicHermiteSE3Curve::Segment* CubicHermiteSE3Curve::getCachedSegment(CoefficientIter a) const {
+  if (!segmentCacheEnabled_ || segmentsStamp_ != manager_.getCoefficientStamp() || a.index() >= segments_.size()) {
+    return NULL;
   }
-  return false;
+  return &segments_[a.index()];
+}
+
+void CubicHermiteSE3Curve::updateSegmentCache() {
+  segments_.clear();
+  if (!segmentCacheEnabled_ || manager_.size() < 2) {
+    segmentsStamp_ = 0;
+    return;
+  }
+  segments_.resize(manager_.size() - 1);
+  const CoefficientIter begin = manager_.coefficientBegin();
+  parallelFor(0, segments_.size(), [&](size_t i) {
+    segments_[i] = getSegment(begin + i, begin + (i + 1));
+  }, numFitThreads_);
+  segmentsStamp_ = manager_.getCoefficientStamp();
+}
+
+void CubicHermiteSE3Curve::updateSegmentCacheTail(size_t numUnchanged, Time unchangedEndTime) {
+  // The window may have dropped knots at the front, which shifts the segments.
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(unchangedEndTime, &a, &b) || a->first != unchangedEndTime) {
+    updateSegmentCache();
+    return;
+  }
+  segments_.erase(segments_.begin(), segments_.begin() + (numUnchanged - a.index()));
+  segments_.resize(a.index());
+  const CoefficientIter begin = manager_.coefficientBegin();
+  for (size_t i = segments_.size(); i + 1 < manager_.size(); ++i) {
+    segments_.push_back(getSegment(begin + i, begin + (i + 1)));
+  }
+  segmentsStamp_ = manager_.getCoefficientStamp();
+}
+
+void CubicHermiteSE3Curve::setSegmentCacheEnabled(bool enabled) {
+  segmentCacheEnabled_ = enabled;
+  updateSegmentCache();
+}
+
+bool CubicHermiteSE3Curve::isSegmentCacheEnabled() const {
+  return segmentCacheEnabled_;
+}
+
+void CubicHermiteSE3Curve::setLazySlopesEnabled(bool enabled) {
+  if (!enabled) {
+    materializeLazySlopes();
+  }
+  lazySlopesEnabled_ = enabled;
+}
+
+bool CubicHermiteSE3Curve::isLazySlopesEnabled() const {
+  return lazySlopesEnabled_;
+}
+
+bool CubicHermiteSE3Curve::hasLazySlopes() const {
+  return lazySlopes_ && lazySlopes_->stamp == manager_.getCoefficientStamp();
+}
+
+CubicHermiteSE3Curve::DerivativeType CubicHermiteSE3Curve::getSlope(CoefficientIter it) const {
+  const size_t i = it.index();
+  // The first and last knot keep the derivatives given to the fit.
+  if (!hasLazySlopes() || i == 0 || i + 1 == manager_.size()) {
+    return it->second.coefficient.getTransformationDerivative();
+  }
+  LazySlopes& lazySlopes = *lazySlopes_;
+  std::atomic<unsigned char>& state = lazySlopes.states[i];
+  if (state.load(std::memory_order_acquire) == LazySlopes::Ready) {
+    return lazySlopes.slopes[i];
+  }
+  const CoefficientIter previous = it - 1;
+  const CoefficientIter next = it + 1;
+  const DerivativeType slope = calculateSlope(previous->first, next->first,
+                                              previous->second.coefficient.getTransformation(),
+                                              next->second.coefficient.getTransformation());
+  // Concurrent evaluations compute the same slope, only the first one stores it.
+  unsigned char expected = LazySlopes::Missing;
+  if (state.compare_exchange_strong(expected, LazySlopes::Computing, std::memory_order_acquire)) {
+    lazySlopes.slopes[i] = slope;
+    state.store(LazySlopes::Ready, std::memory_order_release);
+  }
+  return slope;
+}
+
+void CubicHermiteSE3Curve::writeLazySlopes(CoefficientManager* manager) const {
+  std::vector<Time> times;
+  manager_.getTimes(&times);
+  std::vector<Coefficient> coefficients(times.size());
+  const CoefficientIter begin = manager_.coefficientBegin();
+  parallelFor(0, times.size(), [&](size_t i) {
+    coefficients[i] = Coefficient((begin + i)->second.coefficient.getTransformation(), getSlope(begin + i));
+  }, numFitThreads_);
+  manager->modifyCoefficientsValuesInBatch(times, coefficients);
+}
+
+void CubicHermiteSE3Curve::materializeLazySlopes() {
+  if (hasLazySlopes()) {
+    writeLazySlopes(&manager_);
+    updateSegmentCache();
+  }
+  lazySlopes_.reset();
+}
+
+CubicHermiteSE3Curve::ValueType CubicHermiteSE3Curve::interpolate(Time time, CoefficientIter a,
+                                                                  CoefficientIter b) const {
+  const Segment* segment = getCachedSegment(a);
+  if (segment != NULL) {
+    return interpolate(time, a->first, *segment);
+  }
+  return interpolate(time, a->first, getSegment(a, b));
+}
+
+CubicHermiteSE3Curve::ValueType CubicHermiteSE3Curve::interpolate(Time time, Time timeA,
+                                                                  const Segment& segment) const {
+  // make alpha
+  const double dt_sec = segment.dt;
+  const double alpha = double(time - timeA)/dt_sec;
+
+  // Implemantation of Hermite Interpolation not easy and not fun (without expressions)!
+
+  // translational part (easy):
+  const double alpha2 = alpha * alpha;
+  const double alpha3 = alpha2 * alpha;
+
+  const double beta0 = 2.0 * alpha3 - 3.0 * alpha2 + 1.0;
+  const double beta1 = -2.0 * alpha3 + 3.0 * alpha2;
+  const double beta2 = alpha3 - 2.0 * alpha2 + alpha;
+  const double beta3 = alpha3 - alpha2;
+
+  /**************************************************************************************
+   *  Translational part:
+   **************************************************************************************/
+  const SE3::Position translation(segment.positionA * beta0
+                                + segment.positionB * beta1
+                                + segment.velocityA * (beta2 * dt_sec)
+                                + segment.velocityB * (beta3 * dt_sec));
+
+  /**************************************************************************************
+   *  Rotational part:
+   **************************************************************************************/
+  const double dBeta1 = alpha3 - 3.0 * alpha2 + 3.0 * alpha;
+  const double dBeta2 = -2.0 * alpha3 + 3.0 * alpha2;
+  const double dBeta3 = alpha3;
+
+  const SO3 w1_dBeta1_exp = RotationQuaternion().exponentialMap(dBeta1 * segment.w1);
+  const SO3 w2_dBeta2_exp = RotationQuaternion().exponentialMap(dBeta2 * segment.w2);
+  const SO3 w3_dBeta3_exp = RotationQuaternion().exponentialMap(dBeta3 * segment.w3);
+
+  const RotationQuaternion rotation = segment.rotationA * w1_dBeta1_exp * w2_dBeta2_exp * w3_dBeta3_exp;
+
+  return SE3(translation, rotation);
 }
 
 bool CubicHermiteSE3Curve::evaluateDerivative(DerivativeType& derivative,
     Time time, unsigned int derivativeOrder) const
 {
-  if (derivativeOrder == 1) {
+  return evaluateDerivative(derivative, time, derivativeOrder, NULL);
+}
+
+bool CubicHermiteSE3Curve::evaluateDerivative(DerivativeType& derivative, Time time,
+                                              unsigned int derivativeOrder,
+                                              CoefficientCursor* cursor) const {
+  return tryEvaluateDerivative(derivative, time, derivativeOrder, cursor) == EvaluationError::None;
+}
+
+EvaluationError CubicHermiteSE3Curve::tryEvaluateDerivative(DerivativeType& derivative, Time time,
+                                                            unsigned int derivativeOrder,
+                                                            CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteSE3Curve::evaluateDerivative");
+  // Higher order derivatives are not implemented.
+  if (derivativeOrder != 1) {
+    return evaluationErrors_.record(EvaluationError::UnsupportedDerivative);
+  }
+  if (manager_.size() == 0) {
+    return evaluationErrors_.record(EvaluationError::Empty);
+  }
+  // Check if the curve is only defined at this one time
+  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
+    derivative = manager_.coefficientBegin()->second.coefficient.getTransformationDerivative();
+    return EvaluationError::None;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, cursor, &a, &b)) {
+    return evaluationErrors_.record(EvaluationError::OutOfRange);
+  }
+  derivative = interpolateDerivative(time, a, b);
+  return EvaluationError::None;
+}
+
+bool CubicHermiteSE3Curve::evaluateDerivative(const std::vector<Time>& times,
+                                              std::vector<DerivativeType>* derivatives,
+                                              unsigned int derivativeOrder) const {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  if (derivativeOrder != 1) {
+    evaluationErrors_.record(EvaluationError::UnsupportedDerivative, times.size());
+    return false;
+  }
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b;
+  // The segment data is only recomputed when the query moves to another segment.
+  Segment segment;
+  const Segment* currentSegment = NULL;
+  CoefficientIter currentA;
+  for (size_t i = 0; i < times.size(); ++i) {
     // Check if the curve is only defined at this one time
-    if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
-      derivative = manager_.coefficientBegin()->second.coefficient.getTransformationDerivative();
-      return true;
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      (*derivatives)[i] = manager_.coefficientBegin()->second.coefficient.getTransformationDerivative();
+      continue;
     }
-    else {
-      CoefficientIter a, b;
-      bool success = manager_.getCoefficientsAt(time, &a, &b);
-      if(!success) {
-        std::cerr << "Unable to get the coefficients at time " << time << std::endl;
-        return false;
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    if (currentSegment == NULL || a != currentA) {
+      currentSegment = getCachedSegment(a);
+      if (currentSegment == NULL) {
+        segment = getSegment(a, b);
+        currentSegment = &segment;
       }
+      currentA = a;
+    }
+    (*derivatives)[i] = interpolateDerivative(times[i], a->first, *currentSegment);
+  }
+  return success;
+}
 
-      // read out transformation from coefficient
-      const SE3 T_W_A = a->second.coefficient.getTransformation();
-      const SE3 T_W_B = b->second.coefficient.getTransformation();
-
-      // read out derivative from coefficient
-      const Twist d_W_A = a->second.coefficient.getTransformationDerivative();
-      const Twist d_W_B = b->second.coefficient.getTransformationDerivative();
-
-      // make alpha
-      double dt_sec = (b->first - a->first);
-      const double one_over_dt_sec = 1.0/dt_sec;
-      double alpha = double(time - a->first)/dt_sec;
-
-      const double alpha2 = alpha * alpha;
-      const double alpha3 = alpha2 * alpha;
-
-      /**************************************************************************************
-       *  Translational part:
-       **************************************************************************************/
-      // Implementation of translation
-      const double gamma0 = 6.0*(alpha2 - alpha);
-      const double gamma1 = 3.0*alpha2 - 4.0*alpha + 1.0;
-      const double gamma2 = 6.0*(alpha - alpha2);
-      const double gamma3 = 3.0*alpha2 - 2.0*alpha;
-
-      const Eigen::Vector3d velocity_m_s = T_W_A.getPosition().vector()*(gamma0*one_over_dt_sec)
-                                         + d_W_A.getTranslationalVelocity().vector()*(gamma1)
-                                         + T_W_B.getPosition().vector()*(gamma2*one_over_dt_sec)
-                                         + d_W_B.getTranslationalVelocity().vector()*(gamma3);
-
-
-      /**************************************************************************************
-       *  Rotational part:
-       **************************************************************************************/
-      const double one_minus_alpha = (1.0 - alpha);
-      const double one_minus_alpha_2 = one_minus_alpha * one_minus_alpha;
-      const double one_minus_alpha_3 = one_minus_alpha * one_minus_alpha_2;
-
-      const double beta1 = 1.0 - one_minus_alpha_3;
-      const double dbeta1 = 3.0*one_minus_alpha_2;
-      const double beta2 = 3.0*alpha2 - 2.0*alpha3;
-      const double dbeta2 = 6.0*alpha*one_minus_alpha;
-      const double beta3 = alpha3;
-      const double dbeta3 = 3.0*alpha2;
-
-      const double one_third = 1.0 / 3.0;
-      const Eigen::Vector3d scaled_d_W_A = (one_third*dt_sec ) * d_W_A.getRotationalVelocity().vector();
-      const Eigen::Vector3d scaled_d_W_B = (one_third*dt_sec ) * d_W_B.getRotationalVelocity().vector();
-
-      const Eigen::Vector3d w1 = T_W_A.getRotation().inverseRotate(scaled_d_W_A);
-      const Eigen::Vector3d w3 = T_W_B.getRotation().inverseRotate(scaled_d_W_B);
-      const RotationQuaternion expW1_inv = RotationQuaternion().exponentialMap(-w1);
-      const RotationQuaternion expW3_inv = RotationQuaternion().exponentialMap(-w3);
-
-      const RotationQuaternion expW1_Inv_qWB_expW3 = expW1_inv * T_W_A.getRotation().inverted() * T_W_B.getRotation() * expW3_inv;
-
-      const Eigen::Vector3d w2 = expW1_Inv_qWB_expW3.logarithmicMap();
-
-      const SO3 w1_beta1_exp = RotationQuaternion().exponentialMap((beta1) * w1);
-      const SO3 w2_beta2_exp = RotationQuaternion().exponentialMap((beta2) * w2);
-      const SO3 w3_beta3_exp = RotationQuaternion().exponentialMap((beta3) * w3);
-
-      const RotationQuaternion w1_dbeta1(0.0, dbeta1 * w1);
-      const RotationQuaternion w2_dbeta2(0.0, dbeta2 * w2);
-      const RotationQuaternion w3_dbeta3(0.0, dbeta3 * w3);
-
-      const Eigen::Vector4d diff =    ((T_W_A.getRotation() * w1_beta1_exp * w1_dbeta1    * w2_beta2_exp * w3_beta3_exp).vector()
-                              + (T_W_A.getRotation() * w1_beta1_exp * w2_beta2_exp * w2_dbeta2    * w3_beta3_exp).vector()
-                              + (T_W_A.getRotation() * w1_beta1_exp * w2_beta2_exp * w3_beta3_exp * w3_dbeta3   ).vector())*one_over_dt_sec;
-
-      const RotationQuaternion qDiff(diff);
-      ValueType q;
-      if(!evaluate(q, time)) {
-        return false;
-      }
-      // This is the global angular velocity
-      const Eigen::Vector3d angularVelocity_rad_s = q.getRotation().rotate((q.getRotation().inverted()*qDiff).imaginary());
+CubicHermiteSE3Curve::DerivativeType CubicHermiteSE3Curve::interpolateDerivative(Time time, CoefficientIter a,
+                                                                                 CoefficientIter b) const {
+  const Segment* segment = getCachedSegment(a);
+  if (segment != NULL) {
+    return interpolateDerivative(time, a->first, *segment);
+  }
+  return interpolateDerivative(time, a->first, getSegment(a, b));
+}
+
+CubicHermiteSE3Curve::DerivativeType CubicHermiteSE3Curve::interpolateDerivative(Time time, Time timeA,
+                                                                                 const Segment& segment) const {
+  // make alpha
+  const double dt_sec = segment.dt;
+  const double one_over_dt_sec = 1.0/dt_sec;
+  double alpha = double(time - timeA)/dt_sec;
 
-      // note: unit of derivative is m/s for first 3 and rad/s for last 3 entries
+  const double alpha2 = alpha * alpha;
+  const double alpha3 = alpha2 * alpha;
 
-      derivative = DerivativeType(velocity_m_s, angularVelocity_rad_s);
-      return true;
-    }
+  /**************************************************************************************
+   *  Translational part:
+   **************************************************************************************/
+  // Implementation of translation
+  const double gamma0 = 6.0*(alpha2 - alpha);
+  const double gamma1 = 3.0*alpha2 - 4.0*alpha + 1.0;
+  const double gamma2 = 6.0*(alpha - alpha2);
+  const double gamma3 = 3.0*alpha2 - 2.0*alpha;
+
+  const Eigen::Vector3d velocity_m_s = segment.positionA*(gamma0*one_over_dt_sec)
+                                     + segment.velocityA*(gamma1)
+                                     + segment.positionB*(gamma2*one_over_dt_sec)
+                                     + segment.velocityB*(gamma3);
+
+
+  /**************************************************************************************
+   *  Rotational part:
+   **************************************************************************************/
+  const double one_minus_alpha = (1.0 - alpha);
+  const double one_minus_alpha_2 = one_minus_alpha * one_minus_alpha;
+  const double one_minus_alpha_3 = one_minus_alpha * one_minus_alpha_2;
+
+  const double beta1 = 1.0 - one_minus_alpha_3;
+  const double dbeta1 = 3.0*one_minus_alpha_2;
+  const double beta2 = 3.0*alpha2 - 2.0*alpha3;
+  const double dbeta2 = 6.0*alpha*one_minus_alpha;
+  const double beta3 = alpha3;
+  const double dbeta3 = 3.0*alpha2;
+
+  const SO3 w1_beta1_exp = RotationQuaternion().exponentialMap((beta1) * segment.w1);
+  const SO3 w2_beta2_exp = RotationQuaternion().exponentialMap((beta2) * segment.w2);
+  const SO3 w3_beta3_exp = RotationQuaternion().exponentialMap((beta3) * segment.w3);
+
+  const RotationQuaternion w1_dbeta1(0.0, dbeta1 * segment.w1);
+  const RotationQuaternion w2_dbeta2(0.0, dbeta2 * segment.w2);
+  const RotationQuaternion w3_dbeta3(0.0, dbeta3 * segment.w3);
+
+  const RotationQuaternion& q_W_A = segment.rotationA;
+  const Eigen::Vector4d diff =    ((q_W_A * w1_beta1_exp * w1_dbeta1    * w2_beta2_exp * w3_beta3_exp).vector()
+                          + (q_W_A * w1_beta1_exp * w2_beta2_exp * w2_dbeta2    * w3_beta3_exp).vector()
+                          + (q_W_A * w1_beta1_exp * w2_beta2_exp * w3_beta3_exp * w3_dbeta3   ).vector())*one_over_dt_sec;
+
+  const RotationQuaternion qDiff(diff);
+  // The interpolated rotation, identical to the one computed by interpolate().
+  const RotationQuaternion q = q_W_A * w1_beta1_exp * w2_beta2_exp * w3_beta3_exp;
+  // This is the global angular velocity
+  const Eigen::Vector3d angularVelocity_rad_s = q.rotate((q.inverted()*qDiff).imaginary());
+
+  // note: unit of derivative is m/s for first 3 and rad/s for last 3 entries
+  return DerivativeType(velocity_m_s, angularVelocity_rad_s);
+}
+
+bool CubicHermiteSE3Curve::evaluateState(State& state, Time time, CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("CubicHermiteSE3Curve::evaluateState");
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty);
+    return false;
   }
-  else {
-    std::cerr << "CubicHermiteSE3Curve::evaluateDerivative: higher order derivatives are not implemented!";
+  // Check if the curve is only defined at this one time
+  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
+    getSingleKnotState(&state);
+    return true;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, cursor, &a, &b)) {
+    evaluationErrors_.record(EvaluationError::OutOfRange);
     return false;
   }
+  const Segment* segment = getCachedSegment(a);
+  interpolateState(time, a->first, segment != NULL ? *segment : getSegment(a, b), &state);
+  return true;
+}
+
+bool CubicHermiteSE3Curve::evaluateStates(const std::vector<Time>& times, StateVector* states) const {
+  CHECK_NOTNULL(states);
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE3Curve::evaluateStates", times.size());
+  states->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b;
+  // The segment data is only recomputed when the query moves to another segment.
+  Segment segment;
+  const Segment* currentSegment = NULL;
+  CoefficientIter currentA;
+  for (size_t i = 0; i < times.size(); ++i) {
+    // Check if the curve is only defined at this one time
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      getSingleKnotState(&(*states)[i]);
+      continue;
+    }
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    if (currentSegment == NULL || a != currentA) {
+      currentSegment = getCachedSegment(a);
+      if (currentSegment == NULL) {
+        segment = getSegment(a, b);
+        currentSegment = &segment;
+      }
+      currentA = a;
+    }
+    interpolateState(times[i], a->first, *currentSegment, &(*states)[i]);
+  }
+  return success;
+}
+
+void CubicHermiteSE3Curve::interpolateState(Time time, Time timeA, const Segment& segment,
+                                            State* state) const {
+  const double dt_sec = segment.dt;
+  const double one_over_dt_sec = 1.0/dt_sec;
+  const double one_over_dt_sec_2 = one_over_dt_sec * one_over_dt_sec;
+  const double alpha = double(time - timeA)/dt_sec;
+  const double alpha2 = alpha * alpha;
+  const double alpha3 = alpha2 * alpha;
+  const double one_minus_alpha = 1.0 - alpha;
+
+  /**************************************************************************************
+   *  Translational part, the Hermite basis and its first two time derivatives:
+   **************************************************************************************/
+  const Eigen::Vector3d position = segment.positionA * (2.0*alpha3 - 3.0*alpha2 + 1.0)
+                                 + segment.positionB * (-2.0*alpha3 + 3.0*alpha2)
+                                 + segment.velocityA * ((alpha3 - 2.0*alpha2 + alpha) * dt_sec)
+                                 + segment.velocityB * ((alpha3 - alpha2) * dt_sec);
+  const Eigen::Vector3d velocity = (segment.positionA - segment.positionB) * (6.0*(alpha2 - alpha)*one_over_dt_sec)
+                                 + segment.velocityA * (3.0*alpha2 - 4.0*alpha + 1.0)
+                                 + segment.velocityB * (3.0*alpha2 - 2.0*alpha);
+  const Eigen::Vector3d acceleration = (segment.positionA - segment.positionB) * (6.0*(2.0*alpha - 1.0)*one_over_dt_sec_2)
+                                     + segment.velocityA * ((6.0*alpha - 4.0)*one_over_dt_sec)
+                                     + segment.velocityB * ((6.0*alpha - 2.0)*one_over_dt_sec);
+
+  /**************************************************************************************
+   *  Rotational part:
+   **************************************************************************************/
+  // q(t) = q_W_A * exp(w1*beta1) * exp(w2*beta2) * exp(w3*beta3). Each factor rotates about
+  // its own axis, so the product of the factors up to it maps its axis into frame A.
+  const double beta1 = 1.0 - one_minus_alpha * one_minus_alpha * one_minus_alpha;
+  const double beta2 = 3.0*alpha2 - 2.0*alpha3;
+  const double beta3 = alpha3;
+  const RotationQuaternion q1 = segment.rotationA * RotationQuaternion().exponentialMap(beta1 * segment.w1);
+  const RotationQuaternion q2 = q1 * RotationQuaternion().exponentialMap(beta2 * segment.w2);
+  const RotationQuaternion q = q2 * RotationQuaternion().exponentialMap(beta3 * segment.w3);
+  const Eigen::Vector3d axis1 = q1.rotate(segment.w1);
+  const Eigen::Vector3d axis2 = q2.rotate(segment.w2);
+  const Eigen::Vector3d axis3 = q.rotate(segment.w3);
+
+  const Eigen::Vector3d omega1 = axis1 * (3.0*one_minus_alpha*one_minus_alpha*one_over_dt_sec);
+  const Eigen::Vector3d omega2 = axis2 * (6.0*alpha*one_minus_alpha*one_over_dt_sec);
+  const Eigen::Vector3d omega3 = axis3 * (3.0*alpha2*one_over_dt_sec);
+  const Eigen::Vector3d angularVelocity = omega1 + omega2 + omega3;
+  // The axes of the later factors turn with the angular velocity of the earlier ones.
+  const Eigen::Vector3d angularAcceleration = axis1 * (-6.0*one_minus_alpha*one_over_dt_sec_2)
+                                            + axis2 * ((6.0 - 12.0*alpha)*one_over_dt_sec_2)
+                                            + axis3 * (6.0*alpha*one_over_dt_sec_2)
+                                            + omega1.cross(omega2) + (omega1 + omega2).cross(omega3);
+
+  state->pose = SE3(SE3::Position(position), q);
+  state->twistA << velocity, angularVelocity;
+  state->twistB << q.inverseRotate(velocity), q.inverseRotate(angularVelocity);
+  state->accelerationA << acceleration, angularAcceleration;
+  state->accelerationB << q.inverseRotate(acceleration), q.inverseRotate(angularAcceleration);
+}
+
+void CubicHermiteSE3Curve::getSingleKnotState(State* state) const {
+  const Coefficient& coefficient = manager_.coefficientBegin()->second.coefficient;
+  const RotationQuaternion rotation = coefficient.getRotation();
+  state->pose = coefficient.getTransformation();
+  state->twistA << coefficient.getLinearVelocity(), coefficient.getAngularVelocity();
+  state->twistB << rotation.inverseRotate(Eigen::Vector3d(coefficient.getLinearVelocity())),
+                   rotation.inverseRotate(Eigen::Vector3d(coefficient.getAngularVelocity()));
+  state->accelerationA.setZero();
+  state->accelerationB.setZero();
 }
 
 bool CubicHermiteSE3Curve::evaluateLinearAcceleration(kindr::Acceleration3D& linearAcceleration, Time time) {
@@ -380,7 +815,7 @@ bool CubicHermiteSE3Curve::evaluateLinearAcceleration(kindr::Acceleration3D& lin
   CoefficientIter a, b;
   bool success = manager_.getCoefficientsAt(time, &a, &b);
   if(!success) {
-    std::cerr << "Unable to get the coefficients at time " << time << std::endl;
+    evaluationErrors_.record(manager_.size() == 0 ? EvaluationError::Empty : EvaluationError::OutOfRange);
     return false;
   }
 
@@ -389,8 +824,8 @@ bool CubicHermiteSE3Curve::evaluateLinearAcceleration(kindr::Acceleration3D& lin
   const SE3 T_W_B = b->second.coefficient.getTransformation();
 
   // read out derivative from coefficient
-  const Twist d_W_A = a->second.coefficient.getTransformationDerivative();
-  const Twist d_W_B = b->second.coefficient.getTransformationDerivative();
+  const Twist d_W_A = getSlope(a);
+  const Twist d_W_B = getSlope(b);
 
   // make alpha
   double dt_sec = (b->first - a->first);
@@ -496,7 +931,7 @@ void CubicHermiteSE3Curve::setTimeRange(Time minTime, Time maxTime) {
 
 /// \brief Evaluate the angular velocity of Frame b as seen from Frame a, expressed in Frame a.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularVelocityA(Time time) {
-  CHECK(false) << "Not implemented";
+  return evaluateDerivativeA(1, time).tail<3>();
 }
 /// \brief Evaluate the angular velocity of Frame a as seen from Frame b, expressed in Frame b.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularVelocityB(Time time) {
@@ -504,7 +939,7 @@ Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularVelocityB(Time time) {
 }
 /// \brief Evaluate the velocity of Frame b as seen from Frame a, expressed in Frame a.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearVelocityA(Time time) {
-  CHECK(false) << "Not implemented";
+  return evaluateDerivativeA(1, time).head<3>();
 }
 /// \brief Evaluate the velocity of Frame a as seen from Frame b, expressed in Frame b.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearVelocityB(Time time) {
@@ -514,7 +949,7 @@ Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearVelocityB(Time time) {
 /// expressed in Frame a. The return value has the linear velocity (0,1,2),
 /// and the angular velocity (3,4,5).
 Vector6d CubicHermiteSE3Curve::evaluateTwistA(Time time) {
-  CHECK(false) << "Not implemented";
+  return evaluateDerivativeA(1, time);
 }
 /// \brief evaluate the velocity/angular velocity of Frame a as seen from Frame b,
 /// expressed in Frame b. The return value has the linear velocity (0,1,2),
@@ -524,7 +959,7 @@ Vector6d CubicHermiteSE3Curve::evaluateTwistB(Time time) {
 }
 /// \brief Evaluate the angular derivative of Frame b as seen from Frame a, expressed in Frame a.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularDerivativeA(unsigned derivativeOrder, Time time) {
-  CHECK(false) << "Not implemented";
+  return evaluateDerivativeA(derivativeOrder, time).tail<3>();
 }
 /// \brief Evaluate the angular derivative of Frame a as seen from Frame b, expressed in Frame b.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularDerivativeB(unsigned derivativeOrder, Time time) {
@@ -532,7 +967,7 @@ Eigen::Vector3d CubicHermiteSE3Curve::evaluateAngularDerivativeB(unsigned deriva
 }
 /// \brief Evaluate the derivative of Frame b as seen from Frame a, expressed in Frame a.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearDerivativeA(unsigned derivativeOrder, Time time) {
-  CHECK(false) << "Not implemented";
+  return evaluateDerivativeA(derivativeOrder, time).head<3>();
 }
 /// \brief Evaluate the derivative of Frame a as seen from Frame b, expressed in Frame b.
 Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearDerivativeB(unsigned derivativeOrder, Time time) {
@@ -542,7 +977,11 @@ Eigen::Vector3d CubicHermiteSE3Curve::evaluateLinearDerivativeB(unsigned derivat
 /// expressed in Frame a. The return value has the linear velocity (0,1,2),
 /// and the angular velocity (3,4,5).
 Vector6d CubicHermiteSE3Curve::evaluateDerivativeA(unsigned derivativeOrder, Time time) {
-  CHECK(false) << "Not implemented";
+  // Only the first two derivatives are implemented, see evaluateState.
+  CHECK(derivativeOrder == 1 || derivativeOrder == 2) << "Not implemented";
+  State state;
+  CHECK(evaluateState(state, time)) << "Unable to evaluate the curve at time " << time;
+  return derivativeOrder == 1 ? state.twistA : state.accelerationA;
 }
 /// \brief evaluate the velocity/angular velocity of Frame a as seen from Frame b,
 /// expressed in Frame b. The return value has the linear velocity (0,1,2),
@@ -560,12 +999,108 @@ void CubicHermiteSE3Curve::setSamplingRatio(const int ratio) {
   hermitePolicy_.setMinimumMeasurements(ratio);
 }
 
+void CubicHermiteSE3Curve::setNumberOfFitThreads(unsigned int numThreads) {
+  numFitThreads_ = numThreads;
+}
+
+void CubicHermiteSE3Curve::setWindow(Time maxDuration, size_t maxCoefficients) {
+  manager_.setWindow(maxDuration, maxCoefficients);
+}
+
 void CubicHermiteSE3Curve::clear() {
   manager_.clear();
+  segments_.clear();
+  lazySlopes_.reset();
+  removedTimes_.clear();
+  removedValues_.clear();
 }
 
 void CubicHermiteSE3Curve::transformCurve(const ValueType T) {
-  //todo
+  transformCurve(T, numFitThreads_);
+}
+
+void CubicHermiteSE3Curve::transformCurve(const ValueType& T, unsigned int numThreads) {
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE3Curve::transformCurve", manager_.size());
+  // Lazy slopes would be computed from the transformed knots, but memoized ones are not.
+  materializeLazySlopes();
+  const Eigen::Matrix3d R = T.getRotation().toImplementation().toRotationMatrix();
+  manager_.updateCoefficientValues([&T, &R](Coefficient& coefficient) {
+    const DerivativeType twist = coefficient.getTransformationDerivative();
+    coefficient = Coefficient(T * coefficient.getTransformation(),
+                              DerivativeType(R * twist.getTranslationalVelocity().vector(),
+                                             R * twist.getRotationalVelocity().vector()));
+  }, numThreads);
+  for (ValueType& value : removedValues_) {
+    value = T * value;
+  }
+  updateSegmentCache();
+}
+
+size_t CubicHermiteSE3Curve::simplify(const KnotTolerance& tolerance) {
+  CURVES_INSTRUMENT_SCOPE_UNITS("CubicHermiteSE3Curve::simplify", manager_.size());
+  if (!tolerance.isEnabled()) {
+    return 0;
+  }
+  materializeLazySlopes();
+  const CoefficientIter begin = manager_.coefficientBegin();
+  // Consecutive checks mostly share the segment, so the last one is kept.
+  Segment segment;
+  size_t segmentA = 0;
+  size_t segmentC = 0;
+  std::vector<bool> keep;
+  const size_t numRemoved = selectKnots(manager_.size(), tolerance.maxRemovedKnots,
+                                        [&](size_t a, size_t c, size_t b) {
+    if (a != segmentA || c != segmentC) {
+      segment = getSegment(begin + a, begin + c);
+      segmentA = a;
+      segmentC = c;
+    }
+    const CoefficientIter knot = begin + b;
+    return tolerance.isWithin(knot->second.coefficient.getTransformation(),
+                              interpolate(knot->first, (begin + a)->first, segment));
+  }, &keep);
+  if (numRemoved > 0) {
+    size_t i = 0;
+    manager_.removeCoefficientsIf([&keep, &i](Time, const Coefficient&) {
+      return !keep[i++];
+    });
+    updateSegmentCache();
+  }
+  removedTimes_.clear();
+  removedValues_.clear();
+  return numRemoved;
+}
+
+void CubicHermiteSE3Curve::setSimplificationTolerance(const KnotTolerance& tolerance) {
+  hermitePolicy_.setSimplificationTolerance(tolerance);
+  removedTimes_.clear();
+  removedValues_.clear();
+}
+
+void CubicHermiteSE3Curve::simplifyEnd(const KnotTolerance& tolerance) {
+  // The slope of a knot is final once the next one was added, so the last knot is not checked.
+  if (!tolerance.isEnabled() || manager_.size() < 4) {
+    return;
+  }
+  const CoefficientIter c = manager_.coefficientEnd() - 2;
+  const CoefficientIter b = c - 1;
+  const CoefficientIter a = b - 1;
+  const Segment segment = getSegment(a, c);
+  bool reproducesAll = removedTimes_.size() < tolerance.maxRemovedKnots
+      && tolerance.isWithin(b->second.coefficient.getTransformation(), interpolate(b->first, a->first, segment));
+  for (size_t i = 0; i < removedTimes_.size() && reproducesAll; ++i) {
+    reproducesAll = tolerance.isWithin(removedValues_[i], interpolate(removedTimes_[i], a->first, segment));
+  }
+  if (!reproducesAll) {
+    // b is kept and starts the next segment.
+    removedTimes_.clear();
+    removedValues_.clear();
+    return;
+  }
+  CURVES_INSTRUMENT_COUNT("CubicHermiteSE3Curve::extend::simplify");
+  removedTimes_.push_back(b->first);
+  removedValues_.push_back(b->second.coefficient.getTransformation());
+  manager_.removeCoefficientAtTime(b->first);
 }
 
 void CubicHermiteSE3Curve::saveCurveTimesAndValues(const std::string& filename) const {
@@ -575,13 +1110,37 @@ void CubicHermiteSE3Curve::saveCurveTimesAndValues(const std::string& filename)
   saveCurveAtTimes(filename, curveTimes);
 }
 
+bool CubicHermiteSE3Curve::saveCurveBinary(const std::string& filename) const {
+  if (hasLazySlopes()) {
+    CoefficientManager manager(manager_);
+    writeLazySlopes(&manager);
+    return saveCoefficientsBinary(filename, manager);
+  }
+  return saveCoefficientsBinary(filename, manager_);
+}
+
+bool CubicHermiteSE3Curve::loadCurveBinary(const std::string& filename) {
+  MappedCurveFile file;
+  return file.open(filename) && loadCurve(file);
+}
+
+bool CubicHermiteSE3Curve::loadCurve(const MappedCurveFile& file) {
+  lazySlopes_.reset();
+  if (!loadCoefficients(file, &manager_)) {
+    return false;
+  }
+  updateSegmentCache();
+  return true;
+}
+
 void CubicHermiteSE3Curve::saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const {
   Eigen::VectorXd v(7);
 
   std::vector<Eigen::VectorXd> curveValues;
-  ValueType val;
+  std::vector<ValueType> values;
+  evaluateInParallel(*this, times, &values);
   for (size_t i = 0; i < times.size(); ++i) {
-    evaluate(val, times[i]);
+    const ValueType& val = values[i];
     v << val.getPosition().x(), val.getPosition().y(), val.getPosition().z(),
         val.getRotation().w(), val.getRotation().x(), val.getRotation().y(), val.getRotation().z();
     curveValues.push_back(v);
@@ -0,0 +1,118 @@
+/*
+ * CurveFile.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "curves/CurveFile.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace curves {
+
+bool writeCurveFile(const std::string& filename, CurveFileContent content, size_t valuesPerEntry,
+                    const std::vector<double>& times, const std::vector<double>& values) {
+  CHECK_EQ(times.size() * valuesPerEntry, values.size());
+  FILE* fp = fopen(filename.c_str(), "wb");
+  if (fp == NULL) {
+    return false;
+  }
+  CurveFileHeader header;
+  header.magic = CurveFileHeader::kMagic;
+  header.version = CurveFileHeader::kVersion;
+  header.content = static_cast<uint32_t>(content);
+  header.valuesPerEntry = static_cast<uint32_t>(valuesPerEntry);
+  header.size = times.size();
+  header.reserved = 0;
+  bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+  success = success && fwrite(times.data(), sizeof(double), times.size(), fp) == times.size();
+  success = success && fwrite(values.data(), sizeof(double), values.size(), fp) == values.size();
+  success = (fclose(fp) == 0) && success;
+  return success;
+}
+
+MappedCurveFile::MappedCurveFile() :
+    data_(NULL),
+    length_(0),
+    header_(NULL) {
+}
+
+MappedCurveFile::~MappedCurveFile() {
+  close();
+}
+
+bool MappedCurveFile::open(const std::string& filename) {
+  close();
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(CurveFileHeader)) {
+    ::close(fd);
+    return false;
+  }
+  const size_t length = status.st_size;
+  void* data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  const CurveFileHeader* header = static_cast<const CurveFileHeader*>(data);
+  const uint64_t payload = header->size * (1 + uint64_t(header->valuesPerEntry)) * sizeof(double);
+  if (header->magic != CurveFileHeader::kMagic || header->version != CurveFileHeader::kVersion ||
+      header->size > length || header->valuesPerEntry > length ||
+      length - sizeof(CurveFileHeader) < payload) {
+    munmap(data, length);
+    return false;
+  }
+  data_ = data;
+  length_ = length;
+  header_ = header;
+  return true;
+}
+
+void MappedCurveFile::close() {
+  if (data_ != NULL) {
+    munmap(data_, length_);
+  }
+  data_ = NULL;
+  length_ = 0;
+  header_ = NULL;
+}
+
+bool MappedCurveFile::isOpen() const {
+  return header_ != NULL;
+}
+
+CurveFileContent MappedCurveFile::getContent() const {
+  CHECK(isOpen());
+  return static_cast<CurveFileContent>(header_->content);
+}
+
+size_t MappedCurveFile::size() const {
+  return isOpen() ? header_->size : 0;
+}
+
+size_t MappedCurveFile::getValuesPerEntry() const {
+  CHECK(isOpen());
+  return header_->valuesPerEntry;
+}
+
+const double* MappedCurveFile::getTimes() const {
+  CHECK(isOpen());
+  return reinterpret_cast<const double*>(header_ + 1);
+}
+
+const double* MappedCurveFile::getValues(size_t i) const {
+  CHECK_LT(i, size());
+  return getTimes() + header_->size + i * header_->valuesPerEntry;
+}
+
+} // namespace curves
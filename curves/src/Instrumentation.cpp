@@ -0,0 +1,97 @@
+/*
+ * Instrumentation.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "curves/Instrumentation.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace curves {
+
+const size_t InstrumentationSnapshot::kNumBuckets;
+
+/// Owns the probes. Lookups by name only happen once per instrumented call site.
+class InstrumentationRegistry {
+ public:
+  static InstrumentationRegistry& getInstance() {
+    static InstrumentationRegistry registry;
+    return registry;
+  }
+
+  InstrumentationProbe& getProbe(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<InstrumentationProbe>& probe = probes_[name];
+    if (!probe) {
+      probe.reset(new InstrumentationProbe(name));
+    }
+    return *probe;
+  }
+
+  std::vector<InstrumentationSnapshot> getSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<InstrumentationSnapshot> snapshot;
+    snapshot.reserve(probes_.size());
+    for (ProbeMap::const_iterator it = probes_.begin(); it != probes_.end(); ++it) {
+      snapshot.push_back(it->second->getSnapshot());
+    }
+    return snapshot;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (ProbeMap::iterator it = probes_.begin(); it != probes_.end(); ++it) {
+      it->second->reset();
+    }
+  }
+
+ private:
+  typedef std::map<std::string, std::unique_ptr<InstrumentationProbe> > ProbeMap;
+
+  std::mutex mutex_;
+  ProbeMap probes_;
+};
+
+InstrumentationProbe& InstrumentationProbe::get(const std::string& name) {
+  return InstrumentationRegistry::getInstance().getProbe(name);
+}
+
+InstrumentationProbe::InstrumentationProbe(const std::string& name) :
+    name_(name) {
+  reset();
+}
+
+InstrumentationSnapshot InstrumentationProbe::getSnapshot() const {
+  InstrumentationSnapshot snapshot;
+  snapshot.name = name_;
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  snapshot.max = max_.load(std::memory_order_relaxed);
+  snapshot.units = units_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < InstrumentationSnapshot::kNumBuckets; ++i) {
+    snapshot.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void InstrumentationProbe::reset() {
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  units_.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < InstrumentationSnapshot::kNumBuckets; ++i) {
+    histogram_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+std::vector<InstrumentationSnapshot> getInstrumentationSnapshot() {
+  return InstrumentationRegistry::getInstance().getSnapshot();
+}
+
+void resetInstrumentation() {
+  InstrumentationRegistry::getInstance().reset();
+}
+
+} // namespace curves
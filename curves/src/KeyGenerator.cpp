@@ -7,15 +7,21 @@
  */
 
 #include <curves/KeyGenerator.hpp>
-#include <boost/thread.hpp>
+#include <atomic>
 
 namespace curves {
 
+namespace {
+// The last key handed out. Zero is never used as a key.
+std::atomic<size_t> lastKey(0);
+}
+
 size_t KeyGenerator::getNextKey() {
-  static size_t key = 0;
-  static boost::mutex mutex;
-  boost::lock_guard<boost::mutex> guard(mutex);
-  return ++key;
+  return reserveKeys(1);
+}
+
+size_t KeyGenerator::reserveKeys(size_t n) {
+  return lastKey.fetch_add(n, std::memory_order_relaxed) + 1;
 }
 
 } // namespace
@@ -0,0 +1,66 @@
+/*
+ * NodePoolAllocator.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include "curves/NodePoolAllocator.hpp"
+
+namespace curves {
+
+const size_t NodePool::kMaxObjectSize;
+const size_t NodePool::kAlignment;
+const size_t NodePool::kNumSizeClasses;
+
+NodePool::NodePool(size_t objectsPerChunk) :
+    objectsPerChunk_(objectsPerChunk > 0 ? objectsPerChunk : 1) {
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    freeLists_[i] = NULL;
+  }
+}
+
+NodePool::~NodePool() {
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    ::operator delete(chunks_[i]);
+  }
+}
+
+void* NodePool::allocate(size_t size) {
+  if (size == 0 || size > kMaxObjectSize) {
+    return ::operator new(size);
+  }
+  const size_t sizeClass = getSizeClass(size);
+  if (freeLists_[sizeClass] == NULL) {
+    addChunk(sizeClass);
+  }
+  FreeNode* node = freeLists_[sizeClass];
+  freeLists_[sizeClass] = node->next;
+  return node;
+}
+
+void NodePool::deallocate(void* pointer, size_t size) {
+  if (pointer == NULL) {
+    return;
+  }
+  if (size == 0 || size > kMaxObjectSize) {
+    ::operator delete(pointer);
+    return;
+  }
+  const size_t sizeClass = getSizeClass(size);
+  FreeNode* node = static_cast<FreeNode*>(pointer);
+  node->next = freeLists_[sizeClass];
+  freeLists_[sizeClass] = node;
+}
+
+void NodePool::addChunk(size_t sizeClass) {
+  const size_t objectSize = (sizeClass + 1) * kAlignment;
+  char* chunk = static_cast<char*>(::operator new(objectSize * objectsPerChunk_));
+  chunks_.push_back(chunk);
+  for (size_t i = objectsPerChunk_; i > 0; --i) {
+    FreeNode* node = reinterpret_cast<FreeNode*>(chunk + (i - 1) * objectSize);
+    node->next = freeLists_[sizeClass];
+    freeLists_[sizeClass] = node;
+  }
+}
+
+} // namespace curves
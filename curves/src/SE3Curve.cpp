@@ -8,6 +8,9 @@
  */
 
 #include <curves/SE3Curve.hpp>
+#include <curves/ParallelFor.hpp>
+#include <glog/logging.h>
+#include <limits>
 
 namespace curves {
 
@@ -15,4 +18,70 @@ SE3Curve::SE3Curve(){}
 
 SE3Curve::~SE3Curve(){}
 
+bool SE3Curve::transformPoints(const std::vector<Time>& times, const Eigen::Matrix3Xd& pointsIn,
+                               Eigen::Matrix3Xd* pointsOut) const {
+  CHECK_NOTNULL(pointsOut);
+  CHECK_NE(&pointsIn, pointsOut) << "The points cannot be transformed in place.";
+  CHECK_EQ(times.size(), static_cast<size_t>(pointsIn.cols()));
+  pointsOut->resize(3, pointsIn.cols());
+  if (times.empty()) {
+    return true;
+  }
+  if (isEmpty()) {
+    pointsOut->setConstant(std::numeric_limits<double>::quiet_NaN());
+    return false;
+  }
+
+  // Bucket i holds the points from bucketBegins[i] with the time bucketTimes[i].
+  std::vector<size_t> bucketBegins;
+  std::vector<Time> bucketTimes;
+  for (size_t i = 0; i < times.size(); ++i) {
+    if (i == 0 || times[i] != times[i - 1]) {
+      bucketBegins.push_back(i);
+      bucketTimes.push_back(times[i]);
+    }
+  }
+  bucketBegins.push_back(times.size());
+
+  // Only buckets within the curve are evaluated, so the others are known.
+  const Time minTime = getMinTime();
+  const Time maxTime = getMaxTime();
+  std::vector<Time> validTimes;
+  validTimes.reserve(bucketTimes.size());
+  for (const Time time : bucketTimes) {
+    if (time >= minTime && time <= maxTime) {
+      validTimes.push_back(time);
+    }
+  }
+  std::vector<ValueType> poses;
+  bool success = validTimes.size() == bucketTimes.size();
+  if (!validTimes.empty() && !evaluate(validTimes, &poses)) {
+    pointsOut->setConstant(std::numeric_limits<double>::quiet_NaN());
+    return false;
+  }
+
+  size_t pose = 0;
+  for (size_t i = 0; i + 1 < bucketBegins.size(); ++i) {
+    const size_t begin = bucketBegins[i];
+    const size_t count = bucketBegins[i + 1] - begin;
+    if (!(bucketTimes[i] >= minTime && bucketTimes[i] <= maxTime)) {
+      pointsOut->middleCols(begin, count).setConstant(std::numeric_limits<double>::quiet_NaN());
+      continue;
+    }
+    const Eigen::Matrix3d R = poses[pose].getRotation().toImplementation().toRotationMatrix();
+    const Eigen::Vector3d t = poses[pose].getPosition().vector();
+    ++pose;
+    pointsOut->middleCols(begin, count).noalias() = R * pointsIn.middleCols(begin, count);
+    pointsOut->middleCols(begin, count).colwise() += t;
+  }
+  return success;
+}
+
+void transformCurves(const std::vector<SE3Curve*>& curves, const SE3Curve::ValueType& T,
+                     unsigned int numThreads) {
+  parallelFor(0, curves.size(), [&](size_t i) {
+    curves[i]->transformCurve(T);
+  }, numThreads, 1);
+}
+
 }  // namespace
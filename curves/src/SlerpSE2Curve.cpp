@@ -5,14 +5,9 @@
  */
 
 #include <curves/SlerpSE2Curve.hpp>
-#include <curves/Pose2_Expressions.hpp>
-#include <curves/helpers.hpp>
-
+#include <curves/Instrumentation.hpp>
 #include <iostream>
 
-#include "gtsam/nonlinear/ExpressionFactor.h"
-
-
 namespace curves {
 
 SlerpSE2Curve::SlerpSE2Curve() : SE2Curve() {}
@@ -25,7 +20,6 @@ void SlerpSE2Curve::print(const std::string& str) const {
   std::cout << str << std::endl;
   std::cout << "num of coefficients: " << manager_.size() << std::endl;
   std::cout << "dimension: " <<  3 << std::endl;
-  std::stringstream ss;
   std::vector<Key> keys;
   std::vector<Time> times;
   manager_.getTimes(&times);
@@ -33,21 +27,18 @@ void SlerpSE2Curve::print(const std::string& str) const {
   std::cout << "curve defined between times: " << manager_.getMinTime() <<
       " and " << manager_.getMaxTime() <<std::endl;
   double sum_dp = 0;
-  Eigen::Vector2d p1, p2;
-  for(size_t i = 0; i < times.size()-1; ++i) {
-    p1 = evaluate(times[i]).t().vector();
-    p2 = evaluate(times[i+1]).t().vector();
-    sum_dp += (p1-p2).norm();
+  for(size_t i = 0; i + 1 < times.size(); ++i) {
+    sum_dp += (evaluate(times[i]).getPosition() - evaluate(times[i+1]).getPosition()).norm();
+  }
+  if (times.size() > 1) {
+    std::cout << "average dt between coefficients: " << (manager_.getMaxTime() -manager_.getMinTime())  / (times.size()-1) << " ns." << std::endl;
+    std::cout << "average distance between coefficients: " << sum_dp / double((times.size()-1))<< " m." << std::endl;
   }
-  std::cout << "average dt between coefficients: " << (manager_.getMaxTime() -manager_.getMinTime())  / (times.size()-1) << " ns." << std::endl;
-  std::cout << "average distance between coefficients: " << sum_dp / double((times.size()-1))<< " m." << std::endl;
   std::cout <<"=========================================" <<std::endl;
-  for (size_t i = 0; i < manager_.size(); i++) {
-    ss << "coefficient " << keys[i] << ": ";
-    gtsam::traits<Coefficient>::Print(manager_.getCoefficientByKey(keys[i]),ss.str());
-    std::cout << " | time: " << times[i];
-    std::cout << std::endl;
-    ss.str("");
+  for (size_t i = 0; i < times.size(); i++) {
+    const ValueType value = evaluate(times[i]);
+    std::cout << "coefficient " << keys[i] << ": x " << value.x() << " y " << value.y()
+              << " theta " << value.getAngle() << " | time: " << times[i] << std::endl;
   }
   std::cout <<"=========================================" <<std::endl;
 }
@@ -72,6 +63,7 @@ void SlerpSE2Curve::fitCurve(const std::vector<Time>& times,
                              const std::vector<ValueType>& values,
                              std::vector<Key>* outKeys) {
   CHECK_EQ(times.size(), values.size());
+  CURVES_INSTRUMENT_SCOPE_UNITS("SlerpSE2Curve::fitCurve", times.size());
   if(times.size() > 0) {
     clear();
     manager_.insertCoefficients(times,values, outKeys);
@@ -91,108 +83,142 @@ void SlerpSE2Curve::extend(const std::vector<Time>& times,
                            std::vector<Key>* outKeys) {
 
   CHECK_EQ(times.size(), values.size()) << "number of times and number of coefficients don't match";
+  CURVES_INSTRUMENT_SCOPE_UNITS("SlerpSE2Curve::extend", times.size());
   slerpPolicy_.extend<SlerpSE2Curve, ValueType>(times, values, this, outKeys);
 }
 
-typename SlerpSE2Curve::DerivativeType
-SlerpSE2Curve::evaluateDerivative(Time time,
-                                  unsigned derivativeOrder) const {
-  CHECK(false) << "Not implemented";
-}
-
-/// \brief \f[T^{\alpha}\f]
-SE2 transformationPower(SE2  T, double alpha) {
-  CHECK(false) << "Not implemented";
-}
-
-/// \brief \f[A*B\f]
-SE2 composeTransformations(SE2 A, SE2 B) {
-  return A*B;
+bool SlerpSE2Curve::evaluate(ValueType& value, Time time) const {
+  CURVES_INSTRUMENT_SCOPE("SlerpSE2Curve::evaluate");
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty);
+    return false;
+  }
+  // Check if the curve is only defined at this one time
+  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
+    value = manager_.coefficientBegin()->second.coefficient;
+    return true;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, &a, &b)) {
+    evaluationErrors_.record(EvaluationError::OutOfRange);
+    return false;
+  }
+  value = interpolate(time, a, b, (a->second.coefficient.inverse() * b->second.coefficient).logarithm());
+  return true;
 }
 
-/// \brief \f[T^{-1}\f]
-SE2 inverseTransformation(SE2 T) {
-  return T.inverse();
+SE2 SlerpSE2Curve::evaluate(Time time) const {
+  ValueType value;
+  CHECK(evaluate(value, time)) << "Unable to get the coefficients at time " << time;
+  return value;
 }
 
-/// \brief forms slerp interpolation into a binary expression with 2 leafs and binds alpha into it,
-///        uses break down of expression into its operations
-///        \f[ T = A(A^{-1}B)^{\alpha} \f]
-gtsam::Expression<typename SlerpSE2Curve::ValueType>
-SlerpSE2Curve::getValueExpression(const Time& time) const {
-
-  typedef typename SlerpSE2Curve::ValueType ValueType;
-  using namespace gtsam;
-  CoefficientIter rval0, rval1;
-  bool success = manager_.getCoefficientsAt(time, &rval0, &rval1);
-  CHECK(success) << "Unable to get the coefficients at time " << time;
-  Expression<ValueType> leaf1(rval0->second.key);
-  Expression<ValueType> leaf2(rval1->second.key);
-  double alpha = double(time - rval0->first)/double(rval1->first - rval0->first);
-
-  if (alpha == 0) {
-    return leaf1;
-  } else if (alpha == 1) {
-    return leaf2;
-  } else {
-    std::cout << "Doing slerp" << std::endl;
-    std::cout << "alpha " << alpha << std::endl;
-    Pose2 P0 = evaluate(rval0->first);
-    std::cout << "Pose0 x " << P0.x() << " y " << P0.y() << " theta " << P0.theta() << std::endl;
-    Pose2 P1 = evaluate(rval1->first);
-    std::cout << "Pose1 x " << P1.x() << " y " << P1.y() << " theta " << P1.theta() << std::endl;
-    std::cout << "diff x " << P1.x() - P0.x() << " y " << P1.y() - P0.y() << " theta " << P1.theta() - P0.theta() << std::endl;
-    return slerp(leaf1, leaf2, alpha);
+bool SlerpSE2Curve::evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const {
+  CURVES_INSTRUMENT_SCOPE("SlerpSE2Curve::evaluateDerivative");
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty);
+    return false;
   }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, &a, &b)) {
+    evaluationErrors_.record(EvaluationError::OutOfRange);
+    return false;
+  }
+  derivative = interpolateDerivative(time, a, b, (a->second.coefficient.inverse() * b->second.coefficient).logarithm(),
+                                     derivativeOrder);
+  return true;
 }
 
-gtsam::Expression<typename SlerpSE2Curve::DerivativeType>
-SlerpSE2Curve::getDerivativeExpression(const Time& time, unsigned derivativeOrder) const {
-  // \todo Abel and Renaud
-  CHECK(false) << "Not implemented";
-}
-
-SE2 SlerpSE2Curve::evaluate(Time time) const {
-  // Check if the curve is only defined at this one time
-  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
-    return manager_.coefficientBegin()->second.coefficient;
-  } else {
-    if (time == manager_.getMaxTime()) {
-      // Efficient evaluation of a curve end
-      return (--manager_.coefficientEnd())->second.coefficient;
-    } else {
-      CoefficientIter a, b;
-      bool success = manager_.getCoefficientsAt(time, &a, &b);
-      CHECK(success) << "Unable to get the coefficients at time " << time;
-      SE2 T_W_A = a->second.coefficient;
-      SE2 T_W_B = b->second.coefficient;
-      double alpha = double(time - a->first)/double(b->first - a->first);
-
-      //Implementation of T_W_I = T_W_A*exp(alpha*log(inv(T_W_A)*T_W_B))
-      SE2 T_A_B = T_W_A.inverse() * T_W_B;
-      gtsam::Vector3 log_T_A_B = gtsam::Pose2::Logmap(T_A_B);
-      gtsam::Vector3 log_T_A_I = log_T_A_B*alpha;
-      SE2 T_A_I = gtsam::Pose2::Expmap(log_T_A_I);
-      return T_W_A * T_A_I;
+bool SlerpSE2Curve::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b, logarithmSegment = manager_.coefficientEnd();
+  Vector3d twist;
+  for (size_t i = 0; i < times.size(); ++i) {
+    // Check if the curve is only defined at this one time
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      (*values)[i] = manager_.coefficientBegin()->second.coefficient;
+      continue;
+    }
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    // The logarithm only depends on the segment, reuse it for consecutive times.
+    if (a != logarithmSegment) {
+      twist = (a->second.coefficient.inverse() * b->second.coefficient).logarithm();
+      logarithmSegment = a;
     }
+    (*values)[i] = interpolate(times[i], a, b, twist);
   }
+  return success;
 }
 
-void SlerpSE2Curve::setTimeRange(Time minTime, Time maxTime) {
-  // \todo Abel and Renaud
-  CHECK(false) << "Not implemented";
+bool SlerpSE2Curve::evaluateDerivative(const std::vector<Time>& times,
+                                       std::vector<DerivativeType>* derivatives,
+                                       unsigned derivativeOrder) const {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b, logarithmSegment = manager_.coefficientEnd();
+  Vector3d twist;
+  for (size_t i = 0; i < times.size(); ++i) {
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    if (a != logarithmSegment) {
+      twist = (a->second.coefficient.inverse() * b->second.coefficient).logarithm();
+      logarithmSegment = a;
+    }
+    (*derivatives)[i] = interpolateDerivative(times[i], a, b, twist, derivativeOrder);
+  }
+  return success;
 }
 
-void SlerpSE2Curve::initializeGTSAMValues(gtsam::KeySet keys, gtsam::Values* values) const {
-  manager_.initializeGTSAMValues(keys, values);
-}
+SE2 SlerpSE2Curve::interpolate(Time time, CoefficientIter a, CoefficientIter b, const Vector3d& twist) const {
+  // Efficient and exact evaluation at the coefficients
+  if (time == a->first) {
+    return a->second.coefficient;
+  }
+  if (time == b->first) {
+    return b->second.coefficient;
+  }
+  const double alpha = double(time - a->first)/double(b->first - a->first);
 
-void SlerpSE2Curve::initializeGTSAMValues(gtsam::Values* values) const {
-  manager_.initializeGTSAMValues(values);
+  //Implementation of T_W_I = T_W_A*exp(alpha*log(inv(T_W_A)*T_W_B))
+  return a->second.coefficient * SE2::exponential(alpha * twist);
 }
 
-void SlerpSE2Curve::updateFromGTSAMValues(const gtsam::Values& values) {
-  manager_.updateFromGTSAMValues(values);
+SlerpSE2Curve::DerivativeType SlerpSE2Curve::interpolateDerivative(Time time, CoefficientIter a, CoefficientIter b,
+                                                                   const Vector3d& twist,
+                                                                   unsigned derivativeOrder) const {
+  // order of derivative > 1 returns zeros
+  if (derivativeOrder != 1) {
+    return DerivativeType::Zero();
+  }
+  // The twist expressed in the interpolated frame is constant along the segment and equals
+  // log(inv(T_W_A)*T_W_B)/dt, only its linear part has to be rotated into the world frame.
+  const double inverse_dt_sec = 1.0/double(b->first - a->first);
+  const Eigen::Vector2d velocity = interpolate(time, a, b, twist).getRotationMatrix() * twist.head<2>() * inverse_dt_sec;
+  return DerivativeType(velocity.x(), velocity.y(), twist.z() * inverse_dt_sec);
 }
 
 void SlerpSE2Curve::setMinSamplingPeriod(Time time) {
@@ -208,56 +234,15 @@ void SlerpSE2Curve::clear() {
   manager_.clear();
 }
 
-void SlerpSE2Curve::addPriorFactors(gtsam::NonlinearFactorGraph* graph, Time priorTime) const {
-  Eigen::Matrix<double,3,1> noise;
-  noise(0) = 0.0000001;
-  noise(1) = 0.0000001;
-  noise(2) = 0.0000001;
-
-  gtsam::noiseModel::Diagonal::shared_ptr priorNoise = gtsam::noiseModel::Diagonal::
-        Sigmas(noise);
-
-  CoefficientIter rVal0, rVal1;
-  manager_.getCoefficientsAt(priorTime, &rVal0, &rVal1);
-
-  gtsam::ExpressionFactor<Coefficient> f0(priorNoise,
-                                          rVal0->second.coefficient,
-                                          gtsam::Expression<Coefficient>(rVal0->second.key));
-  gtsam::ExpressionFactor<Coefficient> f1(priorNoise,
-                                          rVal1->second.coefficient,
-                                          gtsam::Expression<Coefficient>(rVal1->second.key));
-  graph->push_back(f0);
-  graph->push_back(f1);
-}
-
 void SlerpSE2Curve::transformCurve(const ValueType T) {
-  std::vector<Time> coefTimes;
-  manager_.getTimes(&coefTimes);
-  for (size_t i = 0; i < coefTimes.size(); ++i) {
-    // Apply a rigid transformation to every coefficient (on the left side).
-    manager_.insertCoefficient(coefTimes[i],T*evaluate(coefTimes[i]));
-  }
+  // Apply a rigid transformation to every coefficient (on the left side), in place.
+  manager_.updateCoefficientValues([&T](Coefficient& coefficient) {
+    coefficient = T * coefficient;
+  });
 }
 
-Time SlerpSE2Curve::getTimeAtKey(gtsam::Key key) const {
-  return manager_.getCoefficientTimeByKey(key);
-}
-
-void SlerpSE2Curve::saveCurveTimesAndValues(const std::string& filename) const {
-  std::vector<Time> curveTimes;
-  manager_.getTimes(&curveTimes);
-
-  Eigen::VectorXd v(3);
-
-  std::vector<Eigen::VectorXd> curveValues;
-  ValueType val;
-  for (size_t i = 0; i < curveTimes.size(); ++i) {
-    val = evaluate(curveTimes[i]);
-    v << val.x(), val.y(), val.theta();
-    curveValues.push_back(v);
-  }
-
-  writeTimeVectorCSV(filename, curveTimes, curveValues);
+void SlerpSE2Curve::getCurveTimes(std::vector<Time>* outTimes) const {
+  manager_.getTimes(outTimes);
 }
 
 } // namespace curves
@@ -7,11 +7,15 @@
  */
 
 #include <curves/SlerpSE3Curve.hpp>
+#include <curves/Instrumentation.hpp>
+#include <curves/ParallelEvaluation.hpp>
 #include <iostream>
 
 namespace curves {
 
-SlerpSE3Curve::SlerpSE3Curve() : SE3Curve() {}
+SlerpSE3Curve::SlerpSE3Curve() :
+    SE3Curve(),
+    interpolationMode_(InterpolationMode::Exact) {}
 
 SlerpSE3Curve::~SlerpSE3Curve() {}
 
@@ -67,6 +71,7 @@ void SlerpSE3Curve::fitCurve(const std::vector<Time>& times,
                              const std::vector<ValueType>& values,
                              std::vector<Key>* outKeys) {
   CHECK_EQ(times.size(), values.size());
+  CURVES_INSTRUMENT_SCOPE_UNITS("SlerpSE3Curve::fitCurve", times.size());
   if(times.size() > 0) {
     clear();
     manager_.insertCoefficients(times,values, outKeys);
@@ -88,50 +93,277 @@ void SlerpSE3Curve::extend(const std::vector<Time>& times,
   if (times.size() != values.size())
   CHECK_EQ(times.size(), values.size()) << "number of times and number of coefficients don't match";
 
+  CURVES_INSTRUMENT_SCOPE_UNITS("SlerpSE3Curve::extend", times.size());
   slerpPolicy_.extend<SlerpSE3Curve, ValueType>(times, values, this, outKeys);
 }
 
+bool SlerpSE3Curve::evaluate(ValueType& value, Time time) const {
+  return evaluate(value, time, NULL);
+}
+
+bool SlerpSE3Curve::evaluate(ValueType& value, Time time, CoefficientCursor* cursor) const {
+  return tryEvaluate(value, time, cursor) == EvaluationError::None;
+}
+
+EvaluationError SlerpSE3Curve::tryEvaluate(ValueType& value, Time time, CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("SlerpSE3Curve::evaluate");
+  if (manager_.size() == 0) {
+    return evaluationErrors_.record(EvaluationError::Empty);
+  }
+  // Check if the curve is only defined at this one time
+  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
+    value = manager_.coefficientBegin()->second.coefficient;
+    return EvaluationError::None;
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, cursor, &a, &b)) {
+    return evaluationErrors_.record(EvaluationError::OutOfRange);
+  }
+  if (interpolationMode_ == InterpolationMode::Approximate) {
+    value = interpolateApproximately(time, a, b);
+    return EvaluationError::None;
+  }
+  Eigen::Vector3d phi, rho;
+  transformationLogarithm(invertAndComposeImplementation(a->second.coefficient, b->second.coefficient), &phi, &rho);
+  value = interpolate(time, a, b, phi, rho);
+  return EvaluationError::None;
+}
+
+SE3 SlerpSE3Curve::evaluate(Time time) const {
+  ValueType value;
+  CHECK(evaluate(value, time)) << "Unable to get the coefficients at time " << time;
+  return value;
+}
+
+bool SlerpSE3Curve::evaluate(const std::vector<Time>& times, std::vector<ValueType>* values) const {
+  CHECK_NOTNULL(values);
+  values->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b, logarithmSegment = manager_.coefficientEnd();
+  Eigen::Vector3d phi, rho;
+  for (size_t i = 0; i < times.size(); ++i) {
+    // Check if the curve is only defined at this one time
+    if (manager_.getMaxTime() == times[i] && manager_.getMinTime() == times[i]) {
+      (*values)[i] = manager_.coefficientBegin()->second.coefficient;
+      continue;
+    }
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    if (interpolationMode_ == InterpolationMode::Approximate) {
+      (*values)[i] = interpolateApproximately(times[i], a, b);
+      continue;
+    }
+    // The logarithm only depends on the segment, reuse it for consecutive times.
+    if (a != logarithmSegment) {
+      transformationLogarithm(invertAndComposeImplementation(a->second.coefficient, b->second.coefficient), &phi, &rho);
+      logarithmSegment = a;
+    }
+    (*values)[i] = interpolate(times[i], a, b, phi, rho);
+  }
+  return success;
+}
+
+bool SlerpSE3Curve::evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder) const {
+  return evaluateDerivative(derivative, time, derivativeOrder, NULL);
+}
+
+bool SlerpSE3Curve::evaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder,
+                                       CoefficientCursor* cursor) const {
+  return tryEvaluateDerivative(derivative, time, derivativeOrder, cursor) == EvaluationError::None;
+}
+
+EvaluationError SlerpSE3Curve::tryEvaluateDerivative(DerivativeType& derivative, Time time, unsigned derivativeOrder,
+                                                     CoefficientCursor* cursor) const {
+  CURVES_INSTRUMENT_SCOPE("SlerpSE3Curve::evaluateDerivative");
+  if (manager_.size() == 0) {
+    return evaluationErrors_.record(EvaluationError::Empty);
+  }
+  CoefficientIter a, b;
+  if (!manager_.getCoefficientsAt(time, cursor, &a, &b)) {
+    return evaluationErrors_.record(EvaluationError::OutOfRange);
+  }
+  Eigen::Vector3d phi, rho;
+  transformationLogarithm(invertAndComposeImplementation(a->second.coefficient, b->second.coefficient), &phi, &rho);
+  derivative = interpolateDerivative(time, a, b, phi, rho, derivativeOrder);
+  return EvaluationError::None;
+}
+
 typename SlerpSE3Curve::DerivativeType
-SlerpSE3Curve::evaluateDerivative(
-    Time time, unsigned derivativeOrder) const
+SlerpSE3Curve::evaluateDerivative(Time time, unsigned derivativeOrder) const
 {
-  CHECK(false) << "Not implemented";
-//  // time is out of bound --> error
-//  CHECK_GE(time, this->getMinTime()) << "Time out of bounds";
-//  CHECK_LE(time, this->getMaxTime()) << "Time out of bounds";
-//
-//  Eigen::VectorXd dCoeff;
-//  Time dt;
-//  CoefficientIter rval0, rval1;
-//  bool success = manager_.getCoefficientsAt(time, &rval0, &rval1);
-//  CHECK(success) << "Unable to get the coefficients at time " << time;
-//  // first derivative
-//  if (derivativeOrder == 1) {
-//    //todo Verify this
-//    dCoeff = gtsam::traits<Coefficient>::Local(rval1->second.coefficient,rval0->second.coefficient);
-//    dt = rval1->first - rval0->first;
-//    return dCoeff/dt;
-//    // order of derivative > 1 returns vector of zeros
-//  } else {
-//    // TODO
-//    const int dimension = gtsam::traits<Coefficient>::dimension;
-//    return Eigen::VectorXd::Zero(dimension,1);
-//  }
+  DerivativeType derivative;
+  CHECK(evaluateDerivative(derivative, time, derivativeOrder)) << "Unable to get the coefficients at time " << time;
+  return derivative;
+}
+
+bool SlerpSE3Curve::evaluateDerivative(const std::vector<Time>& times,
+                                       std::vector<DerivativeType>* derivatives,
+                                       unsigned derivativeOrder) const {
+  CHECK_NOTNULL(derivatives);
+  derivatives->resize(times.size());
+  if (manager_.size() == 0) {
+    evaluationErrors_.record(EvaluationError::Empty, times.size());
+    return times.empty();
+  }
+  bool success = true;
+  bool hasSegment = false;
+  CoefficientIter a, b, logarithmSegment = manager_.coefficientEnd();
+  Eigen::Vector3d phi, rho;
+  for (size_t i = 0; i < times.size(); ++i) {
+    hasSegment = hasSegment ? manager_.advanceCoefficientsTo(times[i], &a, &b)
+                            : manager_.getCoefficientsAt(times[i], &a, &b);
+    if (!hasSegment) {
+      evaluationErrors_.record(EvaluationError::OutOfRange);
+      success = false;
+      continue;
+    }
+    if (a != logarithmSegment) {
+      transformationLogarithm(invertAndComposeImplementation(a->second.coefficient, b->second.coefficient), &phi, &rho);
+      logarithmSegment = a;
+    }
+    (*derivatives)[i] = interpolateDerivative(times[i], a, b, phi, rho, derivativeOrder);
+  }
+  return success;
+}
+
+SE3 SlerpSE3Curve::interpolate(Time time, CoefficientIter a, CoefficientIter b,
+                               const Eigen::Vector3d& phi, const Eigen::Vector3d& rho) const {
+  // Efficient and exact evaluation at the coefficients
+  if (time == a->first) {
+    return a->second.coefficient;
+  }
+  if (time == b->first) {
+    return b->second.coefficient;
+  }
+  const double alpha = double(time - a->first)/double(b->first - a->first);
+
+  //Implementation of T_W_I = T_W_A*exp(alpha*log(inv(T_W_A)*T_W_B))
+  return composeTransformations(a->second.coefficient, transformationExponential(alpha * phi, alpha * rho));
+}
+
+SE3 SlerpSE3Curve::interpolateApproximately(Time time, CoefficientIter a, CoefficientIter b) const {
+  if (time == a->first) {
+    return a->second.coefficient;
+  }
+  if (time == b->first) {
+    return b->second.coefficient;
+  }
+  const double alpha = double(time - a->first)/double(b->first - a->first);
+  const SE3& A = a->second.coefficient;
+  const SE3& B = b->second.coefficient;
+  return SE3(SE3::Position((1.0 - alpha) * A.getPosition().vector() + alpha * B.getPosition().vector()),
+             approximateSlerp(A.getRotation(), B.getRotation(), alpha));
+}
+
+SE3 SlerpSE3Curve::interpolateSegment(Time time, CoefficientIter a, CoefficientIter b) const {
+  if (interpolationMode_ == InterpolationMode::Approximate) {
+    return interpolateApproximately(time, a, b);
+  }
+  Eigen::Vector3d phi, rho;
+  transformationLogarithm(invertAndComposeImplementation(a->second.coefficient, b->second.coefficient), &phi, &rho);
+  return interpolate(time, a, b, phi, rho);
+}
+
+SlerpSE3Curve::DerivativeType SlerpSE3Curve::interpolateDerivative(Time time, CoefficientIter a, CoefficientIter b,
+                                                                   const Eigen::Vector3d& phi,
+                                                                   const Eigen::Vector3d& rho,
+                                                                   unsigned derivativeOrder) const {
+  // order of derivative > 1 returns zeros
+  if (derivativeOrder != 1) {
+    return DerivativeType(Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+  }
+  // The twist expressed in the interpolated frame is constant along the segment and equals
+  // log(inv(T_W_A)*T_W_B)/dt. The global angular velocity R_W_I*phi/dt = R_W_A*phi/dt
+  // is constant as well.
+  const double inverse_dt_sec = 1.0/double(b->first - a->first);
+  const SE3 T_W_I = interpolate(time, a, b, phi, rho);
+  return DerivativeType(T_W_I.getRotation().rotate(rho) * inverse_dt_sec,
+                        a->second.coefficient.getRotation().rotate(phi) * inverse_dt_sec);
+}
+
+namespace {
+
+Eigen::Matrix3d getSkewMatrix(const Eigen::Vector3d& v) {
+  Eigen::Matrix3d skew;
+  skew << 0.0, -v.z(), v.y(),
+          v.z(), 0.0, -v.x(),
+          -v.y(), v.x(), 0.0;
+  return skew;
+}
+
+/// Left Jacobian of SO(3), maps rho to the translation of exp((rho, phi)).
+Eigen::Matrix3d getLeftJacobian(const Eigen::Vector3d& phi) {
+  const double angle = phi.norm();
+  const Eigen::Matrix3d phiSkew = getSkewMatrix(phi);
+  if (angle < 1e-6) {
+    return Eigen::Matrix3d::Identity() + 0.5 * phiSkew + phiSkew * phiSkew / 6.0;
+  }
+  const double angle2 = angle * angle;
+  return Eigen::Matrix3d::Identity() + (1.0 - std::cos(angle)) / angle2 * phiSkew
+      + (angle - std::sin(angle)) / (angle2 * angle) * phiSkew * phiSkew;
+}
+
+/// Inverse of the left Jacobian of SO(3).
+Eigen::Matrix3d getLeftJacobianInverse(const Eigen::Vector3d& phi) {
+  const double angle = phi.norm();
+  const Eigen::Matrix3d phiSkew = getSkewMatrix(phi);
+  if (angle < 1e-6) {
+    return Eigen::Matrix3d::Identity() - 0.5 * phiSkew + phiSkew * phiSkew / 12.0;
+  }
+  return Eigen::Matrix3d::Identity() - 0.5 * phiSkew
+      + (1.0 - angle * std::sin(angle) / (2.0 * (1.0 - std::cos(angle)))) / (angle * angle) * phiSkew * phiSkew;
+}
+
+} // namespace
+
+void transformationLogarithm(const SE3& T, Eigen::Vector3d* phi, Eigen::Vector3d* rho) {
+  CHECK_NOTNULL(phi);
+  CHECK_NOTNULL(rho);
+  // Take the shortest rotation.
+  *phi = T.getRotation().getUnique().logarithmicMap();
+  *rho = getLeftJacobianInverse(*phi) * T.getPosition().vector();
+}
+
+SE3 transformationExponential(const Eigen::Vector3d& phi, const Eigen::Vector3d& rho) {
+  return SE3(SE3::Position(getLeftJacobian(phi) * rho), RotationQuaternion().exponentialMap(phi));
+}
+
+SO3 approximateSlerp(const SO3& a, const SO3& b, double alpha) {
+  const Eigen::Vector4d qa = a.toImplementation().coeffs();
+  Eigen::Vector4d qb = b.toImplementation().coeffs();
+  // Take the shortest rotation.
+  double d = qa.dot(qb);
+  if (d < 0.0) {
+    qb = -qb;
+    d = -d;
+  }
+  // Correct alpha along the arc with a polynomial in alpha and the cosine d of the half
+  // angle, so that the normalized lerp moves with the constant angular speed of the slerp.
+  const double ka = 1.0904 + d * (-3.2452 + d * (3.55645 - d * 1.43519));
+  const double kb = 0.848013 + d * (-1.06021 + d * 0.215638);
+  const double centered = alpha - 0.5;
+  const double t = alpha + alpha * centered * (alpha - 1.0) * (ka * centered * centered + kb);
+  Eigen::Quaterniond q;
+  q.coeffs() = ((1.0 - t) * qa + t * qb).normalized();
+  return SO3(q);
 }
 
 /// \brief \f[T^{\alpha}\f]
 SE3 transformationPower(SE3 T, double alpha)
 {
-  CHECK(false) << "Not implemented";
-//  SO3 R(T.getRotation());
-//  SE3::Position t(T.getPosition());
-//
-//  AngleAxis angleAxis(R);
-//  angleAxis.setUnique();
-//  angleAxis.setAngle(angleAxis.angle() * alpha);
-//  angleAxis.setUnique();
-//
-//  return SE3(SO3(angleAxis),(t*alpha).eval());
+  Eigen::Vector3d phi, rho;
+  transformationLogarithm(T, &phi, &rho);
+  return transformationExponential(alpha * phi, alpha * rho);
 }
 
 /// \brief \f[A*B\f]
@@ -143,8 +375,7 @@ SE3 composeTransformations(SE3 A, SE3 B)
 /// \brief \f[T^{-1}\f]
 SE3 inverseTransformation(SE3 T)
 {
-  CHECK(false) << "Not implemented";
-//  return T.inverted();
+  return T.inverted();
 }
 
 SE3 invertAndComposeImplementation(SE3 A, SE3 B)
@@ -153,36 +384,6 @@ SE3 invertAndComposeImplementation(SE3 A, SE3 B)
   return result;
 }
 
-SE3 SlerpSE3Curve::evaluate(Time time) const
-{
-  CHECK(false) << "Not implemented";
-
-  // Check if the curve is only defined at this one time
-//  if (manager_.getMaxTime() == time && manager_.getMinTime() == time) {
-//    return manager_.coefficientBegin()->second.coefficient;
-//  } else {
-//    if (time == manager_.getMaxTime()) {
-//      // Efficient evaluation of a curve end
-//      return (--manager_.coefficientEnd())->second.coefficient;
-//    } else {
-//      CoefficientIter a, b;
-//      bool success = manager_.getCoefficientsAt(time, &a, &b);
-//      CHECK(success) << "Unable to get the coefficients at time " << time;
-//      SE3 T_W_A = a->second.coefficient;
-//      SE3 T_W_B = b->second.coefficient;
-//      double alpha = double(time - a->first)/double(b->first - a->first);
-//
-//      //Implementation of T_W_I = T_W_A*exp(alpha*log(inv(T_W_A)*T_W_B))
-//      using namespace kindr::minimal;
-//      SE3 T_A_B = invertAndComposeImplementation(T_W_A, T_W_B, boost::none, boost::none);
-//      gtsam::Vector6 log_T_A_B = transformationLogImplementation(T_A_B, boost::none);
-//      gtsam::Vector6 log_T_A_I = vectorScalingImplementation<int(6)>(log_T_A_B, alpha, boost::none, boost::none);
-//      SE3 T_A_I = transformationExpImplementation(log_T_A_I, boost::none);
-//      return composeImplementation(T_W_A, T_A_I, boost::none, boost::none);
-//    }
-//  }
-}
-
 void SlerpSE3Curve::setTimeRange(Time minTime, Time maxTime) {
   // \todo Abel and Renaud
   CHECK(false) << "Not implemented";
@@ -245,6 +446,20 @@ Vector6d SlerpSE3Curve::evaluateDerivativeB(unsigned derivativeOrder, Time time)
   CHECK(false) << "Not implemented";
 }
 
+void SlerpSE3Curve::setInterpolationMode(InterpolationMode mode) {
+  interpolationMode_ = mode;
+}
+
+SlerpSE3Curve::InterpolationMode SlerpSE3Curve::getInterpolationMode() const {
+  return interpolationMode_;
+}
+
+double SlerpSE3Curve::getMaxAngularError(InterpolationMode mode) {
+  // Largest error of approximateSlerp, found on a dense grid of angles and alphas. It is
+  // reached for half a turn, segments of 90 degrees stay below 1e-4.
+  return mode == InterpolationMode::Approximate ? 8e-4 : 0.0;
+}
+
 void SlerpSE3Curve::setMinSamplingPeriod(Time time) {
   slerpPolicy_.setMinSamplingPeriod(time);
 }
@@ -254,17 +469,77 @@ void SlerpSE3Curve::setSamplingRatio(const int ratio) {
   slerpPolicy_.setMinimumMeasurements(ratio);
 }
 
+void SlerpSE3Curve::setWindow(Time maxDuration, size_t maxCoefficients) {
+  manager_.setWindow(maxDuration, maxCoefficients);
+}
+
 void SlerpSE3Curve::clear() {
   manager_.clear();
+  removedTimes_.clear();
+  removedValues_.clear();
 }
 
 void SlerpSE3Curve::transformCurve(const ValueType T) {
-  std::vector<Time> coefTimes;
-  manager_.getTimes(&coefTimes);
-  for (size_t i = 0; i < coefTimes.size(); ++i) {
-    // Apply a rigid transformation to every coefficient (on the left side).
-    manager_.insertCoefficient(coefTimes[i],T*evaluate(coefTimes[i]));
+  // Apply a rigid transformation to every coefficient (on the left side), in place.
+  manager_.updateCoefficientValues([&T](Coefficient& coefficient) {
+    coefficient = T * coefficient;
+  });
+  for (ValueType& value : removedValues_) {
+    value = T * value;
+  }
+}
+
+size_t SlerpSE3Curve::simplify(const KnotTolerance& tolerance) {
+  CURVES_INSTRUMENT_SCOPE_UNITS("SlerpSE3Curve::simplify", manager_.size());
+  if (!tolerance.isEnabled()) {
+    return 0;
+  }
+  const CoefficientIter begin = manager_.coefficientBegin();
+  std::vector<bool> keep;
+  const size_t numRemoved = selectKnots(manager_.size(), tolerance.maxRemovedKnots,
+                                        [this, &begin, &tolerance](size_t a, size_t c, size_t b) {
+    const CoefficientIter knot = begin + b;
+    return tolerance.isWithin(knot->second.coefficient, interpolateSegment(knot->first, begin + a, begin + c));
+  }, &keep);
+  if (numRemoved > 0) {
+    size_t i = 0;
+    manager_.removeCoefficientsIf([&keep, &i](Time, const Coefficient&) {
+      return !keep[i++];
+    });
+  }
+  removedTimes_.clear();
+  removedValues_.clear();
+  return numRemoved;
+}
+
+void SlerpSE3Curve::setSimplificationTolerance(const KnotTolerance& tolerance) {
+  slerpPolicy_.setSimplificationTolerance(tolerance);
+  removedTimes_.clear();
+  removedValues_.clear();
+}
+
+void SlerpSE3Curve::simplifyEnd(const KnotTolerance& tolerance) {
+  if (!tolerance.isEnabled() || manager_.size() < 3) {
+    return;
   }
+  const CoefficientIter c = --manager_.coefficientEnd();
+  const CoefficientIter b = c - 1;
+  const CoefficientIter a = b - 1;
+  bool reproducesAll = removedTimes_.size() < tolerance.maxRemovedKnots
+      && tolerance.isWithin(b->second.coefficient, interpolateSegment(b->first, a, c));
+  for (size_t i = 0; i < removedTimes_.size() && reproducesAll; ++i) {
+    reproducesAll = tolerance.isWithin(removedValues_[i], interpolateSegment(removedTimes_[i], a, c));
+  }
+  if (!reproducesAll) {
+    // b is kept and starts the next segment.
+    removedTimes_.clear();
+    removedValues_.clear();
+    return;
+  }
+  CURVES_INSTRUMENT_COUNT("SlerpSE3Curve::extend::simplify");
+  removedTimes_.push_back(b->first);
+  removedValues_.push_back(b->second.coefficient);
+  manager_.removeCoefficientAtTime(b->first);
 }
 
 void SlerpSE3Curve::saveCurveTimesAndValues(const std::string& filename) const {
@@ -274,13 +549,27 @@ void SlerpSE3Curve::saveCurveTimesAndValues(const std::string& filename) const {
   saveCurveAtTimes(filename, curveTimes);
 }
 
+bool SlerpSE3Curve::saveCurveBinary(const std::string& filename) const {
+  return saveCoefficientsBinary(filename, manager_);
+}
+
+bool SlerpSE3Curve::loadCurveBinary(const std::string& filename) {
+  MappedCurveFile file;
+  return file.open(filename) && loadCurve(file);
+}
+
+bool SlerpSE3Curve::loadCurve(const MappedCurveFile& file) {
+  return loadCoefficients(file, &manager_);
+}
+
 void SlerpSE3Curve::saveCurveAtTimes(const std::string& filename, std::vector<Time> times) const {
   Eigen::VectorXd v(7);
 
   std::vector<Eigen::VectorXd> curveValues;
-  ValueType val;
+  std::vector<ValueType> values;
+  CHECK(evaluateInParallel(*this, times, &values)) << "Unable to evaluate the curve at the given times";
   for (size_t i = 0; i < times.size(); ++i) {
-    val = evaluate(times[i]);
+    const ValueType& val = values[i];
     v << val.getPosition().x(), val.getPosition().y(), val.getPosition().z(),
         val.getRotation().w(), val.getRotation().x(), val.getRotation().y(), val.getRotation().z();
     curveValues.push_back(v);
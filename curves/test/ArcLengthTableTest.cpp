@@ -0,0 +1,128 @@
+/*
+ * ArcLengthTableTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/ArcLengthTable.hpp"
+#include "curves/CubicHermiteE3Curve.hpp"
+#include "curves/CubicHermiteSE3Curve.hpp"
+#include "curves/PolynomialSplineVectorSpaceCurve.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+namespace {
+
+/// Length of the curve by summing up many chords.
+template <class CurveType>
+double getChordLength(const CurveType& curve, Time start, Time end)
+{
+  const int n = 20000;
+  typename CurveType::ValueType previous, value;
+  EXPECT_TRUE(curve.evaluate(previous, start));
+  double length = 0.0;
+  for (int i = 1; i <= n; ++i) {
+    EXPECT_TRUE(curve.evaluate(value, start + (end - start) * i / n));
+    length += (value - previous).norm();
+    previous = value;
+  }
+  return length;
+}
+
+} // namespace
+
+TEST(ArcLengthTableTest, StraightLine)
+{
+  // A straight line with changing speed, rest to rest.
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values, velocities, accelerations;
+  const Eigen::Vector3d direction(1.0, 2.0, 2.0);
+  for (int i = 0; i < 5; ++i) {
+    times.push_back(i);
+    values.push_back(direction * i * i);
+    velocities.push_back(2.0 * direction * i);
+    accelerations.push_back(2.0 * direction);
+  }
+  PolynomialSplineQuinticVector3Curve curve;
+  curve.fitCurve(times, values, velocities, accelerations);
+
+  ArcLengthTable<PolynomialSplineQuinticVector3Curve> table;
+  ASSERT_TRUE(table.build(curve));
+  EXPECT_NEAR(3.0 * 16.0, table.getTotalLength(), 1e-9);
+  EXPECT_EQ(0.0, table.getTimeAtArcLength(-1.0));
+  EXPECT_EQ(4.0, table.getTimeAtArcLength(100.0));
+
+  std::vector<Eigen::Vector3d> samples;
+  ASSERT_TRUE(table.sampleAtEqualArcLengths(17, &samples));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_NEAR(3.0 * i, samples[i].norm(), 2e-3);
+  }
+}
+
+TEST(ArcLengthTableTest, CubicHermiteE3Curve)
+{
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values;
+  for (int i = 0; i < 12; ++i) {
+    times.push_back(0.5 * i + 0.03 * i * i);
+    values.push_back(Eigen::Vector3d(std::cos(times.back()), std::sin(2.0 * times.back()), 0.3 * times.back()));
+  }
+  CubicHermiteE3Curve curve;
+  curve.fitCurve(times, values);
+
+  // The inverse is only a cubic in every interval, which needs a few more intervals on these
+  // long and strongly curved segments to be accurate to 1e-3.
+  ArcLengthTable<CubicHermiteE3Curve> table;
+  ASSERT_TRUE(table.build(curve, 16));
+  EXPECT_NEAR(getChordLength(curve, times.front(), times.back()), table.getTotalLength(), 1e-6);
+
+  double previousLength = 0.0;
+  for (Time time = times.front(); time <= times.back(); time += 0.0719) {
+    const double length = table.getArcLengthAtTime(time);
+    EXPECT_LE(previousLength, length);
+    EXPECT_NEAR(getChordLength(curve, times.front(), time), length, 1e-6);
+    EXPECT_NEAR(time, table.getTimeAtArcLength(length), 1e-3);
+    previousLength = length;
+  }
+
+  // The inverse is monotone, also through the slow parts.
+  Time previousTime = times.front();
+  for (double length = 0.0; length <= table.getTotalLength(); length += 0.01) {
+    const Time time = table.getTimeAtArcLength(length);
+    EXPECT_LE(previousTime, time);
+    previousTime = time;
+  }
+}
+
+TEST(ArcLengthTableTest, CubicHermiteSE3Curve)
+{
+  typedef CubicHermiteSE3Curve::ValueType ValueType;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 8; ++i) {
+    times.push_back(0.4 * i);
+    values.push_back(ValueType(ValueType::Position(std::cos(times.back()), std::sin(times.back()), 0.0),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(times.back(), 0.0, 0.0))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+
+  ArcLengthTable<CubicHermiteSE3Curve> table;
+  ASSERT_TRUE(table.build(curve, 8));
+  double chordLength = 0.0;
+  ValueType previous, value;
+  ASSERT_TRUE(curve.evaluate(previous, times.front()));
+  for (int i = 1; i <= 10000; ++i) {
+    ASSERT_TRUE(curve.evaluate(value, times.front() + (times.back() - times.front()) * i / 10000));
+    chordLength += (value.getPosition() - previous.getPosition()).norm();
+    previous = value;
+  }
+  EXPECT_NEAR(chordLength, table.getTotalLength(), 1e-6);
+
+  ASSERT_TRUE(table.evaluateAtArcLength(value, 0.5 * table.getTotalLength()));
+  EXPECT_NEAR(0.5 * table.getTotalLength(), table.getArcLengthAtTime(table.getTimeAtArcLength(0.5 * table.getTotalLength())), 1e-4);
+}
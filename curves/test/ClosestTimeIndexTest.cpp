@@ -0,0 +1,136 @@
+/*
+ * ClosestTimeIndexTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/ClosestTimeIndex.hpp"
+#include "curves/CubicHermiteE3Curve.hpp"
+#include "curves/CubicHermiteSE3Curve.hpp"
+#include "curves/PolynomialSplineVectorSpaceCurve.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace curves;
+
+namespace {
+
+/// Closest time by densely sampling the curve.
+template <class CurveType>
+Time getSampledClosestTime(const CurveType& curve, const Eigen::Vector3d& position, Time start, Time end,
+                           double* distance)
+{
+  const int n = 20000;
+  typename CurveType::ValueType value;
+  Time closestTime = start;
+  *distance = std::numeric_limits<double>::infinity();
+  for (int i = 0; i <= n; ++i) {
+    const Time time = start + (end - start) * i / n;
+    EXPECT_TRUE(curve.evaluate(value, time));
+    const double sampleDistance = (getPositionVector(value) - position).norm();
+    if (sampleDistance < *distance) {
+      *distance = sampleDistance;
+      closestTime = time;
+    }
+  }
+  return closestTime;
+}
+
+} // namespace
+
+TEST(ClosestTimeIndexTest, CubicHermiteE3Curve)
+{
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values;
+  for (int i = 0; i < 20; ++i) {
+    times.push_back(0.5 * i);
+    values.push_back(Eigen::Vector3d(std::cos(times.back()), std::sin(times.back()), 0.1 * times.back()));
+  }
+  CubicHermiteE3Curve curve;
+  curve.fitCurve(times, values);
+
+  ClosestTimeIndex<CubicHermiteE3Curve> index;
+  ASSERT_TRUE(index.build(curve));
+
+  Time previousTime = times.front();
+  for (int i = 0; i < 40; ++i) {
+    const double angle = 0.23 * i;
+    const Eigen::Vector3d position(1.2 * std::cos(angle), 1.2 * std::sin(angle), 0.1 * angle + 0.05);
+    double sampledDistance;
+    const Time sampledTime = getSampledClosestTime(curve, position, times.front(), times.back(), &sampledDistance);
+
+    Time time;
+    double distance;
+    ASSERT_TRUE(index.findClosestTime(position, &time, &distance));
+    EXPECT_NEAR(sampledTime, time, 1e-3);
+    EXPECT_NEAR(sampledDistance, distance, 1e-6);
+    EXPECT_LE(distance, sampledDistance + 1e-12);
+
+    Time warmTime;
+    ASSERT_TRUE(index.findClosestTime(position, previousTime, &warmTime, &distance));
+    EXPECT_NEAR(time, warmTime, 1e-6);
+    previousTime = warmTime;
+  }
+
+  // Points beyond the ends are closest to the ends.
+  Time time;
+  ASSERT_TRUE(index.findClosestTime(Eigen::Vector3d(1.0, -1.0, -5.0), &time));
+  EXPECT_EQ(times.front(), time);
+  ASSERT_TRUE(index.findClosestTime(values.back() + Eigen::Vector3d(0.0, 0.0, 5.0), &time));
+  EXPECT_EQ(times.back(), time);
+}
+
+TEST(ClosestTimeIndexTest, CubicHermiteSE3Curve)
+{
+  typedef CubicHermiteSE3Curve::ValueType ValueType;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 12; ++i) {
+    times.push_back(0.4 * i);
+    values.push_back(ValueType(ValueType::Position(times.back(), std::sin(times.back()), 0.0),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(times.back(), 0.0, 0.0))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+
+  ClosestTimeIndex<CubicHermiteSE3Curve> index;
+  ASSERT_TRUE(index.build(curve));
+  for (int i = 0; i < 20; ++i) {
+    const Eigen::Vector3d position(0.23 * i, 0.3 - 0.03 * i, 0.2);
+    double sampledDistance;
+    const Time sampledTime = getSampledClosestTime(curve, position, times.front(), times.back(), &sampledDistance);
+    Time time;
+    double distance;
+    ASSERT_TRUE(index.findClosestTime(position, &time, &distance));
+    EXPECT_NEAR(sampledTime, time, 1e-3);
+    EXPECT_NEAR(sampledDistance, distance, 1e-6);
+  }
+}
+
+TEST(ClosestTimeIndexTest, PolynomialSplineQuinticVector3Curve)
+{
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values;
+  for (int i = 0; i < 10; ++i) {
+    times.push_back(i);
+    values.push_back(Eigen::Vector3d(i, std::cos(i), 0.5 * std::sin(2.0 * i)));
+  }
+  PolynomialSplineQuinticVector3Curve curve;
+  curve.fitCurve(times, values);
+
+  ClosestTimeIndex<PolynomialSplineQuinticVector3Curve> index;
+  ASSERT_TRUE(index.build(curve));
+  for (int i = 0; i < 20; ++i) {
+    const Eigen::Vector3d position(0.45 * i, 0.5, 0.0);
+    double sampledDistance;
+    const Time sampledTime = getSampledClosestTime(curve, position, times.front(), times.back(), &sampledDistance);
+    Time time;
+    double distance;
+    ASSERT_TRUE(index.findClosestTime(position, &time, &distance));
+    EXPECT_NEAR(sampledDistance, distance, 1e-6);
+    EXPECT_NEAR(sampledTime, time, 1e-3);
+  }
+}
@@ -0,0 +1,132 @@
+/*
+ * ConcurrentCurveTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/ConcurrentCurve.hpp"
+#include "curves/CubicHermiteSE3Curve.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+using namespace curves;
+
+namespace {
+
+CubicHermiteSE3Curve::ValueType getPose(Time time) {
+  return CubicHermiteSE3Curve::ValueType(
+      CubicHermiteSE3Curve::ValueType::Position(std::sin(time), std::cos(time), time),
+      CubicHermiteSE3Curve::ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time)));
+}
+
+} // namespace
+
+TEST(ConcurrentCurve, Snapshot)
+{
+  ConcurrentCurve<CubicHermiteSE3Curve> curve;
+  std::vector<Time> times;
+  std::vector<CubicHermiteSE3Curve::ValueType> values;
+  for (int i = 0; i < 10; ++i) {
+    times.push_back(0.1 * i);
+    values.push_back(getPose(times.back()));
+  }
+  curve.fitCurve(times, values);
+  const ConcurrentCurve<CubicHermiteSE3Curve>::Snapshot snapshot = curve.getSnapshot();
+
+  // A snapshot is not affected by later modifications.
+  curve.extend(std::vector<Time>(1, 1.0), std::vector<CubicHermiteSE3Curve::ValueType>(1, getPose(1.0)));
+  EXPECT_EQ(0.9, snapshot->getMaxTime());
+  EXPECT_EQ(1.0, curve.getMaxTime());
+  CubicHermiteSE3Curve::ValueType value, expected;
+  ASSERT_TRUE(snapshot->evaluate(expected, 0.45));
+  ASSERT_TRUE(curve.evaluate(value, 0.45));
+  EXPECT_EQ(expected.getPosition(), value.getPosition());
+}
+
+TEST(ConcurrentCurve, ReadersAndWriter)
+{
+  ConcurrentCurve<CubicHermiteSE3Curve> curve;
+  curve.update([](CubicHermiteSE3Curve& c) { c.setWindow(1.0); });
+  curve.extend(std::vector<Time>(1, 0.0), std::vector<CubicHermiteSE3Curve::ValueType>(1, getPose(0.0)));
+
+  std::atomic<bool> done(false);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.push_back(std::thread([&]() {
+      while (!done) {
+        const ConcurrentCurve<CubicHermiteSE3Curve>::Snapshot snapshot = curve.getSnapshot();
+        CubicHermiteSE3Curve::ValueType value;
+        if (!snapshot->evaluate(value, snapshot->getMaxTime()) ||
+            std::abs(value.getPosition().z() - snapshot->getMaxTime()) > 1e-10) {
+          ++failures;
+        }
+      }
+    }));
+  }
+  for (int i = 1; i <= 500; ++i) {
+    const Time time = 0.01 * i;
+    curve.extend(std::vector<Time>(1, time), std::vector<CubicHermiteSE3Curve::ValueType>(1, getPose(time)));
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures);
+  EXPECT_NEAR(5.0, curve.getMaxTime(), 1e-12);
+  EXPECT_LE(curve.getSnapshot()->size(), 102u);
+}
+
+TEST(ConcurrentCurve, CursorWithWriter)
+{
+  ConcurrentCurve<CubicHermiteSE3Curve> curve;
+  curve.update([](CubicHermiteSE3Curve& c) { c.setWindow(1.0); });
+  // Start with two knots, a curve with a single knot can not be evaluated.
+  curve.extend({0.0, 0.01}, {getPose(0.0), getPose(0.01)});
+
+  // The readers follow the end of the curve with their cursors while it is extended.
+  std::atomic<bool> done(false);
+  std::atomic<int> failures(0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.push_back(std::thread([&]() {
+      ConcurrentCurve<CubicHermiteSE3Curve>::Cursor cursor(curve);
+      while (!done) {
+        const Time time = curve.getMaxTime();
+        CubicHermiteSE3Curve::ValueType value;
+        if (!cursor.evaluate(value, time)) {
+          // The window may have moved past the time before the cursor took its snapshot.
+          if (time >= cursor.getSnapshot()->getMinTime()) {
+            ++failures;
+          }
+        } else if (std::abs(value.getPosition().z() - time) > 1e-10) {
+          ++failures;
+        }
+      }
+    }));
+  }
+  for (int i = 2; i <= 500; ++i) {
+    const Time time = 0.01 * i;
+    curve.extend(std::vector<Time>(1, time), std::vector<CubicHermiteSE3Curve::ValueType>(1, getPose(time)));
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures);
+
+  // The cursor evaluates the curve like the snapshot it holds.
+  ConcurrentCurve<CubicHermiteSE3Curve>::Cursor cursor(curve);
+  EXPECT_FALSE(cursor.getSnapshot());
+  for (Time time = curve.getMinTime(); time <= curve.getMaxTime(); time += 0.0037) {
+    CubicHermiteSE3Curve::ValueType value, expected;
+    ASSERT_TRUE(cursor.evaluate(value, time));
+    ASSERT_TRUE(cursor.getSnapshot()->evaluate(expected, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+  }
+  EXPECT_EQ(curve.getSnapshot(), cursor.getSnapshot());
+}
@@ -0,0 +1,128 @@
+/*
+ * CubicHermiteE3CurveTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/CubicHermiteE3Curve.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace curves;
+
+typedef CubicHermiteE3Curve::ValueType ValueType;
+typedef CubicHermiteE3Curve::DerivativeType DerivativeType;
+
+TEST(CubicHermiteE3CurveTest, BatchEvaluation)
+{
+  CubicHermiteE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 7; ++i) {
+    times.push_back(0.5 * i + 0.1 * i * i);
+    values.push_back(ValueType(std::sin(times.back()), std::cos(times.back()), 0.3 * i));
+  }
+  curve.fitCurve(times, values);
+
+  // Sorted times, times on the knots and a time evaluated out of order.
+  std::vector<Time> evaluationTimes;
+  for (Time time = times.front(); time < times.back(); time += 0.037) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.push_back(times[3]);
+  evaluationTimes.push_back(times.back());
+  evaluationTimes.push_back(0.2);
+
+  std::vector<ValueType> batchValues;
+  std::vector<DerivativeType> batchVelocities, batchAccelerations;
+  ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchVelocities, 1));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchAccelerations, 2));
+  ASSERT_EQ(evaluationTimes.size(), batchValues.size());
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType value;
+    DerivativeType velocity, acceleration;
+    ASSERT_TRUE(curve.evaluate(value, evaluationTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(velocity, evaluationTimes[i], 1));
+    ASSERT_TRUE(curve.evaluateDerivative(acceleration, evaluationTimes[i], 2));
+    EXPECT_NEAR(0.0, (value - batchValues[i]).norm(), 1e-12) << "time " << evaluationTimes[i];
+    EXPECT_NEAR(0.0, (velocity - batchVelocities[i]).norm(), 1e-10) << "time " << evaluationTimes[i];
+    EXPECT_NEAR(0.0, (acceleration - batchAccelerations[i]).norm(), 1e-9) << "time " << evaluationTimes[i];
+  }
+
+  // Times out of range fail and are set to zero, the others are still evaluated.
+  std::vector<Time> outOfRangeTimes(1, times.front() - 1.0);
+  outOfRangeTimes.push_back(1.0);
+  EXPECT_FALSE(curve.evaluate(outOfRangeTimes, &batchValues));
+  EXPECT_EQ(ValueType::Zero(), batchValues[0]);
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 1.0));
+  EXPECT_NEAR(0.0, (value - batchValues[1]).norm(), 1e-12);
+  EXPECT_FALSE(curve.evaluateDerivative(outOfRangeTimes, &batchVelocities, 3));
+}
+
+TEST(CubicHermiteE3CurveTest, EvaluateWithJacobians)
+{
+  CubicHermiteE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 5; ++i) {
+    times.push_back(0.4 * i + 0.1 * i * i);
+    values.push_back(ValueType(std::sin(times.back()), std::cos(times.back()), 0.3 * i));
+  }
+  std::vector<Key> keys;
+  curve.fitCurve(times, values, &keys);
+  ASSERT_EQ(times.size(), keys.size());
+
+  std::vector<Time> evaluationTimes;
+  for (Time time = times[1]; time <= times.back(); time += 0.043) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.push_back(times.back());
+
+  // The values are linear in the knots, so the Jacobian maps the knots to the values.
+  for (unsigned int derivativeOrder = 0; derivativeOrder <= 2; ++derivativeOrder) {
+    CubicHermiteE3Curve::KnotJacobians jacobians;
+    ASSERT_TRUE(curve.evaluateWithJacobians(evaluationTimes, &jacobians, derivativeOrder));
+    ASSERT_EQ(evaluationTimes.size(), jacobians.size());
+    // The first segment is not evaluated, so its first knot has no block column.
+    ASSERT_EQ(keys.size() - 1, jacobians.getKeys().size());
+    EXPECT_EQ(keys[1], jacobians.getKeys().front());
+    EXPECT_EQ(keys.back(), jacobians.getKeys().back());
+
+    std::vector<DerivativeType> batchValues;
+    if (derivativeOrder == 0) {
+      ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+    } else {
+      ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchValues, derivativeOrder));
+    }
+
+    Eigen::VectorXd knots(6 * jacobians.getKeys().size());
+    for (size_t j = 0; j < jacobians.getKeys().size(); ++j) {
+      const size_t k = std::find(keys.begin(), keys.end(), jacobians.getKeys()[j]) - keys.begin();
+      ASSERT_LT(k, keys.size());
+      DerivativeType velocity;
+      ASSERT_TRUE(curve.evaluateDerivative(velocity, times[k], 1));
+      knots.segment<3>(6 * j) = values[k];
+      knots.segment<3>(6 * j + 3) = velocity;
+    }
+    Eigen::SparseMatrix<double> jacobian;
+    jacobians.getSparseJacobian(&jacobian);
+    ASSERT_EQ(3 * static_cast<int>(evaluationTimes.size()), jacobian.rows());
+    const Eigen::VectorXd linearValues = jacobian * knots;
+    for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+      EXPECT_NEAR(0.0, (jacobians.getValue(i) - batchValues[i]).norm(), 1e-10) << "time " << evaluationTimes[i];
+      EXPECT_NEAR(0.0, (linearValues.segment<3>(3 * i) - batchValues[i]).norm(), 1e-9) << "time " << evaluationTimes[i];
+    }
+  }
+
+  // Out of range times fail with zero values and Jacobians.
+  CubicHermiteE3Curve::KnotJacobians jacobians;
+  EXPECT_FALSE(curve.evaluateWithJacobians(std::vector<Time>(1, times.back() + 1.0), &jacobians));
+  EXPECT_EQ(ValueType::Zero(), jacobians.getValue(0));
+  EXPECT_TRUE(jacobians.getJacobian(0, 0).isZero());
+  EXPECT_EQ(keys.back(), jacobians.getKey(0, 1));
+}
@@ -0,0 +1,209 @@
+/*
+ * CubicHermiteSE2CurveTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/CubicHermiteSE2Curve.hpp"
+#include <set>
+
+using namespace curves;
+
+typedef curves::CubicHermiteSE2Curve::ValueType ValueType;
+typedef curves::CubicHermiteSE2Curve::DerivativeType DerivativeType;
+
+namespace {
+
+void getTestValues(std::vector<Time>& times, std::vector<ValueType>& values)
+{
+  times = {0.0, 1.0, 2.5, 3.0};
+  values = {ValueType(1.0, 2.0, 0.3), ValueType(2.0, 4.0, 1.5), ValueType(0.0, 1.0, -2.9),
+            ValueType(-1.0, 0.5, 2.8)};
+}
+
+double getAngleError(double expected, double angle)
+{
+  return std::abs(SE2Transformation::wrapAngle(expected - angle));
+}
+
+} // namespace
+
+TEST(CubicHermiteSE2CurveTest, Evaluate)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  getTestValues(times, values);
+  CubicHermiteSE2Curve curve;
+  curve.fitCurve(times, values);
+  ASSERT_EQ(4, curve.size());
+
+  for (size_t i = 0; i < times.size(); ++i) {
+    const ValueType value = curve.evaluate(times[i]);
+    EXPECT_DOUBLE_EQ(values[i].x(), value.x());
+    EXPECT_DOUBLE_EQ(values[i].y(), value.y());
+    EXPECT_DOUBLE_EQ(values[i].getAngle(), value.getAngle());
+  }
+
+  // Zero slopes at the ends, Catmull-Rom slopes in between.
+  DerivativeType derivative;
+  ASSERT_TRUE(curve.evaluateDerivative(derivative, 0.0, 1));
+  EXPECT_TRUE(derivative.isZero());
+  ASSERT_TRUE(curve.evaluateDerivative(derivative, 1.0, 1));
+  EXPECT_TRUE(derivative.isApprox(curve.calculateSlope(0.0, 2.5, values[0], values[2])));
+
+  // The heading between 2.5 and 3.0 turns across pi, not back through 0.
+  for (Time time = 2.5; time <= 3.0; time += 0.05) {
+    EXPECT_GT(std::abs(curve.evaluate(time).getAngle()), 2.7);
+  }
+
+  ValueType value;
+  EXPECT_FALSE(curve.evaluate(value, 3.5));
+  EXPECT_EQ(1u, curve.getEvaluationErrorCounters().getCount(EvaluationError::OutOfRange));
+}
+
+TEST(CubicHermiteSE2CurveTest, EvaluateDerivative)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  getTestValues(times, values);
+  CubicHermiteSE2Curve curve;
+  curve.fitCurve(times, values);
+
+  const double h = 1e-5;
+  for (const Time time : {0.2, 0.7, 1.3, 2.2, 2.8}) {
+    DerivativeType velocity, acceleration, jerk;
+    ASSERT_TRUE(curve.evaluateDerivative(velocity, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(acceleration, time, 2));
+    ASSERT_TRUE(curve.evaluateDerivative(jerk, time, 3));
+    const ValueType before = curve.evaluate(time - h);
+    const ValueType after = curve.evaluate(time + h);
+    EXPECT_NEAR((after.x() - before.x()) / (2.0 * h), velocity.x(), 1e-6);
+    EXPECT_NEAR((after.y() - before.y()) / (2.0 * h), velocity.y(), 1e-6);
+    EXPECT_NEAR(SE2Transformation::wrapAngle(after.getAngle() - before.getAngle()) / (2.0 * h), velocity.z(), 1e-6);
+
+    DerivativeType velocityBefore, velocityAfter, accelerationBefore, accelerationAfter;
+    curve.evaluateDerivative(velocityBefore, time - h, 1);
+    curve.evaluateDerivative(velocityAfter, time + h, 1);
+    EXPECT_TRUE(((velocityAfter - velocityBefore) / (2.0 * h)).isApprox(acceleration, 1e-6));
+    curve.evaluateDerivative(accelerationBefore, time - h, 2);
+    curve.evaluateDerivative(accelerationAfter, time + h, 2);
+    EXPECT_TRUE(((accelerationAfter - accelerationBefore) / (2.0 * h)).isApprox(jerk, 1e-6));
+
+    ASSERT_TRUE(curve.evaluateDerivative(velocity, time, 4));
+    EXPECT_TRUE(velocity.isZero());
+  }
+}
+
+TEST(CubicHermiteSE2CurveTest, EvaluateBatch)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  getTestValues(times, values);
+  CubicHermiteSE2Curve curve;
+  curve.fitCurve(times, values);
+
+  std::vector<Time> queries;
+  for (int i = 0; i <= 60; ++i) {
+    queries.push_back(0.05 * i);
+  }
+  std::vector<ValueType> batch;
+  std::vector<DerivativeType> derivatives;
+  ASSERT_TRUE(curve.evaluate(queries, &batch));
+  ASSERT_TRUE(curve.evaluateDerivative(queries, &derivatives, 2));
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const ValueType value = curve.evaluate(queries[i]);
+    EXPECT_DOUBLE_EQ(value.x(), batch[i].x());
+    EXPECT_DOUBLE_EQ(value.y(), batch[i].y());
+    EXPECT_DOUBLE_EQ(value.getAngle(), batch[i].getAngle());
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, queries[i], 2));
+    EXPECT_TRUE(derivative.isApprox(derivatives[i]));
+  }
+}
+
+TEST(CubicHermiteSE2CurveTest, Extend)
+{
+  const std::vector<Time> times = {0.0, 1.0, 2.0, 3.0, 4.0};
+  const std::vector<ValueType> values = {ValueType(1.0, 2.0, 0.3), ValueType(2.0, 4.0, 1.5), ValueType(0.0, 1.0, 3.0),
+                                         ValueType(-1.0, 0.5, -2.9), ValueType(-2.0, 1.0, -2.5)};
+  CubicHermiteSE2Curve curve;
+  for (size_t i = 0; i < times.size(); ++i) {
+    curve.extend({times[i]}, {values[i]});
+  }
+  // As for CubicHermiteSE3Curve, every other measurement is an interpolated knot, which is
+  // replaced by the next measurement.
+  std::vector<Time> knotTimes;
+  curve.getCurveTimes(&knotTimes);
+  ASSERT_EQ(std::vector<Time>({0.0, 2.0, 4.0}), knotTimes);
+
+  // The inner knots get the Catmull-Rom slopes, the last one the slope of the last segment.
+  DerivativeType derivative;
+  ASSERT_TRUE(curve.evaluateDerivative(derivative, 2.0, 1));
+  EXPECT_TRUE(derivative.isApprox(curve.calculateSlope(0.0, 4.0, values[0], values[4])));
+  ASSERT_TRUE(curve.evaluateDerivative(derivative, 4.0, 1));
+  EXPECT_TRUE(derivative.isApprox(curve.calculateSlope(2.0, 4.0, values[2], values[4])));
+
+  // Measurements between the knots move the interpolated knot at the end.
+  CubicHermiteSE2Curve sampled;
+  sampled.setSamplingRatio(3);
+  std::vector<Time> extendTimes;
+  std::vector<ValueType> extendValues;
+  for (int i = 0; i < 10; ++i) {
+    extendTimes.push_back(0.1 * i);
+    extendValues.push_back(ValueType(0.1 * i, 0.0, 0.2 * i));
+  }
+  sampled.extend(extendTimes, extendValues);
+  EXPECT_DOUBLE_EQ(0.9, sampled.getMaxTime());
+  EXPECT_LT(getAngleError(1.8, sampled.evaluate(0.9).getAngle()), 1e-12);
+  EXPECT_LT(sampled.size(), 10);
+}
+
+TEST(CubicHermiteSE2CurveTest, ExtendKeys)
+{
+  // A measurement which adds a knot returns its key, one which moves the interpolated knot
+  // returns none.
+  CubicHermiteSE2Curve curve;
+  std::vector<Key> keys;
+  std::vector<size_t> numKeys;
+  for (int i = 0; i < 5; ++i) {
+    const size_t numPreviousKeys = keys.size();
+    curve.extend({Time(i)}, {ValueType(i, 0.0, 0.1 * i)}, &keys);
+    numKeys.push_back(keys.size() - numPreviousKeys);
+  }
+  EXPECT_EQ(std::vector<size_t>({1u, 1u, 0u, 1u, 0u}), numKeys);
+  ASSERT_EQ(size_t(curve.size()), keys.size());
+  EXPECT_EQ(keys.size(), std::set<Key>(keys.begin(), keys.end()).size());
+
+  // A batch returns the keys of the knots it added.
+  CubicHermiteSE2Curve sampled;
+  sampled.setSamplingRatio(3);
+  std::vector<Time> extendTimes;
+  std::vector<ValueType> extendValues;
+  for (int i = 0; i < 10; ++i) {
+    extendTimes.push_back(0.1 * i);
+    extendValues.push_back(ValueType(0.1 * i, 0.0, 0.2 * i));
+  }
+  keys.clear();
+  sampled.extend(extendTimes, extendValues, &keys);
+  ASSERT_EQ(size_t(sampled.size()), keys.size());
+  EXPECT_EQ(keys.size(), std::set<Key>(keys.begin(), keys.end()).size());
+}
+
+TEST(CubicHermiteSE2CurveTest, TransformCurve)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  getTestValues(times, values);
+  CubicHermiteSE2Curve curve;
+  curve.fitCurve(times, values);
+  const ValueType before = curve.evaluate(1.7);
+  const ValueType transform(1.0, -2.0, 2.5);
+  curve.transformCurve(transform);
+  const ValueType expected = transform * before;
+  const ValueType after = curve.evaluate(1.7);
+  EXPECT_NEAR(expected.x(), after.x(), 1e-12);
+  EXPECT_NEAR(expected.y(), after.y(), 1e-12);
+  EXPECT_LT(getAngleError(expected.getAngle(), after.getAngle()), 1e-12);
+}
@@ -9,9 +9,12 @@
 #include <gtest/gtest.h>
 
 #include "curves/CubicHermiteSE3Curve.hpp"
+#include "curves/CurveCursor.hpp"
 #include <kindr/Core>
 #include <kindr/common/gtest_eigen.hpp>
+#include <cstdio>
 #include <limits>
+#include <set>
 
 typedef std::numeric_limits< double > dbl;
 
@@ -317,6 +320,67 @@ TEST(CubicHermiteSE3CurveTest, linearAcceleration)
    }
 }
 
+TEST(CubicHermiteSE3CurveTest, evaluateState)
+{
+  CubicHermiteSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 6; ++i) {
+    const Time time = 0.7 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), 2.0 * std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(time), 0.3 * time, -0.5 * time))));
+  }
+  curve.fitCurve(times, values);
+
+  std::vector<Time> evaluationTimes;
+  for (double time = times.front() + 1e-3; time < times.back(); time += 0.05) {
+    evaluationTimes.push_back(time);
+  }
+  CubicHermiteSE3Curve::StateVector states;
+  ASSERT_TRUE(curve.evaluateStates(evaluationTimes, &states));
+  ASSERT_EQ(evaluationTimes.size(), states.size());
+
+  const double h = 1.0e-6;
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    const Time time = evaluationTimes[i];
+    CubicHermiteSE3Curve::State state;
+    ASSERT_TRUE(curve.evaluateState(state, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ(state.twistA, states[i].twistA, 1e-12, "batch");
+    KINDR_ASSERT_DOUBLE_MX_EQ(state.accelerationA, states[i].accelerationA, 1e-12, "batch");
+
+    // The pose and twist are those of evaluate and evaluateDerivative.
+    ValueType value;
+    DerivativeType derivative, derivativeBefore, derivativeAfter;
+    ASSERT_TRUE(curve.evaluate(value, time));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 1));
+    KINDR_ASSERT_DOUBLE_MX_EQ(value.getPosition().vector(), state.pose.getPosition().vector(), 1e-10, "position");
+    EXPECT_NEAR(0.0, value.getRotation().getDisparityAngle(state.pose.getRotation()), 1e-10);
+    KINDR_ASSERT_DOUBLE_MX_EQ_ZT(derivative.getVector(), state.twistA, 1e-8, "twist", 1e-12);
+
+    // The accelerations are the derivatives of the twist.
+    ASSERT_TRUE(curve.evaluateDerivative(derivativeBefore, time - h, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(derivativeAfter, time + h, 1));
+    const Vector6d expectedAcceleration = (derivativeAfter.getVector() - derivativeBefore.getVector()) / (2.0 * h);
+    KINDR_ASSERT_DOUBLE_MX_EQ_ZT(expectedAcceleration, state.accelerationA, 1.0, "acceleration", 1.0e-4);
+    kindr::Acceleration3D linearAcceleration;
+    ASSERT_TRUE(curve.evaluateLinearAcceleration(linearAcceleration, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ_ZT(linearAcceleration.vector(), state.accelerationA.head<3>(), 1e-8, "linear acceleration",
+                                 1e-12);
+
+    // Frame B only changes the frame the vectors are expressed in.
+    KINDR_ASSERT_DOUBLE_MX_EQ_ZT(state.pose.getRotation().rotate(Eigen::Vector3d(state.twistB.tail<3>())),
+                                 state.twistA.tail<3>(), 1e-10, "twist B", 1e-12);
+    KINDR_ASSERT_DOUBLE_MX_EQ_ZT(state.pose.getRotation().rotate(Eigen::Vector3d(state.accelerationB.head<3>())),
+                                 state.accelerationA.head<3>(), 1e-10, "acceleration B", 1e-12);
+    KINDR_ASSERT_DOUBLE_MX_EQ(curve.evaluateDerivativeA(2, time), state.accelerationA, 1e-12, "derivative A");
+  }
+
+  CubicHermiteSE3Curve::State state;
+  EXPECT_FALSE(curve.evaluateState(state, times.back() + 1.0));
+  EXPECT_EQ(1u, curve.getEvaluationErrorCounters().getCount(EvaluationError::OutOfRange));
+}
+
 TEST(Debugging, FreeGaitTorsoControl)
 {
   CubicHermiteSE3Curve curve;
@@ -373,3 +437,602 @@ TEST(GetTime, Simple)
   EXPECT_EQ(times[0], curve.getMinTime());
   EXPECT_EQ(times[2], curve.getMaxTime());
 }
+
+TEST(Evaluate, BatchEvaluation)
+{
+  CubicHermiteSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  times.push_back(-1.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 2.0, 4.0), ValueType::Rotation(kindr::EulerAnglesZyxD(M_PI_2, 0.2, -0.9))));
+  times.push_back(0.5);
+  values.push_back(ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(2.0, 3.0, -1.1))));
+  times.push_back(1.0);
+  values.push_back(ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(0.2, 0.5, 0.2))));
+  times.push_back(3.0);
+  values.push_back(ValueType(ValueType::Position(4.0, 8.0, 16.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+
+  // Sorted times hitting every knot, followed by unsorted times.
+  std::vector<Time> evaluationTimes;
+  for (double time = times.front(); time < times.back(); time += 0.05) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.insert(evaluationTimes.end(), times.begin(), times.end());
+  evaluationTimes.push_back(0.7);
+  evaluationTimes.push_back(-0.5);
+
+  std::vector<ValueType> batchValues;
+  std::vector<DerivativeType> batchDerivatives;
+  ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchDerivatives, 1));
+  ASSERT_EQ(evaluationTimes.size(), batchValues.size());
+  ASSERT_EQ(evaluationTimes.size(), batchDerivatives.size());
+
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType value;
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluate(value, evaluationTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, evaluationTimes[i], 1));
+    EXPECT_EQ(value.getPosition(), batchValues[i].getPosition());
+    EXPECT_EQ(value.getRotation(), batchValues[i].getRotation());
+    KINDR_ASSERT_DOUBLE_MX_EQ(derivative.getVector(), batchDerivatives[i].getVector(), 1e-10, "batch");
+  }
+
+  // Times outside of the curve are reported, the others are still evaluated.
+  std::vector<Time> outOfRangeTimes;
+  outOfRangeTimes.push_back(0.0);
+  outOfRangeTimes.push_back(times.back() + 1.0);
+  EXPECT_FALSE(curve.evaluate(outOfRangeTimes, &batchValues));
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 0.0));
+  EXPECT_EQ(value.getPosition(), batchValues[0].getPosition());
+}
+
+TEST(Evaluate, Cursor)
+{
+  CubicHermiteSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  for (size_t i = 0; i < 20; ++i) {
+    times.push_back(0.5 * i);
+    values.push_back(ValueType(ValueType::Position(i, 0.5 * i, -1.0 * i),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.1 * i, 0.05 * i, -0.2))));
+  }
+  curve.fitCurve(times, values);
+  CurveCursor<CubicHermiteSE3Curve> cursor(curve);
+
+  ValueType value, expected;
+  DerivativeType derivative, expectedDerivative;
+  for (double time = times.front(); time <= times.back(); time += 0.07) {
+    ASSERT_TRUE(cursor.evaluate(value, time));
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+    ASSERT_TRUE(cursor.evaluateDerivative(derivative, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, time, 1));
+    EXPECT_EQ(expectedDerivative.getVector(), derivative.getVector());
+  }
+
+  // Jumping backwards falls back to a regular search.
+  ASSERT_TRUE(cursor.evaluate(value, 1.2));
+  ASSERT_TRUE(curve.evaluate(expected, 1.2));
+  EXPECT_EQ(expected.getPosition(), value.getPosition());
+
+  // Refitting the curve invalidates the remembered segment.
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i].getPosition() = ValueType::Position(0.0, 0.0, 0.0);
+  }
+  curve.fitCurve(times, values);
+  ASSERT_TRUE(cursor.evaluate(value, 1.3));
+  KINDR_ASSERT_DOUBLE_MX_EQ(Eigen::Vector3d::Zero(), value.getPosition().vector(), 1e-10, "position");
+}
+
+TEST(Evaluate, ErrorCounters)
+{
+  CubicHermiteSE3Curve curve;
+  ValueType value;
+  DerivativeType derivative;
+  EXPECT_EQ(EvaluationError::Empty, curve.tryEvaluate(value, 0.0));
+  EXPECT_FALSE(curve.evaluate(value, 0.0));
+
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(0.0);
+  values.push_back(ValueType());
+  times.push_back(1.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 0.0, 0.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+
+  EXPECT_EQ(EvaluationError::None, curve.tryEvaluate(value, 0.5));
+  EXPECT_EQ(EvaluationError::OutOfRange, curve.tryEvaluate(value, 1.1));
+  EXPECT_EQ(EvaluationError::OutOfRange, curve.tryEvaluate(value, -0.1));
+  EXPECT_EQ(EvaluationError::None, curve.tryEvaluateDerivative(derivative, 0.5, 1));
+  EXPECT_EQ(EvaluationError::UnsupportedDerivative, curve.tryEvaluateDerivative(derivative, 0.5, 2));
+
+  std::vector<Time> evaluationTimes;
+  evaluationTimes.push_back(0.5);
+  evaluationTimes.push_back(2.0);
+  std::vector<ValueType> evaluatedValues;
+  EXPECT_FALSE(curve.evaluate(evaluationTimes, &evaluatedValues));
+
+  const EvaluationErrorCounters& counters = curve.getEvaluationErrorCounters();
+  EXPECT_EQ(2u, counters.getCount(EvaluationError::Empty));
+  EXPECT_EQ(3u, counters.getCount(EvaluationError::OutOfRange));
+  EXPECT_EQ(1u, counters.getCount(EvaluationError::UnsupportedDerivative));
+  EXPECT_EQ(6u, counters.getTotalCount());
+
+  curve.resetEvaluationErrorCounters();
+  EXPECT_EQ(0u, counters.getTotalCount());
+}
+
+TEST(Evaluate, SegmentCache)
+{
+  CubicHermiteSE3Curve curve;
+  CubicHermiteSE3Curve cachedCurve;
+  cachedCurve.setSegmentCacheEnabled(true);
+  EXPECT_TRUE(cachedCurve.isSegmentCacheEnabled());
+
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(0.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 2.0, 4.0), ValueType::Rotation(kindr::EulerAnglesZyxD(M_PI_2, 0.2, -0.9))));
+  times.push_back(0.5);
+  values.push_back(ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(2.0, 3.0, -1.1))));
+  times.push_back(2.0);
+  values.push_back(ValueType(ValueType::Position(4.0, 8.0, 16.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+  cachedCurve.fitCurve(times, values);
+
+  std::vector<Time> evaluationTimes;
+  for (double time = times.front(); time <= times.back(); time += 0.1) {
+    evaluationTimes.push_back(time);
+  }
+  std::vector<ValueType> batchValues;
+  std::vector<DerivativeType> batchDerivatives;
+  ASSERT_TRUE(cachedCurve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(cachedCurve.evaluateDerivative(evaluationTimes, &batchDerivatives, 1));
+
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType expected, value;
+    DerivativeType expectedDerivative, derivative;
+    ASSERT_TRUE(curve.evaluate(expected, evaluationTimes[i]));
+    ASSERT_TRUE(cachedCurve.evaluate(value, evaluationTimes[i]));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), value.getPosition().vector(), 1e-10, "position");
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getRotation().vector(), value.getRotation().vector(), 1e-10, "rotation");
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), batchValues[i].getPosition().vector(), 1e-10, "batch");
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, evaluationTimes[i], 1));
+    ASSERT_TRUE(cachedCurve.evaluateDerivative(derivative, evaluationTimes[i], 1));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expectedDerivative.getVector(), derivative.getVector(), 1e-10, "derivative");
+    KINDR_ASSERT_DOUBLE_MX_EQ(expectedDerivative.getVector(), batchDerivatives[i].getVector(), 1e-10, "batch derivative");
+  }
+
+  // Changing the coefficients must not leave stale segments behind.
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i].getPosition() = ValueType::Position(0.0, 0.0, 0.0);
+  }
+  cachedCurve.fitCurve(times, values);
+  ValueType value;
+  ASSERT_TRUE(cachedCurve.evaluate(value, 1.3));
+  KINDR_ASSERT_DOUBLE_MX_EQ(Eigen::Vector3d::Zero(), value.getPosition().vector(), 1e-10, "position");
+}
+
+TEST(Evaluate, BinaryFile)
+{
+  CubicHermiteSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(-1.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 2.0, 4.0), ValueType::Rotation(kindr::EulerAnglesZyxD(M_PI_2, 0.2, -0.9))));
+  times.push_back(0.5);
+  values.push_back(ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(2.0, 3.0, -1.1))));
+  times.push_back(3.0);
+  values.push_back(ValueType(ValueType::Position(4.0, 8.0, 16.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+
+  const std::string filename = "CubicHermiteSE3CurveTest.bin";
+  ASSERT_TRUE(curve.saveCurveBinary(filename));
+
+  CubicHermiteSE3Curve loaded;
+  ASSERT_TRUE(loaded.loadCurveBinary(filename));
+  ASSERT_EQ(curve.size(), loaded.size());
+  EXPECT_EQ(curve.getMinTime(), loaded.getMinTime());
+  EXPECT_EQ(curve.getMaxTime(), loaded.getMaxTime());
+  for (double time = times.front(); time <= times.back(); time += 0.1) {
+    ValueType expected, value;
+    DerivativeType expectedDerivative, derivative;
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    ASSERT_TRUE(loaded.evaluate(value, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, time, 1));
+    ASSERT_TRUE(loaded.evaluateDerivative(derivative, time, 1));
+    EXPECT_EQ(expectedDerivative.getVector(), derivative.getVector());
+  }
+
+  std::remove(filename.c_str());
+  EXPECT_FALSE(loaded.loadCurveBinary(filename));
+}
+
+TEST(Evaluate, Window)
+{
+  CubicHermiteSE3Curve curve;
+  CubicHermiteSE3Curve windowedCurve;
+  const double windowDuration = 2.0;
+  windowedCurve.setWindow(windowDuration);
+
+  for (int i = 0; i < 500; ++i) {
+    const Time time = 0.1 * i;
+    const ValueType value(ValueType::Position(std::sin(time), std::cos(time), time),
+                          ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time)));
+    curve.extend(std::vector<Time>(1, time), std::vector<ValueType>(1, value));
+    windowedCurve.extend(std::vector<Time>(1, time), std::vector<ValueType>(1, value));
+    ASSERT_LE(windowedCurve.size(), 25);
+  }
+  ASSERT_EQ(curve.getMaxTime(), windowedCurve.getMaxTime());
+  ASSERT_LE(windowedCurve.getMinTime(), windowedCurve.getMaxTime() - windowDuration);
+
+  // The window is evaluated as if nothing had been dropped.
+  for (Time time = windowedCurve.getMaxTime() - windowDuration; time <= windowedCurve.getMaxTime(); time += 0.05) {
+    ValueType expected, value;
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    ASSERT_TRUE(windowedCurve.evaluate(value, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), value.getPosition().vector(), 1e-10, "position");
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getRotation().vector(), value.getRotation().vector(), 1e-10, "rotation");
+  }
+  ValueType value;
+  EXPECT_FALSE(windowedCurve.evaluate(value, 1.0));
+}
+
+TEST(Evaluate, ParallelFit)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 5000; ++i) {
+    const Time time = 0.01 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.setSegmentCacheEnabled(true);
+  curve.fitCurve(times, values);
+  CubicHermiteSE3Curve parallelCurve;
+  parallelCurve.setSegmentCacheEnabled(true);
+  parallelCurve.setNumberOfFitThreads(4);
+  std::vector<Key> keys;
+  parallelCurve.fitCurve(times, values, &keys);
+  ASSERT_EQ(times.size(), keys.size());
+  ASSERT_EQ(curve.size(), parallelCurve.size());
+
+  // The knots are computed independently, so the results are identical.
+  for (Time time = times.front(); time <= times.back(); time += 0.137) {
+    ValueType expected, value;
+    DerivativeType expectedDerivative, derivative;
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    ASSERT_TRUE(parallelCurve.evaluate(value, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, time, 1));
+    ASSERT_TRUE(parallelCurve.evaluateDerivative(derivative, time, 1));
+    EXPECT_EQ(expectedDerivative.getVector(), derivative.getVector());
+  }
+}
+
+TEST(Evaluate, LazySlopes)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 2000; ++i) {
+    const Time time = 0.01 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+  CubicHermiteSE3Curve lazyCurve;
+  lazyCurve.setLazySlopesEnabled(true);
+  EXPECT_TRUE(lazyCurve.isLazySlopesEnabled());
+  lazyCurve.fitCurve(times, values);
+  ASSERT_EQ(curve.size(), lazyCurve.size());
+
+  // Scattered evaluations, twice to also read the memoized slopes.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (Time time = times.front(); time <= times.back(); time += 0.737) {
+      ValueType expected, value;
+      DerivativeType expectedDerivative, derivative;
+      ASSERT_TRUE(curve.evaluate(expected, time));
+      ASSERT_TRUE(lazyCurve.evaluate(value, time));
+      EXPECT_EQ(expected.getPosition(), value.getPosition());
+      EXPECT_EQ(expected.getRotation(), value.getRotation());
+      ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, time, 1));
+      ASSERT_TRUE(lazyCurve.evaluateDerivative(derivative, time, 1));
+      EXPECT_EQ(expectedDerivative.getVector(), derivative.getVector());
+    }
+  }
+
+  // Extending writes the slopes into the coefficients first.
+  CubicHermiteSE3Curve lazyCopy(lazyCurve);
+  const Time time = times.back() + 0.5;
+  const ValueType value(ValueType::Position(1.0, 2.0, 3.0), ValueType::Rotation());
+  curve.extend(std::vector<Time>(1, time), std::vector<ValueType>(1, value));
+  lazyCopy.extend(std::vector<Time>(1, time), std::vector<ValueType>(1, value));
+  for (Time t = times.front(); t <= time; t += 0.291) {
+    ValueType expected, lazyValue;
+    ASSERT_TRUE(curve.evaluate(expected, t));
+    ASSERT_TRUE(lazyCopy.evaluate(lazyValue, t));
+    EXPECT_EQ(expected.getPosition(), lazyValue.getPosition());
+    EXPECT_EQ(expected.getRotation(), lazyValue.getRotation());
+  }
+}
+
+TEST(Evaluate, KnotDerivatives)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  std::vector<DerivativeType> derivatives;
+  for (int i = 0; i < 10; ++i) {
+    const Time time = 0.2 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time), ValueType::Rotation()));
+    derivatives.push_back(DerivativeType(Eigen::Vector3d(std::cos(time), -std::sin(time), 1.0), Eigen::Vector3d::Zero()));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurveWithDerivatives(times, values, derivatives);
+  ASSERT_EQ(times.size(), curve.size());
+
+  // The given derivatives are the tangents at the knots.
+  for (size_t i = 0; i < times.size(); ++i) {
+    ValueType value;
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluate(value, times[i]));
+    KINDR_ASSERT_DOUBLE_MX_EQ(values[i].getPosition().vector(), value.getPosition().vector(), 1e-10, "position");
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, times[i], 1));
+    KINDR_ASSERT_DOUBLE_MX_EQ(derivatives[i].getVector(), derivative.getVector(), 1e-10, "derivative");
+  }
+}
+
+TEST(Evaluate, TransformCurve)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 3000; ++i) {
+    const Time time = 0.01 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+  CubicHermiteSE3Curve transformedCurve(curve);
+  transformedCurve.setSegmentCacheEnabled(true);
+  CubicHermiteSE3Curve lazyCurve;
+  lazyCurve.setLazySlopesEnabled(true);
+  lazyCurve.fitCurve(times, values);
+
+  const ValueType T(ValueType::Position(1.0, -2.0, 0.5),
+                    ValueType::Rotation(kindr::EulerAnglesZyxD(0.4, -0.3, 1.2)));
+  transformedCurve.transformCurve(T, 4);
+  std::vector<SE3Curve*> curves(1, &lazyCurve);
+  transformCurves(curves, T, 2);
+  ASSERT_EQ(curve.size(), transformedCurve.size());
+
+  // The curve is transformed as a whole, the global twists are rotated into the new frame.
+  for (Time time = times.front(); time <= times.back(); time += 0.173) {
+    ValueType value, transformedValue, lazyValue;
+    DerivativeType derivative, transformedDerivative;
+    ASSERT_TRUE(curve.evaluate(value, time));
+    ASSERT_TRUE(transformedCurve.evaluate(transformedValue, time));
+    ASSERT_TRUE(lazyCurve.evaluate(lazyValue, time));
+    const ValueType expected = T * value;
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), transformedValue.getPosition().vector(), 1e-9, "position");
+    EXPECT_NEAR(0.0, expected.getRotation().getDisparityAngle(transformedValue.getRotation()), 1e-9);
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), lazyValue.getPosition().vector(), 1e-9, "lazy position");
+    EXPECT_NEAR(0.0, expected.getRotation().getDisparityAngle(lazyValue.getRotation()), 1e-9);
+
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 1));
+    ASSERT_TRUE(transformedCurve.evaluateDerivative(transformedDerivative, time, 1));
+    // The slopes are differences over 10 ms, absolute errors of 1e-12 are rounding.
+    EXPECT_NEAR(0.0, (T.getRotation().rotate(derivative.getTranslationalVelocity().vector())
+                      - transformedDerivative.getTranslationalVelocity().vector()).norm(), 1e-10);
+    EXPECT_NEAR(0.0, (T.getRotation().rotate(derivative.getRotationalVelocity().vector())
+                      - transformedDerivative.getRotationalVelocity().vector()).norm(), 1e-10);
+  }
+}
+
+TEST(Evaluate, Simplify)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 1000; ++i) {
+    const Time time = 0.01 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(0.5 * time), std::cos(0.5 * time), 0.1 * time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.5 * time, 0.1, 0.0))));
+  }
+  const KnotTolerance tolerance(1e-3, 1e-3);
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+  const size_t numRemoved = curve.simplify(tolerance);
+  EXPECT_EQ(times.size() - numRemoved, curve.size());
+  EXPECT_LT(curve.size(), times.size() / 4);
+
+  // The curve is streamed with the same tolerance.
+  CubicHermiteSE3Curve streamedCurve;
+  streamedCurve.setSimplificationTolerance(tolerance);
+  streamedCurve.extend(times, values);
+  EXPECT_LT(streamedCurve.size(), times.size() / 2);
+
+  for (size_t i = 0; i < times.size(); ++i) {
+    ValueType value, streamedValue;
+    ASSERT_TRUE(curve.evaluate(value, times[i]));
+    EXPECT_LE((values[i].getPosition() - value.getPosition()).norm(), tolerance.translation);
+    EXPECT_LE(values[i].getRotation().getDisparityAngle(value.getRotation()), tolerance.rotation);
+    // The last sample is only interpolated, see SamplingPolicy::interpolationExtend.
+    if (i + 1 < times.size()) {
+      ASSERT_TRUE(streamedCurve.evaluate(streamedValue, times[i]));
+      EXPECT_LE((values[i].getPosition() - streamedValue.getPosition()).norm(), tolerance.translation);
+      EXPECT_LE(values[i].getRotation().getDisparityAngle(streamedValue.getRotation()), tolerance.rotation);
+    }
+  }
+}
+
+TEST(Evaluate, BatchedExtend)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 400; ++i) {
+    const Time time = 0.0025 * (i + 1);
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.3 * time, 0.2, time))));
+  }
+  // The batches only write the interpolated knot for their last measurement.
+  CubicHermiteSE3Curve curve, batchedCurve;
+  curve.setSamplingRatio(4);
+  batchedCurve.setSamplingRatio(4);
+  for (size_t i = 0; i < times.size(); ++i) {
+    curve.extend(std::vector<Time>(1, times[i]), std::vector<ValueType>(1, values[i]));
+  }
+  std::vector<Key> keys;
+  for (size_t i = 0; i < times.size(); i += 7) {
+    const size_t end = std::min(i + 7, times.size());
+    batchedCurve.extend(std::vector<Time>(times.begin() + i, times.begin() + end),
+                        std::vector<ValueType>(values.begin() + i, values.begin() + end), &keys);
+  }
+
+  std::vector<Time> knotTimes, batchedKnotTimes;
+  curve.getCurveTimes(&knotTimes);
+  batchedCurve.getCurveTimes(&batchedKnotTimes);
+  ASSERT_EQ(knotTimes, batchedKnotTimes);
+  // Every knot was returned once, by the batch which added it.
+  ASSERT_EQ(batchedKnotTimes.size(), keys.size());
+  EXPECT_EQ(keys.size(), std::set<Key>(keys.begin(), keys.end()).size());
+  EXPECT_EQ(times.back(), batchedCurve.getMaxTime());
+  for (Time time = times.front(); time <= times.back(); time += 0.0013) {
+    ValueType value, batchedValue;
+    ASSERT_TRUE(curve.evaluate(value, time));
+    ASSERT_TRUE(batchedCurve.evaluate(batchedValue, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ(value.getPosition().vector(), batchedValue.getPosition().vector(), 1e-12, "position");
+    EXPECT_NEAR(0.0, value.getRotation().getDisparityAngle(batchedValue.getRotation()), 1e-12);
+  }
+}
+
+TEST(Evaluate, StreamedExtend)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i <= 300; ++i) {
+    const Time time = 0.01 * i;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(std::sin(time), std::cos(time), time),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(std::sin(0.3 * time), 0.2, time))));
+  }
+  CubicHermiteSE3Curve curve, windowedCurve, fittedCurve;
+  curve.setSamplingRatio(1);
+  curve.setSegmentCacheEnabled(true);
+  windowedCurve.setSamplingRatio(1);
+  windowedCurve.setSegmentCacheEnabled(true);
+  windowedCurve.setWindow(0.5);
+  std::set<Key> keys;
+  for (size_t i = 0; i < times.size(); ++i) {
+    keys.insert(curve.extend(times[i], values[i]));
+    EXPECT_EQ(times[i], curve.getMaxTime());
+    windowedCurve.extend(times[i], values[i]);
+  }
+
+  // Every second sample becomes a knot, the others are written into the interpolated knot.
+  std::vector<Time> knotTimes, expectedKnotTimes;
+  std::vector<ValueType> knotValues;
+  for (size_t i = 0; i < times.size(); i += 2) {
+    expectedKnotTimes.push_back(times[i]);
+    knotValues.push_back(values[i]);
+  }
+  curve.getCurveTimes(&knotTimes);
+  ASSERT_EQ(expectedKnotTimes, knotTimes);
+  EXPECT_EQ(knotTimes.size(), keys.size());
+
+  // The streamed slopes are those of a fit through the knots.
+  const size_t n = knotTimes.size();
+  fittedCurve.fitCurveWithDerivatives(
+      knotTimes, knotValues, fittedCurve.calculateSlope(knotTimes[0], knotTimes[1], knotValues[0], knotValues[1]),
+      fittedCurve.calculateSlope(knotTimes[n - 2], knotTimes[n - 1], knotValues[n - 2], knotValues[n - 1]));
+  for (Time time = times.front(); time <= times.back(); time += 0.0037) {
+    ValueType expected, value;
+    DerivativeType expectedDerivative, derivative;
+    ASSERT_TRUE(fittedCurve.evaluate(expected, time));
+    ASSERT_TRUE(curve.evaluate(value, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), value.getPosition().vector(), 1e-10, "position");
+    EXPECT_NEAR(0.0, expected.getRotation().getDisparityAngle(value.getRotation()), 1e-10);
+    ASSERT_TRUE(fittedCurve.evaluateDerivative(expectedDerivative, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 1));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expectedDerivative.getVector(), derivative.getVector(), 1e-8, "derivative");
+  }
+
+  // The cached segments follow the window.
+  for (Time time = windowedCurve.getMinTime(); time <= windowedCurve.getMaxTime(); time += 0.0037) {
+    ValueType expected, value;
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    ASSERT_TRUE(windowedCurve.evaluate(value, time));
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), value.getPosition().vector(), 1e-10, "window position");
+  }
+}
+
+TEST(Evaluate, TransformPoints)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i <= 10; ++i) {
+    times.push_back(0.01 * i);
+    values.push_back(ValueType(ValueType::Position(i, 0.5 * i, 0.1 * i * i),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.2 * i, 0.1, -0.05 * i))));
+  }
+  CubicHermiteSE3Curve curve;
+  curve.fitCurve(times, values);
+
+  // Points of a scan, fired in groups sharing their time, and one point after the curve.
+  const size_t numPoints = 1001;
+  std::vector<Time> pointTimes;
+  Eigen::Matrix3Xd points = Eigen::Matrix3Xd::Random(3, numPoints);
+  for (size_t i = 0; i + 1 < numPoints; ++i) {
+    pointTimes.push_back(0.1 * (i / 8) / (numPoints / 8));
+  }
+  pointTimes.push_back(0.2);
+
+  Eigen::Matrix3Xd transformedPoints;
+  EXPECT_FALSE(curve.transformPoints(pointTimes, points, &transformedPoints));
+  ASSERT_EQ(numPoints, transformedPoints.cols());
+  for (size_t i = 0; i + 1 < numPoints; ++i) {
+    ValueType pose;
+    ASSERT_TRUE(curve.evaluate(pose, pointTimes[i]));
+    const Eigen::Vector3d expected = pose.getRotation().rotate(Eigen::Vector3d(points.col(i))) + pose.getPosition().vector();
+    KINDR_ASSERT_DOUBLE_MX_EQ(expected, transformedPoints.col(i), 1e-10, "point");
+  }
+  EXPECT_TRUE(transformedPoints.col(numPoints - 1).hasNaN());
+}
+
+TEST(Coefficient, PackedLayout)
+{
+  typedef CubicHermiteSE3Curve::Coefficient Coefficient;
+  // The key and the 13 packed values, without padding.
+  EXPECT_EQ(14 * sizeof(double), sizeof(KeyedCoefficient<Coefficient>));
+
+  const ValueType pose(ValueType::Position(1.0, -2.0, 3.0),
+                       ValueType::Rotation(kindr::EulerAnglesZyxD(0.4, -0.2, 1.3)));
+  const DerivativeType twist(Eigen::Vector3d(0.1, 0.2, 0.3), Eigen::Vector3d(-0.4, 0.5, -0.6));
+  const Coefficient coefficient(pose, twist);
+  EXPECT_EQ(pose.getPosition(), coefficient.getTransformation().getPosition());
+  EXPECT_EQ(pose.getRotation(), coefficient.getTransformation().getRotation());
+  EXPECT_EQ(twist.getVector(), coefficient.getTransformationDerivative().getVector());
+  EXPECT_EQ(pose.getPosition().vector(), coefficient.getPosition());
+  EXPECT_EQ(twist.getRotationalVelocity().vector(), coefficient.getAngularVelocity());
+
+  // The default coefficient is the identity at rest.
+  const Coefficient identity;
+  EXPECT_EQ(ValueType().getRotation(), identity.getRotation());
+  EXPECT_EQ(Eigen::Vector3d::Zero(), identity.getPosition());
+  EXPECT_EQ(Eigen::Vector3d::Zero(), identity.getLinearVelocity());
+}
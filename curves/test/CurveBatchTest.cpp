@@ -0,0 +1,104 @@
+/*
+ * CurveBatchTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/CurveBatch.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+typedef PolynomialSplineQuinticVector3Curve::ValueType ValueType;
+
+namespace {
+
+void fitTestCurve(double phase, PolynomialSplineQuinticVector3Curve* curve)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 8; ++i) {
+    times.push_back(0.4 * i + 0.02 * i * i);
+    values.push_back(ValueType(std::sin(times.back() + phase), std::cos(2.0 * times.back()), phase * i));
+  }
+  curve->fitCurve(times, values);
+}
+
+void fitTestCurve(double phase, CubicHermiteE3Curve* curve)
+{
+  std::vector<Time> times;
+  std::vector<CubicHermiteE3Curve::ValueType> values;
+  for (int i = 0; i < 6; ++i) {
+    times.push_back(1.0 + 0.5 * i);
+    values.push_back(CubicHermiteE3Curve::ValueType(phase * i, std::sin(times.back()), -0.2 * i * i));
+  }
+  curve->fitCurve(times, values);
+}
+
+} // namespace
+
+TEST(CurveBatchTest, PolynomialSplineCurves)
+{
+  std::vector<PolynomialSplineQuinticVector3Curve> curves(300);
+  CurveBatch<3> batch;
+  for (size_t i = 0; i < curves.size(); ++i) {
+    fitTestCurve(0.01 * i, &curves[i]);
+    EXPECT_EQ(i, batch.addCurve(curves[i]));
+  }
+  ASSERT_EQ(curves.size(), batch.size());
+
+  CurveBatch<3>::ValueMatrix values, velocities;
+  ValueType value, velocity;
+  for (Time time = 0.0; time < 3.7; time += 0.13) {
+    ASSERT_TRUE(batch.evaluate(time, &values));
+    ASSERT_TRUE(batch.evaluateDerivative(time, 1, &velocities));
+    for (size_t i = 0; i < curves.size(); i += 7) {
+      ASSERT_TRUE(curves[i].evaluate(value, time));
+      ASSERT_TRUE(curves[i].evaluateDerivative(velocity, time, 1));
+      EXPECT_NEAR(0.0, (values.row(i).transpose() - value).norm(), 1e-9);
+      EXPECT_NEAR(0.0, (velocities.row(i).transpose() - velocity).norm(), 1e-9);
+    }
+  }
+
+  // Per curve times, in random order.
+  batch.setNumberOfThreads(4);
+  const Eigen::VectorXd times = (Eigen::VectorXd::Random(curves.size()).array() + 1.0) * 1.8;
+  ASSERT_TRUE(batch.evaluate(times, &values));
+  for (size_t i = 0; i < curves.size(); ++i) {
+    ASSERT_TRUE(curves[i].evaluate(value, times(i)));
+    EXPECT_NEAR(0.0, (values.row(i).transpose() - value).norm(), 1e-9);
+  }
+
+  // Times after the end are clamped.
+  EXPECT_FALSE(batch.evaluate(100.0, &values));
+  ASSERT_TRUE(curves[0].evaluate(value, 100.0));
+  EXPECT_NEAR(0.0, (values.row(0).transpose() - value).norm(), 1e-9);
+}
+
+TEST(CurveBatchTest, CubicHermiteCurves)
+{
+  std::vector<CubicHermiteE3Curve> curves(5);
+  CurveBatch<3, 3> batch;
+  for (size_t i = 0; i < curves.size(); ++i) {
+    fitTestCurve(0.3 * i, &curves[i]);
+    batch.addCurve(curves[i]);
+  }
+
+  CurveBatch<3, 3>::ValueMatrix values, velocities;
+  CubicHermiteE3Curve::ValueType value;
+  CubicHermiteE3Curve::DerivativeType velocity;
+  for (Time time = 1.0; time <= 3.5; time += 0.05) {
+    ASSERT_TRUE(batch.evaluate(time, &values));
+    ASSERT_TRUE(batch.evaluateDerivative(time, 1, &velocities));
+    for (size_t i = 0; i < curves.size(); ++i) {
+      ASSERT_TRUE(curves[i].evaluate(value, time));
+      ASSERT_TRUE(curves[i].evaluateDerivative(velocity, time, 1));
+      EXPECT_NEAR(0.0, (values.row(i).transpose() - value).norm(), 1e-9);
+      EXPECT_NEAR(0.0, (velocities.row(i).transpose() - velocity).norm(), 1e-9);
+    }
+  }
+  EXPECT_FALSE(batch.evaluate(0.5, &values));
+}
@@ -0,0 +1,95 @@
+/*
+ * InstrumentationTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/Instrumentation.hpp"
+#include "curves/SlerpSE3Curve.hpp"
+
+using namespace curves;
+
+namespace {
+
+bool findSnapshot(const std::string& name, InstrumentationSnapshot* snapshot)
+{
+  const std::vector<InstrumentationSnapshot> snapshots = getInstrumentationSnapshot();
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    if (snapshots[i].name == name) {
+      *snapshot = snapshots[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+TEST(InstrumentationTest, ProbeStatistics)
+{
+  InstrumentationProbe& probe = InstrumentationProbe::get("InstrumentationTest::probe");
+  EXPECT_EQ(&probe, &InstrumentationProbe::get("InstrumentationTest::probe"));
+  probe.reset();
+  probe.record(0);
+  probe.record(1);
+  probe.record(5, 2);
+  probe.record(1024);
+
+  InstrumentationSnapshot snapshot;
+  ASSERT_TRUE(findSnapshot("InstrumentationTest::probe", &snapshot));
+  EXPECT_EQ(4u, snapshot.count);
+  EXPECT_EQ(1030u, snapshot.sum);
+  EXPECT_EQ(1024u, snapshot.max);
+  EXPECT_EQ(5u, snapshot.units);
+  EXPECT_EQ(1u, snapshot.histogram[0]);
+  EXPECT_EQ(1u, snapshot.histogram[1]);
+  EXPECT_EQ(1u, snapshot.histogram[3]);
+  EXPECT_EQ(1u, snapshot.histogram[11]);
+
+  resetInstrumentation();
+  ASSERT_TRUE(findSnapshot("InstrumentationTest::probe", &snapshot));
+  EXPECT_EQ(0u, snapshot.count);
+  EXPECT_EQ(0u, snapshot.max);
+  EXPECT_EQ(0u, snapshot.histogram[11]);
+}
+
+TEST(InstrumentationTest, Timer)
+{
+  InstrumentationProbe& probe = InstrumentationProbe::get("InstrumentationTest::timer");
+  probe.reset();
+  {
+    InstrumentationTimer timer(probe, 3);
+  }
+  InstrumentationSnapshot snapshot;
+  ASSERT_TRUE(findSnapshot("InstrumentationTest::timer", &snapshot));
+  EXPECT_EQ(1u, snapshot.count);
+  EXPECT_EQ(3u, snapshot.units);
+}
+
+#ifdef CURVES_ENABLE_INSTRUMENTATION
+TEST(InstrumentationTest, CurveEvaluation)
+{
+  typedef SlerpSE3Curve::ValueType ValueType;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 4; ++i) {
+    times.push_back(i);
+    values.push_back(ValueType(ValueType::Position(i, 0.0, 0.0), ValueType::Rotation()));
+  }
+  SlerpSE3Curve curve;
+  curve.fitCurve(times, values);
+  resetInstrumentation();
+
+  ValueType value;
+  EXPECT_TRUE(curve.evaluate(value, 1.5));
+  EXPECT_FALSE(curve.evaluate(value, 10.0));
+
+  InstrumentationSnapshot snapshot;
+  ASSERT_TRUE(findSnapshot("SlerpSE3Curve::evaluate", &snapshot));
+  EXPECT_EQ(2u, snapshot.count);
+  ASSERT_TRUE(findSnapshot("LocalSupport2CoefficientManager::outOfRange", &snapshot));
+  EXPECT_EQ(1u, snapshot.count);
+}
+#endif
@@ -0,0 +1,94 @@
+/*
+ * PeriodicCurveTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/CubicHermiteE3Curve.hpp"
+#include "curves/PeriodicCurve.hpp"
+#include "curves/PolynomialSplineVectorSpaceCurve.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+TEST(PeriodicCurveTest, CubicHermiteE3Curve)
+{
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values;
+  for (int i = 0; i <= 8; ++i) {
+    times.push_back(1.0 + 0.1 * i);
+    const double phase = 2.0 * M_PI * i / 8;
+    values.push_back(Eigen::Vector3d(std::cos(phase), std::sin(phase), 0.2 * std::sin(2.0 * phase)));
+  }
+  CubicHermiteE3Curve curve;
+  curve.fitPeriodicCurve(times, values);
+
+  PeriodicCurve<CubicHermiteE3Curve> periodicCurve(curve);
+  EXPECT_NEAR(0.8, periodicCurve.getPeriod(), 1e-12);
+  EXPECT_NEAR(1.25, periodicCurve.wrapTime(1.25 + 3.0 * 0.8), 1e-12);
+  EXPECT_NEAR(1.25, periodicCurve.wrapTime(1.25 - 5.0 * 0.8), 1e-12);
+  EXPECT_EQ(curve.getMinTime(), periodicCurve.wrapTime(curve.getMaxTime()));
+
+  // Several cycles, forwards and backwards in time.
+  std::vector<Time> queryTimes;
+  for (Time time = -3.0; time < 6.0; time += 0.013) {
+    queryTimes.push_back(time);
+  }
+  std::vector<Eigen::Vector3d> batchValues;
+  ASSERT_TRUE(periodicCurve.evaluate(queryTimes, &batchValues));
+  std::vector<Eigen::Vector3d> batchVelocities;
+  ASSERT_TRUE(periodicCurve.evaluateDerivative(queryTimes, &batchVelocities, 1));
+  PeriodicCurveCursor<CubicHermiteE3Curve> cursor(periodicCurve);
+  for (size_t i = 0; i < queryTimes.size(); ++i) {
+    Eigen::Vector3d expected, value, velocity;
+    ASSERT_TRUE(curve.evaluate(expected, periodicCurve.wrapTime(queryTimes[i])));
+    ASSERT_TRUE(periodicCurve.evaluate(value, queryTimes[i]));
+    EXPECT_TRUE(expected.isApprox(value, 1e-12));
+    EXPECT_TRUE(expected.isApprox(batchValues[i], 1e-9));
+    ASSERT_TRUE(cursor.evaluate(value, queryTimes[i]));
+    EXPECT_TRUE(expected.isApprox(value, 1e-12));
+    ASSERT_TRUE(cursor.evaluateDerivative(velocity, queryTimes[i], 1));
+    EXPECT_TRUE(velocity.isApprox(batchVelocities[i], 1e-9));
+  }
+
+  // The curve is continuous over the wrap.
+  Eigen::Vector3d before, after;
+  ASSERT_TRUE(periodicCurve.evaluate(before, 1.8 - 1e-9));
+  ASSERT_TRUE(periodicCurve.evaluate(after, 1.8 + 1e-9));
+  EXPECT_NEAR(0.0, (before - after).norm(), 1e-6);
+}
+
+TEST(PeriodicCurveTest, PolynomialSplineQuinticVector3Curve)
+{
+  std::vector<Time> times;
+  std::vector<Eigen::Vector3d> values;
+  for (int i = 0; i <= 6; ++i) {
+    times.push_back(0.25 * i);
+    values.push_back(Eigen::Vector3d(std::cos(M_PI * i / 3), 0.0, std::sin(M_PI * i / 3)));
+  }
+  PolynomialSplineQuinticVector3Curve curve;
+  curve.fitCurve(times, values);
+
+  PeriodicCurve<PolynomialSplineQuinticVector3Curve> periodicCurve(curve);
+  EXPECT_NEAR(1.5, periodicCurve.getPeriod(), 1e-12);
+  std::vector<Time> queryTimes;
+  for (Time time = 0.0; time < 20.0; time += 0.01) {
+    queryTimes.push_back(time);
+  }
+  std::vector<Eigen::Vector3d> batchValues;
+  ASSERT_TRUE(periodicCurve.evaluate(queryTimes, &batchValues));
+  for (size_t i = 0; i < queryTimes.size(); ++i) {
+    Eigen::Vector3d expected;
+    ASSERT_TRUE(curve.evaluate(expected, std::fmod(queryTimes[i], 1.5)));
+    EXPECT_NEAR(0.0, (expected - batchValues[i]).norm(), 1e-9);
+  }
+
+  // An empty curve has no period.
+  PolynomialSplineQuinticVector3Curve emptyCurve;
+  PeriodicCurve<PolynomialSplineQuinticVector3Curve> emptyPeriodicCurve(emptyCurve);
+  Eigen::Vector3d value;
+  EXPECT_FALSE(emptyPeriodicCurve.evaluate(value, 1.0));
+}
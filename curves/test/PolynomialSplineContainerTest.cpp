@@ -10,6 +10,9 @@
 
 #include "curves/PolynomialSplineContainer.hpp"
 
+#include <cmath>
+#include <cstdio>
+
 TEST(PolynomialSplineContainer, getActiveSplineIndexAtTime)
 {
   std::vector<double> knotPos;
@@ -44,6 +47,89 @@ TEST(PolynomialSplineContainer, getActiveSplineIndexAtTime)
   EXPECT_EQ(1.0, timeOffset);
 }
 
+TEST(PolynomialSplineContainer, getActiveSplineIndexAtTimeManySplines)
+{
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 200; ++i) {
+    knotPos.push_back(i == 0 ? 0.0 : knotPos.back() + 0.01 + 0.02 * (i % 7));
+    knotVal.push_back(0.1 * (i % 5));
+  }
+
+  curves::PolynomialSplineContainer polyContainer;
+  polyContainer.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+  const curves::PolynomialSplineContainer::SplineList& splines = polyContainer.getSplines();
+
+  // Reference: linear scan over the accumulated spline durations.
+  std::vector<double> queryTimes;
+  for (double t = -0.1; t < knotPos.back() + 0.1; t += 0.013) {
+    queryTimes.push_back(t);
+  }
+  queryTimes.insert(queryTimes.end(), knotPos.begin(), knotPos.end());
+  queryTimes.push_back(0.5);
+
+  for (size_t k = 0; k < queryTimes.size(); ++k) {
+    const double t = queryTimes[k];
+    int expectedIdx = splines.size() - 1;
+    double expectedOffset = 0.0;
+    for (size_t i = 0; i < splines.size(); ++i) {
+      if (t - expectedOffset < splines[i].getSplineDuration()) {
+        expectedIdx = i;
+        break;
+      }
+      if (i < splines.size() - 1) {
+        expectedOffset += splines[i].getSplineDuration();
+      }
+    }
+
+    double timeOffset = 0.0;
+    EXPECT_EQ(expectedIdx, polyContainer.getActiveSplineIndexAtTime(t, timeOffset)) << "time: " << t;
+    EXPECT_EQ(expectedOffset, timeOffset) << "time: " << t;
+  }
+}
+
+TEST(PolynomialSplineContainer, getActiveSplineIndexAtTimeUniformSplines)
+{
+  // Knots of a 200 Hz sensor, the durations only differ by rounding errors.
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 500; ++i) {
+    knotPos.push_back(0.005 * i);
+    knotVal.push_back(0.1 * (i % 5));
+  }
+
+  curves::PolynomialSplineCubicContainer polyContainer;
+  polyContainer.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+  EXPECT_TRUE(polyContainer.hasUniformSplineDuration());
+
+  for (int pass = 0; pass < 2; ++pass) {
+    const curves::PolynomialSplineCubicContainer::SplineList& splines = polyContainer.getSplines();
+    // Jump around, so that the lookup cannot start from the previous spline.
+    for (int k = 0; k < 1000; ++k) {
+      const double t = -0.01 + (k * 337 % 1000) * 0.0026;
+      int expectedIdx = splines.size() - 1;
+      double expectedOffset = 0.0;
+      for (size_t i = 0; i < splines.size(); ++i) {
+        if (t - expectedOffset < splines[i].getSplineDuration()) {
+          expectedIdx = i;
+          break;
+        }
+        if (i < splines.size() - 1) {
+          expectedOffset += splines[i].getSplineDuration();
+        }
+      }
+      double timeOffset = 0.0;
+      ASSERT_EQ(expectedIdx, polyContainer.getActiveSplineIndexAtTime(t, timeOffset)) << "time: " << t;
+      EXPECT_EQ(expectedOffset, timeOffset) << "time: " << t;
+    }
+
+    // A longer spline ends the uniform spacing.
+    curves::PolynomialSplineCubic spline;
+    spline.computeCoefficients(curves::SplineOptions(0.5, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0));
+    polyContainer.addSpline(spline);
+    EXPECT_FALSE(polyContainer.hasUniformSplineDuration());
+  }
+}
 
 TEST(PolynomialSplineContainer, eval) {
   std::vector<double> knotPos;
@@ -66,7 +152,7 @@ TEST(PolynomialSplineContainer, eval) {
   curves::PolynomialSplineContainer polyContainer;
   polyContainer.setData(knotPos, knotVal, initialVelocity, initialAcceleration, finalVelocity, finalAcceleration);
 
-  for (int i=0; i<knotVal.size()-1; i++) {
+  for (size_t i=0; i<knotVal.size()-1; i++) {
     EXPECT_NEAR(knotVal[i], polyContainer.getSpline(i)->getPositionAtTime(0.0), 1e-2 ) << " knot:"  << i;
     EXPECT_NEAR(knotVal[i+1], polyContainer.getSpline(i)->getPositionAtTime(knotPos[i+1]-knotPos[i]), 1e-2) << " knot:"  << i;
   }
@@ -83,3 +169,431 @@ TEST(PolynomialSplineContainer, eval) {
 //  EXPECT_NEAR(finalAcceleration, polyContainer.getSpline(knotVal.size()-2)->getAccelerationAtTime(knotPos[knotPos.size()-1]-knotPos[knotVal.size()-2]), 1e-2 );
 
 }
+
+TEST(PolynomialSplineContainer, sparseMinimumNormSolver) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 2000; ++i) {
+    // Mix short and long splines.
+    knotPos.push_back(i == 0 ? 0.0 : knotPos.back() + (i % 10 == 0 ? 3.0 : 0.05 + 0.01 * (i % 3)));
+    knotVal.push_back(std::sin(0.1 * i));
+  }
+
+  const double initialVelocity = 0.1;
+  const double initialAcceleration = 0.2;
+  const double finalVelocity = 0.3;
+  const double finalAcceleration = 0.4;
+
+  curves::PolynomialSplineContainer polyContainer;
+  polyContainer.setSolverType(curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  EXPECT_TRUE(polyContainer.getSolverType() == curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  polyContainer.setData(knotPos, knotVal, initialVelocity, initialAcceleration, finalVelocity, finalAcceleration);
+  ASSERT_EQ(knotPos.size() - 1, polyContainer.getSplines().size());
+  EXPECT_NEAR(knotPos.back(), polyContainer.getContainerDuration(), 1e-9);
+
+  const curves::PolynomialSplineContainer::SplineList& splines = polyContainer.getSplines();
+  EXPECT_NEAR(initialVelocity, splines.front().getVelocityAtTime(0.0), 1e-6);
+  EXPECT_NEAR(initialAcceleration, splines.front().getAccelerationAtTime(0.0), 1e-6);
+  EXPECT_NEAR(finalVelocity, splines.back().getVelocityAtTime(splines.back().getSplineDuration()), 1e-6);
+  EXPECT_NEAR(finalAcceleration, splines.back().getAccelerationAtTime(splines.back().getSplineDuration()), 1e-6);
+
+  for (size_t i = 0; i < splines.size(); ++i) {
+    const double tf = splines[i].getSplineDuration();
+    EXPECT_NEAR(knotVal[i], splines[i].getPositionAtTime(0.0), 1e-6) << " knot:" << i;
+    EXPECT_NEAR(knotVal[i+1], splines[i].getPositionAtTime(tf), 1e-6) << " knot:" << i;
+    if (i + 1 < splines.size()) {
+      EXPECT_NEAR(splines[i].getVelocityAtTime(tf), splines[i+1].getVelocityAtTime(0.0), 1e-6) << " knot:" << i;
+      EXPECT_NEAR(splines[i].getAccelerationAtTime(tf), splines[i+1].getAccelerationAtTime(0.0), 1e-5) << " knot:" << i;
+    }
+  }
+}
+
+TEST(PolynomialSplineContainer, sparseMinimumNormSolverMatchesDenseAtKnots) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  knotPos.push_back(0.0);
+  knotPos.push_back(1.0);
+  knotPos.push_back(2.5);
+  knotPos.push_back(3.0);
+  knotVal.push_back(0.0);
+  knotVal.push_back(1.0);
+  knotVal.push_back(-1.0);
+  knotVal.push_back(0.5);
+
+  curves::PolynomialSplineContainer dense, sparse;
+  sparse.setSolverType(curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  dense.setData(knotPos, knotVal, 0.1, 0.2, 0.3, 0.4);
+  sparse.setData(knotPos, knotVal, 0.1, 0.2, 0.3, 0.4);
+
+  for (size_t i = 0; i < knotPos.size(); ++i) {
+    EXPECT_NEAR(dense.getPositionAtTime(knotPos[i]), sparse.getPositionAtTime(knotPos[i]), 1e-8) << " knot:" << i;
+  }
+  EXPECT_NEAR(dense.getVelocityAtTime(0.0), sparse.getVelocityAtTime(0.0), 1e-8);
+  EXPECT_NEAR(dense.getEndAcceleration(), sparse.getEndAcceleration(), 1e-8);
+}
+
+TEST(PolynomialSplineContainer, setDataSharedKnots) {
+  std::vector<double> knotPos;
+  knotPos.push_back(0.0);
+  knotPos.push_back(1.0);
+  knotPos.push_back(2.5);
+  knotPos.push_back(3.0);
+  knotPos.push_back(4.2);
+
+  const int nContainers = 3;
+  Eigen::MatrixXd knotVal(knotPos.size(), nContainers);
+  for (size_t i = 0; i < knotPos.size(); ++i) {
+    for (int j = 0; j < nContainers; ++j) {
+      knotVal(i, j) = std::sin(knotPos[i] + j) * (j + 1);
+    }
+  }
+  const Eigen::Vector3d initialVelocities(0.1, -0.2, 0.0);
+  const Eigen::Vector3d initialAccelerations(0.0, 0.3, -0.1);
+  const Eigen::Vector3d finalVelocities(0.2, 0.0, 0.4);
+  const Eigen::Vector3d finalAccelerations(-0.3, 0.1, 0.0);
+
+  const curves::PolynomialSplineContainer::SolverType solverTypes[] = {
+      curves::PolynomialSplineContainer::SolverType::DenseQR,
+      curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm};
+
+  for (const auto solverType : solverTypes) {
+    std::vector<curves::PolynomialSplineContainer> shared(nContainers);
+    std::vector<curves::PolynomialSplineContainer*> sharedPointers;
+    for (auto& container : shared) {
+      container.setSolverType(solverType);
+      sharedPointers.push_back(&container);
+    }
+    curves::PolynomialSplineContainer::setData(knotPos, knotVal, initialVelocities, initialAccelerations,
+                                               finalVelocities, finalAccelerations, sharedPointers);
+
+    for (int j = 0; j < nContainers; ++j) {
+      curves::PolynomialSplineContainer single;
+      single.setSolverType(solverType);
+      std::vector<double> values(knotVal.rows());
+      Eigen::VectorXd::Map(values.data(), values.size()) = knotVal.col(j);
+      single.setData(knotPos, values, initialVelocities(j), initialAccelerations(j),
+                     finalVelocities(j), finalAccelerations(j));
+
+      ASSERT_EQ(single.getSplines().size(), shared[j].getSplines().size());
+      for (double t = 0.0; t <= knotPos.back(); t += 0.1) {
+        EXPECT_NEAR(single.getPositionAtTime(t), shared[j].getPositionAtTime(t), 1e-8) << " time:" << t;
+        EXPECT_NEAR(single.getVelocityAtTime(t), shared[j].getVelocityAtTime(t), 1e-8) << " time:" << t;
+        EXPECT_NEAR(single.getAccelerationAtTime(t), shared[j].getAccelerationAtTime(t), 1e-7) << " time:" << t;
+      }
+    }
+  }
+}
+
+TEST(PolynomialSplineContainer, refitReusesFactorization) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 20; ++i) {
+    knotPos.push_back(0.3*i + 0.01*i*i);
+    knotVal.push_back(std::cos(0.5*i));
+  }
+  std::vector<double> shiftedKnotPos(knotPos);
+  shiftedKnotPos.back() += 0.2;
+
+  const curves::PolynomialSplineContainer::SolverType solverTypes[] = {
+      curves::PolynomialSplineContainer::SolverType::DenseQR,
+      curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm};
+
+  for (const auto solverType : solverTypes) {
+    curves::PolynomialSplineContainer replanned;
+    replanned.setSolverType(solverType);
+    replanned.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+
+    for (int k = 0; k < 3; ++k) {
+      // Same timing with new boundary conditions, then changed timing.
+      const std::vector<double>& positions = (k == 2) ? shiftedKnotPos : knotPos;
+      replanned.setData(positions, knotVal, 0.1*k, -0.2*k, 0.3, 0.4*k);
+
+      curves::PolynomialSplineContainer fresh;
+      fresh.setSolverType(solverType);
+      fresh.setData(positions, knotVal, 0.1*k, -0.2*k, 0.3, 0.4*k);
+
+      ASSERT_EQ(fresh.getSplines().size(), replanned.getSplines().size());
+      for (double t = 0.0; t <= positions.back(); t += 0.05) {
+        EXPECT_NEAR(fresh.getPositionAtTime(t), replanned.getPositionAtTime(t), 1e-10) << " time:" << t;
+        EXPECT_NEAR(fresh.getVelocityAtTime(t), replanned.getVelocityAtTime(t), 1e-10) << " time:" << t;
+      }
+    }
+  }
+}
+
+TEST(PolynomialSplineContainer, binaryFile) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 10; ++i) {
+    knotPos.push_back(0.4*i);
+    knotVal.push_back(std::sin(0.7*i));
+  }
+  curves::PolynomialSplineContainer container;
+  container.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+
+  const std::string filename = "PolynomialSplineContainerTest.bin";
+  ASSERT_TRUE(container.saveBinary(filename));
+
+  curves::MappedCurveFile file;
+  ASSERT_TRUE(file.open(filename));
+  EXPECT_EQ(curves::CurveFileContent::Splines, file.getContent());
+  ASSERT_EQ(container.getSplines().size(), file.size());
+  EXPECT_EQ(container.getSplines()[2].getSplineDuration(), file.getTimes()[2]);
+  EXPECT_EQ(container.getSplines()[2].getCoefficients()[1], file.getValues(2)[1]);
+
+  curves::PolynomialSplineContainer loaded;
+  ASSERT_TRUE(loaded.load(file));
+  EXPECT_EQ(container.getContainerDuration(), loaded.getContainerDuration());
+  for (double t = 0.0; t <= knotPos.back(); t += 0.05) {
+    EXPECT_EQ(container.getPositionAtTime(t), loaded.getPositionAtTime(t)) << " time:" << t;
+    EXPECT_EQ(container.getAccelerationAtTime(t), loaded.getAccelerationAtTime(t)) << " time:" << t;
+  }
+  file.close();
+  std::remove(filename.c_str());
+
+  EXPECT_FALSE(loaded.loadBinary(filename));
+}
+
+TEST(PolynomialSplineContainer, appendKnot) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 6; ++i) {
+    knotPos.push_back(0.5*i);
+    knotVal.push_back(std::sin(0.8*i));
+  }
+  curves::PolynomialSplineContainer container;
+  EXPECT_FALSE(container.appendKnot(0.5, 1.0));
+  container.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+  const double endTime = container.getContainerDuration();
+  const double endAcceleration = container.getEndAcceleration();
+  const double unchangedValue = container.getPositionAtTime(1.3);
+  EXPECT_FALSE(container.appendKnot(0.0, 1.0));
+
+  // The new spline continues the end state and reaches the knot.
+  ASSERT_TRUE(container.appendKnot(0.4, 2.0, 0.5, -1.0));
+  ASSERT_EQ(knotPos.size(), container.getSplines().size());
+  EXPECT_NEAR(endTime + 0.4, container.getContainerDuration(), 1e-12);
+  EXPECT_NEAR(2.0, container.getEndPosition(), 1e-10);
+  EXPECT_NEAR(0.5, container.getEndVelocity(), 1e-10);
+  EXPECT_NEAR(-1.0, container.getEndAcceleration(), 1e-10);
+  const double eps = 1e-7;
+  const curves::PolynomialSplineContainer::SplineType& newSpline = container.getSplines().back();
+  EXPECT_NEAR(container.getPositionAtTime(endTime - eps), newSpline.getPositionAtTime(0.0), 1e-5);
+  EXPECT_NEAR(container.getVelocityAtTime(endTime - eps), newSpline.getVelocityAtTime(0.0), 1e-5);
+  EXPECT_NEAR(endAcceleration, newSpline.getAccelerationAtTime(0.0), 1e-10);
+  EXPECT_EQ(unchangedValue, container.getPositionAtTime(1.3));
+
+  // Refitting a tail window keeps its knots and the state at its beginning.
+  const unsigned int tailWindow = 3;
+  std::vector<double> tailKnotPos;
+  std::vector<double> tailKnotVal;
+  const double tailStart = container.getContainerDuration() - 0.4 - 2*0.5;
+  for (unsigned int i = 0; i <= tailWindow; ++i) {
+    const double t = tailStart + (i < tailWindow ? 0.5*i : 0.5*(i - 1) + 0.4);
+    tailKnotPos.push_back(t);
+    tailKnotVal.push_back(container.getPositionAtTime(t));
+  }
+  const double initialVelocity = container.getVelocityAtTime(tailStart + eps);
+  tailKnotPos.push_back(tailKnotPos.back() + 0.6);
+  tailKnotVal.push_back(-1.0);
+  ASSERT_TRUE(container.appendKnot(0.6, -1.0, 0.0, 0.0, tailWindow));
+  ASSERT_EQ(knotPos.size() + 1, container.getSplines().size());
+  EXPECT_NEAR(-1.0, container.getEndPosition(), 1e-10);
+  EXPECT_NEAR(0.0, container.getEndVelocity(), 1e-10);
+  EXPECT_NEAR(initialVelocity, container.getVelocityAtTime(tailStart + eps), 1e-3);
+  for (size_t i = 0; i < tailKnotPos.size(); ++i) {
+    EXPECT_NEAR(tailKnotVal[i], container.getPositionAtTime(tailKnotPos[i]), 1e-8) << " knot:" << i;
+  }
+  EXPECT_EQ(unchangedValue, container.getPositionAtTime(1.3));
+}
+
+TEST(PolynomialSplineContainer, cubic)
+{
+  std::vector<double> knotPositions;
+  std::vector<double> knotValues;
+  for (int i = 0; i < 12; ++i) {
+    knotPositions.push_back(0.2 * i + 0.01 * i * i);
+    knotValues.push_back(std::cos(2.0 * knotPositions.back()));
+  }
+
+  for (auto solverType : {curves::PolynomialSplineCubicContainer::SolverType::DenseQR,
+                          curves::PolynomialSplineCubicContainer::SolverType::SparseMinimumNorm}) {
+    curves::PolynomialSplineCubicContainer container;
+    container.setSolverType(solverType);
+    container.setData(knotPositions, knotValues, 0.3, 0.0, -0.2, 0.0);
+    ASSERT_EQ(knotPositions.size() - 1, container.getSplines().size());
+    EXPECT_NEAR(0.3, container.getVelocityAtTime(0.0), 1e-8);
+    EXPECT_NEAR(-0.2, container.getVelocityAtTime(container.getContainerDuration()), 1e-8);
+
+    // The knots are met and the velocity is continuous across them.
+    const double eps = 1e-7;
+    for (size_t i = 0; i < knotPositions.size(); ++i) {
+      const double t = knotPositions[i] - knotPositions.front();
+      EXPECT_NEAR(knotValues[i], container.getPositionAtTime(t), 1e-8);
+      if (i > 0 && i + 1 < knotPositions.size()) {
+        EXPECT_NEAR(container.getVelocityAtTime(t - eps), container.getVelocityAtTime(t + eps), 1e-5);
+      }
+    }
+  }
+}
+
+TEST(PolynomialSplineContainer, singlePrecisionSplines)
+{
+  std::vector<double> knotPositions;
+  std::vector<double> knotValues;
+  for (int i = 0; i < 10; ++i) {
+    knotPositions.push_back(0.3 * i);
+    knotValues.push_back(std::sin(knotPositions.back()));
+  }
+
+  curves::PolynomialSplineContainer container;
+  curves::PolynomialSplineContainerf containerf;
+  container.setData(knotPositions, knotValues, 0.5, 0.0, -0.5, 0.0);
+  containerf.setData(knotPositions, knotValues, 0.5, 0.0, -0.5, 0.0);
+  ASSERT_EQ(container.getSplines().size(), containerf.getSplines().size());
+
+  for (double t = 0.0; t <= container.getContainerDuration(); t += 0.05) {
+    const curves::PolynomialSplineContainer::State state = container.evaluateState(t);
+    const curves::PolynomialSplineContainerf::State statef = containerf.evaluateState(t);
+    EXPECT_NEAR(state.position, statef.position, 1e-4);
+    EXPECT_NEAR(state.velocity, statef.velocity, 1e-4);
+    EXPECT_NEAR(state.acceleration, statef.acceleration, 1e-3);
+  }
+}
+
+TEST(PolynomialSplineContainer, bounds)
+{
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 8; ++i) {
+    knotPos.push_back(0.3 * i + 0.05 * i * i);
+    knotVal.push_back(std::sin(1.7 * i));
+  }
+  curves::PolynomialSplineContainer container;
+  container.setData(knotPos, knotVal, 0.5, 0.0, 0.0, 0.0);
+
+  // Compare the bounds of some intervals with dense sampling.
+  const double duration = container.getContainerDuration();
+  const std::vector<std::pair<double, double>> intervals = {
+      {0.0, duration}, {0.1, 0.2}, {0.45, 2.1}, {knotPos[2], knotPos[5]}, {-1.0, 0.7}, {2.5, 10.0}};
+  for (const auto& interval : intervals) {
+    const curves::PolynomialSplineContainer::Bounds bounds = container.getBounds(interval.first, interval.second);
+    const double start = std::max(0.0, interval.first);
+    const double end = std::min(duration, interval.second);
+    curves::PolynomialSplineContainer::State state = container.evaluateState(start);
+    curves::PolynomialSplineContainer::Bounds sampled = {state.position, state.position, state.velocity,
+                                                         state.velocity, state.acceleration, state.acceleration};
+    std::vector<double> times;
+    const int n = 20000;
+    for (int i = 1; i <= n; ++i) {
+      times.push_back(start + (end - start) * i / n);
+    }
+    // The acceleration peaks at the knots.
+    for (const double knot : knotPos) {
+      if (knot > start && knot < end) {
+        times.push_back(knot);
+      }
+    }
+    for (const double time : times) {
+      state = container.evaluateState(time);
+      sampled.merge({state.position, state.position, state.velocity,
+                     state.velocity, state.acceleration, state.acceleration});
+    }
+    EXPECT_NEAR(sampled.minPosition, bounds.minPosition, 1e-6);
+    EXPECT_NEAR(sampled.maxPosition, bounds.maxPosition, 1e-6);
+    EXPECT_NEAR(sampled.minVelocity, bounds.minVelocity, 1e-4);
+    EXPECT_NEAR(sampled.maxVelocity, bounds.maxVelocity, 1e-4);
+    EXPECT_NEAR(sampled.minAcceleration, bounds.minAcceleration, 1e-3);
+    EXPECT_NEAR(sampled.maxAcceleration, bounds.maxAcceleration, 1e-3);
+    EXPECT_LE(bounds.minPosition, sampled.minPosition + 1e-12);
+    EXPECT_GE(bounds.maxPosition, sampled.maxPosition - 1e-12);
+    EXPECT_LE(bounds.minAcceleration, sampled.minAcceleration + 1e-12);
+    EXPECT_GE(bounds.maxAcceleration, sampled.maxAcceleration - 1e-12);
+  }
+
+  // The bounds follow appended and modified splines.
+  ASSERT_TRUE(container.appendKnot(0.5, 3.0));
+  EXPECT_NEAR(3.0, container.getBounds().maxPosition, 1e-9);
+  curves::PolynomialSplineQuintic* spline = container.getSpline(0);
+  spline->setCoefficientsAndDuration(curves::PolynomialSplineQuintic::SplineCoefficients{{0.0, 0.0, 0.0, 0.0, 0.0, -5.0}},
+                                     spline->getSplineDuration());
+  EXPECT_EQ(-5.0, container.getBounds(0.0, knotPos[1]).minPosition);
+  EXPECT_EQ(-5.0, container.getSplineBounds(0).maxPosition);
+}
+
+TEST(PolynomialSplineContainer, snapshot) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 200; ++i) {
+    knotPos.push_back(0.1*i);
+    knotVal.push_back(std::sin(0.3*i));
+  }
+  curves::PolynomialSplineContainer container;
+  container.setSolverType(curves::PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  container.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+  const curves::PolynomialSplineContainer snapshot(container);
+  const double duration = snapshot.getContainerDuration();
+  const double endPosition = snapshot.getEndPosition();
+
+  // Extending and modifying the container leaves the snapshot unchanged.
+  ASSERT_TRUE(container.appendKnot(0.1, 2.0, 0.0, 0.0, 2));
+  container.getSpline(0)->setCoefficientsAndDuration(
+      curves::PolynomialSplineQuintic::SplineCoefficients{{0.0, 0.0, 0.0, 0.0, 0.0, -5.0}},
+      container.getSplines()[0].getSplineDuration());
+  EXPECT_EQ(knotPos.size() - 1, snapshot.getSplines().size());
+  EXPECT_EQ(duration, snapshot.getContainerDuration());
+  EXPECT_EQ(endPosition, snapshot.getEndPosition());
+  EXPECT_NEAR(knotVal[0], snapshot.getPositionAtTime(0.0), 1e-10);
+  EXPECT_EQ(-5.0, container.getPositionAtTime(0.0));
+  EXPECT_NEAR(2.0, container.getEndPosition(), 1e-10);
+  for (size_t i = 0; i < knotPos.size(); ++i) {
+    EXPECT_NEAR(knotVal[i], snapshot.getPositionAtTime(knotPos[i]), 1e-8) << " knot:" << i;
+  }
+
+  // Only the modified chunks are copied.
+  EXPECT_NE(&snapshot.getSplines()[0], &container.getSplines()[0]);
+  EXPECT_EQ(&snapshot.getSplines()[100], &container.getSplines()[100]);
+}
+
+TEST(PolynomialSplineContainer, derivativeAtTimes) {
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 8; ++i) {
+    knotPos.push_back(0.3*i + 0.05*(i % 3));
+    knotVal.push_back(std::cos(0.7*i));
+  }
+  curves::PolynomialSplineContainer container;
+  container.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+  curves::PolynomialSplineContainerf containerf;
+  containerf.setData(knotPos, knotVal, 0.0, 0.0, 0.0, 0.0);
+
+  // Resample at 1 kHz, including times before and after the container.
+  Eigen::ArrayXd times = Eigen::ArrayXd::LinSpaced(2501, -0.1, 2.4);
+  Eigen::ArrayXd positions(times.size()), velocities(times.size()), accelerations(times.size());
+  container.getPositionsAtTimes(times, positions);
+  container.getVelocitiesAtTimes(times, velocities);
+  container.getAccelerationsAtTimes(times, accelerations);
+  for (Eigen::Index i = 0; i < times.size(); ++i) {
+    EXPECT_NEAR(container.getPositionAtTime(times(i)), positions(i), 1e-12) << " time: " << times(i);
+    EXPECT_NEAR(container.getVelocityAtTime(times(i)), velocities(i), 1e-11) << " time: " << times(i);
+    EXPECT_NEAR(container.getAccelerationAtTime(times(i)), accelerations(i), 1e-10) << " time: " << times(i);
+  }
+
+  // Unsorted times are evaluated as well.
+  Eigen::ArrayXd shuffledTimes = times.reverse();
+  Eigen::ArrayXd shuffledPositions(times.size());
+  container.getPositionsAtTimes(shuffledTimes, shuffledPositions);
+  for (Eigen::Index i = 0; i < times.size(); ++i) {
+    EXPECT_NEAR(positions(i), shuffledPositions(times.size() - 1 - i), 1e-12);
+  }
+
+  // Splines of single precision are evaluated in their own scalar type.
+  containerf.getPositionsAtTimes(times, positions);
+  for (Eigen::Index i = 0; i < times.size(); ++i) {
+    EXPECT_EQ(containerf.getPositionAtTime(times(i)), positions(i)) << " time: " << times(i);
+  }
+
+  Eigen::ArrayXd tooFewValues(times.size() - 1);
+  EXPECT_THROW(container.getPositionsAtTimes(times, tooFewValues), std::invalid_argument);
+  EXPECT_THROW(curves::PolynomialSplineContainer().getPositionsAtTimes(times, positions), std::out_of_range);
+}
@@ -195,3 +195,185 @@ TEST(PolynomialSplineQuinticScalarCurveTest, invarianceUnderOffset)
     EXPECT_NEAR(value1, value2 - offset, 1.0e-7);
   }
 }
+
+TEST(PolynomialSplineQuinticScalarCurveTest, batchEvaluation)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  times.push_back(0.5);
+  values.push_back(ValueType(0.0));
+  times.push_back(1.5);
+  values.push_back(ValueType(2.0));
+  times.push_back(2.0);
+  values.push_back(ValueType(-1.0));
+  times.push_back(3.5);
+  values.push_back(ValueType(1.0));
+  curve.fitCurve(times, values);
+
+  // Sorted times, including times outside of the curve and repeated times.
+  std::vector<Time> evaluationTimes;
+  for (double time = 0.0; time <= 4.0; time += 0.05) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.push_back(4.0);
+  // Unsorted times.
+  evaluationTimes.push_back(1.7);
+  evaluationTimes.push_back(0.6);
+
+  std::vector<ValueType> batchValues;
+  std::vector<DerivativeType> batchVelocities, batchAccelerations;
+  ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchVelocities, 1));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchAccelerations, 2));
+  ASSERT_EQ(evaluationTimes.size(), batchValues.size());
+
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType value;
+    DerivativeType velocity, acceleration;
+    ASSERT_TRUE(curve.evaluate(value, evaluationTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(velocity, evaluationTimes[i], 1));
+    ASSERT_TRUE(curve.evaluateDerivative(acceleration, evaluationTimes[i], 2));
+    EXPECT_EQ(value, batchValues[i]) << "time: " << evaluationTimes[i];
+    EXPECT_EQ(velocity, batchVelocities[i]) << "time: " << evaluationTimes[i];
+    EXPECT_EQ(acceleration, batchAccelerations[i]) << "time: " << evaluationTimes[i];
+  }
+}
+
+TEST(PolynomialSplineQuinticScalarCurveTest, evaluateState)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  times.push_back(0.5);
+  values.push_back(ValueType(0.0));
+  times.push_back(1.5);
+  values.push_back(ValueType(2.0));
+  times.push_back(2.0);
+  values.push_back(ValueType(-1.0));
+  times.push_back(3.5);
+  values.push_back(ValueType(1.0));
+  curve.fitCurve(times, values, 0.2, -0.5, 0.1, 0.3);
+
+  for (double time = 0.0; time <= 4.0; time += 0.05) {
+    ValueType value, expectedValue;
+    DerivativeType velocity, acceleration, expectedVelocity, expectedAcceleration;
+    ASSERT_TRUE(curve.evaluateState(value, velocity, acceleration, time));
+    ASSERT_TRUE(curve.evaluate(expectedValue, time));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedVelocity, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedAcceleration, time, 2));
+    EXPECT_NEAR(expectedValue, value, 1e-10) << "time: " << time;
+    EXPECT_NEAR(expectedVelocity, velocity, 1e-10) << "time: " << time;
+    EXPECT_NEAR(expectedAcceleration, acceleration, 1e-10) << "time: " << time;
+  }
+}
+
+TEST(PolynomialSplineQuinticScalarCurveTest, extend)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(0.5);
+  values.push_back(ValueType(0.0));
+  times.push_back(1.5);
+  values.push_back(ValueType(2.0));
+  curve.extend(times, values, NULL);
+  EXPECT_EQ(0.5, curve.getMinTime());
+  EXPECT_EQ(1.5, curve.getMaxTime());
+
+  curve.extend(std::vector<Time>(1, 2.25), std::vector<ValueType>(1, -1.0), NULL);
+  EXPECT_NEAR(2.25, curve.getMaxTime(), 1e-12);
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 2.25));
+  EXPECT_NEAR(-1.0, value, 1e-10);
+  ASSERT_TRUE(curve.evaluate(value, 1.5));
+  EXPECT_NEAR(2.0, value, 1e-10);
+}
+
+TEST(PolynomialSplineQuinticScalarCurveTest, knotDerivatives)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  std::vector<DerivativeType> velocities, accelerations;
+  for (int i = 0; i < 8; ++i) {
+    const Time time = 1.0 + 0.3 * i + 0.05 * i * i;
+    times.push_back(time);
+    values.push_back(std::sin(time));
+    velocities.push_back(std::cos(time));
+    accelerations.push_back(-std::sin(time));
+  }
+  curve.fitCurve(times, values, velocities, accelerations);
+  EXPECT_EQ(times.front(), curve.getMinTime());
+  EXPECT_NEAR(times.back(), curve.getMaxTime(), 1e-12);
+
+  // Every knot is met with its derivatives.
+  for (size_t i = 0; i < times.size(); ++i) {
+    ValueType value;
+    DerivativeType velocity, acceleration;
+    ASSERT_TRUE(curve.evaluateState(value, velocity, acceleration, times[i]));
+    EXPECT_NEAR(values[i], value, 1e-10);
+    EXPECT_NEAR(velocities[i], velocity, 1e-10);
+    EXPECT_NEAR(accelerations[i], acceleration, 1e-10);
+  }
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 2.0));
+  EXPECT_NEAR(std::sin(2.0), value, 1e-4);
+}
+
+TEST(PolynomialSplineQuinticScalarCurveTest, asyncFit)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 5; ++i) {
+    times.push_back(1.0 * i);
+    values.push_back(0.5 * i);
+  }
+  curve.fitCurve(times, values);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(curve.advance(0.01));
+  }
+  EXPECT_NEAR(1.0, curve.getTime(), 1e-10);
+
+  std::vector<Time> newTimes;
+  std::vector<ValueType> newValues;
+  for (int i = 0; i < 6; ++i) {
+    newTimes.push_back(0.5 + 1.0 * i);
+    newValues.push_back(std::sin(newTimes.back()));
+  }
+  PolynomialSplineQuinticScalarCurve expectedCurve;
+  expectedCurve.fitCurve(newTimes, newValues);
+
+  ValueType value, expected;
+  ASSERT_TRUE(curve.fitCurveAsync(newTimes, newValues));
+  EXPECT_FALSE(curve.fitCurveAsync(newTimes, newValues));
+  EXPECT_TRUE(curve.isAsyncFitPending());
+  ASSERT_TRUE(curve.evaluate(value, 2.0));
+  EXPECT_NEAR(1.0, value, 1e-10);
+
+  // The fit is only visible after it has been swapped in, at the same curve time.
+  curve.waitForAsyncFit();
+  EXPECT_EQ(0.0, curve.getMinTime());
+  ASSERT_TRUE(curve.advance(0.01));
+  EXPECT_FALSE(curve.isAsyncFitPending());
+  EXPECT_NEAR(1.01, curve.getTime(), 1e-10);
+  EXPECT_EQ(0.5, curve.getMinTime());
+  for (Time time = 0.5; time <= 5.5; time += 0.1) {
+    ASSERT_TRUE(curve.evaluate(value, time));
+    ASSERT_TRUE(expectedCurve.evaluate(expected, time));
+    EXPECT_NEAR(expected, value, 1e-10);
+  }
+
+  // A copy only has the swapped in curve.
+  ASSERT_TRUE(curve.fitCurveAsync(times, values));
+  PolynomialSplineQuinticScalarCurve copy(curve);
+  EXPECT_FALSE(copy.isAsyncFitPending());
+  EXPECT_FALSE(copy.swapAsyncFit());
+  curve.waitForAsyncFit();
+  EXPECT_TRUE(curve.swapAsyncFit());
+  EXPECT_EQ(0.0, curve.getMinTime());
+  EXPECT_EQ(0.5, copy.getMinTime());
+}
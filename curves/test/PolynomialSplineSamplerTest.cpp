@@ -0,0 +1,81 @@
+/*
+ * PolynomialSplineSamplerTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/PolynomialSplineSampler.hpp"
+
+#include <cmath>
+
+namespace {
+
+template <typename ContainerType>
+void fitContainer(ContainerType& container)
+{
+  std::vector<double> knotPos;
+  std::vector<double> knotVal;
+  for (int i = 0; i < 10; ++i) {
+    knotPos.push_back(0.37 * i + 0.02 * i * i);
+    knotVal.push_back(std::cos(1.3 * i));
+  }
+  container.setData(knotPos, knotVal, 0.2, 0.0, 0.0, 0.0);
+}
+
+template <typename ContainerType>
+void expectSamplerMatchesContainer(const ContainerType& container, double dt, double startTime)
+{
+  curves::PolynomialSplineSampler<ContainerType> sampler(container, dt, startTime);
+  unsigned int numTicks = 0;
+  for (; !sampler.isAtEnd(); ++sampler, ++numTicks) {
+    const double time = startTime + numTicks * dt;
+    EXPECT_DOUBLE_EQ(time, sampler.getTime());
+    const typename ContainerType::State state = container.evaluateState(time);
+    EXPECT_NEAR(state.position, sampler->position, 1e-9);
+    EXPECT_NEAR(state.velocity, sampler->velocity, 1e-8);
+    EXPECT_NEAR(state.acceleration, sampler->acceleration, 1e-7);
+  }
+  EXPECT_EQ(numTicks, sampler.getTick());
+  EXPECT_GT(sampler.getTime(), container.getContainerDuration());
+  EXPECT_LE(sampler.getTime() - dt, container.getContainerDuration());
+
+  // The end state is held.
+  for (int i = 0; i < 3; ++i, ++sampler) {
+    EXPECT_NEAR(container.getEndPosition(), sampler->position, 1e-12);
+    EXPECT_NEAR(container.getEndVelocity(), sampler->velocity, 1e-12);
+    EXPECT_NEAR(container.getEndAcceleration(), sampler->acceleration, 1e-12);
+  }
+}
+
+} // namespace
+
+TEST(PolynomialSplineSampler, quintic)
+{
+  curves::PolynomialSplineContainer container;
+  fitContainer(container);
+  expectSamplerMatchesContainer(container, 0.0025, 0.0);
+  expectSamplerMatchesContainer(container, 0.01, 0.3);
+  // Ticks longer than some of the splines.
+  expectSamplerMatchesContainer(container, 0.5, 0.1);
+}
+
+TEST(PolynomialSplineSampler, cubic)
+{
+  curves::PolynomialSplineCubicContainer container;
+  fitContainer(container);
+  expectSamplerMatchesContainer(container, 0.001, 0.0);
+}
+
+TEST(PolynomialSplineSampler, invalidArguments)
+{
+  curves::PolynomialSplineContainer container;
+  EXPECT_THROW(curves::PolynomialSplineSampler<curves::PolynomialSplineContainer>(container, 0.01),
+               std::invalid_argument);
+  fitContainer(container);
+  EXPECT_THROW(curves::PolynomialSplineSampler<curves::PolynomialSplineContainer>(container, 0.0),
+               std::invalid_argument);
+  EXPECT_THROW(curves::PolynomialSplineSampler<curves::PolynomialSplineContainer>(container, 0.01, -1.0),
+               std::invalid_argument);
+}
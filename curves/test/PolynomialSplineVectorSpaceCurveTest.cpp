@@ -79,3 +79,97 @@ TEST(PolynomialSplineQuinticVector3Curve, Debugging)
 //  EXPECT_EQ(ValueType::Position(), curve.evaluate(1.0).getPosition());
 //  EXPECT_EQ(ValueType::Rotation(), curve.evaluate(1.0).getRotation());
 }
+
+TEST(PolynomialSplineQuinticVector3Curve, BatchEvaluation)
+{
+  PolynomialSplineQuinticVector3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  times.push_back(0.0);
+  values.push_back(ValueType(0.0, 0.0, 0.0));
+  times.push_back(1.0);
+  values.push_back(ValueType(1.0, -2.0, 0.5));
+  times.push_back(2.5);
+  values.push_back(ValueType(-1.0, 3.0, 1.0));
+  times.push_back(3.0);
+  values.push_back(ValueType(0.0, 1.0, 2.0));
+  curve.fitCurve(times, values);
+
+  std::vector<Time> evaluationTimes;
+  for (double time = -0.5; time <= 3.5; time += 0.1) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.push_back(1.2);
+
+  std::vector<ValueType> batchValues, batchDerivatives;
+  ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchDerivatives, 1));
+  ASSERT_EQ(evaluationTimes.size(), batchValues.size());
+
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType value, derivative;
+    ASSERT_TRUE(curve.evaluate(value, evaluationTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, evaluationTimes[i], 1));
+    for (size_t j = 0; j < 3; ++j) {
+      EXPECT_EQ(value[j], batchValues[i][j]) << "time: " << evaluationTimes[i];
+      EXPECT_EQ(derivative[j], batchDerivatives[i][j]) << "time: " << evaluationTimes[i];
+    }
+  }
+}
+
+TEST(PolynomialSplineQuinticVector3Curve, EvaluateState)
+{
+  PolynomialSplineQuinticVector3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+
+  times.push_back(0.0);
+  values.push_back(ValueType(0.0, 0.0, 0.0));
+  times.push_back(1.0);
+  values.push_back(ValueType(1.0, -2.0, 0.5));
+  times.push_back(2.5);
+  values.push_back(ValueType(-1.0, 3.0, 1.0));
+  times.push_back(3.0);
+  values.push_back(ValueType(0.0, 1.0, 2.0));
+  curve.fitCurve(times, values);
+
+  for (double time = -0.5; time <= 3.5; time += 0.1) {
+    ValueType value, expectedValue, velocity, expectedVelocity, acceleration, expectedAcceleration;
+    ASSERT_TRUE(curve.evaluateState(value, velocity, acceleration, time));
+    ASSERT_TRUE(curve.evaluate(expectedValue, time));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedVelocity, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedAcceleration, time, 2));
+    for (size_t j = 0; j < 3; ++j) {
+      EXPECT_NEAR(expectedValue[j], value[j], 1e-10) << "time: " << time;
+      EXPECT_NEAR(expectedVelocity[j], velocity[j], 1e-10) << "time: " << time;
+      EXPECT_NEAR(expectedAcceleration[j], acceleration[j], 1e-10) << "time: " << time;
+    }
+  }
+}
+
+TEST(PolynomialSplineQuinticVector3Curve, SetSplines)
+{
+  PolynomialSplineQuinticVector3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 6; ++i) {
+    times.push_back(0.5 * i);
+    values.push_back(ValueType(std::sin(times.back()), 0.2 * i, std::cos(times.back())));
+  }
+  curve.fitCurve(times, values);
+
+  // The splines are taken over as they are, without a fit.
+  PolynomialSplineQuinticVector3Curve copy;
+  for (size_t j = 0; j < 3; ++j) {
+    copy.setSplines(j, curve.getSplineContainer(j).getSplines(), curve.getMinTime());
+  }
+  EXPECT_EQ(curve.getMinTime(), copy.getMinTime());
+  EXPECT_EQ(curve.getMaxTime(), copy.getMaxTime());
+  for (double time = 0.0; time <= times.back(); time += 0.1) {
+    ValueType value, expectedValue;
+    ASSERT_TRUE(curve.evaluate(expectedValue, time));
+    ASSERT_TRUE(copy.evaluate(value, time));
+    EXPECT_EQ(expectedValue, value) << "time: " << time;
+  }
+}
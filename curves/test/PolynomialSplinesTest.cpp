@@ -11,9 +11,17 @@
 // curves
 #include "curves/polynomial_splines.hpp"
 
+// eigen
+#include <Eigen/QR>
+
 // random number generation
 #include <random>
 
+// stl
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 
 // Construct a random number generator
 std::random_device randomDevice;
@@ -59,3 +67,135 @@ TEST(PolynomialSplines, PolynomialSplinesQuintic)
   EXPECT_NEAR(spline.getAccelerationAtTime(0.0), opts.acc0_, 1e-5);
   EXPECT_NEAR(spline.getAccelerationAtTime(opts.tf_), opts.accT_, 1e-5);
 }
+
+TEST(PolynomialSplines, PolynomialSplinesQuinticEvaluationKernels)
+{
+  curves::PolynomialSplineQuintic spline;
+
+  curves::SplineOptions opts(std::abs(uniformDistribution(randomEngine)) + 0.1,
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine));
+
+  spline.computeCoefficients(opts);
+
+  // Times outside of the spline duration are clamped.
+  const int nTimes = 37;
+  const Eigen::ArrayXd times = Eigen::ArrayXd::LinSpaced(nTimes, -0.1*opts.tf_, 1.1*opts.tf_);
+  Eigen::ArrayXd positions(nTimes), velocities(nTimes), accelerations(nTimes);
+  spline.getPositionAtTimes(times, positions);
+  spline.getVelocityAtTimes(times, velocities);
+  spline.getAccelerationAtTimes(times, accelerations);
+
+  const auto& coefficients = spline.getCoefficients();
+  using SplineImplementation = curves::PolynomialSplineQuintic::SplineImplementation;
+  for (int i = 0; i < nTimes; ++i) {
+    const double t = std::max(0.0, std::min(times(i), opts.tf_));
+    const double position = std::inner_product(coefficients.begin(), coefficients.end(),
+                                               SplineImplementation::tau(t).begin(), 0.0);
+    const double velocity = std::inner_product(coefficients.begin(), coefficients.end(),
+                                               SplineImplementation::dtau(t).begin(), 0.0);
+    const double acceleration = std::inner_product(coefficients.begin(), coefficients.end(),
+                                                   SplineImplementation::ddtau(t).begin(), 0.0);
+    const double tolerance = 1e-9*(1.0 + std::abs(position) + std::abs(velocity) + std::abs(acceleration));
+
+    EXPECT_NEAR(position, spline.getPositionAtTime(times(i)), tolerance);
+    EXPECT_NEAR(velocity, spline.getVelocityAtTime(times(i)), tolerance);
+    EXPECT_NEAR(acceleration, spline.getAccelerationAtTime(times(i)), tolerance);
+    EXPECT_NEAR(position, positions(i), tolerance);
+    EXPECT_NEAR(velocity, velocities(i), tolerance);
+    EXPECT_NEAR(acceleration, accelerations(i), tolerance);
+  }
+}
+
+TEST(PolynomialSplines, PolynomialSplinesSeptic)
+{
+  curves::PolynomialSpline<7> spline;
+
+  curves::SplineOptions opts(std::abs(uniformDistribution(randomEngine)) + 0.1,
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine));
+
+  EXPECT_TRUE(spline.computeCoefficients(opts));
+
+  const double tolerance = 1e-6;
+  EXPECT_NEAR(spline.getPositionAtTime(0.0), opts.pos0_, tolerance);
+  EXPECT_NEAR(spline.getPositionAtTime(opts.tf_), opts.posT_, tolerance);
+
+  EXPECT_NEAR(spline.getVelocityAtTime(0.0), opts.vel0_, tolerance);
+  EXPECT_NEAR(spline.getVelocityAtTime(opts.tf_), opts.velT_, tolerance);
+
+  EXPECT_NEAR(spline.getAccelerationAtTime(0.0), opts.acc0_, tolerance);
+  EXPECT_NEAR(spline.getAccelerationAtTime(opts.tf_), opts.accT_, tolerance);
+
+  // The jerk vanishes at both ends.
+  EXPECT_NEAR(spline.getDerivativeAtTime<3>(0.0), 0.0, tolerance);
+  EXPECT_NEAR(spline.getDerivativeAtTime<3>(opts.tf_), 0.0, tolerance*std::pow(opts.tf_, -3.0));
+}
+
+TEST(PolynomialSplines, PolynomialSplinesQuinticClosedForm)
+{
+  using SplineImplementation = curves::PolynomialSplineQuintic::SplineImplementation;
+  constexpr unsigned int n = SplineImplementation::numCoefficients;
+
+  curves::SplineOptions opts(std::abs(uniformDistribution(randomEngine)) + 0.1,
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine));
+
+  SplineImplementation::SplineCoefficients coefficients;
+  EXPECT_TRUE(SplineImplementation::compute(opts, coefficients));
+
+  // Solve the boundary conditions directly.
+  Eigen::Matrix<double, n, 1> b;
+  b << opts.pos0_, opts.vel0_, opts.acc0_, opts.posT_, opts.velT_, opts.accT_;
+  Eigen::Matrix<double, n, n> A;
+  A << Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::tauZero.data()),
+       Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::dtauZero.data()),
+       Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::ddtauZero.data()),
+       Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::tau(opts.tf_).data()),
+       Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::dtau(opts.tf_).data()),
+       Eigen::Map<const Eigen::Matrix<double, 1, n>>(SplineImplementation::ddtau(opts.tf_).data());
+  const Eigen::Matrix<double, n, 1> expected = A.colPivHouseholderQr().solve(b);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    EXPECT_NEAR(coefficients[k], expected(k), 1e-6*(1.0 + std::abs(expected(k))));
+  }
+
+  // Non-positive durations give a constant spline.
+  opts.tf_ = 0.0;
+  EXPECT_FALSE(SplineImplementation::compute(opts, coefficients));
+  EXPECT_EQ(opts.pos0_, coefficients[n - 1]);
+  EXPECT_EQ(0.0, coefficients[0]);
+}
+
+TEST(PolynomialSplines, PolynomialSplinesQuinticFloat)
+{
+  curves::PolynomialSplineQuintic spline;
+  curves::PolynomialSplineQuinticf splinef;
+
+  curves::SplineOptions opts(std::abs(uniformDistribution(randomEngine)) + 0.5,
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine),
+                             uniformDistribution(randomEngine), uniformDistribution(randomEngine));
+
+  spline.computeCoefficients(opts);
+  splinef.computeCoefficients(opts);
+
+  const int nTimes = 41;
+  const Eigen::ArrayXf times = Eigen::ArrayXf::LinSpaced(nTimes, 0.0f, float(opts.tf_));
+  Eigen::ArrayXf positions(nTimes), velocities(nTimes);
+  splinef.getPositionAtTimes(times, positions);
+  splinef.getVelocityAtTimes(times, velocities);
+
+  for (int i = 0; i < nTimes; ++i) {
+    const double position = spline.getPositionAtTime(times(i));
+    const double velocity = spline.getVelocityAtTime(times(i));
+    const double tolerance = 1e-4*(1.0 + std::abs(position) + std::abs(velocity));
+    EXPECT_NEAR(position, splinef.getPositionAtTime(times(i)), tolerance);
+    EXPECT_NEAR(velocity, splinef.getVelocityAtTime(times(i)), tolerance);
+    EXPECT_NEAR(position, positions(i), tolerance);
+    EXPECT_NEAR(velocity, velocities(i), tolerance);
+  }
+}
@@ -0,0 +1,222 @@
+/*
+ * SE3CompositionCurveTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/SlerpSE3Curve.hpp"
+#include "curves/SE3CompositionCurve.hpp"
+#include <kindr/Core>
+#include <kindr/common/gtest_eigen.hpp>
+#include <thread>
+
+using namespace curves;
+
+typedef SE3CompositionCurve<SlerpSE3Curve, SlerpSE3Curve> CompositionCurve;
+typedef SlerpSE3Curve::ValueType ValueType;
+
+namespace {
+
+void extendTestCurve(CompositionCurve& curve, SlerpSE3Curve& reference)
+{
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i < 6; ++i) {
+    times.push_back(0.5 * i);
+    values.push_back(ValueType(ValueType::Position(1.0 * i, 2.0, -0.5 * i),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.3 * i, 0.2, -0.1 * i))));
+    curve.extend(std::vector<Time>(1, times.back()), std::vector<ValueType>(1, values.back()));
+  }
+  reference.fitCurve(times, values);
+}
+
+void expectNearTransformation(const ValueType& expected, const ValueType& actual, double tolerance)
+{
+  KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), actual.getPosition().vector(),
+                            tolerance, "position");
+  EXPECT_NEAR(0.0, expected.getRotation().getDisparityAngle(actual.getRotation()), tolerance);
+}
+
+} // namespace
+
+TEST(SE3CompositionCurveTest, IdentityCorrections)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+  ASSERT_EQ(6, curve.baseSize());
+
+  ValueType value;
+  for (Time t = 0.0; t <= 2.5; t += 0.1) {
+    ASSERT_TRUE(curve.evaluate(value, t));
+    expectNearTransformation(reference.evaluate(t), value, 1e-9);
+  }
+  EXPECT_FALSE(curve.evaluate(value, 3.0));
+}
+
+TEST(SE3CompositionCurveTest, ModifiedCorrections)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+
+  std::vector<Time> correctionTimes;
+  curve.getCurveTimes(&correctionTimes);
+  ASSERT_LE(2u, correctionTimes.size());
+
+  // Evaluate once to fill the cached segments and corrections.
+  ValueType value;
+  for (Time t = 0.0; t <= 2.5; t += 0.25) {
+    ASSERT_TRUE(curve.evaluate(value, t));
+  }
+
+  const ValueType correction(ValueType::Position(0.5, -1.0, 0.2),
+                             ValueType::Rotation(kindr::EulerAnglesZyxD(0.4, 0.0, 0.1)));
+  curve.setCorrectionCoefficientAtTime(correctionTimes.front(), correction);
+
+  SlerpSE3Curve correctionReference;
+  std::vector<ValueType> correctionValues(correctionTimes.size(), ValueType());
+  correctionValues.front() = correction;
+  correctionReference.fitCurve(correctionTimes, correctionValues);
+
+  // At the base coefficient times all composition strategies give corr(t) * base(t).
+  for (int i = 0; i < 6; ++i) {
+    const Time t = 0.5 * i;
+    ASSERT_TRUE(curve.evaluate(value, t));
+    expectNearTransformation(correctionReference.evaluate(t) * reference.evaluate(t), value, 1e-9);
+  }
+}
+
+TEST(SE3CompositionCurveTest, BatchEvaluation)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+  std::vector<Time> correctionTimes;
+  curve.getCurveTimes(&correctionTimes);
+  curve.setCorrectionCoefficientAtTime(correctionTimes.back(),
+                                       ValueType(ValueType::Position(0.1, 0.2, 0.3),
+                                                 ValueType::Rotation(kindr::EulerAnglesZyxD(-0.2, 0.1, 0.0))));
+
+  std::vector<Time> times;
+  for (int i = 0; i <= 5000; ++i) {
+    times.push_back(2.5 * i / 5000.0);
+  }
+  for (unsigned int numThreads = 1; numThreads <= 4; numThreads += 3) {
+    curve.setNumberOfThreads(numThreads);
+    std::vector<ValueType> values;
+    ASSERT_TRUE(curve.evaluate(times, &values));
+    ASSERT_EQ(times.size(), values.size());
+    ValueType value;
+    for (size_t i = 0; i < times.size(); i += 250) {
+      ASSERT_TRUE(curve.evaluate(value, times[i]));
+      expectNearTransformation(value, values[i], 1e-9);
+    }
+  }
+
+  times.push_back(3.0);
+  std::vector<ValueType> values;
+  EXPECT_FALSE(curve.evaluate(times, &values));
+}
+
+TEST(SE3CompositionCurveTest, TransformPointsFailedEvaluation)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+  std::vector<Time> correctionTimes;
+  curve.getCurveTimes(&correctionTimes);
+  curve.removeCorrectionCoefficientAtTime(correctionTimes.front());
+
+  // The start of the base curve has no correction any more, so the evaluation fails although
+  // the times are within the curve. All points are set to NaN.
+  const Eigen::Matrix3Xd points = Eigen::Matrix3Xd::Random(3, 2);
+  Eigen::Matrix3Xd transformedPoints;
+  EXPECT_FALSE(curve.transformPoints({0.25, 2.0}, points, &transformedPoints));
+  ASSERT_EQ(2, transformedPoints.cols());
+  EXPECT_TRUE(transformedPoints.array().isNaN().all());
+}
+
+TEST(SE3CompositionCurveTest, FoldInCorrections)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+  std::vector<Time> correctionTimes;
+  curve.getCurveTimes(&correctionTimes);
+  curve.setCorrectionCoefficientAtTime(correctionTimes.front(),
+                                       ValueType(ValueType::Position(0.5, -1.0, 0.2),
+                                                 ValueType::Rotation(kindr::EulerAnglesZyxD(0.4, 0.0, 0.1))));
+
+  std::vector<Time> baseTimes;
+  curve.getBaseCurveTimes(&baseTimes);
+  std::vector<ValueType> expected;
+  ASSERT_TRUE(curve.evaluate(baseTimes, &expected));
+
+  curve.foldInCorrections();
+  std::vector<ValueType> values;
+  ASSERT_TRUE(curve.evaluate(baseTimes, &values));
+  for (size_t i = 0; i < baseTimes.size(); ++i) {
+    expectNearTransformation(expected[i], values[i], 1e-9);
+  }
+}
+
+TEST(SE3CompositionCurveTest, ConcurrentEvaluation)
+{
+  CompositionCurve curve;
+  SlerpSE3Curve reference;
+  extendTestCurve(curve, reference);
+  std::vector<Time> correctionTimes;
+  curve.getCurveTimes(&correctionTimes);
+  curve.setCorrectionCoefficientAtTime(correctionTimes.front(),
+                                       ValueType(ValueType::Position(0.5, -1.0, 0.2),
+                                                 ValueType::Rotation(kindr::EulerAnglesZyxD(0.4, 0.0, 0.1))));
+
+  std::vector<Time> times;
+  for (Time t = 0.0; t <= 2.5; t += 0.01) {
+    times.push_back(t);
+  }
+  // The reference values are computed by a copy, so the threads start with an empty cache.
+  const CompositionCurve copy(curve);
+  std::vector<ValueType> expected(times.size());
+  CompositionCurve::Cursor cursor;
+  for (size_t i = 0; i < times.size(); ++i) {
+    ASSERT_TRUE(copy.evaluate(expected[i], times[i], &cursor));
+  }
+
+  // Several threads evaluate one const curve, each with its own cursor or none.
+  const CompositionCurve& sharedCurve = curve;
+  std::vector<std::vector<ValueType> > results(4, std::vector<ValueType>(times.size()));
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); ++t) {
+    threads.push_back(std::thread([&, t]() {
+      CompositionCurve::Cursor threadCursor;
+      for (size_t i = 0; i < times.size(); ++i) {
+        if (t % 2 == 0) {
+          sharedCurve.evaluate(results[t][i], times[i], &threadCursor);
+        } else {
+          sharedCurve.evaluate(results[t][i], times[i]);
+        }
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < results.size(); ++t) {
+    for (size_t i = 0; i < times.size(); ++i) {
+      expectNearTransformation(expected[i], results[t][i], 1e-12);
+    }
+  }
+
+  // Modifying the corrections of a copy leaves the cached corrections of the original.
+  CompositionCurve modified(curve);
+  modified.setCorrectionCoefficientAtTime(correctionTimes.front(), ValueType());
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 0.0));
+  expectNearTransformation(expected.front(), value, 1e-12);
+  ASSERT_TRUE(modified.evaluate(value, 0.0));
+  expectNearTransformation(reference.evaluate(0.0), value, 1e-9);
+}
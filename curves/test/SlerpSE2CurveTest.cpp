@@ -0,0 +1,141 @@
+/*
+ * SlerpSE2CurveTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/SlerpSE2Curve.hpp"
+
+using namespace curves;
+
+typedef curves::SlerpSE2Curve::ValueType ValueType;
+typedef curves::SlerpSE2Curve::DerivativeType DerivativeType;
+
+namespace {
+
+void fitTestCurve(SlerpSE2Curve& curve, std::vector<Time>& times)
+{
+  std::vector<ValueType> values;
+  times.clear();
+  times.push_back(0.0);
+  values.push_back(ValueType(1.0, 2.0, 0.3));
+  times.push_back(1.0);
+  values.push_back(ValueType(2.0, 4.0, 1.5));
+  times.push_back(2.5);
+  values.push_back(ValueType(0.0, 1.0, -2.9));
+  curve.fitCurve(times, values);
+}
+
+} // namespace
+
+TEST(SlerpSE2CurveTest, Evaluate)
+{
+  SlerpSE2Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+  ASSERT_EQ(3, curve.size());
+
+  // Exact at the knots.
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 1.0));
+  EXPECT_DOUBLE_EQ(2.0, value.x());
+  EXPECT_DOUBLE_EQ(4.0, value.y());
+  EXPECT_DOUBLE_EQ(1.5, value.getAngle());
+
+  // The heading is interpolated along the shortest rotation, across pi.
+  const ValueType start = curve.evaluate(1.0);
+  const ValueType end = curve.evaluate(2.5);
+  const double deltaAngle = SE2Transformation::wrapAngle(end.getAngle() - start.getAngle());
+  EXPECT_LT(std::abs(deltaAngle), M_PI);
+  EXPECT_NEAR(0.0, SE2Transformation::wrapAngle(curve.evaluate(1.75).getAngle()
+                                                - (start.getAngle() + 0.5 * deltaAngle)), 1e-12);
+
+  // A pure translation is interpolated linearly.
+  SlerpSE2Curve translation;
+  translation.fitCurve({0.0, 2.0}, {ValueType(0.0, 0.0, 0.5), ValueType(2.0, -4.0, 0.5)});
+  EXPECT_NEAR(1.0, translation.evaluate(1.0).x(), 1e-12);
+  EXPECT_NEAR(-2.0, translation.evaluate(1.0).y(), 1e-12);
+
+  EXPECT_FALSE(curve.evaluate(value, 3.0));
+  EXPECT_EQ(1u, curve.getEvaluationErrorCounters().getCount(EvaluationError::OutOfRange));
+}
+
+TEST(SlerpSE2CurveTest, EvaluateDerivative)
+{
+  SlerpSE2Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  const double h = 1e-6;
+  for (const Time time : {0.2, 0.7, 1.3, 2.2}) {
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 1));
+    const ValueType before = curve.evaluate(time - h);
+    const ValueType after = curve.evaluate(time + h);
+    EXPECT_NEAR((after.x() - before.x()) / (2.0 * h), derivative.x(), 1e-6);
+    EXPECT_NEAR((after.y() - before.y()) / (2.0 * h), derivative.y(), 1e-6);
+    EXPECT_NEAR(SE2Transformation::wrapAngle(after.getAngle() - before.getAngle()) / (2.0 * h), derivative.z(), 1e-6);
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 2));
+    EXPECT_TRUE(derivative.isZero());
+  }
+}
+
+TEST(SlerpSE2CurveTest, EvaluateBatch)
+{
+  SlerpSE2Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  std::vector<Time> queries;
+  for (int i = 0; i <= 50; ++i) {
+    queries.push_back(0.05 * i);
+  }
+  std::vector<ValueType> values;
+  std::vector<DerivativeType> derivatives;
+  ASSERT_TRUE(curve.evaluate(queries, &values));
+  ASSERT_TRUE(curve.evaluateDerivative(queries, &derivatives, 1));
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const ValueType value = curve.evaluate(queries[i]);
+    EXPECT_DOUBLE_EQ(value.x(), values[i].x());
+    EXPECT_DOUBLE_EQ(value.y(), values[i].y());
+    EXPECT_DOUBLE_EQ(value.getAngle(), values[i].getAngle());
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, queries[i], 1));
+    EXPECT_TRUE(derivative.isApprox(derivatives[i]));
+  }
+
+  queries.push_back(3.0);
+  EXPECT_FALSE(curve.evaluate(queries, &values));
+}
+
+TEST(SlerpSE2CurveTest, Extend)
+{
+  SlerpSE2Curve curve;
+  curve.setSamplingRatio(2);
+  for (int i = 0; i < 7; ++i) {
+    curve.extend({double(i)}, {ValueType(i, 0.0, 0.1 * i)});
+  }
+  // The first two measurements are knots, then every second measurement.
+  std::vector<Time> times;
+  curve.getCurveTimes(&times);
+  ASSERT_EQ(5u, times.size());
+  EXPECT_DOUBLE_EQ(6.0, curve.getMaxTime());
+  EXPECT_NEAR(0.6, curve.evaluate(6.0).getAngle(), 1e-12);
+}
+
+TEST(SlerpSE2CurveTest, TransformCurve)
+{
+  SlerpSE2Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+  const ValueType before = curve.evaluate(1.7);
+  const ValueType transform(1.0, -2.0, 2.5);
+  curve.transformCurve(transform);
+  const ValueType expected = transform * before;
+  const ValueType after = curve.evaluate(1.7);
+  EXPECT_NEAR(expected.x(), after.x(), 1e-12);
+  EXPECT_NEAR(expected.y(), after.y(), 1e-12);
+  EXPECT_NEAR(0.0, SE2Transformation::wrapAngle(expected.getAngle() - after.getAngle()), 1e-12);
+}
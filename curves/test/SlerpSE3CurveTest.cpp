@@ -0,0 +1,320 @@
+/*
+ * SlerpSE3CurveTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/SlerpSE3Curve.hpp"
+#include "curves/CurveCursor.hpp"
+#include "curves/ParallelEvaluation.hpp"
+#include <kindr/Core>
+#include <kindr/common/gtest_eigen.hpp>
+#include <cstdio>
+
+using namespace curves;
+
+typedef typename curves::SlerpSE3Curve::ValueType ValueType;
+typedef typename curves::SlerpSE3Curve::DerivativeType DerivativeType;
+typedef typename curves::Time Time;
+
+namespace {
+
+void fitTestCurve(SlerpSE3Curve& curve, std::vector<Time>& times)
+{
+  std::vector<ValueType> values;
+  times.clear();
+  times.push_back(0.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 2.0, 4.0), ValueType::Rotation(kindr::EulerAnglesZyxD(0.3, 0.2, -0.9))));
+  times.push_back(1.0);
+  values.push_back(ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(1.0, 0.5, -1.1))));
+  times.push_back(2.5);
+  values.push_back(ValueType(ValueType::Position(0.0, 1.0, 2.0), ValueType::Rotation(kindr::EulerAnglesZyxD(0.2, -0.5, 0.2))));
+  curve.fitCurve(times, values);
+}
+
+} // namespace
+
+TEST(SlerpSE3CurveTest, Knots)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  ValueType value;
+  ValueType expected;
+  ASSERT_TRUE(curve.evaluate(value, 1.0));
+  expected = ValueType(ValueType::Position(2.0, 4.0, 8.0), ValueType::Rotation(kindr::EulerAnglesZyxD(1.0, 0.5, -1.1)));
+  KINDR_ASSERT_DOUBLE_MX_EQ(expected.getPosition().vector(), value.getPosition().vector(), 1e-6, "position");
+  EXPECT_NEAR(0.0, expected.getRotation().getDisparityAngle(value.getRotation()), 1e-6);
+
+  EXPECT_FALSE(curve.evaluate(value, -0.1));
+  EXPECT_FALSE(curve.evaluate(value, 2.6));
+}
+
+TEST(SlerpSE3CurveTest, PureTranslation)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(0.0);
+  values.push_back(ValueType(ValueType::Position(0.0, 0.0, 0.0), ValueType::Rotation()));
+  times.push_back(2.0);
+  values.push_back(ValueType(ValueType::Position(2.0, -4.0, 1.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+
+  ValueType value;
+  ASSERT_TRUE(curve.evaluate(value, 0.5));
+  KINDR_ASSERT_DOUBLE_MX_EQ(Eigen::Vector3d(0.5, -1.0, 0.25), value.getPosition().vector(), 1e-6, "position");
+
+  DerivativeType derivative;
+  ASSERT_TRUE(curve.evaluateDerivative(derivative, 0.5, 1));
+  KINDR_ASSERT_DOUBLE_MX_EQ(Eigen::Vector3d(1.0, -2.0, 0.5), derivative.getTranslationalVelocity().vector(), 1e-6, "velocity");
+  KINDR_ASSERT_DOUBLE_MX_EQ(Eigen::Vector3d::Zero(), derivative.getRotationalVelocity().vector(), 1e-6, "angular velocity");
+}
+
+TEST(SlerpSE3CurveTest, FiniteDifferences)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  const double h = 1e-6;
+  for (double time = 0.1; time < 2.5; time += 0.2) {
+    ValueType before, after;
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluate(before, time - h));
+    ASSERT_TRUE(curve.evaluate(after, time + h));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, time, 1));
+
+    const Eigen::Vector3d velocity = (after.getPosition().vector() - before.getPosition().vector()) / (2.0 * h);
+    const Eigen::Vector3d angularVelocity = after.getRotation().boxMinus(before.getRotation()) / (2.0 * h);
+    KINDR_ASSERT_DOUBLE_MX_EQ(velocity, derivative.getTranslationalVelocity().vector(), 1e-3, "velocity");
+    KINDR_ASSERT_DOUBLE_MX_EQ(angularVelocity, derivative.getRotationalVelocity().vector(), 1e-3, "angular velocity");
+  }
+}
+
+TEST(SlerpSE3CurveTest, BatchEvaluation)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  std::vector<Time> evaluationTimes;
+  for (double time = 0.0; time <= 2.5; time += 0.05) {
+    evaluationTimes.push_back(time);
+  }
+  evaluationTimes.insert(evaluationTimes.end(), times.begin(), times.end());
+  evaluationTimes.push_back(0.3);
+
+  std::vector<ValueType> batchValues;
+  std::vector<DerivativeType> batchDerivatives;
+  ASSERT_TRUE(curve.evaluate(evaluationTimes, &batchValues));
+  ASSERT_TRUE(curve.evaluateDerivative(evaluationTimes, &batchDerivatives, 1));
+  ASSERT_EQ(evaluationTimes.size(), batchValues.size());
+
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType value;
+    DerivativeType derivative;
+    ASSERT_TRUE(curve.evaluate(value, evaluationTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(derivative, evaluationTimes[i], 1));
+    KINDR_ASSERT_DOUBLE_MX_EQ(value.getPosition().vector(), batchValues[i].getPosition().vector(), 1e-12, "position");
+    EXPECT_NEAR(0.0, value.getRotation().getDisparityAngle(batchValues[i].getRotation()), 1e-12);
+    KINDR_ASSERT_DOUBLE_MX_EQ(derivative.getVector(), batchDerivatives[i].getVector(), 1e-12, "derivative");
+  }
+}
+
+TEST(SlerpSE3CurveTest, Cursor)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+  CurveCursor<SlerpSE3Curve> cursor(curve);
+
+  ValueType value, expected;
+  DerivativeType derivative, expectedDerivative;
+  for (double time = 0.0; time <= 2.5; time += 0.1) {
+    ASSERT_TRUE(cursor.evaluate(value, time));
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+    ASSERT_TRUE(cursor.evaluateDerivative(derivative, time, 1));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, time, 1));
+    EXPECT_EQ(expectedDerivative.getVector(), derivative.getVector());
+  }
+
+  // Going backwards and out of bounds.
+  ASSERT_TRUE(cursor.evaluate(value, 0.2));
+  ASSERT_TRUE(curve.evaluate(expected, 0.2));
+  EXPECT_EQ(expected.getPosition(), value.getPosition());
+  EXPECT_FALSE(cursor.evaluate(value, 3.0));
+
+  // The cursor stays usable while the curve is extended.
+  std::vector<Time> newTimes(1, 3.0);
+  std::vector<ValueType> newValues(1, ValueType(ValueType::Position(1.0, 1.0, 1.0), ValueType::Rotation()));
+  ASSERT_TRUE(cursor.evaluate(value, 2.4));
+  curve.extend(newTimes, newValues);
+  for (double time = 2.4; time <= 3.0; time += 0.1) {
+    ASSERT_TRUE(cursor.evaluate(value, time));
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+  }
+}
+
+TEST(SlerpSE3CurveTest, ParallelEvaluation)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  std::vector<Time> gridTimes;
+  for (int i = 0; i <= 1000; ++i) {
+    gridTimes.push_back(0.0025 * i);
+  }
+  std::vector<ValueType> values;
+  std::vector<DerivativeType> derivatives;
+  ASSERT_TRUE(evaluateInParallel(curve, gridTimes, &values, 4, 64));
+  ASSERT_TRUE(evaluateDerivativeInParallel(curve, gridTimes, 1, &derivatives, 4, 64));
+  ASSERT_EQ(gridTimes.size(), values.size());
+  ASSERT_EQ(gridTimes.size(), derivatives.size());
+  ValueType expected;
+  DerivativeType expectedDerivative;
+  for (size_t i = 0; i < gridTimes.size(); ++i) {
+    ASSERT_TRUE(curve.evaluate(expected, gridTimes[i]));
+    ASSERT_TRUE(curve.evaluateDerivative(expectedDerivative, gridTimes[i], 1));
+    EXPECT_EQ(expected.getPosition(), values[i].getPosition());
+    EXPECT_EQ(expected.getRotation(), values[i].getRotation());
+    EXPECT_EQ(expectedDerivative.getVector(), derivatives[i].getVector());
+  }
+
+  gridTimes.push_back(3.0);
+  EXPECT_FALSE(evaluateInParallel(curve, gridTimes, &values, 4, 64));
+}
+
+TEST(SlerpSE3CurveTest, ErrorCounters)
+{
+  SlerpSE3Curve curve;
+  ValueType value;
+  EXPECT_EQ(EvaluationError::Empty, curve.tryEvaluate(value, 0.0));
+
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  times.push_back(0.0);
+  values.push_back(ValueType());
+  times.push_back(1.0);
+  values.push_back(ValueType(ValueType::Position(1.0, 0.0, 0.0), ValueType::Rotation()));
+  curve.fitCurve(times, values);
+
+  EXPECT_EQ(EvaluationError::None, curve.tryEvaluate(value, 1.0));
+  EXPECT_EQ(EvaluationError::OutOfRange, curve.tryEvaluate(value, 1.0 + 1e-9));
+  EXPECT_FALSE(curve.evaluate(value, 3.0));
+
+  EXPECT_EQ(1u, curve.getEvaluationErrorCounters().getCount(EvaluationError::Empty));
+  EXPECT_EQ(2u, curve.getEvaluationErrorCounters().getCount(EvaluationError::OutOfRange));
+}
+
+TEST(SlerpSE3CurveTest, BinaryFile)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  fitTestCurve(curve, times);
+
+  const std::string filename = "SlerpSE3CurveTest.bin";
+  ASSERT_TRUE(curve.saveCurveBinary(filename));
+  SlerpSE3Curve loaded;
+  ASSERT_TRUE(loaded.loadCurveBinary(filename));
+  for (double time = times.front(); time <= times.back(); time += 0.1) {
+    ValueType expected, value;
+    ASSERT_TRUE(curve.evaluate(expected, time));
+    ASSERT_TRUE(loaded.evaluate(value, time));
+    EXPECT_EQ(expected.getPosition(), value.getPosition());
+    EXPECT_EQ(expected.getRotation(), value.getRotation());
+  }
+
+  // Files of other coefficient types are rejected.
+  CubicHermiteSE3Curve hermiteCurve;
+  EXPECT_FALSE(hermiteCurve.loadCurveBinary(filename));
+  std::remove(filename.c_str());
+}
+
+TEST(SlerpSE3CurveTest, ApproximateInterpolation)
+{
+  SlerpSE3Curve curve;
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  // Segments of up to half a turn.
+  for (int i = 0; i < 6; ++i) {
+    times.push_back(i);
+    values.push_back(ValueType(ValueType::Position(i, 0.5 * i, 0.0),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(0.6 * i * i, 0.3 * i, -0.1 * i))));
+  }
+  curve.fitCurve(times, values);
+  SlerpSE3Curve approximateCurve = curve;
+  approximateCurve.setInterpolationMode(SlerpSE3Curve::InterpolationMode::Approximate);
+  EXPECT_EQ(0.0, SlerpSE3Curve::getMaxAngularError(SlerpSE3Curve::InterpolationMode::Exact));
+  const double maxError = SlerpSE3Curve::getMaxAngularError(SlerpSE3Curve::InterpolationMode::Approximate);
+
+  std::vector<Time> evaluationTimes;
+  for (Time time = 0.0; time <= 5.0; time += 0.01) {
+    evaluationTimes.push_back(time);
+  }
+  std::vector<ValueType> approximateValues;
+  ASSERT_TRUE(approximateCurve.evaluate(evaluationTimes, &approximateValues));
+  for (size_t i = 0; i < evaluationTimes.size(); ++i) {
+    ValueType expected, value;
+    ASSERT_TRUE(curve.evaluate(expected, evaluationTimes[i]));
+    ASSERT_TRUE(approximateCurve.evaluate(value, evaluationTimes[i]));
+    EXPECT_LE(expected.getRotation().getDisparityAngle(value.getRotation()), maxError);
+    EXPECT_EQ(value.getPosition(), approximateValues[i].getPosition());
+    EXPECT_EQ(value.getRotation(), approximateValues[i].getRotation());
+  }
+
+  // Knots are met exactly.
+  ValueType value;
+  ASSERT_TRUE(approximateCurve.evaluate(value, 3.0));
+  EXPECT_EQ(values[3].getPosition(), value.getPosition());
+  EXPECT_EQ(values[3].getRotation(), value.getRotation());
+}
+
+TEST(SlerpSE3CurveTest, Simplify)
+{
+  // Straight pieces sampled densely, with a turn in between.
+  std::vector<Time> times;
+  std::vector<ValueType> values;
+  for (int i = 0; i <= 200; ++i) {
+    const Time time = 0.01 * i;
+    const double yaw = time < 1.0 ? 0.0 : time - 1.0;
+    times.push_back(time);
+    values.push_back(ValueType(ValueType::Position(time, std::max(0.0, time - 1.0), 0.0),
+                               ValueType::Rotation(kindr::EulerAnglesZyxD(yaw, 0.0, 0.0))));
+  }
+  const KnotTolerance tolerance(1e-3, 1e-3);
+  SlerpSE3Curve curve;
+  curve.fitCurve(times, values);
+  const size_t numRemoved = curve.simplify(tolerance);
+  EXPECT_EQ(times.size() - numRemoved, curve.size());
+  EXPECT_LT(curve.size(), times.size() / 4);
+
+  // The curve is streamed with the same tolerance.
+  SlerpSE3Curve streamedCurve;
+  streamedCurve.setSimplificationTolerance(tolerance);
+  for (size_t i = 0; i < times.size(); ++i) {
+    streamedCurve.extend(std::vector<Time>(1, times[i]), std::vector<ValueType>(1, values[i]));
+  }
+  EXPECT_LT(streamedCurve.size(), times.size() / 4);
+
+  for (size_t i = 0; i < times.size(); ++i) {
+    ValueType value, streamedValue;
+    ASSERT_TRUE(curve.evaluate(value, times[i]));
+    ASSERT_TRUE(streamedCurve.evaluate(streamedValue, times[i]));
+    EXPECT_LE((values[i].getPosition() - value.getPosition()).norm(), tolerance.translation);
+    EXPECT_LE(values[i].getRotation().getDisparityAngle(value.getRotation()), tolerance.rotation);
+    EXPECT_LE((values[i].getPosition() - streamedValue.getPosition()).norm(), tolerance.translation);
+    EXPECT_LE(values[i].getRotation().getDisparityAngle(streamedValue.getRotation()), tolerance.rotation);
+  }
+  EXPECT_EQ(times.front(), curve.getMinTime());
+  EXPECT_EQ(times.back(), curve.getMaxTime());
+  EXPECT_EQ(times.back(), streamedCurve.getMaxTime());
+}
@@ -0,0 +1,87 @@
+/*
+ * StaticCurveTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves/PolynomialSplineScalarCurve.hpp"
+#include "curves/PolynomialSplineVectorSpaceCurve.hpp"
+#include "curves/StaticCurve.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+TEST(StaticCurve, Evaluate)
+{
+  PolynomialSplineQuinticVector3Curve curve;
+  std::vector<Time> times;
+  std::vector<PolynomialSplineQuinticVector3Curve::ValueType> values;
+  for (int i = 0; i < 10; ++i) {
+    times.push_back(0.3 * i);
+    values.push_back(Eigen::Vector3d(std::sin(i), std::cos(i), 0.1 * i));
+  }
+  curve.fitCurve(times, values);
+
+  std::vector<Time> queries;
+  for (Time time = 0.0; time <= 2.7; time += 0.01) {
+    queries.push_back(time);
+  }
+  std::vector<PolynomialSplineQuinticVector3Curve::ValueType> expected, staticValues;
+  ASSERT_TRUE(curve.evaluate(queries, &expected));
+  ASSERT_TRUE(evaluateStatic(curve, queries, &staticValues));
+  std::vector<PolynomialSplineQuinticVector3Curve::DerivativeType> expectedDerivatives, staticDerivatives;
+  ASSERT_TRUE(curve.evaluateDerivative(queries, &expectedDerivatives, 1));
+  ASSERT_TRUE(evaluateDerivativeStatic(curve, queries, &staticDerivatives, 1));
+  ASSERT_EQ(queries.size(), staticValues.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    EXPECT_TRUE(expected[i].isApprox(staticValues[i], 1e-12));
+    EXPECT_TRUE(expectedDerivatives[i].isApprox(staticDerivatives[i], 1e-12));
+  }
+}
+
+TEST(StaticCurve, Bounds)
+{
+  PolynomialSplineQuinticScalarCurve curve;
+  std::vector<Time> times;
+  std::vector<double> values;
+  times.push_back(0.0);
+  values.push_back(1.0);
+  times.push_back(1.0);
+  values.push_back(-2.0);
+  times.push_back(2.0);
+  values.push_back(3.0);
+  curve.fitCurve(times, values);
+
+  double lower, upper;
+  ASSERT_TRUE(getBoundsStatic(curve, 201, &lower, &upper));
+  for (Time time = 0.0; time <= 2.0; time += 0.001) {
+    double value;
+    ASSERT_TRUE(curve.evaluate(value, time));
+    EXPECT_LE(lower, value + 1e-3);
+    EXPECT_GE(upper, value - 1e-3);
+  }
+  EXPECT_LE(lower, -2.0);
+  EXPECT_GE(upper, 3.0);
+}
+
+TEST(StaticCurve, ArcLength)
+{
+  // A straight line from the origin to (3, 4, 0), with a speed of zero at the ends.
+  PolynomialSplineQuinticVector3Curve curve;
+  std::vector<Time> times;
+  std::vector<PolynomialSplineQuinticVector3Curve::ValueType> values;
+  times.push_back(0.0);
+  values.push_back(Eigen::Vector3d::Zero());
+  times.push_back(2.0);
+  values.push_back(Eigen::Vector3d(3.0, 4.0, 0.0));
+  curve.fitCurve(times, values);
+
+  double length;
+  ASSERT_TRUE(getArcLengthStatic(curve, 0.0, 2.0, 4, &length));
+  EXPECT_NEAR(5.0, length, 1e-9);
+  ASSERT_TRUE(getArcLengthStatic(curve, 0.0, 1.0, 4, &length));
+  EXPECT_NEAR(2.5, length, 1e-9);
+}
@@ -0,0 +1,76 @@
+/*
+ * StaticPolynomialSplineContainerTest.cpp
+ *
+ *  Created on: Oct 14, 2026
+ */
+
+// Lets the test forbid allocations by Eigen.
+#define EIGEN_RUNTIME_NO_MALLOC
+
+#include <gtest/gtest.h>
+
+#include "curves/PolynomialSplineContainer.hpp"
+#include "curves/StaticPolynomialSplineContainer.hpp"
+
+#include <cmath>
+#include <memory>
+
+using namespace curves;
+
+typedef StaticPolynomialSplineContainer<PolynomialSplineQuintic, 8> StaticContainer;
+
+TEST(StaticPolynomialSplineContainer, setData)
+{
+  std::vector<double> knotPositions;
+  std::vector<double> knotValues;
+  for (int i = 0; i < 7; ++i) {
+    knotPositions.push_back(0.1 * i + 0.02 * i * i);
+    knotValues.push_back(std::sin(3.0 * knotPositions.back()));
+  }
+
+  std::unique_ptr<StaticContainer> container(new StaticContainer());
+  Eigen::internal::set_is_malloc_allowed(false);
+  const bool success = container->setData(knotPositions, knotValues, 0.5, -1.0, 0.2, 0.0);
+  Eigen::internal::set_is_malloc_allowed(true);
+  ASSERT_TRUE(success);
+  ASSERT_EQ(knotPositions.size() - 1, container->size());
+  EXPECT_NEAR(knotPositions.back() - knotPositions.front(), container->getContainerDuration(), 1e-12);
+
+  // Same splines as the minimum norm fit of the dynamic container.
+  PolynomialSplineContainer reference;
+  reference.setSolverType(PolynomialSplineContainer::SolverType::SparseMinimumNorm);
+  reference.setData(knotPositions, knotValues, 0.5, -1.0, 0.2, 0.0);
+  for (double t = -0.1; t < container->getContainerDuration() + 0.1; t += 0.013) {
+    EXPECT_NEAR(reference.getPositionAtTime(t), container->getPositionAtTime(t), 1e-8);
+    EXPECT_NEAR(reference.getVelocityAtTime(t), container->getVelocityAtTime(t), 1e-7);
+    EXPECT_NEAR(reference.getAccelerationAtTime(t), container->getAccelerationAtTime(t), 1e-6);
+    const StaticContainer::State state = container->evaluateState(t);
+    EXPECT_EQ(container->getPositionAtTime(t), state.position);
+  }
+  EXPECT_NEAR(0.5, container->getVelocityAtTime(0.0), 1e-8);
+  EXPECT_NEAR(-1.0, container->getAccelerationAtTime(0.0), 1e-8);
+  for (size_t i = 0; i < knotPositions.size(); ++i) {
+    EXPECT_NEAR(knotValues[i], container->getPositionAtTime(knotPositions[i] - knotPositions.front()), 1e-8);
+  }
+}
+
+TEST(StaticPolynomialSplineContainer, capacity)
+{
+  std::unique_ptr<StaticContainer> container(new StaticContainer());
+  std::vector<double> knotPositions(10);
+  std::vector<double> knotValues(10, 1.0);
+  for (size_t i = 0; i < knotPositions.size(); ++i) {
+    knotPositions[i] = i;
+  }
+  EXPECT_FALSE(container->setData(knotPositions, knotValues, 0.0, 0.0, 0.0, 0.0));
+  EXPECT_TRUE(container->isEmpty());
+
+  knotPositions.resize(9);
+  knotValues.resize(9);
+  EXPECT_TRUE(container->setData(knotPositions, knotValues, 0.0, 0.0, 0.0, 0.0));
+  EXPECT_NEAR(1.0, container->getPositionAtTime(4.5), 1e-8);
+  EXPECT_FALSE(container->addSpline(container->getSpline(0)));
+
+  knotPositions[3] = knotPositions[2];
+  EXPECT_FALSE(container->setData(knotPositions, knotValues, 0.0, 0.0, 0.0, 0.0));
+}
@@ -6,21 +6,31 @@
 
 #include <gtest/gtest.h>
 #include <curves/LocalSupport2CoefficientManager.hpp>
+#include <curves/ChunkedVector.hpp>
+#include <curves/DenseKeyIndex.hpp>
+#include <curves/KeyGenerator.hpp>
+#include <curves/NodePoolAllocator.hpp>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
 
 using namespace curves;
 
+typedef Eigen::Matrix<double,3,1> Coefficient;
+
+template <class Manager>
 class LocalSupport2CoefficientManagerTest : public ::testing::Test {
  protected:
 
-  typedef Eigen::Matrix<double,3,1> Coefficient;
-  typedef LocalSupport2CoefficientManager<Coefficient>::CoefficientIter CoefficientIter;
+  typedef typename Manager::CoefficientIter CoefficientIter;
 
   virtual void SetUp() {
     N = 50;
     for(size_t i = 0; i < N; ++i) {
       coefficients.push_back(Coefficient::Random(3));
       // Make sure there are some negative times in there
-      times.push_back(i * 1000 - 3250);
+      times.push_back(curves::Time(i) * 1000 - 3250);
       keys1.push_back( manager1.insertCoefficient(times[i], coefficients[i]) );
     }
     manager2.insertCoefficients(times, coefficients, &keys2);
@@ -44,104 +54,710 @@ class LocalSupport2CoefficientManagerTest : public ::testing::Test {
   std::vector<curves::Time> times2;
   std::vector<curves::Key> keys1;
   std::vector<curves::Key> keys2;
-  LocalSupport2CoefficientManager<Coefficient> manager1;
-  LocalSupport2CoefficientManager<Coefficient> manager2;
+  Manager manager1;
+  Manager manager2;
 
 };
 
-TEST_F(LocalSupport2CoefficientManagerTest, testInsert) {
+typedef ::testing::Types<
+    LocalSupport2CoefficientManager<Coefficient>,
+    LocalSupport2CoefficientManager<Coefficient, MapCoefficientStorage<Coefficient, NodePoolAllocator<Coefficient> > >,
+    LocalSupport2CoefficientManager<Coefficient, SortedArrayCoefficientStorage<Coefficient> >,
+    LocalSupport2CoefficientManager<Coefficient, NanosecondCoefficientStorage<Coefficient> >,
+    LocalSupport2CoefficientManager<Coefficient, CopyOnWriteCoefficientStorage<Coefficient> > > Managers;
+TYPED_TEST_CASE(LocalSupport2CoefficientManagerTest, Managers);
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testInsert) {
 
-  ASSERT_EQ(N, manager1.size());
-  ASSERT_EQ(N, manager2.size());
+  ASSERT_EQ(this->N, this->manager1.size());
+  ASSERT_EQ(this->N, this->manager2.size());
 
-  ASSERT_EQ(N, keys1.size());
-  ASSERT_EQ(N, keys2.size());
+  ASSERT_EQ(this->N, this->keys1.size());
+  ASSERT_EQ(this->N, this->keys2.size());
 
-  ASSERT_EQ(N, times1.size());
-  ASSERT_EQ(N, times2.size());
+  ASSERT_EQ(this->N, this->times1.size());
+  ASSERT_EQ(this->N, this->times2.size());
 
-  for(size_t i = 0; i < N; ++i) {
-    ASSERT_EQ(times1[i], times[i]);
-    ASSERT_EQ(times2[i], times[i]);
+  for(size_t i = 0; i < this->N; ++i) {
+    ASSERT_EQ(this->times1[i], this->times[i]);
+    ASSERT_EQ(this->times2[i], this->times[i]);
   }
 
-  ASSERT_EXIT(manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
-  ASSERT_EXIT(manager2.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+  ASSERT_EXIT(this->manager2.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
 }
 
 
-TEST_F(LocalSupport2CoefficientManagerTest, testTimes) {
-  CoefficientIter bracket0;
-  CoefficientIter bracket1;
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testTimes) {
+  typename TestFixture::CoefficientIter bracket0;
+  typename TestFixture::CoefficientIter bracket1;
   bool success = false;
   curves::Time etime;
 
-  etime = times[0] - 1;
-  success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+  etime = this->times[0] - 1;
+  success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
   ASSERT_FALSE(success) << "Eval at time " << etime;
 
-  etime = times[0] - 100;
-  success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+  etime = this->times[0] - 100;
+  success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
   ASSERT_FALSE(success) << "Eval at time " << etime;
 
-  etime = times[N-1];
-  success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+  etime = this->times[this->N-1];
+  success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
   ASSERT_TRUE(success) << "Eval at time " << etime;
-  ASSERT_EQ(times[N-2],bracket0->first) << "index " << N-2 << ", time: " << etime;
-  ASSERT_EQ(times[N-1],bracket1->first) << "index " << N-1 << ", time: " << etime;
+  ASSERT_EQ(this->times[this->N-2],bracket0->first) << "index " << this->N-2 << ", time: " << etime;
+  ASSERT_EQ(this->times[this->N-1],bracket1->first) << "index " << this->N-1 << ", time: " << etime;
 
-  etime = times[N-1] + 1;
-  success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+  etime = this->times[this->N-1] + 1;
+  success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
   ASSERT_FALSE(success) << "Eval at time " << etime;
 
-  etime = times[N-1] + 100;
-  success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+  etime = this->times[this->N-1] + 100;
+  success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
   ASSERT_FALSE(success) << "Eval at time " << etime;
 
-  for(size_t i = 1; i < times.size(); ++i) {
+  for(size_t i = 1; i < this->times.size(); ++i) {
 
-    etime = times[i-1];
-    success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+    etime = this->times[i-1];
+    success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
     ASSERT_TRUE(success) << "Eval at time " << etime;
-    ASSERT_EQ(times[i-1],bracket0->first) << "index " << i << ", time: " << etime;
-    ASSERT_EQ(times[i],bracket1->first) << "index " << i << ", time: " << etime;
+    ASSERT_EQ(this->times[i-1],bracket0->first) << "index " << i << ", time: " << etime;
+    ASSERT_EQ(this->times[i],bracket1->first) << "index " << i << ", time: " << etime;
 
-    etime = (times[i-1] + times[i]) / 2;
-    success = manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
+    etime = (this->times[i-1] + this->times[i]) / 2;
+    success = this->manager1.getCoefficientsAt(etime, &bracket0, &bracket1);
     ASSERT_TRUE(success) << "Eval at time " << etime;
-    ASSERT_EQ(times[i-1],bracket0->first) << "index " << i << ", time: " << etime;
-    ASSERT_EQ(times[i],bracket1->first) << "index " << i << ", time: " << etime;
+    ASSERT_EQ(this->times[i-1],bracket0->first) << "index " << i << ", time: " << etime;
+    ASSERT_EQ(this->times[i],bracket1->first) << "index " << i << ", time: " << etime;
 
 
   }
 
 }
 
-TEST_F(LocalSupport2CoefficientManagerTest, testGetCoefficientsInRange) {
-  // \todo Abel and Renaud
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testGetCoefficientsInRange) {
+  typedef typename TypeParam::CoefficientMap CoefficientMap;
+  typedef typename TypeParam::CoefficientRange CoefficientRange;
+
+  // From the coefficient at or before the start to the first one at or after the end.
+  CoefficientMap coefficients;
+  this->manager1.getCoefficientsInRange(this->times[3] + 500, this->times[7], &coefficients);
+  ASSERT_EQ(5u, coefficients.size());
+  CoefficientRange range = this->manager1.getCoefficientRange(this->times[3] + 500, this->times[7]);
+  ASSERT_EQ(5, std::distance(range.begin(), range.end()));
+  size_t i = 3;
+  for (typename TestFixture::CoefficientIter it = range.begin(); it != range.end(); ++it, ++i) {
+    ASSERT_EQ(this->times[i], it->first);
+    ASSERT_EQ(this->keys1[i], it->second.key);
+    ASSERT_EQ(this->coefficients[i], coefficients[it->second.key]);
+  }
+
+  // Ranges beyond the curve are clamped.
+  range = this->manager1.getCoefficientRange(this->times[this->N - 2] + 1, this->times[this->N - 1] + 1000);
+  ASSERT_EQ(2, std::distance(range.begin(), range.end()));
+  range = this->manager1.getCoefficientRange(this->times[this->N - 1] + 1, this->times[this->N - 1] + 1000);
+  ASSERT_TRUE(range.empty());
+  range = this->manager1.getCoefficientRange(this->times[5], this->times[4]);
+  ASSERT_TRUE(range.empty());
+
+  range = this->manager1.getCoefficientRange();
+  ASSERT_EQ(this->N, size_t(std::distance(range.begin(), range.end())));
+  ASSERT_EQ(this->times[0], range.front().first);
+  ASSERT_EQ(this->times[this->N - 1], range.back().first);
+
+  TypeParam empty;
+  ASSERT_TRUE(empty.getCoefficientRange(0, 10).empty());
+  coefficients.clear();
+  empty.getCoefficientsInRange(0, 10, &coefficients);
+  ASSERT_TRUE(coefficients.empty());
 }
 
-TEST_F(LocalSupport2CoefficientManagerTest, testUpdateCoefficients) {
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testUpdateCoefficients) {
 
-  for (size_t i = 0; i < keys1.size(); ++i) {
-    manager1.updateCoefficientByKey(keys1[i], Coefficient::Zero());
-    ASSERT_EQ(manager1.getCoefficientByKey(keys1[i]), Coefficient::Zero());
+  for (size_t i = 0; i < this->keys1.size(); ++i) {
+    this->manager1.updateCoefficientByKey(this->keys1[i], Coefficient::Zero());
+    ASSERT_EQ(this->manager1.getCoefficientByKey(this->keys1[i]), Coefficient::Zero());
   }
 
   typedef boost::unordered_map<curves::Key, Coefficient> CoefficientMap;
   CoefficientMap allCoeffs;
-  for (size_t i = 0; i < keys2.size(); ++i) {
-    std::pair<curves::Key, Coefficient> pair = std::make_pair(keys2[i], Coefficient::Zero());
+  for (size_t i = 0; i < this->keys2.size(); ++i) {
+    std::pair<curves::Key, Coefficient> pair = std::make_pair(this->keys2[i], Coefficient::Zero());
     allCoeffs.insert(pair);
   }
 
-  manager2.updateCoefficients(allCoeffs);
-  for (size_t i = 0; i < keys2.size(); ++i) {
-    ASSERT_EQ(manager2.getCoefficientByKey(keys2[i]), Coefficient::Zero());
+  this->manager2.updateCoefficients(allCoeffs);
+  for (size_t i = 0; i < this->keys2.size(); ++i) {
+    ASSERT_EQ(this->manager2.getCoefficientByKey(this->keys2[i]), Coefficient::Zero());
+  }
+
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testUpdateCoefficientValues) {
+  const size_t stamp = this->manager1.getCoefficientStamp();
+  const size_t revision = this->manager1.getRevision();
+  this->manager1.updateCoefficientValues([](Coefficient& coefficient) {
+    coefficient = 2.0 * coefficient + Coefficient::Ones();
+  }, 4);
+  ASSERT_EQ(revision, this->manager1.getRevision());
+  ASSERT_NE(stamp, this->manager1.getCoefficientStamp());
+  ASSERT_EQ(this->N, this->manager1.size());
+  for (size_t i = 0; i < this->keys1.size(); ++i) {
+    ASSERT_EQ(this->manager1.getCoefficientByKey(this->keys1[i]), 2.0 * this->coefficients[i] + Coefficient::Ones());
+    ASSERT_EQ(this->times[i], this->manager1.getCoefficientTimeByKey(this->keys1[i]));
+  }
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testRemoveCoefficientsIf) {
+  // Remove every other coefficient, the others keep their keys.
+  size_t i = 0;
+  const size_t revision = this->manager1.getRevision();
+  const size_t count = this->manager1.removeCoefficientsIf([&i](curves::Time, const Coefficient&) {
+    return i++ % 2 == 1;
+  });
+  ASSERT_EQ(this->N, i);
+  ASSERT_EQ(this->N / 2, count);
+  ASSERT_NE(revision, this->manager1.getRevision());
+  ASSERT_EQ(this->N - count, this->manager1.size());
+  for (size_t j = 0; j < this->N; ++j) {
+    ASSERT_EQ(j % 2 == 0, this->manager1.hasCoefficientWithKey(this->keys1[j]));
+    ASSERT_EQ(j % 2 == 0, this->manager1.hasCoefficientAtTime(this->times[j]));
+    if (j % 2 == 0) {
+      ASSERT_EQ(this->coefficients[j], this->manager1.getCoefficientByKey(this->keys1[j]));
+    }
+  }
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+
+  ASSERT_EQ(0u, this->manager2.removeCoefficientsIf([](curves::Time, const Coefficient&) { return false; }));
+  ASSERT_EQ(this->N, this->manager2.size());
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testRemoveCoefficients) {
+  // Remove every other coefficient, alternating between removal by key and by time.
+  for (size_t i = 0; i < this->N; i += 2) {
+    if (i % 4 == 0) {
+      this->manager1.removeCoefficientWithKey(this->keys1[i]);
+    } else {
+      this->manager1.removeCoefficientAtTime(this->times[i]);
+    }
+  }
+  ASSERT_EQ(this->N / 2, this->manager1.size());
+  for (size_t i = 0; i < this->N; ++i) {
+    ASSERT_EQ(i % 2 == 1, this->manager1.hasCoefficientWithKey(this->keys1[i])) << "index " << i;
+    ASSERT_EQ(i % 2 == 1, this->manager1.hasCoefficientAtTime(this->times[i])) << "index " << i;
+    if (i % 2 == 1) {
+      ASSERT_EQ(this->coefficients[i], this->manager1.getCoefficientByKey(this->keys1[i]));
+      ASSERT_EQ(this->times[i], this->manager1.getCoefficientTimeByKey(this->keys1[i]));
+    }
+  }
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testUnevenInsertions) {
+  // Uneven spacing and insertions in random order exercise the lookups away from
+  // the evenly spaced case.
+  TypeParam manager;
+  std::vector<curves::Time> sortedTimes;
+  std::vector<curves::Key> keys;
+  for (size_t i = 0; i < this->N; ++i) {
+    const curves::Time time = (i * 7919) % this->N;
+    sortedTimes.push_back(time * time * 0.25);
+    keys.push_back(manager.insertCoefficient(sortedTimes.back(), Coefficient::Constant(time)));
+  }
+  std::sort(sortedTimes.begin(), sortedTimes.end());
+  std::vector<curves::Time> managerTimes;
+  manager.getTimes(&managerTimes);
+  ASSERT_EQ(sortedTimes, managerTimes);
+
+  typename TestFixture::CoefficientIter bracket0, bracket1;
+  for (size_t i = 1; i < sortedTimes.size(); ++i) {
+    const curves::Time etime = 0.3 * sortedTimes[i-1] + 0.7 * sortedTimes[i];
+    ASSERT_TRUE(manager.getCoefficientsAt(etime, &bracket0, &bracket1));
+    ASSERT_EQ(sortedTimes[i-1], bracket0->first) << "index " << i;
+    ASSERT_EQ(sortedTimes[i], bracket1->first) << "index " << i;
+  }
+
+  // Moving a coefficient keeps its key.
+  typename TypeParam::TimeToKeyCoefficientMap::iterator it = manager.coefficientBegin();
+  const curves::Key key = it->second.key;
+  manager.modifyCoefficient(it, sortedTimes.back() + 1.0, Coefficient::Zero());
+  ASSERT_EQ(sortedTimes.back() + 1.0, manager.getMaxTime());
+  ASSERT_EQ(sortedTimes[1], manager.getMinTime());
+  ASSERT_EQ(sortedTimes.back() + 1.0, manager.getCoefficientTimeByKey(key));
+  ASSERT_EQ(Coefficient::Zero(), manager.getCoefficientByKey(key));
+
+  // Overwriting the coefficient at an existing time keeps its key.
+  ASSERT_EQ(key, manager.insertCoefficient(sortedTimes.back() + 1.0, Coefficient::Ones()));
+  ASSERT_EQ(this->N, manager.size());
+  ASSERT_EXIT(manager.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testCursor) {
+  typename TypeParam::Cursor cursor;
+  typename TestFixture::CoefficientIter bracket0, bracket1;
+
+  for (size_t i = 1; i < this->N; ++i) {
+    const curves::Time etime = 0.5 * (this->times[i-1] + this->times[i]);
+    ASSERT_TRUE(this->manager1.getCoefficientsAt(etime, &cursor, &bracket0, &bracket1));
+    ASSERT_EQ(this->times[i-1], bracket0->first) << "index " << i;
+    ASSERT_EQ(this->times[i], bracket1->first) << "index " << i;
   }
+  ASSERT_FALSE(this->manager1.getCoefficientsAt(this->times.back() + 1, &cursor, &bracket0, &bracket1));
+
+  // A structural change must make the cursor search again.
+  ASSERT_TRUE(this->manager1.getCoefficientsAt(this->times[1], &cursor, &bracket0, &bracket1));
+  const size_t revision = this->manager1.getRevision();
+  const curves::Time insertedTime = 0.5 * (this->times[1] + this->times[2]);
+  this->manager1.insertCoefficient(insertedTime, Coefficient::Zero());
+  ASSERT_LT(revision, this->manager1.getRevision());
+  ASSERT_TRUE(this->manager1.getCoefficientsAt(insertedTime + 1, &cursor, &bracket0, &bracket1));
+  ASSERT_EQ(insertedTime, bracket0->first);
+  ASSERT_EQ(this->times[2], bracket1->first);
+}
 
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testInterleavedKeys) {
+  // Curves built at the same time share the KeyGenerator, their keys interleave.
+  TypeParam managers[2];
+  std::vector<Key> keys[2];
+  for (size_t i = 0; i < 1000; ++i) {
+    for (size_t m = 0; m < 2; ++m) {
+      keys[m].push_back(managers[m].insertCoefficient(curves::Time(i), Coefficient::Constant(double(m))));
+    }
+  }
+  // A large gap, e.g. from keys handed out to many other curves.
+  KeyGenerator::reserveKeys(1000000);
+  for (size_t m = 0; m < 2; ++m) {
+    keys[m].push_back(managers[m].insertCoefficient(curves::Time(1000), Coefficient::Constant(double(m))));
+  }
+
+  for (size_t m = 0; m < 2; ++m) {
+    ASSERT_EQ(keys[m].size(), managers[m].size());
+    for (size_t i = 0; i < keys[m].size(); ++i) {
+      ASSERT_TRUE(managers[m].hasCoefficientWithKey(keys[m][i]));
+      ASSERT_FALSE(managers[1 - m].hasCoefficientWithKey(keys[m][i]));
+      ASSERT_EQ(Coefficient::Constant(double(m)), managers[m].getCoefficientByKey(keys[m][i]));
+      ASSERT_EQ(curves::Time(i), managers[m].getCoefficientTimeByKey(keys[m][i]));
+    }
+  }
+
+  // The keys keep working when coefficients are removed again.
+  for (size_t i = 0; i < keys[0].size(); i += 2) {
+    managers[0].removeCoefficientWithKey(keys[0][i]);
+  }
+  for (size_t i = 0; i < keys[0].size(); ++i) {
+    ASSERT_EQ(i % 2 == 1, managers[0].hasCoefficientWithKey(keys[0][i]));
+  }
 }
 
-TEST_F(LocalSupport2CoefficientManagerTest, testRemoveCoefficients) {
-  // \todo Abel and Renaud
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testCursorOnCopy) {
+  // A cursor filled from one manager must not be reused with a copy, whose iterators differ.
+  TypeParam empty, emptyCopy(empty);
+  ASSERT_NE(empty.getRevision(), emptyCopy.getRevision());
+  TypeParam copy(this->manager1);
+  ASSERT_NE(this->manager1.getRevision(), copy.getRevision());
+  const size_t revision = this->manager2.getRevision();
+  this->manager2 = this->manager1;
+  ASSERT_LT(revision, this->manager2.getRevision());
+  ASSERT_NE(this->manager1.getRevision(), this->manager2.getRevision());
+  ASSERT_NE(copy.getRevision(), this->manager2.getRevision());
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testInsertCoefficientsKeepsExistingKeys) {
+  // Reinserting at existing times updates the coefficients and keeps their keys.
+  std::vector<Coefficient> newCoefficients;
+  for (size_t i = 0; i < this->N; ++i) {
+    newCoefficients.push_back(Coefficient::Random(3));
+  }
+  std::vector<Key> keys;
+  this->manager2.insertCoefficients(this->times, newCoefficients, &keys);
+  ASSERT_EQ(this->N, this->manager2.size());
+  ASSERT_EQ(this->keys2, keys);
+  for (size_t i = 0; i < this->N; ++i) {
+    ASSERT_EQ(newCoefficients[i], this->manager2.getCoefficientByKey(keys[i]));
+  }
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testInsertSortedCoefficients) {
+  // A sorted batch before, between, at and after the existing times is merged in one pass.
+  std::vector<Time> times;
+  std::vector<Coefficient> newCoefficients;
+  times.push_back(this->times.front() - 10.0);
+  for (size_t i = 0; i < this->N; ++i) {
+    if (i % 5 == 0) {
+      times.push_back(this->times[i]);
+    }
+    if (i % 2 == 0) {
+      times.push_back(this->times[i] + 500.0);
+    }
+  }
+  times.push_back(this->times.back() + 10.0);
+  for (size_t i = 0; i < times.size(); ++i) {
+    newCoefficients.push_back(Coefficient::Random(3));
+  }
+
+  const size_t revision = this->manager1.getRevision();
+  std::vector<Key> keys;
+  this->manager1.insertCoefficients(times, newCoefficients, &keys);
+  ASSERT_LT(revision, this->manager1.getRevision());
+  ASSERT_EQ(times.size(), keys.size());
+  ASSERT_EQ(this->N + times.size() - this->N / 5, this->manager1.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    ASSERT_EQ(times[i], this->manager1.getCoefficientTimeByKey(keys[i]));
+    ASSERT_EQ(newCoefficients[i], this->manager1.getCoefficientByKey(keys[i]));
+  }
+  for (size_t i = 0; i < this->N; i += 5) {
+    ASSERT_EQ(this->keys1[i], keys[std::find(times.begin(), times.end(), this->times[i]) - times.begin()]);
+  }
+  std::vector<Time> allTimes;
+  this->manager1.getTimes(&allTimes);
+  ASSERT_TRUE(std::adjacent_find(allTimes.begin(), allTimes.end(), std::greater_equal<Time>()) == allTimes.end());
+  ASSERT_EQ(this->times[1], this->manager1.getCoefficientTimeByKey(this->keys1[1]));
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+
+  // Times after the curve are appended.
+  std::vector<Time> laterTimes(3, this->times.back() + 20.0);
+  laterTimes[1] += 1.0;
+  laterTimes[2] += 2.0;
+  keys.clear();
+  this->manager1.insertCoefficients(laterTimes, std::vector<Coefficient>(3, Coefficient::Zero()), &keys);
+  ASSERT_EQ(laterTimes.back(), this->manager1.getMaxTime());
+  ASSERT_EQ(laterTimes[1], this->manager1.getCoefficientTimeByKey(keys[1]));
+}
+
+TEST(NanosecondCoefficientStorage, insertSortedCoefficientsAtRoundedTimes) {
+  // The merge matches existing times in the rounded nanosecond keys, like the lookups do.
+  LocalSupport2CoefficientManager<Coefficient, NanosecondCoefficientStorage<Coefficient> > manager;
+  std::vector<Key> keys;
+  manager.insertCoefficients({0.1, 0.3, 0.5}, std::vector<Coefficient>(3, Coefficient::Zero()), &keys);
+  const Time roundedTime = 0.1 * 3;
+  ASSERT_NE(0.3, roundedTime);
+  std::vector<Key> newKeys;
+  manager.insertCoefficients({0.2, roundedTime, 0.4}, std::vector<Coefficient>(3, Coefficient::Ones()), &newKeys);
+  ASSERT_EQ(5u, manager.size());
+  ASSERT_EQ(keys[1], newKeys[1]);
+  ASSERT_EQ(Coefficient::Ones(), manager.getCoefficientByKey(keys[1]));
+  ASSERT_EQ(Coefficient::Zero(), manager.getCoefficientByKey(keys[2]));
+  ASSERT_EXIT(manager.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testCoefficientStamp) {
+  // Copies share the stamp until one of them changes.
+  TypeParam copy(this->manager1);
+  const size_t stamp = this->manager1.getCoefficientStamp();
+  ASSERT_EQ(stamp, copy.getCoefficientStamp());
+  ASSERT_NE(stamp, this->manager2.getCoefficientStamp());
+
+  // Value changes are no structural changes but still give a new stamp.
+  const size_t revision = copy.getRevision();
+  copy.updateCoefficientByKey(this->keys1[0], Coefficient::Zero());
+  ASSERT_EQ(revision, copy.getRevision());
+  ASSERT_NE(stamp, copy.getCoefficientStamp());
+  ASSERT_EQ(stamp, this->manager1.getCoefficientStamp());
+
+  const size_t valueStamp = copy.getCoefficientStamp();
+  copy.removeCoefficientAtTime(this->times[1]);
+  ASSERT_NE(valueStamp, copy.getCoefficientStamp());
+  ASSERT_NE(stamp, copy.getCoefficientStamp());
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testWindow) {
+  TypeParam& manager = this->manager1;
+  const size_t windowSize = 10;
+  manager.setWindow(0.0, windowSize);
+  ASSERT_EQ(windowSize, manager.size());
+  ASSERT_EQ(this->times[this->N - windowSize], manager.getMinTime());
+
+  // Appending evicts the oldest coefficients, the others keep their keys.
+  for (size_t i = 0; i < 3 * windowSize; ++i) {
+    const curves::Time time = manager.getMaxTime() + 1000;
+    const Coefficient coefficient = Coefficient::Random(3);
+    const curves::Key key = manager.insertCoefficient(time, coefficient);
+    ASSERT_EQ(windowSize, manager.size());
+    ASSERT_EQ(coefficient, manager.getCoefficientByKey(key));
+  }
+  for (size_t i = this->N - 1; i > this->N - windowSize; --i) {
+    ASSERT_FALSE(manager.hasCoefficientWithKey(this->keys1[i]));
+  }
+  ASSERT_EXIT(manager.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+
+  // The duration limit keeps the coefficient at or before the start of the window.
+  manager.setWindow(2500.0);
+  ASSERT_EQ(4u, manager.size());
+  typename TestFixture::CoefficientIter bracket0, bracket1;
+  ASSERT_TRUE(manager.getCoefficientsAt(manager.getMaxTime() - 2500.0, &bracket0, &bracket1));
+
+  manager.setWindow(0.0);
+  const curves::Time maxTime = manager.getMaxTime();
+  manager.removeCoefficientsBefore(maxTime);
+  ASSERT_EQ(1u, manager.size());
+  ASSERT_EQ(maxTime, manager.getMinTime());
+  ASSERT_EXIT(manager.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TYPED_TEST(LocalSupport2CoefficientManagerTest, testResetCoefficients) {
+  // Sorted times are appended in one pass and get fresh keys.
+  std::vector<Key> keys;
+  this->manager1.resetCoefficients(this->times, this->coefficients, &keys);
+  ASSERT_EQ(this->N, this->manager1.size());
+  ASSERT_EQ(this->N, keys.size());
+  for (size_t i = 0; i < this->N; ++i) {
+    ASSERT_FALSE(this->manager1.hasCoefficientWithKey(this->keys1[i]));
+    ASSERT_EQ(this->coefficients[i], this->manager1.getCoefficientByKey(keys[i]));
+  }
+  std::vector<curves::Time> times;
+  this->manager1.getTimes(&times);
+  ASSERT_EQ(this->times, times);
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+
+  // Unsorted times fall back to regular insertion.
+  std::vector<curves::Time> reversedTimes(this->times.rbegin(), this->times.rend());
+  std::vector<Coefficient> reversedCoefficients(this->coefficients.rbegin(), this->coefficients.rend());
+  keys.clear();
+  this->manager1.resetCoefficients(reversedTimes, reversedCoefficients, &keys);
+  ASSERT_EQ(this->N, this->manager1.size());
+  for (size_t i = 0; i < this->N; ++i) {
+    ASSERT_EQ(reversedCoefficients[i], this->manager1.getCoefficientByKey(keys[i]));
+  }
+  this->manager1.getTimes(&times);
+  ASSERT_EQ(this->times, times);
+  ASSERT_EXIT(this->manager1.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TEST(NanosecondCoefficientStorage, epochTimes) {
+  LocalSupport2CoefficientManager<Coefficient, NanosecondCoefficientStorage<Coefficient> > manager;
+  const curves::Time epoch = 1476403200.0;
+  std::vector<curves::Time> times;
+  std::vector<Coefficient> coefficients;
+  for (int i = 0; i < 10; ++i) {
+    times.push_back(epoch + 0.1 * i);
+    coefficients.push_back(Coefficient::Constant(i));
+  }
+  std::vector<Key> keys;
+  manager.insertCoefficients(times, coefficients, &keys);
+  ASSERT_EQ(10u, manager.size());
+
+  // A time off by less than half a nanosecond is the same knot.
+  const curves::Time nearTime = times[3] + 2e-10;
+  ASSERT_TRUE(manager.hasCoefficientAtTime(nearTime));
+  ASSERT_EQ(keys[3], manager.insertCoefficient(nearTime, Coefficient::Zero()));
+  ASSERT_EQ(10u, manager.size());
+  ASSERT_FALSE(manager.hasCoefficientAtTime(times[3] + 1e-6));
+
+  typename LocalSupport2CoefficientManager<Coefficient, NanosecondCoefficientStorage<Coefficient> >::CoefficientIter
+      it0, it1;
+  ASSERT_TRUE(manager.getCoefficientsAt(times[9], &it0, &it1));
+  ASSERT_EQ(keys[8], it0->second.key);
+  ASSERT_EQ(keys[9], it1->second.key);
+  ASSERT_TRUE(manager.getCoefficientsAt(epoch + 0.45, &it0, &it1));
+  ASSERT_EQ(keys[4], it0->second.key);
+  ASSERT_FALSE(manager.getCoefficientsAt(times[9] + 1e-6, &it0, &it1));
+  ASSERT_NEAR(times[5], manager.getCoefficientTimeByKey(keys[5]), 1e-9);
+}
+
+TEST(CopyOnWriteCoefficientStorage, snapshots) {
+  typedef LocalSupport2CoefficientManager<Coefficient, CopyOnWriteCoefficientStorage<Coefficient> > Manager;
+  Manager manager;
+  std::vector<curves::Time> times;
+  std::vector<Coefficient> coefficients;
+  for (int i = 0; i < 200; ++i) {
+    times.push_back(i);
+    coefficients.push_back(Coefficient::Constant(i));
+  }
+  std::vector<Key> keys;
+  manager.insertCoefficients(times, coefficients, &keys);
+
+  // Extending and modifying the manager leaves the snapshot unchanged.
+  const Manager snapshot(manager);
+  const auto getFirst = [](const Manager& manager) { return &manager.coefficientBegin()->second.coefficient; };
+  const Coefficient* first = getFirst(snapshot);
+  ASSERT_EQ(first, getFirst(manager));
+  manager.addCoefficientAtEnd(200.0, Coefficient::Constant(200.0));
+  manager.updateCoefficientByKey(keys[199], Coefficient::Zero());
+  ASSERT_EQ(201u, manager.size());
+  ASSERT_EQ(200u, snapshot.size());
+  ASSERT_EQ(Coefficient::Constant(199.0), snapshot.getCoefficientByKey(keys[199]));
+  ASSERT_EQ(Coefficient::Zero(), manager.getCoefficientByKey(keys[199]));
+  ASSERT_DOUBLE_EQ(199.0, snapshot.getMaxTime());
+
+  // The chunks of the first coefficients are still shared.
+  ASSERT_EQ(first, getFirst(manager));
+
+  // Updating all coefficients in parallel copies the shared chunks first.
+  manager.updateCoefficientValues([](Coefficient& coefficient) { coefficient *= 2.0; }, 4);
+  ASSERT_EQ(Coefficient::Constant(2.0), manager.getCoefficientByKey(keys[1]));
+  ASSERT_EQ(Coefficient::Constant(1.0), snapshot.getCoefficientByKey(keys[1]));
+  ASSERT_EXIT(snapshot.checkInternalConsistency(true), ::testing::ExitedWithCode(0), "^");
+}
+
+TEST(CopyOnWriteCoefficientStorage, constReadsKeepChunksShared) {
+  typedef LocalSupport2CoefficientManager<Coefficient, CopyOnWriteCoefficientStorage<Coefficient> > Manager;
+  typedef Manager::TimeToKeyCoefficientMap::iterator MutableIter;
+  Manager manager;
+  std::vector<curves::Time> times;
+  std::vector<Coefficient> coefficients;
+  for (int i = 0; i < 200; ++i) {
+    times.push_back(i);
+    coefficients.push_back(Coefficient::Constant(i));
+  }
+  manager.insertCoefficients(times, coefficients);
+  const Manager snapshot(manager);
+
+  // Reading the non-const manager through const iterators does not copy any chunk.
+  double sum = 0.0;
+  for (Manager::CoefficientIter it = manager.coefficientBegin(); it != Manager::CoefficientIter(manager.coefficientEnd()); ++it) {
+    sum += it->second.coefficient(0);
+  }
+  ASSERT_DOUBLE_EQ(199.0 * 200.0 / 2.0, sum);
+  ASSERT_EQ(&snapshot.coefficientBegin()->second.coefficient, &Manager::CoefficientIter(manager.coefficientBegin())->second.coefficient);
+  ASSERT_EQ(&(snapshot.coefficientEnd() - 1)->second.coefficient,
+            &(Manager::CoefficientIter(manager.coefficientEnd()) - 1)->second.coefficient);
+
+  // Dereferencing a mutable iterator copies its chunk only.
+  const MutableIter last = manager.coefficientEnd() - 1;
+  last->second.coefficient = Coefficient::Zero();
+  ASSERT_NE(&(snapshot.coefficientEnd() - 1)->second.coefficient,
+            &(Manager::CoefficientIter(manager.coefficientEnd()) - 1)->second.coefficient);
+  ASSERT_EQ(&snapshot.coefficientBegin()->second.coefficient, &Manager::CoefficientIter(manager.coefficientBegin())->second.coefficient);
+  ASSERT_EQ(Coefficient::Constant(199.0), (snapshot.coefficientEnd() - 1)->second.coefficient);
+}
+
+TEST(ChunkedVector, copyOnWrite) {
+  typedef ChunkedVector<int, 4> Vector;
+  Vector vector;
+  for (int i = 0; i < 10; ++i) {
+    vector.push_back(i);
+  }
+  const Vector copy(vector);
+  ASSERT_TRUE(copy.isShared(0));
+  vector[9] = -9;
+  ASSERT_EQ(9, copy[9]);
+  const Vector& constVector = vector;
+  ASSERT_EQ(&copy[0], &constVector[0]);
+  ASSERT_NE(&copy[9], &constVector[9]);
+
+  // Erasing at the front and inserting in the middle keep the order.
+  vector.erase(vector.begin(), vector.begin() + 5);
+  vector.insert(vector.begin() + 2, 2, 100);
+  vector.insert(vector.begin(), 3, -1);
+  const std::vector<int> expected = {-1, -1, -1, 5, 6, 100, 100, 7, 8, -9};
+  ASSERT_EQ(expected, std::vector<int>(vector.begin(), vector.end()));
+  vector.erase(vector.begin() + 3);
+  vector.resize(3);
+  ASSERT_EQ(std::vector<int>(3, -1), std::vector<int>(vector.begin(), vector.end()));
+  ASSERT_EQ(10u, copy.size());
+  ASSERT_EQ(0, copy.front());
+  ASSERT_THROW(copy.at(10), std::out_of_range);
+}
+
+TEST(NodePoolAllocator, reuse) {
+  NodePoolAllocator<Coefficient> allocator;
+  Coefficient* a = allocator.allocate(1);
+  Coefficient* b = allocator.allocate(1);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(0u, reinterpret_cast<size_t>(b) % 16);
+  allocator.deallocate(a, 1);
+  ASSERT_EQ(a, allocator.allocate(1));
+
+  // Rebinds share the pool, copies of containers do not.
+  NodePoolAllocator<double> rebound(allocator);
+  ASSERT_TRUE(rebound == allocator);
+  ASSERT_FALSE(allocator.select_on_container_copy_construction() == allocator);
+  allocator.deallocate(a, 1);
+  allocator.deallocate(b, 1);
+}
+
+TEST(DenseKeyIndex, slidingWindow) {
+  DenseKeyIndex<int> index;
+  ASSERT_TRUE(index.find(0) == NULL);
+
+  // Keys after the current range, with a gap.
+  index.set(100, 0);
+  index.set(105, 5);
+  ASSERT_EQ(2u, index.size());
+  ASSERT_FALSE(index.isSparse());
+  ASSERT_EQ(0, *index.find(100));
+  ASSERT_EQ(5, *index.find(105));
+  ASSERT_TRUE(index.find(99) == NULL);
+  ASSERT_TRUE(index.find(106) == NULL);
+  index.set(105, 6);
+  ASSERT_EQ(2u, index.size());
+  ASSERT_EQ(6, *index.find(105));
+
+  // Slide a window over the keys.
+  index.erase(105);
+  for (Key key = 101; key < 1000; ++key) {
+    index.set(key, key - 100);
+    index.erase(key - 1);
+    ASSERT_EQ(1u, index.size());
+    ASSERT_FALSE(index.isSparse());
+    ASSERT_EQ(static_cast<int>(key - 100), *index.find(key));
+    ASSERT_TRUE(index.find(key - 1) == NULL);
+  }
+  index.erase(999);
+  ASSERT_TRUE(index.empty());
+  ASSERT_TRUE(index.find(999) == NULL);
+}
+
+TEST(DenseKeyIndex, sparseKeys) {
+  DenseKeyIndex<int, ChunkedVector<int>, ChunkedVector<unsigned char> > index;
+
+  // A key before the range is hashed instead of moving all slots.
+  index.set(100, 0);
+  index.set(101, 1);
+  index.set(98, -2);
+  ASSERT_TRUE(index.isSparse());
+  ASSERT_EQ(3u, index.size());
+  ASSERT_EQ(-2, *index.find(98));
+  ASSERT_EQ(1, *index.find(101));
+  ASSERT_TRUE(index.find(99) == NULL);
+  index.erase(98);
+  index.erase(100);
+  index.erase(101);
+  ASSERT_TRUE(index.empty());
+  ASSERT_FALSE(index.isSparse());
+
+  // Keys far apart are hashed once the slots would outnumber them more than 4 to 1.
+  for (Key key = 0; key < 64; key += 16) {
+    index.set(key, static_cast<int>(key));
+  }
+  ASSERT_FALSE(index.isSparse());
+  for (Key key = 64; key < 100000; key += 16) {
+    index.set(key, static_cast<int>(key));
+  }
+  ASSERT_TRUE(index.isSparse());
+  ASSERT_EQ(6250u, index.size());
+  for (Key key = 0; key < 100000; ++key) {
+    const int* value = index.find(key);
+    ASSERT_EQ(key % 16 == 0, value != NULL) << key;
+    if (value != NULL) {
+      ASSERT_EQ(static_cast<int>(key), *value);
+    }
+  }
+}
+
+TEST(KeyGenerator, reserveKeys) {
+  const Key first = KeyGenerator::reserveKeys(10);
+  const Key next = KeyGenerator::getNextKey();
+  ASSERT_LE(first + 10, next);
+
+  // Keys handed out concurrently are unique.
+  const size_t nThreads = 4;
+  const size_t nKeys = 1000;
+  std::vector<std::vector<Key> > keys(nThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nThreads; ++t) {
+    threads.push_back(std::thread([&keys, t, nKeys]() {
+      for (size_t i = 0; i < nKeys; ++i) {
+        keys[t].push_back(KeyGenerator::getNextKey());
+      }
+    }));
+  }
+  std::vector<Key> allKeys;
+  for (size_t t = 0; t < nThreads; ++t) {
+    threads[t].join();
+    allKeys.insert(allKeys.end(), keys[t].begin(), keys[t].end());
+  }
+  std::sort(allKeys.begin(), allKeys.end());
+  ASSERT_TRUE(std::adjacent_find(allKeys.begin(), allKeys.end()) == allKeys.end());
+  ASSERT_LT(next, allKeys.front());
 }
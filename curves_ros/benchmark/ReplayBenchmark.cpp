@@ -0,0 +1,316 @@
+/*
+ * ReplayBenchmark.cpp
+ *
+ *  Created on: Oct 15, 2026
+ *
+ *  Replays recorded trajectories through the ingestion paths of the curves and interleaves
+ *  the queries of a controller, then reports throughput, tail latency and peak memory:
+ *
+ *    curves_ros_replay_benchmark --bag trajectories.bag
+ *    curves_ros_replay_benchmark --poses poses.txt --sampling-ratio 4 --window 10
+ *
+ *  Every JointTrajectory and MultiDOFJointTrajectory message of the bag is read with
+ *  fromMessage(), and the curves are queried at the control rate over the horizon of the
+ *  message. Every line "time x y z qw qx qy qz" of a pose log is added with extend() to a
+ *  CubicHermiteSE3Curve and a SlerpSE3Curve, which are queried at the control rate slightly
+ *  in the past, as an estimator would be.
+ */
+
+// Curves
+#include <curves/CubicHermiteSE3Curve.hpp>
+#include <curves/SlerpSE3Curve.hpp>
+#include <curves_ros/RosJointTrajectoryInterface.hpp>
+#include <curves_ros/RosMultiDOFJointTrajectoryInterface.hpp>
+
+// ROS
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+
+// STD
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// POSIX
+#include <sys/resource.h>
+
+using namespace curves;
+
+namespace {
+
+struct Options
+{
+  std::string bagFile;
+  std::string posesFile;
+  //! Rate of the controller queries [Hz].
+  double queryRate = 400.0;
+  //! Delay of the queries behind the latest pose [s].
+  double queryLag = 0.01;
+  //! Number of times the recording is replayed.
+  int repetitions = 1;
+  //! See CubicHermiteSE3Curve::setSamplingRatio.
+  int samplingRatio = 1;
+  //! See CubicHermiteSE3Curve::setMinSamplingPeriod.
+  double minSamplingPeriod = 0.0;
+  //! See CubicHermiteSE3Curve::setWindow, 0 to keep the whole curve.
+  double window = 0.0;
+};
+
+/*!
+ * Latencies of one kind of operation.
+ */
+class LatencyRecorder
+{
+ public:
+  explicit LatencyRecorder(const std::string& name) : name_(name), units_(0) {}
+
+  //! Add the latency of one operation on units items, e.g. the points of a message.
+  void add(double seconds, size_t units = 1)
+  {
+    latencies_.push_back(seconds);
+    units_ += units;
+  }
+
+  void print() const
+  {
+    if (latencies_.empty()) return;
+    std::vector<double> sorted(latencies_);
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (const double latency : sorted) total += latency;
+    std::printf("%-28s %10zu ops %12.0f units/s   p50 %9.3f us   p99 %9.3f us   p99.9 %9.3f us   max %9.3f us\n",
+                name_.c_str(), sorted.size(), total > 0.0 ? units_ / total : 0.0,
+                1e6 * getPercentile(sorted, 0.5), 1e6 * getPercentile(sorted, 0.99),
+                1e6 * getPercentile(sorted, 0.999), 1e6 * sorted.back());
+  }
+
+ private:
+  static double getPercentile(const std::vector<double>& sorted, double percentile)
+  {
+    const size_t i = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+  }
+
+  std::string name_;
+  std::vector<double> latencies_;
+  size_t units_;
+};
+
+/*!
+ * Measures the duration of the scope into a recorder.
+ */
+class ScopedLatency
+{
+ public:
+  ScopedLatency(LatencyRecorder& recorder, size_t units = 1)
+      : recorder_(recorder), units_(units), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedLatency()
+  {
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+    recorder_.add(duration.count(), units_);
+  }
+
+ private:
+  LatencyRecorder& recorder_;
+  size_t units_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+//! Peak resident memory of the process [kB].
+long getPeakMemory()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void replayBag(const Options& options)
+{
+  std::vector<trajectory_msgs::JointTrajectory> jointTrajectories;
+  std::vector<trajectory_msgs::MultiDOFJointTrajectory> multiDofTrajectories;
+  rosbag::Bag bag(options.bagFile, rosbag::bagmode::Read);
+  for (const rosbag::MessageInstance& instance : rosbag::View(bag)) {
+    const auto jointTrajectory = instance.instantiate<trajectory_msgs::JointTrajectory>();
+    if (jointTrajectory) jointTrajectories.push_back(*jointTrajectory);
+    const auto multiDofTrajectory = instance.instantiate<trajectory_msgs::MultiDOFJointTrajectory>();
+    if (multiDofTrajectory) multiDofTrajectories.push_back(*multiDofTrajectory);
+  }
+  std::printf("Replaying %zu JointTrajectory and %zu MultiDOFJointTrajectory messages.\n",
+              jointTrajectories.size(), multiDofTrajectories.size());
+
+  LatencyRecorder jointIngestion("JointTrajectory fromMessage");
+  LatencyRecorder jointQueries("JointTrajectory evaluate");
+  LatencyRecorder multiDofIngestion("MultiDOF fromMessage");
+  LatencyRecorder multiDofQueries("MultiDOF evaluate");
+  const double period = 1.0 / options.queryRate;
+
+  std::vector<RosJointTrajectoryInterface> jointCurves;
+  std::vector<RosMultiDOFJointTrajectoryInterface> multiDofCurves;
+  for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+    for (const auto& message : jointTrajectories) {
+      bool success;
+      {
+        ScopedLatency latency(jointIngestion, message.points.size());
+        success = RosJointTrajectoryInterface::fromMessage(message, jointCurves);
+      }
+      if (!success || jointCurves.empty()) continue;
+      // A controller tracks all joints at every tick until the next message arrives.
+      const Time maxTime = jointCurves[0].getMaxTime();
+      for (Time time = jointCurves[0].getMinTime(); time <= maxTime; time += period) {
+        ScopedLatency latency(jointQueries, jointCurves.size());
+        for (const auto& curve : jointCurves) {
+          double position, velocity, acceleration;
+          curve.evaluateState(position, velocity, acceleration, time);
+        }
+      }
+    }
+    for (const auto& message : multiDofTrajectories) {
+      bool success;
+      {
+        ScopedLatency latency(multiDofIngestion, message.points.size());
+        success = RosMultiDOFJointTrajectoryInterface::fromMessage(message, multiDofCurves);
+      }
+      if (!success || multiDofCurves.empty()) continue;
+      const Time maxTime = multiDofCurves[0].getMaxTime();
+      for (Time time = multiDofCurves[0].getMinTime(); time <= maxTime; time += period) {
+        ScopedLatency latency(multiDofQueries, multiDofCurves.size());
+        for (const auto& curve : multiDofCurves) {
+          CubicHermiteSE3Curve::ValueType pose;
+          CubicHermiteSE3Curve::DerivativeType twist;
+          curve.evaluate(pose, time);
+          curve.evaluateDerivative(twist, time, 1);
+        }
+      }
+    }
+  }
+
+  jointIngestion.print();
+  jointQueries.print();
+  multiDofIngestion.print();
+  multiDofQueries.print();
+}
+
+bool readPoses(const std::string& filename, std::vector<Time>& times,
+               std::vector<SE3Curve::ValueType>& poses)
+{
+  std::ifstream file(filename);
+  if (!file) return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream stream(line);
+    double time, x, y, z, qw, qx, qy, qz;
+    if (!(stream >> time >> x >> y >> z >> qw >> qx >> qy >> qz)) return false;
+    times.push_back(time);
+    poses.push_back(SE3Curve::ValueType(SE3Curve::ValueType::Position(x, y, z),
+                                        SE3Curve::ValueType::Rotation(Eigen::Quaterniond(qw, qx, qy, qz).normalized())));
+  }
+  return true;
+}
+
+/*!
+ * Extend the curve with every pose, querying it at the control rate in between.
+ */
+template <typename CurveType>
+void replayPoses(const Options& options, const std::vector<Time>& times,
+                 const std::vector<SE3Curve::ValueType>& poses, const std::string& name)
+{
+  LatencyRecorder ingestion(name + " extend");
+  LatencyRecorder queries(name + " evaluate");
+  const double period = 1.0 / options.queryRate;
+  size_t maxSize = 0;
+
+  for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+    CurveType curve;
+    curve.setSamplingRatio(options.samplingRatio);
+    curve.setMinSamplingPeriod(options.minSamplingPeriod);
+    if (options.window > 0.0) curve.setWindow(options.window);
+
+    Time queryTime = times.empty() ? 0.0 : times.front();
+    std::vector<Time> time(1);
+    std::vector<SE3Curve::ValueType> pose(1);
+    for (size_t i = 0; i < times.size(); ++i) {
+      time[0] = times[i];
+      pose[0] = poses[i];
+      {
+        ScopedLatency latency(ingestion);
+        curve.extend(time, pose);
+      }
+      maxSize = std::max(maxSize, static_cast<size_t>(curve.size()));
+      // The controller ticks that passed until this pose arrived.
+      for (; queryTime + options.queryLag <= times[i]; queryTime += period) {
+        if (queryTime < curve.getMinTime()) continue;
+        SE3Curve::ValueType value;
+        SE3Curve::DerivativeType twist;
+        ScopedLatency latency(queries);
+        curve.evaluate(value, queryTime);
+        curve.evaluateDerivative(twist, queryTime, 1);
+      }
+    }
+  }
+
+  ingestion.print();
+  queries.print();
+  std::printf("%-28s %10zu knots at most\n", name.c_str(), maxSize);
+}
+
+void printUsage()
+{
+  std::printf("Usage: curves_ros_replay_benchmark [--bag <file>] [--poses <file>] [--rate <Hz>] [--lag <s>]\n"
+              "         [--repetitions <n>] [--sampling-ratio <n>] [--min-sampling-period <s>] [--window <s>]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument(argv[i]);
+    if (i + 1 >= argc) {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    const char* value = argv[++i];
+    if (argument == "--bag") options.bagFile = value;
+    else if (argument == "--poses") options.posesFile = value;
+    else if (argument == "--rate") options.queryRate = std::atof(value);
+    else if (argument == "--lag") options.queryLag = std::atof(value);
+    else if (argument == "--repetitions") options.repetitions = std::atoi(value);
+    else if (argument == "--sampling-ratio") options.samplingRatio = std::atoi(value);
+    else if (argument == "--min-sampling-period") options.minSamplingPeriod = std::atof(value);
+    else if (argument == "--window") options.window = std::atof(value);
+    else {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+  if ((options.bagFile.empty() && options.posesFile.empty()) || !(options.queryRate > 0.0)
+      || options.repetitions < 1 || options.samplingRatio < 1) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  if (!options.bagFile.empty()) {
+    replayBag(options);
+  }
+  if (!options.posesFile.empty()) {
+    std::vector<Time> times;
+    std::vector<SE3Curve::ValueType> poses;
+    if (!readPoses(options.posesFile, times, poses)) {
+      std::fprintf(stderr, "Could not read the poses from %s.\n", options.posesFile.c_str());
+      return EXIT_FAILURE;
+    }
+    std::printf("Replaying %zu poses.\n", times.size());
+    replayPoses<CubicHermiteSE3Curve>(options, times, poses, "CubicHermiteSE3Curve");
+    replayPoses<SlerpSE3Curve>(options, times, poses, "SlerpSE3Curve");
+  }
+  std::printf("Peak memory: %ld kB\n", getPeakMemory());
+  return EXIT_SUCCESS;
+}
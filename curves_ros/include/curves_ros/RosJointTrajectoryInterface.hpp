@@ -15,6 +15,7 @@
 
 // STD
 #include <string>
+#include <vector>
 
 namespace curves {
 
@@ -25,11 +26,40 @@ class RosJointTrajectoryInterface : public PolynomialSplineQuinticScalarCurve
   virtual ~RosJointTrajectoryInterface();
 
   /*!
-   * Populate spline from a ROS joint trajectory message.
+   * Populate spline from a ROS joint trajectory message. If all points have velocities
+   * and accelerations, every segment is computed directly from its end points.
    * @param message the ROS trajectory message.
    * @param jointName the name of the joint to be copied.
    */
   bool fromMessage(const trajectory_msgs::JointTrajectory& message, const std::string& jointName);
+
+  /*!
+   * Populate one spline per joint from a ROS joint trajectory message. All joints
+   * share the knot times, so the spline system is solved only once. If all points have
+   * velocities and accelerations, no system is solved.
+   * @param message the ROS trajectory message.
+   * @param curves the splines, in the order of message.joint_names.
+   */
+  static bool fromMessage(const trajectory_msgs::JointTrajectory& message,
+                          std::vector<RosJointTrajectoryInterface>& curves);
+
+  /*!
+   * Populate one spline per selected joint from a ROS joint trajectory message in a
+   * single pass over the points. All joints share the knot times, so the spline
+   * system is solved only once.
+   * @param message the ROS trajectory message.
+   * @param jointNames the names of the joints to be copied.
+   * @param curves the splines, in the order of jointNames.
+   * @return false if a joint name is not found or a point has too few positions.
+   */
+  static bool fromMessage(const trajectory_msgs::JointTrajectory& message,
+                          const std::vector<std::string>& jointNames,
+                          std::vector<RosJointTrajectoryInterface>& curves);
+
+ private:
+  static bool fitJoints(const trajectory_msgs::JointTrajectory& message,
+                        const std::vector<size_t>& jointIndices,
+                        std::vector<RosJointTrajectoryInterface>& curves);
 };
 
 }  // namespace
@@ -15,6 +15,7 @@
 
 // STD
 #include <string>
+#include <vector>
 
 namespace curves {
 
@@ -25,12 +26,39 @@ class RosMultiDOFJointTrajectoryInterface : public CubicHermiteSE3Curve
   virtual ~RosMultiDOFJointTrajectoryInterface();
 
   /*!
-   * Populate spline from a ROS multi DOF joint trajectory message.
+   * Populate spline from a ROS multi DOF joint trajectory message. If all points have
+   * velocities, the twists are used as the tangents of the curve.
    * @param message the ROS multi DOF trajectory message.
    * @param jointName the name of the joint to be copied.
    */
   virtual bool fromMessage(const trajectory_msgs::MultiDOFJointTrajectory& message,
                            const std::string& jointName);
+
+  /*!
+   * Populate one spline per joint from a ROS multi DOF joint trajectory message in
+   * a single pass over the points.
+   * @param message the ROS multi DOF trajectory message.
+   * @param curves the splines, in the order of message.joint_names.
+   */
+  static bool fromMessage(const trajectory_msgs::MultiDOFJointTrajectory& message,
+                          std::vector<RosMultiDOFJointTrajectoryInterface>& curves);
+
+  /*!
+   * Populate one spline per selected joint from a ROS multi DOF joint trajectory
+   * message in a single pass over the points.
+   * @param message the ROS multi DOF trajectory message.
+   * @param jointNames the names of the joints to be copied.
+   * @param curves the splines, in the order of jointNames.
+   * @return false if a joint name is not found or a point has too few transforms.
+   */
+  static bool fromMessage(const trajectory_msgs::MultiDOFJointTrajectory& message,
+                          const std::vector<std::string>& jointNames,
+                          std::vector<RosMultiDOFJointTrajectoryInterface>& curves);
+
+ private:
+  static bool fitJoints(const trajectory_msgs::MultiDOFJointTrajectory& message,
+                        const std::vector<size_t>& jointIndices,
+                        std::vector<RosMultiDOFJointTrajectoryInterface>& curves);
 };
 
 }  // namespace
@@ -0,0 +1,188 @@
+/*
+ * SplineCurveMessage.hpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#pragma once
+
+// Curves
+#include <curves/PolynomialSplineScalarCurve.hpp>
+#include <curves/PolynomialSplineVectorSpaceCurve.hpp>
+
+// ROS
+#include <curves_ros/SplineCurve.h>
+
+// STD
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace curves {
+
+/*!
+ * Encode splines into a compact message, one container per dimension. The containers must
+ * hold splines of the same durations, like the ones fitted together with fitCurves().
+ * @param containers the splines of every dimension.
+ * @param startTime the time at which the first spline starts.
+ * @param maxError the maximal error of the decoded values. With 0, the coefficients are
+ *        sent as they are and decoded exactly, otherwise they are quantized to int32.
+ * @param message the message.
+ * @return false if the containers are empty or differ in their durations, or if a
+ *         coefficient is too large to be quantized with maxError.
+ */
+template <typename ContainerType>
+bool splinesToMessage(const std::vector<const ContainerType*>& containers, double startTime,
+                      double maxError, curves_ros::SplineCurve& message)
+{
+  using SplineType = typename ContainerType::SplineType;
+  const unsigned int nCoefficients = SplineType::coefficientCount;
+  if (containers.empty() || containers.size() > std::numeric_limits<uint8_t>::max() || maxError < 0.0) return false;
+  const size_t nDimensions = containers.size();
+  const size_t nSplines = containers[0]->getSplines().size();
+  for (const auto container : containers) {
+    if (container->getSplines().size() != nSplines) return false;
+  }
+
+  message.start_time = startTime;
+  message.num_dimensions = nDimensions;
+  message.num_coefficients = nCoefficients;
+  message.durations.resize(nSplines);
+  message.coefficients.clear();
+  message.quantized_coefficients.clear();
+  message.quantization_step = 0.0;
+  if (maxError > 0.0) {
+    message.quantization_step = 2.0 * maxError / nCoefficients;
+    message.quantized_coefficients.resize(nSplines * nDimensions * nCoefficients);
+  } else {
+    message.coefficients.resize(nSplines * nDimensions * nCoefficients);
+  }
+
+  const double maxQuantized = std::numeric_limits<int32_t>::max();
+  size_t c = 0;
+  for (size_t i = 0; i < nSplines; ++i) {
+    const double duration = containers[0]->getSplines()[i].getSplineDuration();
+    message.durations[i] = duration;
+    for (size_t j = 0; j < nDimensions; ++j) {
+      const SplineType& spline = containers[j]->getSplines()[i];
+      if (spline.getSplineDuration() != duration) return false;
+      const auto& coefficients = spline.getCoefficients();
+      if (maxError == 0.0) {
+        for (unsigned int k = 0; k < nCoefficients; ++k, ++c) {
+          message.coefficients[c] = coefficients[k];
+        }
+        continue;
+      }
+      // Coefficient k belongs to the power nCoefficients - 1 - k.
+      for (unsigned int k = 0; k < nCoefficients; ++k, ++c) {
+        const double normalized = coefficients[k] * std::pow(duration, nCoefficients - 1 - k);
+        const double quantized = std::round(normalized / message.quantization_step);
+        if (!(std::abs(quantized) <= maxQuantized)) return false;
+        message.quantized_coefficients[c] = static_cast<int32_t>(quantized);
+      }
+    }
+  }
+  return true;
+}
+
+/*!
+ * Decode the splines of every dimension from a message.
+ * @param message the message.
+ * @param splines the splines, one list per dimension.
+ * @return false if the message is inconsistent, e.g. has non-positive durations, or encodes
+ *         splines of another order.
+ */
+template <typename SplineType>
+bool splinesFromMessage(const curves_ros::SplineCurve& message,
+                        std::vector<std::vector<SplineType>>& splines)
+{
+  const unsigned int nCoefficients = SplineType::coefficientCount;
+  const size_t nDimensions = message.num_dimensions;
+  const size_t nSplines = message.durations.size();
+  const size_t size = nSplines * nDimensions * nCoefficients;
+  const bool isQuantized = message.coefficients.empty() && !message.quantized_coefficients.empty();
+  if (message.num_coefficients != nCoefficients || nDimensions == 0) return false;
+  if (isQuantized ? message.quantized_coefficients.size() != size || !(message.quantization_step > 0.0)
+                  : message.coefficients.size() != size) return false;
+
+  splines.assign(nDimensions, std::vector<SplineType>(nSplines));
+  typename SplineType::SplineCoefficients coefficients;
+  size_t c = 0;
+  for (size_t i = 0; i < nSplines; ++i) {
+    const double duration = message.durations[i];
+    if (!(duration > 0.0)) return false;
+    for (size_t j = 0; j < nDimensions; ++j) {
+      for (unsigned int k = 0; k < nCoefficients; ++k, ++c) {
+        coefficients[k] = isQuantized
+            ? message.quantized_coefficients[c] * message.quantization_step / std::pow(duration, nCoefficients - 1 - k)
+            : message.coefficients[c];
+      }
+      splines[j][i].setCoefficientsAndDuration(coefficients, duration);
+    }
+  }
+  return true;
+}
+
+/*!
+ * Encode scalar spline curves which share their knot times, e.g. the joints of a
+ * trajectory read with RosJointTrajectoryInterface::fromMessage, see splinesToMessage.
+ */
+template <typename SplineType>
+bool curvesToMessage(const std::vector<const PolynomialSplineScalarCurve<SplineType>*>& curves,
+                     double maxError, curves_ros::SplineCurve& message)
+{
+  if (curves.empty()) return false;
+  std::vector<const typename PolynomialSplineScalarCurve<SplineType>::Container*> containers;
+  containers.reserve(curves.size());
+  for (const auto curve : curves) {
+    containers.push_back(&curve->getSplineContainer());
+  }
+  return splinesToMessage(containers, curves[0]->getMinTime(), maxError, message);
+}
+
+/*!
+ * Decode scalar spline curves, one per dimension of the message, see splinesFromMessage.
+ */
+template <typename SplineType>
+bool curvesFromMessage(const curves_ros::SplineCurve& message,
+                       const std::vector<PolynomialSplineScalarCurve<SplineType>*>& curves)
+{
+  std::vector<std::vector<SplineType>> splines;
+  if (!splinesFromMessage(message, splines) || splines.size() != curves.size()) return false;
+  for (size_t j = 0; j < curves.size(); ++j) {
+    curves[j]->setSplines({splines[j].begin(), splines[j].end()}, message.start_time);
+  }
+  return true;
+}
+
+/*!
+ * Encode a vector space spline curve, see splinesToMessage.
+ */
+template <typename SplineType, int N>
+bool curveToMessage(const PolynomialSplineVectorSpaceCurve<SplineType, N>& curve, double maxError,
+                    curves_ros::SplineCurve& message)
+{
+  std::vector<const typename PolynomialSplineVectorSpaceCurve<SplineType, N>::Container*> containers;
+  containers.reserve(N);
+  for (size_t j = 0; j < N; ++j) {
+    containers.push_back(&curve.getSplineContainer(j));
+  }
+  return splinesToMessage(containers, curve.getMinTime(), maxError, message);
+}
+
+/*!
+ * Decode a vector space spline curve, see splinesFromMessage.
+ */
+template <typename SplineType, int N>
+bool curveFromMessage(const curves_ros::SplineCurve& message, PolynomialSplineVectorSpaceCurve<SplineType, N>& curve)
+{
+  std::vector<std::vector<SplineType>> splines;
+  if (!splinesFromMessage(message, splines) || splines.size() != N) return false;
+  for (size_t j = 0; j < N; ++j) {
+    curve.setSplines(j, {splines[j].begin(), splines[j].end()}, message.start_time);
+  }
+  return true;
+}
+
+}  // namespace
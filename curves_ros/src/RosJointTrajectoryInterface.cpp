@@ -9,10 +9,30 @@
 #include <ros/ros.h>
 
 // STD
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
 #include <vector>
 
 namespace curves {
 
+namespace {
+
+/*!
+ * True if every point of the message has a velocity and an acceleration for every joint.
+ * Such trajectories are fitted segment by segment, without solving a spline system.
+ */
+bool hasDerivatives(const trajectory_msgs::JointTrajectory& message)
+{
+  const size_t nJoints = message.joint_names.size();
+  for (const auto& point : message.points) {
+    if (point.velocities.size() != nJoints || point.accelerations.size() != nJoints) return false;
+  }
+  return !message.points.empty();
+}
+
+}  // namespace
+
 RosJointTrajectoryInterface::RosJointTrajectoryInterface() :
     PolynomialSplineQuinticScalarCurve()
 {
@@ -27,24 +47,111 @@ RosJointTrajectoryInterface::~RosJointTrajectoryInterface()
 bool RosJointTrajectoryInterface::fromMessage(const trajectory_msgs::JointTrajectory& message,
                                               const std::string& jointName)
 {
-  size_t nJoints = message.joint_names.size();
-  size_t j = 0;
-  for (; j < nJoints; ++j) {
-    if (message.joint_names[j] == jointName) break;
-    if (j == nJoints - 1) return false; // Joint name not found.
-  }
+  const auto joint = std::find(message.joint_names.begin(), message.joint_names.end(), jointName);
+  if (joint == message.joint_names.end()) return false; // Joint name not found.
+  const size_t j = joint - message.joint_names.begin();
 
   std::vector<Time> times;
   std::vector<PolynomialSplineQuinticScalarCurve::ValueType> values;
+  times.reserve(message.points.size());
+  values.reserve(message.points.size());
 
   for (const auto& point : message.points) {
+    if (point.positions.size() <= j) return false;
     times.push_back(ros::Duration(point.time_from_start).toSec());
     values.push_back(point.positions[j]);
   }
 
-  // TODO Make this work also with velocities and accelerations.
+  if (!hasDerivatives(message)) {
+    fitCurve(times, values);
+    return true;
+  }
+
+  std::vector<PolynomialSplineQuinticScalarCurve::DerivativeType> velocities, accelerations;
+  velocities.reserve(message.points.size());
+  accelerations.reserve(message.points.size());
+  for (const auto& point : message.points) {
+    velocities.push_back(point.velocities[j]);
+    accelerations.push_back(point.accelerations[j]);
+  }
+  fitCurve(times, values, velocities, accelerations);
+
+  return true;
+}
+
+bool RosJointTrajectoryInterface::fromMessage(const trajectory_msgs::JointTrajectory& message,
+                                              std::vector<RosJointTrajectoryInterface>& curves)
+{
+  if (message.joint_names.empty()) return false;
+  std::vector<size_t> jointIndices(message.joint_names.size());
+  std::iota(jointIndices.begin(), jointIndices.end(), 0);
+  return fitJoints(message, jointIndices, curves);
+}
 
-  fitCurve(times, values);
+bool RosJointTrajectoryInterface::fromMessage(const trajectory_msgs::JointTrajectory& message,
+                                              const std::vector<std::string>& jointNames,
+                                              std::vector<RosJointTrajectoryInterface>& curves)
+{
+  if (jointNames.empty()) return false;
+  std::unordered_map<std::string, size_t> messageIndices;
+  messageIndices.reserve(message.joint_names.size());
+  for (size_t j = 0; j < message.joint_names.size(); ++j) {
+    messageIndices[message.joint_names[j]] = j;
+  }
+
+  std::vector<size_t> jointIndices;
+  jointIndices.reserve(jointNames.size());
+  for (const auto& jointName : jointNames) {
+    const auto index = messageIndices.find(jointName);
+    if (index == messageIndices.end()) return false; // Joint name not found.
+    jointIndices.push_back(index->second);
+  }
+  return fitJoints(message, jointIndices, curves);
+}
+
+bool RosJointTrajectoryInterface::fitJoints(const trajectory_msgs::JointTrajectory& message,
+                                            const std::vector<size_t>& jointIndices,
+                                            std::vector<RosJointTrajectoryInterface>& curves)
+{
+  const size_t nJoints = jointIndices.size();
+  const size_t nPositions = message.joint_names.size();
+
+  const size_t nPoints = message.points.size();
+
+  std::vector<Time> times;
+  times.reserve(nPoints);
+  Eigen::MatrixXd values(nPoints, nJoints);
+
+  for (size_t i = 0; i < nPoints; ++i) {
+    const auto& point = message.points[i];
+    if (point.positions.size() != nPositions) return false;
+    times.push_back(ros::Duration(point.time_from_start).toSec());
+    for (size_t j = 0; j < nJoints; ++j) {
+      values(i, j) = point.positions[jointIndices[j]];
+    }
+  }
+
+  curves.resize(nJoints);
+
+  if (hasDerivatives(message)) {
+    std::vector<double> jointValues(nPoints), velocities(nPoints), accelerations(nPoints);
+    for (size_t j = 0; j < nJoints; ++j) {
+      for (size_t i = 0; i < nPoints; ++i) {
+        jointValues[i] = values(i, j);
+        velocities[i] = message.points[i].velocities[jointIndices[j]];
+        accelerations[i] = message.points[i].accelerations[jointIndices[j]];
+      }
+      curves[j].fitCurve(times, jointValues, velocities, accelerations);
+    }
+    return true;
+  }
+
+  std::vector<PolynomialSplineQuinticScalarCurve*> splineCurves;
+  splineCurves.reserve(nJoints);
+  for (auto& curve : curves) {
+    splineCurves.push_back(&curve);
+  }
+  fitCurves(times, values, splineCurves);
 
   return true;
 }
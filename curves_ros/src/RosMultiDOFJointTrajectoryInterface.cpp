@@ -9,6 +9,9 @@
 #include <ros/ros.h>
 
 // STD
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
 #include <vector>
 
 // Kindr
@@ -16,6 +19,30 @@
 
 namespace curves {
 
+namespace {
+
+/*!
+ * True if every point of the message has a velocity for every joint. The twists of
+ * such trajectories are used as the tangents of the curve instead of estimated slopes.
+ */
+bool hasVelocities(const trajectory_msgs::MultiDOFJointTrajectory& message)
+{
+  const size_t nJoints = message.joint_names.size();
+  for (const auto& point : message.points) {
+    if (point.velocities.size() != nJoints) return false;
+  }
+  return !message.points.empty();
+}
+
+CubicHermiteSE3Curve::DerivativeType toDerivative(const geometry_msgs::Twist& twist)
+{
+  return CubicHermiteSE3Curve::DerivativeType(
+      Eigen::Vector3d(twist.linear.x, twist.linear.y, twist.linear.z),
+      Eigen::Vector3d(twist.angular.x, twist.angular.y, twist.angular.z));
+}
+
+}  // namespace
+
 RosMultiDOFJointTrajectoryInterface::RosMultiDOFJointTrajectoryInterface() :
     CubicHermiteSE3Curve()
 {
@@ -30,26 +57,110 @@ RosMultiDOFJointTrajectoryInterface::~RosMultiDOFJointTrajectoryInterface()
 bool RosMultiDOFJointTrajectoryInterface::fromMessage(
     const trajectory_msgs::MultiDOFJointTrajectory& message, const std::string& jointName)
 {
-  size_t nJoints = message.joint_names.size();
-  size_t j = 0;
-  for (; j < nJoints; ++j) {
-    if (message.joint_names[j] == jointName) break;
-    if (j == nJoints - 1) return false; // Joint name not found.
-  }
+  const auto joint = std::find(message.joint_names.begin(), message.joint_names.end(), jointName);
+  if (joint == message.joint_names.end()) return false; // Joint name not found.
+  const size_t j = joint - message.joint_names.begin();
 
   std::vector<Time> times;
   std::vector<CubicHermiteSE3Curve::ValueType> values;
+  times.reserve(message.points.size());
+  values.reserve(message.points.size());
 
   for (const auto& point : message.points) {
+    if (point.transforms.size() <= j) return false;
     times.push_back(ros::Duration(point.time_from_start).toSec());
     CubicHermiteSE3Curve::ValueType pose;
     kindr_ros::convertFromRosGeometryMsg(point.transforms[j], pose);
     values.push_back(pose);
   }
 
-  // TODO Make this work also with velocities and accelerations.
+  if (!hasVelocities(message)) {
+    fitCurve(times, values);
+    return true;
+  }
+
+  std::vector<CubicHermiteSE3Curve::DerivativeType> derivatives;
+  derivatives.reserve(message.points.size());
+  for (const auto& point : message.points) {
+    derivatives.push_back(toDerivative(point.velocities[j]));
+  }
+  fitCurveWithDerivatives(times, values, derivatives);
+
+  return true;
+}
+
+bool RosMultiDOFJointTrajectoryInterface::fromMessage(
+    const trajectory_msgs::MultiDOFJointTrajectory& message,
+    std::vector<RosMultiDOFJointTrajectoryInterface>& curves)
+{
+  if (message.joint_names.empty()) return false;
+  std::vector<size_t> jointIndices(message.joint_names.size());
+  std::iota(jointIndices.begin(), jointIndices.end(), 0);
+  return fitJoints(message, jointIndices, curves);
+}
+
+bool RosMultiDOFJointTrajectoryInterface::fromMessage(
+    const trajectory_msgs::MultiDOFJointTrajectory& message,
+    const std::vector<std::string>& jointNames,
+    std::vector<RosMultiDOFJointTrajectoryInterface>& curves)
+{
+  if (jointNames.empty()) return false;
+  std::unordered_map<std::string, size_t> messageIndices;
+  messageIndices.reserve(message.joint_names.size());
+  for (size_t j = 0; j < message.joint_names.size(); ++j) {
+    messageIndices[message.joint_names[j]] = j;
+  }
+
+  std::vector<size_t> jointIndices;
+  jointIndices.reserve(jointNames.size());
+  for (const auto& jointName : jointNames) {
+    const auto index = messageIndices.find(jointName);
+    if (index == messageIndices.end()) return false; // Joint name not found.
+    jointIndices.push_back(index->second);
+  }
+  return fitJoints(message, jointIndices, curves);
+}
+
+bool RosMultiDOFJointTrajectoryInterface::fitJoints(
+    const trajectory_msgs::MultiDOFJointTrajectory& message,
+    const std::vector<size_t>& jointIndices,
+    std::vector<RosMultiDOFJointTrajectoryInterface>& curves)
+{
+  const size_t nJoints = jointIndices.size();
+  const size_t nTransforms = message.joint_names.size();
 
-  fitCurve(times, values);
+  std::vector<Time> times;
+  times.reserve(message.points.size());
+  std::vector<std::vector<CubicHermiteSE3Curve::ValueType> > values(nJoints);
+  for (auto& jointValues : values) {
+    jointValues.reserve(message.points.size());
+  }
+
+  for (const auto& point : message.points) {
+    if (point.transforms.size() != nTransforms) return false;
+    times.push_back(ros::Duration(point.time_from_start).toSec());
+    for (size_t j = 0; j < nJoints; ++j) {
+      CubicHermiteSE3Curve::ValueType pose;
+      kindr_ros::convertFromRosGeometryMsg(point.transforms[jointIndices[j]], pose);
+      values[j].push_back(pose);
+    }
+  }
+
+  curves.resize(nJoints);
+  if (!hasVelocities(message)) {
+    for (size_t j = 0; j < nJoints; ++j) {
+      curves[j].fitCurve(times, values[j]);
+    }
+    return true;
+  }
+
+  std::vector<CubicHermiteSE3Curve::DerivativeType> derivatives(message.points.size());
+  for (size_t j = 0; j < nJoints; ++j) {
+    for (size_t i = 0; i < message.points.size(); ++i) {
+      derivatives[i] = toDerivative(message.points[i].velocities[jointIndices[j]]);
+    }
+    curves[j].fitCurveWithDerivatives(times, values[j], derivatives);
+  }
 
   return true;
 }
@@ -0,0 +1,122 @@
+/*
+ * SplineCurveMessageTest.cpp
+ *
+ *  Created on: Oct 15, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include "curves_ros/SplineCurveMessage.hpp"
+
+#include <cmath>
+
+using namespace curves;
+
+typedef PolynomialSplineQuinticVector3Curve VectorCurve;
+
+namespace {
+
+void getTestCurve(VectorCurve& curve)
+{
+  std::vector<Time> times;
+  std::vector<VectorCurve::ValueType> values;
+  for (int i = 0; i < 8; ++i) {
+    times.push_back(1.0 + 0.3 * i + 0.05 * (i % 3));
+    values.push_back(VectorCurve::ValueType(std::sin(i), 2.0 * std::cos(0.5 * i), 0.1 * i * i));
+  }
+  curve.fitCurve(times, values);
+}
+
+} // namespace
+
+TEST(SplineCurveMessage, ExactRoundTrip)
+{
+  VectorCurve curve;
+  getTestCurve(curve);
+  curves_ros::SplineCurve message;
+  ASSERT_TRUE(curveToMessage(curve, 0.0, message));
+  EXPECT_TRUE(message.quantized_coefficients.empty());
+
+  VectorCurve decoded;
+  ASSERT_TRUE(curveFromMessage(message, decoded));
+  EXPECT_EQ(curve.getMinTime(), decoded.getMinTime());
+  for (size_t j = 0; j < 3; ++j) {
+    const auto& splines = curve.getSplineContainer(j).getSplines();
+    const auto& decodedSplines = decoded.getSplineContainer(j).getSplines();
+    ASSERT_EQ(splines.size(), decodedSplines.size());
+    for (size_t i = 0; i < splines.size(); ++i) {
+      EXPECT_EQ(splines[i].getSplineDuration(), decodedSplines[i].getSplineDuration());
+      for (unsigned int k = 0; k < PolynomialSplineQuintic::coefficientCount; ++k) {
+        EXPECT_EQ(splines[i].getCoefficients()[k], decodedSplines[i].getCoefficients()[k]);
+      }
+    }
+  }
+}
+
+TEST(SplineCurveMessage, QuantizedRoundTrip)
+{
+  VectorCurve curve;
+  getTestCurve(curve);
+  const double maxError = 1e-4;
+  curves_ros::SplineCurve message;
+  ASSERT_TRUE(curveToMessage(curve, maxError, message));
+  EXPECT_TRUE(message.coefficients.empty());
+  const double bound = message.num_coefficients * message.quantization_step / 2.0;
+  EXPECT_NEAR(maxError, bound, 1e-15);
+
+  VectorCurve decoded;
+  ASSERT_TRUE(curveFromMessage(message, decoded));
+  for (Time time = curve.getMinTime(); time <= curve.getMaxTime(); time += 0.01) {
+    VectorCurve::ValueType value, decodedValue;
+    ASSERT_TRUE(curve.evaluate(value, time));
+    ASSERT_TRUE(decoded.evaluate(decodedValue, time));
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_LE(std::abs(value[j] - decodedValue[j]), bound * (1.0 + 1e-9));
+    }
+  }
+}
+
+TEST(SplineCurveMessage, QuantizationOverflow)
+{
+  typedef PolynomialSplineContainerT<PolynomialSplineQuintic> Container;
+  PolynomialSplineQuintic spline;
+  spline.setCoefficientsAndDuration(PolynomialSplineQuintic::EigenCoefficientVectorType::Constant(1e3), 1.0);
+  Container container;
+  container.addSpline(spline);
+  curves_ros::SplineCurve message;
+  EXPECT_TRUE(splinesToMessage<Container>({&container}, 0.0, 1e-3, message));
+  // The coefficients are too large for int32 in multiples of the step of this error.
+  EXPECT_FALSE(splinesToMessage<Container>({&container}, 0.0, 1e-7, message));
+}
+
+TEST(SplineCurveMessage, InconsistentMessage)
+{
+  VectorCurve curve;
+  getTestCurve(curve);
+  std::vector<std::vector<PolynomialSplineQuintic>> splines;
+  for (const double maxError : {0.0, 1e-4}) {
+    curves_ros::SplineCurve message;
+    ASSERT_TRUE(curveToMessage(curve, maxError, message));
+    ASSERT_TRUE(splinesFromMessage(message, splines));
+
+    curves_ros::SplineCurve inconsistent = message;
+    inconsistent.durations.pop_back();
+    EXPECT_FALSE(splinesFromMessage(inconsistent, splines));
+    inconsistent = message;
+    inconsistent.coefficients.push_back(0.0);
+    inconsistent.quantized_coefficients.push_back(0);
+    EXPECT_FALSE(splinesFromMessage(inconsistent, splines));
+    inconsistent = message;
+    ++inconsistent.num_dimensions;
+    EXPECT_FALSE(splinesFromMessage(inconsistent, splines));
+    inconsistent = message;
+    inconsistent.num_coefficients = 4;
+    EXPECT_FALSE(splinesFromMessage(inconsistent, splines));
+
+    for (const double duration : {0.0, -0.1}) {
+      inconsistent = message;
+      inconsistent.durations[2] = duration;
+      EXPECT_FALSE(splinesFromMessage(inconsistent, splines));
+    }
+  }
+}